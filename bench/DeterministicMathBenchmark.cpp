@@ -0,0 +1,163 @@
+// The simulation's sqrt, atan2 and sin: time per call and worst error of the
+// C library and the deterministic versions. Then a scripted run of a map,
+// whose hash must be the same on every machine.
+#include "core/AssetLoader.hpp"
+#include "core/DeterministicMath.hpp"
+#include "core/LevelBuilder.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace
+{
+    constexpr int CALLS = 1 << 20;
+    constexpr int TICKS = 60 * 60;
+    constexpr float TICK = 1.0f / 60.0f;
+
+    using Clock = std::chrono::steady_clock;
+
+    volatile float sink;
+
+    struct Cost
+    {
+        double nsPerCall = 0;
+        double maxError = 0;
+    };
+
+    // Times f over the inputs, then measures its worst error against the
+    // double precision answer
+    template <typename Function, typename Exact>
+    Cost measure(const std::vector<float>& a, const std::vector<float>& b, Function f, Exact exact)
+    {
+        float sum = 0;
+        auto start = Clock::now();
+        for (std::size_t i = 0; i < a.size(); ++i)
+        {
+            sum += f(a[i], b[i]);
+        }
+        double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+        sink = sum;
+
+        Cost cost;
+        cost.nsPerCall = seconds * 1e9 / a.size();
+        for (std::size_t i = 0; i < a.size(); ++i)
+        {
+            cost.maxError = std::max(cost.maxError, std::abs(f(a[i], b[i]) - exact(a[i], b[i])));
+        }
+        return cost;
+    }
+
+    void printRow(const char* function, const char* version, const Cost& cost)
+    {
+        std::printf("%-8s %-8s %10.2f %14.2e\n", function, version, cost.nsPerCall, cost.maxError);
+    }
+
+    // Same rhythm as the ghost benchmark: runs, jumps and swings
+    InputState scriptedInput(int tick)
+    {
+        InputState input;
+        input.setHeld(Action::MoveRight, (tick / 60) % 4 != 3);
+        input.setHeld(Action::MoveLeft, (tick / 60) % 4 == 3);
+        if (tick % 50 == 0)
+        {
+            input.setHeld(Action::Jump, true);
+            input.pressed |= InputState::bit(Action::Jump);
+        }
+        if (tick % 140 == 40)
+        {
+            input.setHeld(Action::Hook, true);
+            input.pressed |= InputState::bit(Action::Hook);
+            input.aim = {400.0f + tick * 2.0f, 100.0f};
+        }
+        if (tick % 140 == 100)
+            input.pressed |= InputState::bit(Action::ReleaseHook);
+        return input;
+    }
+
+    // FNV-1a over the bits of a float
+    void hashFloat(std::uint64_t& hash, float value)
+    {
+        std::uint32_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        for (int i = 0; i < 4; ++i)
+        {
+            hash = (hash ^ ((bits >> (i * 8)) & 0xFF)) * 1099511628211ull;
+        }
+    }
+}
+
+int main(int argc, char** argv)
+{
+    std::string mapFile = argc > 1 ? argv[1] : "map1.txt";
+
+    // Inputs in the range the simulation feeds them: squared lengths, rope
+    // offsets and platform phases
+    std::minstd_rand random(3);
+    std::uniform_real_distribution<float> square(0.0f, 16000.0f);
+    std::uniform_real_distribution<float> side(-8000.0f, 8000.0f);
+    std::uniform_real_distribution<float> phase(-60.0f, 60.0f);
+    std::vector<float> squares(CALLS), ys(CALLS), xs(CALLS), phases(CALLS), unused(CALLS);
+    for (int i = 0; i < CALLS; ++i)
+    {
+        squares[i] = square(random);
+        ys[i] = side(random);
+        xs[i] = side(random);
+        phases[i] = phase(random);
+    }
+
+    std::printf("Deterministic math benchmark: %d calls each\n", CALLS);
+    std::printf("%-8s %-8s %10s %14s\n", "function", "version", "ns/call", "max error");
+
+    auto exactSqrt = [](float x, float) { return std::sqrt(static_cast<double>(x)); };
+    printRow("sqrt", "std", measure(squares, unused, [](float x, float) { return std::sqrt(x); }, exactSqrt));
+    printRow("sqrt", "float", measure(squares, unused, [](float x, float) { return detSqrt(x); }, exactSqrt));
+
+    auto exactAtan2 = [](float y, float x) { return std::atan2(static_cast<double>(y), static_cast<double>(x)); };
+    printRow("atan2", "std", measure(ys, xs, [](float y, float x) { return std::atan2(y, x); }, exactAtan2));
+    printRow("atan2", "float", measure(ys, xs, [](float y, float x) { return detAtan2(y, x); }, exactAtan2));
+
+    auto exactSin = [](float x, float) { return std::sin(static_cast<double>(x)); };
+    printRow("sin", "std", measure(phases, unused, [](float x, float) { return std::sin(x); }, exactSin));
+    printRow("sin", "float", measure(phases, unused, [](float x, float) { return detSin(x); }, exactSin));
+
+    AssetLoader assets;
+    assets.open();
+
+    MapData map;
+    std::uint64_t mapHash = 0;
+    if (!assets.readMap(mapFile, map, mapHash))
+        return 1;
+
+    sf::Texture texture;
+    LevelBuilder builder({&texture, &texture, &texture, &texture, &texture, &texture});
+    Simulation simulation(texture);
+    std::vector<Entity> entities;
+    builder.build(simulation, map, entities);
+    simulation.restart({LevelBuilder::SPAWN_X, LevelBuilder::SPAWN_Y});
+
+    // Every tick's position and velocity go into the hash, so the first
+    // difference anywhere in the run changes it
+    std::uint64_t stateHash = 14695981039346656037ull;
+    SimulationEvents events;
+    auto start = Clock::now();
+    for (int tick = 0; tick < TICKS; ++tick)
+    {
+        simulation.step(scriptedInput(tick), sf::seconds(TICK), events);
+        const Player& player = simulation.getPlayer();
+        hashFloat(stateHash, player.getPosition().x);
+        hashFloat(stateHash, player.getPosition().y);
+        hashFloat(stateHash, player.getVelocity().x);
+        hashFloat(stateHash, player.getVelocity().y);
+    }
+    double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+    std::printf("\n%s, %d ticks: %.0f ticks/s, state hash %016llx\n", mapFile.c_str(), TICKS, TICKS / seconds,
+                static_cast<unsigned long long>(stateHash));
+    return 0;
+}
@@ -0,0 +1,143 @@
+// Steps a second through hookleap_env for growing batches of worlds, on one
+// thread and on every core, and the heap allocations made per step and
+// observation once the batch is warm. Resetting a world copies its level
+// and is left out of the count.
+#include "env/hookleap_env.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    std::atomic<std::uint64_t> allocations{0};
+}
+
+// Counts every allocation in the process, the library's included
+void* operator new(std::size_t size)
+{
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* memory = std::malloc(size ? size : 1))
+        return memory;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* memory) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete(void* memory, std::size_t) noexcept
+{
+    std::free(memory);
+}
+
+namespace
+{
+    // Long enough for most worlds to have used their hook and rope buffers
+    constexpr int WARMUP_STEPS = 1200;
+    constexpr int STEPS = 1200;
+    // Inputs change this often, about how often an agent acts
+    constexpr int ACTION_REPEAT = 4;
+
+    using Clock = std::chrono::steady_clock;
+
+    struct Result
+    {
+        double stepsPerSecond = 0;
+        double allocationsPerStep = 0;
+    };
+
+    Result run(const std::string& map, std::uint32_t worlds, std::uint32_t threads)
+    {
+        HookLeapEnv* env = hookleap_env_create(map.c_str(), worlds, threads);
+        if (!env)
+        {
+            std::fprintf(stderr, "%s\n", hookleap_env_last_error());
+            std::exit(1);
+        }
+
+        std::vector<std::uint16_t> buttons(worlds);
+        std::vector<float> aim(2 * worlds);
+        std::vector<std::uint8_t> events(worlds);
+        std::vector<std::uint8_t> done(worlds);
+        std::vector<float> observations(HOOKLEAP_OBSERVATION_SIZE * worlds);
+        std::minstd_rand random(7);
+
+        // A random policy that runs right and fires the hook up ahead
+        auto act = [&]()
+        {
+            for (std::uint32_t w = 0; w < worlds; ++w)
+            {
+                std::uint16_t choice = static_cast<std::uint16_t>(random() % 32);
+                buttons[w] = static_cast<std::uint16_t>((choice & ~HOOKLEAP_BUTTON_LEFT) | HOOKLEAP_BUTTON_RIGHT);
+                aim[w] = observations[HOOKLEAP_OBS_X * worlds + w] + 200.0f;
+                aim[worlds + w] = observations[HOOKLEAP_OBS_Y * worlds + w] - 300.0f;
+            }
+        };
+
+        std::uint64_t stepAllocations = 0;
+        auto stepOnce = [&](int step)
+        {
+            if (step % ACTION_REPEAT == 0)
+                act();
+            std::uint64_t before = allocations.load();
+            hookleap_env_step(env, buttons.data(), aim.data(), events.data());
+            hookleap_env_observe(env, observations.data());
+            stepAllocations += allocations.load() - before;
+
+            bool any = false;
+            for (std::uint32_t w = 0; w < worlds; ++w)
+            {
+                done[w] = (events[w] & HOOKLEAP_EVENT_WON) != 0;
+                any = any || done[w];
+            }
+            if (any)
+                hookleap_env_reset(env, done.data());
+        };
+
+        hookleap_env_reset(env, nullptr);
+        hookleap_env_observe(env, observations.data());
+        for (int step = 0; step < WARMUP_STEPS; ++step)
+        {
+            stepOnce(step);
+        }
+
+        stepAllocations = 0;
+        auto start = Clock::now();
+        for (int step = 0; step < STEPS; ++step)
+        {
+            stepOnce(step);
+        }
+        double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+        Result result;
+        result.stepsPerSecond = static_cast<double>(STEPS) * worlds / seconds;
+        result.allocationsPerStep = static_cast<double>(stepAllocations) / STEPS;
+        hookleap_env_destroy(env);
+        return result;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    std::string map = argc > 1 ? argv[1] : "assets/maps/map1.txt";
+    std::uint32_t cores = std::max(1u, std::thread::hardware_concurrency());
+
+    std::printf("Environment benchmark: %s, %d steps per run, %u cores\n", map.c_str(), STEPS, cores);
+    std::printf("%8s %16s %16s %16s\n", "worlds", "1 thread", "all threads", "allocs/step");
+    for (std::uint32_t worlds : {1u, 16u, 256u, 1024u, 4096u})
+    {
+        Result single = run(map, worlds, 1);
+        Result all = run(map, worlds, 0);
+        std::printf("%8u %14.0f/s %14.0f/s %16.2f\n", worlds, single.stepsPerSecond, all.stepsPerSecond,
+                    all.allocationsPerStep);
+    }
+    return 0;
+}
@@ -0,0 +1,136 @@
+// Ghost files and ghost drawing: size of a recorded run against storing every
+// frame raw, and the per-tick cost of streaming and batching many ghosts.
+#include "core/AssetLoader.hpp"
+#include "core/Ghost.hpp"
+#include "core/GhostRenderer.hpp"
+#include "core/LevelBuilder.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+namespace
+{
+    constexpr int TICKS = 60 * 60;
+    constexpr float TICK = 1.0f / 60.0f;
+    constexpr int GHOST_COUNTS[] = {1, 10, 50};
+    constexpr const char* GHOST_FILE = "bench_run.ghost";
+
+    using Clock = std::chrono::steady_clock;
+
+    // Runs right, jumps and swings on a fixed rhythm, so the run has every
+    // kind of movement a player makes
+    InputState scriptedInput(int tick)
+    {
+        InputState input;
+        input.setHeld(Action::MoveRight, (tick / 60) % 4 != 3);
+        input.setHeld(Action::MoveLeft, (tick / 60) % 4 == 3);
+        if (tick % 50 == 0)
+        {
+            input.setHeld(Action::Jump, true);
+            input.pressed |= InputState::bit(Action::Jump);
+        }
+        if (tick % 140 == 40)
+        {
+            input.setHeld(Action::Hook, true);
+            input.pressed |= InputState::bit(Action::Hook);
+            input.aim = {400.0f + tick * 2.0f, 100.0f};
+        }
+        if (tick % 140 == 100)
+            input.pressed |= InputState::bit(Action::ReleaseHook);
+        return input;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    std::string mapFile = argc > 1 ? argv[1] : "map1.txt";
+
+    AssetLoader assets;
+    assets.open();
+
+    MapData map;
+    std::uint64_t hash = 0;
+    if (!assets.readMap(mapFile, map, hash))
+        return 1;
+
+    sf::Texture texture;
+    LevelBuilder builder({&texture, &texture, &texture, &texture, &texture, &texture});
+    Simulation simulation(texture);
+    std::vector<Entity> entities;
+    builder.build(simulation, map, entities);
+    simulation.restart({LevelBuilder::SPAWN_X, LevelBuilder::SPAWN_Y});
+
+    // Record, keeping every frame to check the playback against
+    GhostRecorder recorder;
+    RenderSnapshot snapshot;
+    std::vector<GhostFrame> recorded;
+    for (int tick = 0; tick < TICKS; ++tick)
+    {
+        simulation.step(scriptedInput(tick), sf::seconds(TICK));
+        simulation.buildSnapshot(snapshot);
+        recorded.push_back(GhostFrame::fromSnapshot(snapshot));
+        recorder.record(recorded.back());
+    }
+
+    if (!recorder.save(GHOST_FILE, hash))
+        return 1;
+
+    // Position, two floats of hook point, time and a byte each for the rest
+    std::size_t rawSize = recorded.size() * (4 * 5 + 4 * 2);
+    std::size_t fileSize = static_cast<std::size_t>(std::filesystem::file_size(GHOST_FILE));
+    std::printf("Ghost benchmark: %s, %.0f s run, %u frames\n", mapFile.c_str(), TICKS * TICK, recorder.getFrameCount());
+    std::printf("%-10s %10s %14s\n", "format", "bytes", "bytes/frame");
+    std::printf("%-10s %10zu %14.2f\n", "raw", rawSize, static_cast<double>(rawSize) / recorded.size());
+    std::printf("%-10s %10zu %14.2f\n", "ghost", fileSize, static_cast<double>(fileSize) / recorded.size());
+
+    // Every recorded frame lands on a tick, so playback must match it to the
+    // 1/16 pixel the file keeps
+    GhostPlayback check;
+    if (!check.open(GHOST_FILE))
+        return 1;
+    float maxError = 0;
+    for (const auto& frame : recorded)
+    {
+        GhostFrame played;
+        if (!check.sample(frame.time, played))
+            break;
+        sf::Vector2f error = played.position - frame.position;
+        maxError = std::max({maxError, std::abs(error.x), std::abs(error.y)});
+    }
+    std::printf("max position error %.4f px\n\n", maxError);
+
+    // However many ghosts, drawing them is two draw calls
+    std::printf("%-8s %14s\n", "ghosts", "us/tick");
+    GhostRenderer renderer;
+    for (int count : GHOST_COUNTS)
+    {
+        std::vector<std::unique_ptr<GhostPlayback>> ghosts;
+        for (int i = 0; i < count; ++i)
+        {
+            ghosts.push_back(std::make_unique<GhostPlayback>());
+            ghosts.back()->open(GHOST_FILE);
+        }
+
+        auto start = Clock::now();
+        for (const auto& frame : recorded)
+        {
+            renderer.clear();
+            for (auto& ghost : ghosts)
+            {
+                GhostFrame played;
+                if (ghost->sample(frame.time, played))
+                    renderer.add(played, {128, 128}, {64, 62}, sf::Color::White);
+            }
+        }
+        double us = std::chrono::duration<double, std::micro>(Clock::now() - start).count() / recorded.size();
+        std::printf("%-8d %14.3f\n", count, us);
+    }
+
+    std::error_code error;
+    std::filesystem::remove(GHOST_FILE, error);
+    return 0;
+}
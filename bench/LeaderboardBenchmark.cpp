@@ -0,0 +1,101 @@
+// Leaderboard store with a large history: opening from the index against
+// rebuilding it from the log, and the cost of the queries the win screen and
+// menu make.
+#include "core/Leaderboard.hpp"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <random>
+#include <vector>
+
+namespace
+{
+    constexpr const char* DIRECTORY = "cache/bench_leaderboard";
+    constexpr std::size_t MAPS = 50;
+    constexpr std::size_t BATCH = 100000;
+    constexpr int QUERIES = 1000;
+
+    using Clock = std::chrono::steady_clock;
+
+    double msSince(Clock::time_point start)
+    {
+        return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    }
+}
+
+int main(int argc, char** argv)
+{
+    std::size_t runCount = argc > 1 ? static_cast<std::size_t>(std::strtoull(argv[1], nullptr, 10)) : 1000000;
+
+    std::error_code error;
+    std::filesystem::remove_all(DIRECTORY, error);
+
+    Leaderboard leaderboard(DIRECTORY);
+    leaderboard.open();
+
+    std::mt19937 rng(7);
+    std::uniform_int_distribution<std::uint32_t> time(20000, 180000);
+    std::uniform_int_distribution<std::uint32_t> deaths(0, 30);
+    std::vector<RunRecord> runs;
+    auto start = Clock::now();
+    for (std::size_t written = 0; written < runCount; written += runs.size())
+    {
+        runs.clear();
+        for (std::size_t i = 0; i < BATCH && written + i < runCount; ++i)
+        {
+            RunRecord run;
+            run.mapHash = (written + i) % MAPS + 1;
+            run.timeMs = time(rng);
+            run.deaths = deaths(rng);
+            run.finishedAt = static_cast<std::int64_t>(written + i);
+            runs.push_back(run);
+        }
+        leaderboard.addRuns(runs);
+    }
+    double writeMs = msSince(start);
+
+    std::uint64_t logBytes = std::filesystem::file_size(std::string(DIRECTORY) + "/runs.log", error);
+    std::uint64_t indexBytes = std::filesystem::file_size(std::string(DIRECTORY) + "/index.bin", error);
+    std::printf("Leaderboard benchmark: %zu runs on %zu maps, log %.1f MB, index %.1f KB\n",
+                runCount, MAPS, logBytes / 1048576.0, indexBytes / 1024.0);
+    std::printf("%-28s %12.2f ms\n", "append in batches", writeMs);
+
+    start = Clock::now();
+    Leaderboard indexed(DIRECTORY);
+    indexed.open();
+    std::printf("%-28s %12.2f ms\n", "open with index", msSince(start));
+
+    std::filesystem::remove(std::string(DIRECTORY) + "/index.bin", error);
+    start = Clock::now();
+    Leaderboard rebuilt(DIRECTORY);
+    rebuilt.open();
+    std::printf("%-28s %12.2f ms\n", "open, rebuilding index", msSince(start));
+
+    std::vector<RunRecord> results;
+    RunRecord best;
+    start = Clock::now();
+    for (int i = 0; i < QUERIES; ++i)
+    {
+        rebuilt.getTop(i % MAPS + 1, 10, results);
+        rebuilt.getPersonalBest(i % MAPS + 1, best);
+    }
+    std::printf("%-28s %12.2f us\n", "top 10 + personal best", msSince(start) * 1000.0 / QUERIES);
+
+    start = Clock::now();
+    for (int i = 0; i < QUERIES; ++i)
+    {
+        rebuilt.getRecent(i % MAPS + 1, 20, results);
+    }
+    std::printf("%-28s %12.2f us\n", "last 20 runs of a map", msSince(start) * 1000.0 / QUERIES);
+
+    RunRecord run;
+    run.mapHash = 1;
+    run.timeMs = 1;
+    start = Clock::now();
+    std::size_t rank = rebuilt.add(run);
+    std::printf("%-28s %12.2f ms (rank %zu)\n", "one synced run", msSince(start), rank);
+
+    std::filesystem::remove_all(DIRECTORY, error);
+    return 0;
+}
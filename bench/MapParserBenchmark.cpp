@@ -0,0 +1,149 @@
+// Map text parsing: the old getline/istringstream loop against MapParser on
+// one thread and on every hardware thread. Pass a map file to time it, or
+// run without arguments to parse a synthetic one-million-object map.
+#include "core/MapParser.hpp"
+#include "core/MappedFile.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+
+namespace
+{
+    constexpr int REPEATS = 5;
+    constexpr std::size_t SYNTHETIC_OBJECTS = 1000000;
+
+    using Clock = std::chrono::steady_clock;
+
+    std::string buildSyntheticMap()
+    {
+        std::mt19937 rng(42);
+        std::uniform_real_distribution<float> coordinate(0.0f, 20000.0f);
+        std::uniform_int_distribution<int> kind(0, 9);
+
+        std::string text = "forest\nground 0 500 640 32\n";
+        char line[128];
+        for (std::size_t i = 0; i < SYNTHETIC_OBJECTS; ++i)
+        {
+            float x = coordinate(rng);
+            float y = coordinate(rng) / 10.0f;
+            int length = 0;
+            switch (kind(rng))
+            {
+                case 0: length = std::snprintf(line, sizeof(line), "obstacle %.2f %.2f\n", x, y); break;
+                case 1: length = std::snprintf(line, sizeof(line), "checkpoint %.2f %.2f\n", x, y); break;
+                case 2: length = std::snprintf(line, sizeof(line), "mover %.2f %.2f %.2f %.2f 60\n", x, y, x + 100, y); break;
+                case 3:
+                case 4:
+                case 5: length = std::snprintf(line, sizeof(line), "pickup %.2f %.2f\n", x, y); break;
+                default: length = std::snprintf(line, sizeof(line), "platform %.2f %.2f\n", x, y); break;
+            }
+            text.append(line, static_cast<std::size_t>(length));
+        }
+        text += "win 100 100\n";
+        return text;
+    }
+
+    // The loop loadMap used before MapParser, minus object creation
+    std::size_t parseWithStreams(const std::string& text)
+    {
+        std::istringstream file(text);
+        std::string line;
+        std::getline(file, line);
+
+        std::size_t objects = 0;
+        float sink = 0;
+        while (std::getline(file, line))
+        {
+            std::istringstream iss(line);
+            std::string type;
+            iss >> type;
+
+            float values[5] = {};
+            if (type == "ground" || type == "crumble")
+            {
+                iss >> values[0] >> values[1] >> values[2] >> values[3];
+            }
+            else if (type == "mover" || type == "oscillator")
+            {
+                iss >> values[0] >> values[1] >> values[2] >> values[3] >> values[4];
+            }
+            else if (type == "platform" || type == "obstacle" || type == "pickup" || type == "checkpoint" || type == "win")
+            {
+                iss >> values[0] >> values[1];
+            }
+            else
+            {
+                continue;
+            }
+            sink += values[0];
+            ++objects;
+        }
+        return sink < 0 ? 0 : objects;
+    }
+
+    template <typename Func>
+    double bestMilliseconds(Func&& func)
+    {
+        double best = 1e30;
+        for (int i = 0; i < REPEATS; ++i)
+        {
+            auto start = Clock::now();
+            func();
+            auto end = Clock::now();
+            double ms = std::chrono::duration<double, std::milli>(end - start).count();
+            if (ms < best)
+                best = ms;
+        }
+        return best;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    std::string text;
+    MappedFile file;
+    if (argc > 1)
+    {
+        if (!file.open(argv[1]))
+        {
+            std::fprintf(stderr, "Could not open %s\n", argv[1]);
+            return 1;
+        }
+        text.assign(file.getData(), file.getSize());
+    }
+    else
+    {
+        text = buildSyntheticMap();
+    }
+
+    std::size_t streamObjects = 0;
+    double streamMs = bestMilliseconds([&] { streamObjects = parseWithStreams(text); });
+
+    MapData data;
+    MapParser parser;
+    parser.setThreadCount(1);
+    double singleMs = bestMilliseconds([&] { parser.parse(text, data); });
+    std::size_t parserObjects = data.objects.size();
+
+    unsigned threads = std::max(1u, std::thread::hardware_concurrency());
+    parser.setThreadCount(threads);
+    double parallelMs = bestMilliseconds([&] { parser.parse(text, data); });
+
+    std::printf("Map parser benchmark: %.1f MB, best of %d\n", text.size() / (1024.0 * 1024.0), REPEATS);
+    std::printf("%-22s %10s %10s %9s\n", "parser", "objects", "ms", "speedup");
+    std::printf("%-22s %10zu %10.1f %8.1fx\n", "istringstream", streamObjects, streamMs, 1.0);
+    std::printf("%-22s %10zu %10.1f %8.1fx\n", "MapParser 1 thread", parserObjects, singleMs, streamMs / singleMs);
+    std::printf("%-19s %2u %10zu %10.1f %8.1fx\n", "MapParser threads", threads, data.objects.size(), parallelMs, streamMs / parallelMs);
+
+    if (!parser.getErrors().empty())
+    {
+        const MapError& error = parser.getErrors().front();
+        std::printf("first error at %zu:%zu: %s\n", error.line, error.column, error.message.c_str());
+    }
+
+    return 0;
+}
@@ -0,0 +1,156 @@
+// Per-tick cost of kinematic platforms. Compares the incremental broadphase
+// update in Physics::updateKinematics against rebuilding the grid from
+// scratch every tick, and broadphase collision queries against a linear scan.
+#include "core/Physics.hpp"
+#include "core/Broadphase.hpp"
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+namespace
+{
+    constexpr int TICKS = 600;
+    constexpr int PROBES = 64;
+    constexpr int STATIC_PLATFORMS = 2000;
+    constexpr float TICK = 1.0f / 60.0f;
+    constexpr float WORLD_WIDTH = 40000.0f;
+    constexpr float WORLD_HEIGHT = 4000.0f;
+
+    using Clock = std::chrono::steady_clock;
+
+    double elapsedNs(Clock::time_point start, Clock::time_point end)
+    {
+        return static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count());
+    }
+
+    void buildLevel(Physics& physics, const sf::Texture& texture, int movingCount, std::mt19937& rng)
+    {
+        std::uniform_real_distribution<float> x(0.0f, WORLD_WIDTH);
+        std::uniform_real_distribution<float> y(0.0f, WORLD_HEIGHT);
+        std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+
+        for (int i = 0; i < STATIC_PLATFORMS; ++i)
+        {
+            auto platform = std::make_shared<Platform>(texture, PlatformType::Floating);
+            platform->setPosition({x(rng), y(rng)});
+            platform->setSize(64, 18);
+            physics.addPlatform(platform);
+        }
+
+        // A mix of the three kinematic kinds, roughly as a level would use them
+        for (int i = 0; i < movingCount; ++i)
+        {
+            auto platform = std::make_shared<Platform>(texture, PlatformType::Floating);
+            platform->setPosition({x(rng), y(rng)});
+            platform->setSize(64, 18);
+
+            switch (i % 3)
+            {
+                case 0:
+                    platform->setLinearPath({platform->getPosition() + sf::Vector2f(200 + unit(rng) * 400, 0)}, 60 + unit(rng) * 60);
+                    break;
+                case 1:
+                    platform->setOscillation({0, 50 + unit(rng) * 100}, 2 + unit(rng) * 3, unit(rng) * 6.28f);
+                    break;
+                default:
+                    platform->setCrumbling(0.5f, 2.0f);
+                    platform->touch();
+                    break;
+            }
+            physics.addPlatform(platform);
+        }
+    }
+
+    void run(int movingCount)
+    {
+        sf::Texture texture;
+        std::mt19937 rng(1234);
+
+        Physics physics;
+        buildLevel(physics, texture, movingCount, rng);
+        const auto& platforms = physics.getPlatforms();
+
+        std::uniform_real_distribution<float> x(0.0f, WORLD_WIDTH);
+        std::uniform_real_distribution<float> y(0.0f, WORLD_HEIGHT);
+        std::vector<sf::FloatRect> probes;
+        for (int i = 0; i < PROBES; ++i)
+        {
+            probes.push_back(sf::FloatRect({x(rng), y(rng)}, {20, 37}));
+        }
+
+        double updateNs = 0;
+        double rebuildNs = 0;
+        double queryNs = 0;
+        double scanNs = 0;
+        std::size_t hits = 0;
+
+        Broadphase rebuilt(Physics::BROADPHASE_CELL_SIZE);
+        std::vector<Platform*> found;
+
+        for (int tick = 0; tick < TICKS; ++tick)
+        {
+            auto start = Clock::now();
+            physics.updateKinematics(sf::seconds(TICK));
+            auto end = Clock::now();
+            updateNs += elapsedNs(start, end);
+
+            // What the same tick costs if the grid is thrown away and refilled
+            start = Clock::now();
+            rebuilt.clear();
+            for (std::size_t i = 0; i < platforms.size(); ++i)
+            {
+                rebuilt.insert(platforms[i]->getBounds(), static_cast<std::uint32_t>(i));
+            }
+            end = Clock::now();
+            rebuildNs += elapsedNs(start, end);
+
+            start = Clock::now();
+            for (const auto& probe : probes)
+            {
+                found.clear();
+                physics.queryPlatforms(probe, found);
+                hits += found.size();
+            }
+            end = Clock::now();
+            queryNs += elapsedNs(start, end);
+
+            start = Clock::now();
+            for (const auto& probe : probes)
+            {
+                for (const auto& platform : platforms)
+                {
+                    if (platform->isSolid() && probe.findIntersection(platform->getBounds()))
+                        ++hits;
+                }
+            }
+            end = Clock::now();
+            scanNs += elapsedNs(start, end);
+        }
+
+        std::printf("%9zu %8d %15.1f %15.1f %12.1f %12.1f\n",
+                    platforms.size(), movingCount,
+                    updateNs / TICKS / 1000.0, rebuildNs / TICKS / 1000.0,
+                    queryNs / (static_cast<double>(TICKS) * PROBES),
+                    scanNs / (static_cast<double>(TICKS) * PROBES));
+
+        // Keep the scans from being optimised away
+        if (hits == static_cast<std::size_t>(-1))
+            std::printf("%zu\n", hits);
+    }
+}
+
+int main()
+{
+    std::printf("Moving platform benchmark: %d ticks at 60 Hz, %d static platforms, %d probes per tick\n",
+                TICKS, STATIC_PLATFORMS, PROBES);
+    std::printf("%9s %8s %15s %15s %12s %12s\n", "platforms", "moving", "update us/tick", "rebuild us/tick", "query ns", "scan ns");
+
+    const int movingCounts[] = {0, 1000, 5000, 20000, 50000};
+    for (int moving : movingCounts)
+    {
+        run(moving);
+    }
+
+    return 0;
+}
@@ -0,0 +1,170 @@
+// Per-frame cost of 100k live particles: ParticleSystem's pooled arrays
+// against a vector of particle structs compacted with erase/remove, and how
+// much of a 144 FPS frame each takes.
+#include "core/ParticleSystem.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <utility>
+#include <vector>
+
+namespace
+{
+    constexpr int FRAMES = 600;
+    constexpr float FRAME_TIME = 1.0f / 144.0f;
+    constexpr float LIFE = 1.0f;
+
+    using Clock = std::chrono::steady_clock;
+
+    // The straightforward version: one struct per particle
+    struct Particle
+    {
+        sf::Vector2f position;
+        sf::Vector2f velocity;
+        float gravity;
+        float drag;
+        float age;
+        float life;
+        sf::Color colorStart;
+        sf::Color colorEnd;
+        float sizeStart;
+        float sizeEnd;
+    };
+
+    ParticleEffect makeEffect()
+    {
+        ParticleEffect effect;
+        effect.count = 1;
+        effect.lifeMin = LIFE * 0.5f;
+        effect.lifeMax = LIFE * 1.5f;
+        effect.gravity = 600;
+        effect.drag = 1;
+        effect.colorStart = sf::Color(255, 215, 0);
+        effect.colorEnd = sf::Color(255, 255, 150, 0);
+        return effect;
+    }
+
+    struct FrameCost
+    {
+        double update = 0;
+        double vertices = 0;
+    };
+
+    double msBetween(Clock::time_point start, Clock::time_point end)
+    {
+        return std::chrono::duration<double, std::milli>(end - start).count();
+    }
+
+    FrameCost runPooled(std::size_t live)
+    {
+        ParticleSystem particles(live * 2);
+        std::size_t effect = particles.addEffect(makeEffect());
+
+        // Emit at the rate particles die, so the count holds at about live
+        double perFrame = static_cast<double>(live) * FRAME_TIME / LIFE;
+        double owed = 0;
+        particles.emit(effect, {0, 0}, live);
+
+        FrameCost cost;
+        for (int frame = 0; frame < FRAMES; ++frame)
+        {
+            owed += perFrame;
+            auto start = Clock::now();
+            particles.emit(effect, {static_cast<float>(frame), 0}, static_cast<std::size_t>(owed));
+            particles.update(FRAME_TIME);
+            auto updated = Clock::now();
+            particles.buildVertices();
+            cost.update += msBetween(start, updated) / FRAMES;
+            cost.vertices += msBetween(updated, Clock::now()) / FRAMES;
+            owed -= std::floor(owed);
+        }
+        return cost;
+    }
+
+    FrameCost runNaive(std::size_t live)
+    {
+        ParticleEffect effect = makeEffect();
+        std::vector<Particle> particles;
+        std::vector<sf::Vertex> vertices;
+        std::minstd_rand random;
+
+        auto emit = [&](std::size_t count, float x)
+        {
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                float angle = std::uniform_real_distribution<float>(0, 6.2831853f)(random);
+                float speed = std::uniform_real_distribution<float>(effect.speedMin, effect.speedMax)(random);
+                float life = std::uniform_real_distribution<float>(effect.lifeMin, effect.lifeMax)(random);
+                particles.push_back({{x, 0}, {std::cos(angle) * speed, std::sin(angle) * speed}, effect.gravity,
+                                     effect.drag, 0, life, effect.colorStart, effect.colorEnd, effect.sizeStart, effect.sizeEnd});
+            }
+        };
+
+        double perFrame = static_cast<double>(live) * FRAME_TIME / LIFE;
+        double owed = 0;
+        emit(live, 0);
+
+        FrameCost cost;
+        for (int frame = 0; frame < FRAMES; ++frame)
+        {
+            owed += perFrame;
+            auto start = Clock::now();
+            emit(static_cast<std::size_t>(owed), static_cast<float>(frame));
+
+            for (auto& p : particles)
+            {
+                float keep = std::max(0.0f, 1.0f - p.drag * FRAME_TIME);
+                p.velocity.x *= keep;
+                p.velocity.y = p.velocity.y * keep + p.gravity * FRAME_TIME;
+                p.position += p.velocity * FRAME_TIME;
+                p.age += FRAME_TIME;
+            }
+            particles.erase(std::remove_if(particles.begin(), particles.end(),
+                                           [](const Particle& p) { return p.age >= p.life; }),
+                            particles.end());
+            auto updated = Clock::now();
+
+            vertices.clear();
+            for (const auto& p : particles)
+            {
+                float t = p.age / p.life;
+                float half = (p.sizeStart + (p.sizeEnd - p.sizeStart) * t) / 2.0f;
+                sf::Color color(p.colorStart.r, p.colorStart.g, p.colorStart.b,
+                                static_cast<std::uint8_t>(p.colorStart.a + (p.colorEnd.a - p.colorStart.a) * t));
+                sf::Vertex a{{p.position.x - half, p.position.y - half}, color};
+                sf::Vertex b{{p.position.x + half, p.position.y - half}, color};
+                sf::Vertex c{{p.position.x + half, p.position.y + half}, color};
+                sf::Vertex d{{p.position.x - half, p.position.y + half}, color};
+                vertices.insert(vertices.end(), {a, b, c, a, c, d});
+            }
+            cost.update += msBetween(start, updated) / FRAMES;
+            cost.vertices += msBetween(updated, Clock::now()) / FRAMES;
+            owed -= std::floor(owed);
+        }
+        return cost;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    std::size_t live = argc > 1 ? static_cast<std::size_t>(std::strtoull(argv[1], nullptr, 10)) : 100000;
+    double budget = 1000.0 / 144.0;
+
+    std::printf("Particle benchmark: %zu live particles, %d frames at 144 FPS\n", live, FRAMES);
+    FrameCost naive = runNaive(live);
+    FrameCost pooled = runPooled(live);
+
+    // Filling vertices is mostly memory traffic, six 20 byte vertices per
+    // particle, so the storage layout shows in the update column
+    std::printf("%-10s %10s %10s %10s %14s\n", "storage", "update ms", "verts ms", "total ms", "frame budget");
+    for (const auto& [name, cost] : {std::make_pair("structs", naive), std::make_pair("pooled", pooled)})
+    {
+        double total = cost.update + cost.vertices;
+        std::printf("%-10s %10.3f %10.3f %10.3f %13.1f%%\n", name, cost.update, cost.vertices, total, total / budget * 100.0);
+    }
+    std::printf("update speedup %.1fx\n", naive.update / pooled.update);
+    return 0;
+}
@@ -0,0 +1,124 @@
+// Compares rope solver iteration counts against accuracy and cost per tick.
+// Accuracy is measured as rope stretch and as body drift from a reference run
+// solved with many more iterations, over a few seconds of free swinging.
+#include "game/Rope.hpp"
+#include "game/Player.hpp"
+#include "core/Physics.hpp"
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+namespace
+{
+    struct Result
+    {
+        double nanosecondsPerTick;
+        float meanStretch;
+        float maxStretch;
+        float rmsDrift;
+    };
+
+    constexpr int TICKS = 600;
+    constexpr int REPEATS = 50;
+    constexpr float TICK = 1.0f / 60.0f;
+
+    void simulate(int iterations, int segments, const Physics& physics,
+                  std::vector<sf::Vector2f>& trajectory, float& meanStretch, float& maxStretch)
+    {
+        Rope rope(segments, iterations);
+        rope.setMaxSpeed(Player::MAX_SWING_SPEED);
+
+        sf::Vector2f body(Hook::MAX_ROPE_LENGTH, 0);
+        sf::Vector2f velocity(0, 0);
+        rope.attach({0, 0}, body, velocity, Hook::MAX_ROPE_LENGTH);
+
+        trajectory.clear();
+        meanStretch = 0;
+        maxStretch = 0;
+        for (int tick = 0; tick < TICKS; ++tick)
+        {
+            // Pump the swing the way a player would, alternating every second
+            float swing = ((tick / 60) % 2 == 0) ? 1.0f : -1.0f;
+            rope.update(sf::seconds(TICK), body, velocity, swing * Player::SWING_ACCELERATION, physics);
+
+            float stretch = std::abs(rope.getStretch());
+            meanStretch += stretch;
+            if (stretch > maxStretch)
+                maxStretch = stretch;
+            trajectory.push_back(body);
+        }
+        meanStretch /= TICKS;
+    }
+
+    Result run(int iterations, int segments, const Physics& physics,
+               const std::vector<sf::Vector2f>& reference)
+    {
+        Result result{};
+        std::vector<sf::Vector2f> trajectory;
+        trajectory.reserve(TICKS);
+
+        auto start = std::chrono::steady_clock::now();
+        for (int repeat = 0; repeat < REPEATS; ++repeat)
+        {
+            simulate(iterations, segments, physics, trajectory, result.meanStretch, result.maxStretch);
+        }
+        auto end = std::chrono::steady_clock::now();
+
+        double totalNs = static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count());
+        result.nanosecondsPerTick = totalNs / (static_cast<double>(REPEATS) * TICKS);
+
+        double drift = 0;
+        for (int i = 0; i < TICKS; ++i)
+        {
+            sf::Vector2f d = trajectory[i] - reference[i];
+            drift += d.x * d.x + d.y * d.y;
+        }
+        result.rmsDrift = static_cast<float>(std::sqrt(drift / TICKS));
+        return result;
+    }
+
+    void runScenario(const char* name, const Physics& physics)
+    {
+        const int segmentCounts[] = {4, 8, 16};
+        const int iterationCounts[] = {1, 2, 4, 8, 16, 32};
+
+        std::printf("\n%s\n", name);
+        std::printf("%8s %10s %12s %12s %12s %12s\n", "segments", "iterations", "ns/tick", "mean stretch", "max stretch", "rms drift");
+
+        for (int segments : segmentCounts)
+        {
+            std::vector<sf::Vector2f> reference;
+            float unusedMean = 0;
+            float unusedMax = 0;
+            simulate(64, segments, physics, reference, unusedMean, unusedMax);
+
+            for (int iterations : iterationCounts)
+            {
+                Result r = run(iterations, segments, physics, reference);
+                std::printf("%8d %10d %12.1f %11.4f%% %11.4f%% %11.3fpx\n", segments, iterations,
+                            r.nanosecondsPerTick, r.meanStretch * 100.0f, r.maxStretch * 100.0f, r.rmsDrift);
+            }
+        }
+    }
+}
+
+int main()
+{
+    std::printf("Rope solver benchmark: %d ticks at 60 Hz, sub-step %.5f s, %d repeats\n",
+                TICKS, Physics::FIXED_TIMESTEP, REPEATS);
+
+    Physics empty;
+    runScenario("Free swing", empty);
+
+    // A block under the anchor that the rope wraps around on every swing
+    sf::Texture texture;
+    Physics physics;
+    auto block = std::make_shared<Platform>(texture, PlatformType::Floating);
+    block->setPosition({-60, 120});
+    block->setSize(120, 64);
+    physics.addPlatform(block);
+    runScenario("Swing with corner wrapping", physics);
+
+    return 0;
+}
@@ -0,0 +1,105 @@
+// What one telemetry event costs the thread recording it, alone and with
+// other threads recording at once, against writing each line to a file and
+// flushing it as std::cerr << std::endl does. Events come in bursts of a
+// frame's worth so the writer keeps up and nothing is dropped.
+#include "core/Telemetry.hpp"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    constexpr int BURSTS = 200;
+    constexpr int BURST_SIZE = 500;
+    constexpr std::chrono::milliseconds BURST_GAP(8);
+    const char* PATH = "telemetry_bench.jsonl";
+
+    using Clock = std::chrono::steady_clock;
+
+    double nsBetween(Clock::time_point start, Clock::time_point end)
+    {
+        return std::chrono::duration<double, std::nano>(end - start).count();
+    }
+
+    // Mean ns per event on this thread, over every burst
+    double recordBursts(Telemetry& telemetry, int thread)
+    {
+        double total = 0;
+        for (int burst = 0; burst < BURSTS; ++burst)
+        {
+            auto start = Clock::now();
+            for (int i = 0; i < BURST_SIZE; ++i)
+            {
+                telemetry.record(TelemetryType::Pickup, {static_cast<float>(i), static_cast<float>(thread)});
+            }
+            total += nsBetween(start, Clock::now());
+            std::this_thread::sleep_for(BURST_GAP);
+        }
+        return total / (BURSTS * BURST_SIZE);
+    }
+
+    double runTelemetry(int threads, std::uint64_t& dropped)
+    {
+        Telemetry telemetry;
+        telemetry.open(PATH);
+
+        std::vector<double> costs(threads);
+        std::vector<std::thread> producers;
+        for (int t = 0; t < threads; ++t)
+        {
+            producers.emplace_back([&, t] { costs[t] = recordBursts(telemetry, t); });
+        }
+        for (auto& producer : producers)
+        {
+            producer.join();
+        }
+        telemetry.close();
+        dropped = telemetry.getDropped();
+
+        double mean = 0;
+        for (double cost : costs)
+        {
+            mean += cost / threads;
+        }
+        return mean;
+    }
+
+    double runFlushed()
+    {
+        std::ofstream file(PATH, std::ios::trunc);
+        double total = 0;
+        for (int burst = 0; burst < BURSTS / 10; ++burst)
+        {
+            auto start = Clock::now();
+            for (int i = 0; i < BURST_SIZE; ++i)
+            {
+                file << "{\"event\":\"pickup\",\"x\":" << i << ".0,\"y\":0.0}" << std::endl;
+            }
+            total += nsBetween(start, Clock::now());
+        }
+        return total / (BURSTS / 10 * BURST_SIZE);
+    }
+}
+
+int main(int argc, char** argv)
+{
+    int maxThreads = argc > 1 ? std::atoi(argv[1]) : 4;
+
+    std::printf("Telemetry benchmark: bursts of %d events every %lld ms\n", BURST_SIZE,
+                static_cast<long long>(BURST_GAP.count()));
+    std::printf("%-22s %12s %10s\n", "recording", "ns / event", "dropped");
+    std::printf("%-22s %12.1f %10s\n", "flushed line", runFlushed(), "-");
+    for (int threads = 1; threads <= maxThreads; threads *= 2)
+    {
+        std::uint64_t dropped = 0;
+        double cost = runTelemetry(threads, dropped);
+        char name[32];
+        std::snprintf(name, sizeof(name), "ring, %d thread%s", threads, threads == 1 ? "" : "s");
+        std::printf("%-22s %12.1f %10llu\n", name, cost, static_cast<unsigned long long>(dropped));
+    }
+    std::remove(PATH);
+    return 0;
+}
@@ -0,0 +1,71 @@
+// Cold start texture loading: decoding every PNG in assets/ against
+// uploading the pre-decoded pixels from the texture cache.
+#include "core/AssetLoader.hpp"
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+namespace
+{
+    constexpr int REPEATS = 20;
+    constexpr const char* CACHE_DIRECTORY = "cache/bench_textures";
+
+    using Clock = std::chrono::steady_clock;
+
+    double loadAll(AssetLoader& assets, const std::vector<std::string>& names)
+    {
+        double best = 1e30;
+        for (int i = 0; i < REPEATS; ++i)
+        {
+            auto start = Clock::now();
+            for (const auto& name : names)
+            {
+                sf::Texture texture;
+                if (!assets.loadTexture(texture, name))
+                    std::fprintf(stderr, "Could not load %s\n", name.c_str());
+            }
+            double ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+            if (ms < best)
+                best = ms;
+        }
+        return best;
+    }
+}
+
+int main()
+{
+    AssetLoader assets;
+    assets.open();
+
+    std::vector<std::string> names;
+    std::error_code error;
+    for (const auto& entry : std::filesystem::directory_iterator(assets.getDirectory(), error))
+    {
+        if (entry.path().extension() == ".png")
+            names.push_back(entry.path().filename().string());
+    }
+
+    if (names.empty())
+    {
+        std::fprintf(stderr, "No textures found in %s/\n", assets.getDirectory().c_str());
+        return 1;
+    }
+
+    assets.getTextureCache().setDirectory("");
+    double decodeMs = loadAll(assets, names);
+
+    // The first pass fills the cache, the timed ones read it
+    assets.getTextureCache().setDirectory(CACHE_DIRECTORY);
+    loadAll(assets, names);
+    double cachedMs = loadAll(assets, names);
+
+    std::printf("Texture cache benchmark: %zu textures, best of %d\n", names.size(), REPEATS);
+    std::printf("%-12s %10s %9s\n", "source", "ms", "speedup");
+    std::printf("%-12s %10.2f %8.1fx\n", "png decode", decodeMs, 1.0);
+    std::printf("%-12s %10.2f %8.1fx\n", "cache", cachedMs, decodeMs / cachedMs);
+
+    std::filesystem::remove_all(CACHE_DIRECTORY, error);
+    return 0;
+}
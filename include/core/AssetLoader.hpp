@@ -0,0 +1,63 @@
+#pragma once
+#include <SFML/Graphics.hpp>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "core/AssetPack.hpp"
+#include "core/MapParser.hpp"
+#include "core/MappedFile.hpp"
+#include "core/TextureCache.hpp"
+
+// Bytes of one asset. From the pack this is a view into the pack mapping;
+// a loose file is mapped for as long as this object lives.
+class AssetData
+{
+public:
+    std::string_view getView() const { return view; }
+
+private:
+    friend class AssetLoader;
+
+    MappedFile file;
+    std::string_view view;
+};
+
+// Where the game reads its data from: assets.pak when one ships next to the
+// executable, otherwise the loose files in assets/. Names are relative to
+// the asset directory, e.g. "hero.png" or "maps/map1.txt".
+class AssetLoader
+{
+public:
+    static constexpr const char* PACK_FILE = "assets.pak";
+    static constexpr const char* ASSET_DIRECTORY = "assets";
+
+    AssetLoader();
+
+    // Falls back to the directory if the pack is missing or unreadable
+    void open(const std::string& packPath = PACK_FILE, const std::string& directory = ASSET_DIRECTORY);
+
+    bool isPacked() const { return pack.isOpen(); }
+    const std::string& getDirectory() const { return directory; }
+
+    bool read(const std::string& name, AssetData& data) const;
+    // Parses maps/<mapFile> and hashes its bytes with contentHash, the key
+    // ghosts, scores and races know the level by. Bad lines are reported and
+    // skipped; false if the file is missing or had any.
+    bool readMap(const std::string& mapFile, MapData& map, std::uint64_t& hash) const;
+    // Names of the files directly in a directory such as "maps", sorted
+    std::vector<std::string> list(const std::string& directoryName) const;
+
+    // Uploads straight from the texture cache when it has this exact source,
+    // otherwise decodes the PNG and refreshes the cache entry
+    bool loadTexture(sf::Texture& texture, const std::string& name) const;
+    // Fonts read from the pack keep pointing into it, so the loader has to
+    // outlive them
+    bool loadFont(sf::Font& font, const std::string& name) const;
+
+    TextureCache& getTextureCache() { return textureCache; }
+
+private:
+    AssetPack pack;
+    std::string directory;
+    TextureCache textureCache;
+};
@@ -0,0 +1,35 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include "core/MappedFile.hpp"
+
+// Read side of assets.pak, every asset in one memory-mapped file. Layout,
+// integers little endian:
+//   header   "HLPK", u32 version, u32 entry count
+//   entries  u64 offset, u64 size, u32 name length, name bytes
+//   data     each asset at its offset from the start, ALIGNMENT aligned
+// Names are paths relative to the asset directory with '/' separators.
+class AssetPack
+{
+public:
+    static constexpr char MAGIC[4] = {'H', 'L', 'P', 'K'};
+    static constexpr std::uint32_t VERSION = 1;
+    static constexpr std::size_t ALIGNMENT = 16;
+
+    bool open(const std::string& path);
+    void close();
+    bool isOpen() const { return file.isOpen(); }
+
+    // The view points into the mapping and stays valid while the pack is open
+    bool find(const std::string& name, std::string_view& data) const;
+    // Appends the names of entries starting with prefix, e.g. "maps/"
+    void list(const std::string& prefix, std::vector<std::string>& names) const;
+    std::size_t getEntryCount() const { return entries.size(); }
+
+private:
+    MappedFile file;
+    std::unordered_map<std::string, std::string_view> entries;
+};
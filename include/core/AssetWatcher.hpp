@@ -0,0 +1,39 @@
+#pragma once
+#include <chrono>
+#include <filesystem>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Reports files that finished being written in a set of directories (not
+// recursive). Linux uses inotify; other platforms rescan the directories for
+// newer write times every POLL_INTERVAL.
+class AssetWatcher
+{
+public:
+    static constexpr std::chrono::milliseconds POLL_INTERVAL{500};
+
+    AssetWatcher();
+    ~AssetWatcher();
+
+    AssetWatcher(const AssetWatcher&) = delete;
+    AssetWatcher& operator=(const AssetWatcher&) = delete;
+
+    bool watch(const std::string& directory);
+
+    // Never blocks. Appends "directory/name" for every file changed since the
+    // last call, each path once.
+    void poll(std::vector<std::string>& changed);
+
+private:
+#ifdef __linux__
+    int descriptor;
+    std::unordered_map<int, std::string> directories;
+#else
+    std::vector<std::string> directories;
+    std::unordered_map<std::string, std::filesystem::file_time_type> writeTimes;
+    std::chrono::steady_clock::time_point lastScan;
+
+    void scan(const std::string& directory, std::vector<std::string>* changed);
+#endif
+};
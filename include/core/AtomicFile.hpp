@@ -0,0 +1,10 @@
+#pragma once
+#include <initializer_list>
+#include <string>
+#include <string_view>
+
+// Writes the parts one after another to a file beside path and renames it
+// over path, so a crash never leaves half a file that a later run would
+// trust. Missing parent directories are created. False if anything failed,
+// with the old file, if any, left in place and nothing left beside it.
+bool writeFileAtomic(const std::string& path, std::initializer_list<std::string_view> parts);
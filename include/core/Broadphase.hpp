@@ -0,0 +1,63 @@
+#pragma once
+#include <SFML/Graphics.hpp>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+// Uniform grid of boxes. Moving a box only touches the cells it leaves and
+// enters, so kinematic objects can be updated every tick without a rebuild.
+// Queries use per-proxy marks and are not safe to run concurrently on one
+// instance.
+class Broadphase
+{
+public:
+    explicit Broadphase(float cellSize = 128.0f);
+
+    int insert(const sf::FloatRect& bounds, std::uint32_t userData);
+    void update(int proxy, const sf::FloatRect& bounds);
+    void remove(int proxy);
+    void clear();
+
+    void setUserData(int proxy, std::uint32_t userData);
+    std::uint32_t getUserData(int proxy) const;
+    const sf::FloatRect& getBounds(int proxy) const;
+    std::size_t getProxyCount() const;
+
+    // Appends the user data of every box overlapping area, once each
+    void query(const sf::FloatRect& area, std::vector<std::uint32_t>& result) const;
+
+private:
+    struct CellRange
+    {
+        int minX;
+        int minY;
+        int maxX;
+        int maxY;
+
+        bool operator==(const CellRange& other) const
+        {
+            return minX == other.minX && minY == other.minY && maxX == other.maxX && maxY == other.maxY;
+        }
+    };
+
+    struct Proxy
+    {
+        sf::FloatRect bounds;
+        CellRange cells;
+        std::uint32_t userData;
+        bool active;
+    };
+
+    float cellSize;
+    std::vector<Proxy> proxies;
+    std::vector<int> freeProxies;
+    std::unordered_map<std::uint64_t, std::vector<int>> cells;
+
+    mutable std::vector<std::uint32_t> queryMarks;
+    mutable std::uint32_t queryStamp;
+
+    CellRange computeRange(const sf::FloatRect& bounds) const;
+    static std::uint64_t cellKey(int x, int y);
+    void addToCells(int proxy, const CellRange& range);
+    void removeFromCells(int proxy, const CellRange& range);
+};
@@ -0,0 +1,73 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Little endian writer for packets and files. Small numbers are written as
+// varints and signed ones zigzag encoded first, so deltas near zero cost one
+// byte. Floats are written as their raw bits, so they read back exactly.
+class ByteWriter
+{
+public:
+    void clear() { bytes.clear(); }
+
+    void writeU8(std::uint8_t value);
+    void writeU16(std::uint16_t value);
+    void writeU32(std::uint32_t value);
+    void writeU64(std::uint64_t value);
+    void writeVarint(std::uint32_t value);
+    void writeSignedVarint(std::int32_t value);
+    void writeF32(float value);
+    void writeString(const std::string& value);
+
+    const std::uint8_t* getData() const { return bytes.data(); }
+    std::size_t getSize() const { return bytes.size(); }
+    std::string_view getView() const { return {reinterpret_cast<const char*>(bytes.data()), bytes.size()}; }
+
+private:
+    std::vector<std::uint8_t> bytes;
+};
+
+// Deltas of signed fields are taken and applied modulo 2^32, so a field read
+// from a damaged file or a hostile packet wraps instead of overflowing. The
+// round trip is exact either way.
+inline std::int32_t deltaBetween(std::int32_t value, std::int32_t base)
+{
+    return static_cast<std::int32_t>(static_cast<std::uint32_t>(value) - static_cast<std::uint32_t>(base));
+}
+
+inline std::int32_t addDelta(std::int32_t value, std::int32_t delta)
+{
+    return static_cast<std::int32_t>(static_cast<std::uint32_t>(value) + static_cast<std::uint32_t>(delta));
+}
+
+// Reads what ByteWriter wrote. Reading past the end returns zeros and marks
+// the reader as failed, so a packet is checked once at the end instead of
+// after every field.
+class ByteReader
+{
+public:
+    ByteReader(const std::uint8_t* data, std::size_t size);
+
+    std::uint8_t readU8();
+    std::uint16_t readU16();
+    std::uint32_t readU32();
+    std::uint64_t readU64();
+    std::uint32_t readVarint();
+    std::int32_t readSignedVarint();
+    float readF32();
+    std::string readString();
+
+    bool isValid() const { return !failed; }
+    bool atEnd() const { return position == size; }
+
+private:
+    const std::uint8_t* data;
+    std::size_t size;
+    std::size_t position;
+    bool failed;
+
+    bool has(std::size_t count);
+};
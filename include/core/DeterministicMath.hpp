@@ -0,0 +1,67 @@
+#pragma once
+#include <cmath>
+
+// sqrt, atan2 and sin for the simulation. std::sin and std::atan2 come from
+// the C library and their last bits differ between platforms, so these are
+// built from + - * / and comparisons only. Those are IEEE operations,
+// correctly rounded everywhere as long as the compiler does not fuse or
+// reorder them (see CMakeLists.txt).
+
+constexpr float detAbs(float x)
+{
+    return x < 0 ? -x : x;
+}
+
+inline int detRoundToInt(float x)
+{
+    return static_cast<int>(x < 0 ? x - 0.5f : x + 0.5f);
+}
+
+inline float detSqrt(float x)
+{
+    // IEEE requires sqrt to be correctly rounded, so std::sqrt is already exact
+    return x > 0 ? std::sqrt(x) : 0.0f;
+}
+
+// atan(z) for z in [0, 1], minimax polynomial, within 1e-5 radians
+inline float detAtanUnit(float z)
+{
+    float z2 = z * z;
+    return z * (0.9998660f + z2 * (-0.3302995f + z2 * (0.1801410f + z2 * (-0.0851330f + z2 * 0.0208351f))));
+}
+
+inline float detAtan2(float y, float x)
+{
+    const float pi = 3.14159265f;
+    const float halfPi = 1.57079633f;
+    float ax = detAbs(x);
+    float ay = detAbs(y);
+    if (ax == 0 && ay == 0)
+        return 0.0f;
+
+    // Keep the ratio in [0, 1] and fold the angle back into its octant
+    float angle = ay <= ax ? detAtanUnit(ay / ax) : halfPi - detAtanUnit(ax / ay);
+    if (x < 0)
+        angle = pi - angle;
+    return y < 0 ? -angle : angle;
+}
+
+inline float detSin(float x)
+{
+    const float pi = 3.14159265f;
+    const float halfPi = 1.57079633f;
+    const float twoPi = 6.28318531f;
+
+    // Into [-pi, pi], then mirrored into [-pi/2, pi/2]
+    int turns = detRoundToInt(x / twoPi);
+    float r = x - static_cast<float>(turns) * twoPi;
+    if (r > halfPi)
+        r = pi - r;
+    else if (r < -halfPi)
+        r = -pi - r;
+
+    // Taylor series to r^9, within 4e-6 on that range
+    float r2 = r * r;
+    return r * (1.0f +
+                r2 * (-1.0f / 6.0f + r2 * (1.0f / 120.0f + r2 * (-1.0f / 5040.0f + r2 * (1.0f / 362880.0f)))));
+}
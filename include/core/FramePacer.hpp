@@ -0,0 +1,29 @@
+#pragma once
+#include <chrono>
+
+// Holds the main loop to a target frame rate. Sleeping alone overshoots by
+// the scheduler's granularity, so it sleeps until shortly before the
+// deadline and spins the rest. Waiting at the top of the frame means input
+// is read after the wait, as close to the next tick as possible.
+class FramePacer
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+    FramePacer();
+
+    // 0 turns pacing off
+    void setTargetFps(float fps);
+    float getTargetFps() const { return targetFps; }
+
+    // Returns at the start of the next frame
+    void wait();
+
+private:
+    // Left to spin after sleeping, more than most schedulers oversleep by
+    static constexpr std::chrono::microseconds SPIN_MARGIN{1500};
+
+    float targetFps;
+    Clock::duration frameTime;
+    Clock::time_point deadline;
+};
@@ -0,0 +1,117 @@
+#pragma once
+#include <SFML/Graphics.hpp>
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include "core/ByteStream.hpp"
+#include "core/MappedFile.hpp"
+#include "core/Simulation.hpp"
+
+// One moment of a recorded run, enough to draw the player and its rope
+struct GhostFrame
+{
+    float time = 0;
+    sf::Vector2f position;
+    PlayerState state = PlayerState::Idle;
+    bool facingLeft = false;
+    // Top left of the animation frame in the character texture
+    sf::Vector2i frame;
+    bool hooked = false;
+    sf::Vector2f hookPoint;
+
+    static GhostFrame fromSnapshot(const RenderSnapshot& snapshot);
+};
+
+// Fields of a frame as stored: time in milliseconds, positions in 1/16 pixel
+static constexpr std::size_t GHOST_FIELD_COUNT = 10;
+using GhostFields = std::array<std::int32_t, GHOST_FIELD_COUNT>;
+
+// A ghost file is
+//   header  "HLGH", u8 version, u64 map hash, u32 frame count, u32 duration ms
+//   frames  a varint mask of the fields that differ from their prediction,
+//           then the zigzag varint error of each of those
+// Time and position are predicted to keep their last step, everything else
+// to stay the same, so a steady jump or swing costs about a byte a frame.
+static constexpr std::uint8_t GHOST_VERSION = 1;
+
+// Encodes a run while it is played
+class GhostRecorder
+{
+public:
+    static constexpr float RECORD_RATE = 60.0f;
+
+    GhostRecorder();
+
+    void clear();
+    // Keeps at most RECORD_RATE frames a second, whatever the frame rate
+    void record(const GhostFrame& frame);
+
+    bool save(const std::string& path, std::uint64_t mapHash) const;
+
+    std::uint32_t getFrameCount() const { return frameCount; }
+    float getDuration() const { return duration; }
+    std::size_t getEncodedSize() const { return frames.getSize(); }
+
+private:
+    ByteWriter frames;
+    std::uint32_t frameCount;
+    float duration;
+    float nextFrameTime;
+    GhostFields last;
+    GhostFields beforeLast;
+};
+
+// Streams a ghost file back. Frames are decoded as playback reaches them,
+// so sample() expects times that only move forward.
+class GhostPlayback
+{
+public:
+    GhostPlayback();
+
+    bool open(const std::string& path);
+
+    std::uint64_t getMapHash() const { return mapHash; }
+    float getDuration() const { return duration; }
+
+    // Where the ghost was at time, between the two recorded frames around it.
+    // False once the run has finished.
+    bool sample(float time, GhostFrame& frame);
+
+private:
+    MappedFile file;
+    ByteReader reader;
+    std::uint64_t mapHash;
+    std::uint32_t frameCount;
+    std::uint32_t decodedCount;
+    float duration;
+    GhostFields last;
+    GhostFields beforeLast;
+
+    bool decodeNext();
+};
+
+// Fastest runs per map, one file each in <directory>/<map name>/. Runs on an
+// older version of the map are skipped and deleted with the next save.
+class GhostLibrary
+{
+public:
+    static constexpr const char* DEFAULT_DIRECTORY = "ghosts";
+    static constexpr std::size_t MAX_GHOSTS = 50;
+
+    explicit GhostLibrary(const std::string& directory = DEFAULT_DIRECTORY);
+
+    // Fastest first
+    void load(const std::string& mapFile, std::uint64_t mapHash,
+              std::vector<std::unique_ptr<GhostPlayback>>& ghosts) const;
+    // Keeps the run if it is one of the MAX_GHOSTS fastest
+    bool save(const std::string& mapFile, std::uint64_t mapHash, const GhostRecorder& run) const;
+
+private:
+    std::string directory;
+
+    std::string mapDirectory(const std::string& mapFile) const;
+    void listRuns(const std::string& mapFile, std::uint64_t mapHash,
+                  std::vector<std::string>& current, std::vector<std::string>& stale) const;
+};
@@ -0,0 +1,26 @@
+#pragma once
+#include <SFML/Graphics.hpp>
+#include <cstddef>
+#include "core/Ghost.hpp"
+
+// Draws any number of ghosts in two draw calls: one textured quad per ghost
+// in a single vertex array, and every rope in one line list
+class GhostRenderer
+{
+public:
+    static constexpr std::uint8_t ALPHA = 90;
+
+    GhostRenderer();
+
+    void clear();
+    // frameSize is the player's animation frame, ropeOffset where the rope
+    // meets the body relative to the player position
+    void add(const GhostFrame& frame, const sf::Vector2i& frameSize, const sf::Vector2f& ropeOffset, sf::Color color);
+    void draw(sf::RenderTarget& target, const sf::Texture& characterTexture) const;
+
+    std::size_t getGhostCount() const { return sprites.getVertexCount() / 6; }
+
+private:
+    sf::VertexArray sprites;
+    sf::VertexArray ropes;
+};
@@ -0,0 +1,8 @@
+#pragma once
+#include <cstdint>
+#include <string_view>
+
+// FNV-1a over raw bytes. Identifies a file's content: the texture cache, the
+// map index, ghosts, the leaderboard and races all key on it, so it must stay
+// the same across versions.
+std::uint64_t contentHash(std::string_view data);
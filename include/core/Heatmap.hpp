@@ -0,0 +1,88 @@
+#pragma once
+#include <SFML/Graphics.hpp>
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+enum class HeatmapLayer : std::uint8_t
+{
+    // Where the player was when it died, before respawning
+    Deaths,
+    // Where the hook bit
+    Hooks,
+    // Where the player went, sampled every few ticks
+    Trajectory,
+    Count
+};
+
+// How often things happened where on one map, counted on a grid of square
+// cells over the level. Positions off the grid count in its edge cells, so
+// falls into pits still show under the gap. Heatmaps of the same map and
+// grid add up, so runs can be counted on separate threads and merged. Large
+// levels get coarser cells, so the grid fits in memory and in one texture.
+//
+// A heatmap file is
+//   header  "HLHM", u32 version, u64 map hash, f32 left, top and cell size,
+//           u32 columns and rows, u64 run count
+//   layers  per layer a u32 count of non-empty cells, then for each the
+//           number of cells skipped since the last one and its count, both
+//           varints, in row order
+class Heatmap
+{
+public:
+    static constexpr std::uint32_t VERSION = 1;
+    static constexpr float DEFAULT_CELL_SIZE = 16.0f;
+    static constexpr std::size_t LAYER_COUNT = static_cast<std::size_t>(HeatmapLayer::Count);
+    static constexpr const char* DIRECTORY = "heatmaps";
+    // Cells per layer, 16 MB of counts; larger files are taken for damaged
+    static constexpr std::uint32_t MAX_CELLS = 4 * 1024 * 1024;
+    // Columns or rows at most, a texture size every GPU the game runs on takes
+    static constexpr std::uint32_t MAX_SIDE = 4096;
+
+    Heatmap();
+    // The cell size is doubled until the grid fits MAX_CELLS and maxSide
+    Heatmap(std::uint64_t mapHash, const sf::FloatRect& area, float cellSize = DEFAULT_CELL_SIZE,
+            std::uint32_t maxSide = MAX_SIDE);
+
+    void add(HeatmapLayer layer, const sf::Vector2f& position);
+    void addRun() { ++runCount; }
+    void clear();
+
+    // False, changing nothing, if the other covers another map or grid
+    bool merge(const Heatmap& other);
+    // Adds up blocks of cells, doubling their size, until neither side is
+    // longer than maxSide, for textures smaller than the file's grid
+    void shrinkToFit(std::uint32_t maxSide);
+
+    bool save(const std::string& path) const;
+    bool load(const std::string& path);
+
+    // One pixel per cell in color, more opaque where more happened, so a
+    // sprite scaled by the cell size lays it over the level
+    void buildImage(HeatmapLayer layer, sf::Color color, sf::Image& image) const;
+
+    std::uint32_t getCount(HeatmapLayer layer, std::uint32_t column, std::uint32_t row) const;
+    std::uint32_t getMax(HeatmapLayer layer) const;
+    std::uint64_t getTotal(HeatmapLayer layer) const;
+
+    std::uint64_t getMapHash() const { return mapHash; }
+    sf::Vector2f getOrigin() const { return origin; }
+    float getCellSize() const { return cellSize; }
+    std::uint32_t getColumns() const { return columns; }
+    std::uint32_t getRows() const { return rows; }
+    std::uint64_t getRunCount() const { return runCount; }
+    bool isEmpty() const { return columns == 0 || rows == 0; }
+
+    // heatmaps/<map without .txt>.heatmap
+    static std::string pathFor(const std::string& mapFile);
+
+private:
+    std::uint64_t mapHash;
+    sf::Vector2f origin;
+    float cellSize;
+    std::uint32_t columns;
+    std::uint32_t rows;
+    std::uint64_t runCount;
+    std::array<std::vector<std::uint32_t>, LAYER_COUNT> layers;
+};
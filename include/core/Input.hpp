@@ -0,0 +1,77 @@
+#pragma once
+#include <SFML/Graphics.hpp>
+#include <array>
+#include <bitset>
+#include <cstdint>
+
+enum class Action : std::uint8_t
+{
+    MoveLeft,
+    MoveRight,
+    Jump,
+    Hook,
+    ReleaseHook,
+    Pause,
+    Count
+};
+
+// One simulation tick worth of input. Plain value so it can be passed into
+// the simulation, recorded, or built by hand for headless runs.
+struct InputState
+{
+    std::uint16_t held = 0;
+    std::uint16_t pressed = 0;
+    std::uint16_t released = 0;
+    sf::Vector2f aim;
+
+    static constexpr std::uint16_t bit(Action action) { return static_cast<std::uint16_t>(1u << static_cast<unsigned>(action)); }
+
+    bool isHeld(Action action) const { return (held & bit(action)) != 0; }
+    bool wasPressed(Action action) const { return (pressed & bit(action)) != 0; }
+    bool wasReleased(Action action) const { return (released & bit(action)) != 0; }
+
+    void setHeld(Action action, bool down);
+};
+
+// Builds InputState from the window's event queue, so the game never polls
+// the keyboard or mouse directly. Actions can be bound to any number of keys
+// and mouse buttons.
+class InputSystem
+{
+public:
+    InputSystem();
+
+    void bind(Action action, sf::Keyboard::Key key);
+    void bind(Action action, sf::Mouse::Button button);
+    void clearBindings(Action action);
+    void bindDefaults();
+
+    void handleEvent(const sf::Event& event);
+
+    // Latched state for this tick; presses and releases are reported once
+    // even if both happened between two samples
+    InputState sample(const sf::RenderTarget& target, const sf::View& view);
+
+    // Drops presses and releases latched since the last sample
+    void flush();
+
+    // Releases everything, e.g. when the window loses focus
+    void reset();
+
+private:
+    static constexpr std::size_t ACTION_COUNT = static_cast<std::size_t>(Action::Count);
+
+    std::array<std::uint16_t, sf::Keyboard::KeyCount> keyActions;
+    std::array<std::uint16_t, sf::Mouse::ButtonCount> buttonActions;
+    std::bitset<sf::Keyboard::KeyCount> keysDown;
+    std::bitset<sf::Mouse::ButtonCount> buttonsDown;
+    std::array<std::uint8_t, ACTION_COUNT> sourcesDown;
+
+    std::uint16_t held;
+    std::uint16_t pressedLatch;
+    std::uint16_t releasedLatch;
+    sf::Vector2i mousePixel;
+
+    void sourceDown(std::uint16_t actions);
+    void sourceUp(std::uint16_t actions);
+};
@@ -0,0 +1,67 @@
+#pragma once
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include <string>
+
+// Distribution of latencies in 0.1 ms buckets up to 250 ms, anything longer
+// in the last one
+class LatencyStats
+{
+public:
+    LatencyStats();
+
+    void add(float milliseconds);
+    void clear();
+
+    std::uint32_t getCount() const { return count; }
+    float getMean() const { return count ? static_cast<float>(total / count) : 0.0f; }
+    float getMax() const { return max; }
+    // Upper edge of the bucket holding the given fraction of samples, 0.99 for p99
+    float getPercentile(float fraction) const;
+
+    // "n inputs: p50 .. p95 .. p99 .. max .. ms"
+    std::string format() const;
+
+private:
+    static constexpr float BUCKET_MS = 0.1f;
+    static constexpr std::size_t BUCKET_COUNT = 2500;
+
+    std::array<std::uint32_t, BUCKET_COUNT> buckets;
+    std::uint32_t count;
+    double total;
+    float max;
+};
+
+// Follows the oldest input not yet on screen through the frame pipeline:
+// seen as a key or mouse press, sampled into a tick, the tick simulated, and
+// that tick's frame presented. Presses arriving while one is followed are
+// answered by the same frame and not counted again.
+//
+// The time starts when the event is polled, so time spent in the OS queue
+// before that is not included.
+class InputLatency
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+    void inputSeen();
+    // The input was sampled into a tick
+    void tickSubmitted();
+    // That tick's snapshot is the next one drawn
+    void tickFinished();
+    // Right after display()
+    void framePresented();
+    // Forgets the input being followed, e.g. when the game pauses
+    void reset();
+
+    const LatencyStats& getStats() const { return stats; }
+    void clearStats() { stats.clear(); }
+
+private:
+    std::optional<Clock::time_point> seen;
+    std::optional<Clock::time_point> submitted;
+    std::optional<Clock::time_point> finished;
+    LatencyStats stats;
+};
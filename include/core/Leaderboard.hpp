@@ -0,0 +1,83 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// One finished run of a level
+struct RunRecord
+{
+    std::uint64_t mapHash = 0;
+    std::uint32_t timeMs = 0;
+    std::int32_t score = 0;
+    std::uint32_t deaths = 0;
+    // Seconds since the Unix epoch
+    std::int64_t finishedAt = 0;
+
+    // Faster first, then fewer deaths, then more score
+    bool isBetterThan(const RunRecord& other) const;
+};
+
+// Every finished run, kept on disk in two files:
+//   runs.log    append only. "HLLB", u32 version, then fixed size records:
+//               u64 map hash, u64 offset of the map's previous run (0 for
+//               none), u32 time ms, i32 score, u32 deaths, i64 finished at,
+//               u32 checksum
+//   index.bin   per map hash the run count, the offset of its newest run and
+//               its TOP_SIZE best runs, plus how much of the log it covers
+// A run is synced to the log before the index is rewritten (write and
+// rename), so a crash loses at most a half written record. Opening replays
+// whatever the index missed and cuts off a torn record. Only the index is
+// held in memory; history is read by following a map's chain in the log.
+class Leaderboard
+{
+public:
+    static constexpr const char* DEFAULT_DIRECTORY = "scores";
+    static constexpr std::uint32_t VERSION = 1;
+    static constexpr std::size_t TOP_SIZE = 100;
+
+    explicit Leaderboard(const std::string& directory = DEFAULT_DIRECTORY);
+
+    // Loads the index, rebuilding it from the log if it is missing or stale
+    bool open();
+
+    // Appends the run and returns its place among the map's best runs,
+    // 1 for a new personal best, 0 if it did not make the top TOP_SIZE
+    std::size_t add(const RunRecord& run);
+    // Many runs with one sync and one index write, for imports and tools
+    bool addRuns(const std::vector<RunRecord>& runs);
+
+    // Best runs on a map, fastest first
+    void getTop(std::uint64_t mapHash, std::size_t count, std::vector<RunRecord>& runs) const;
+    bool getPersonalBest(std::uint64_t mapHash, RunRecord& run) const;
+    std::uint64_t getRunCount(std::uint64_t mapHash) const;
+    // Latest runs on a map, newest first
+    void getRecent(std::uint64_t mapHash, std::size_t count, std::vector<RunRecord>& runs) const;
+
+    std::size_t getMapCount() const { return boards.size(); }
+
+private:
+    struct MapBoard
+    {
+        std::uint64_t runCount = 0;
+        std::uint64_t lastOffset = 0;
+        std::vector<RunRecord> top;
+    };
+
+    std::string directory;
+    std::unordered_map<std::uint64_t, MapBoard> boards;
+    // Bytes of the log the index covers
+    std::uint64_t logSize;
+    bool opened;
+
+    std::string logPath() const;
+    std::string indexPath() const;
+
+    bool readIndex();
+    bool writeIndex() const;
+    // Indexes records from logSize to the end of the log and truncates a
+    // torn record at the end
+    bool replayLog();
+    bool appendRecords(const std::vector<RunRecord>& runs, std::vector<std::size_t>* ranks);
+    std::size_t indexRun(const RunRecord& run, std::uint64_t offset);
+};
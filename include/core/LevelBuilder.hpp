@@ -0,0 +1,44 @@
+#pragma once
+#include <SFML/Graphics.hpp>
+#include <memory>
+#include <vector>
+#include "core/MapParser.hpp"
+#include "core/Simulation.hpp"
+
+// Turns parsed map objects into platforms and pickups of a Simulation.
+//
+// Collision sizes are fixed rather than taken from the textures, so a
+// headless server built with empty textures and a client with the real art
+// simulate exactly the same level. Sprites are scaled to fit.
+class LevelBuilder
+{
+public:
+    static constexpr float PLATFORM_WIDTH = 64.0f;
+    static constexpr float PLATFORM_HEIGHT = 18.0f;
+    static constexpr float OBSTACLE_WIDTH = 192.0f;
+    static constexpr float OBSTACLE_HEIGHT = 32.0f;
+    // Maps have no spawn marker, every level starts here
+    static constexpr float SPAWN_X = 100.0f;
+    static constexpr float SPAWN_Y = 250.0f;
+
+    struct Textures
+    {
+        const sf::Texture* ground;
+        const sf::Texture* platform;
+        const sf::Texture* obstacle;
+        const sf::Texture* coin;
+        const sf::Texture* checkpoint;
+        const sf::Texture* win;
+    };
+
+    explicit LevelBuilder(const Textures& textures);
+
+    // entities[i] is what map.objects[i] became
+    void build(Simulation& simulation, const MapData& map, std::vector<Entity>& entities) const;
+    Entity createObject(Simulation& simulation, const MapObject& object) const;
+
+private:
+    Textures textures;
+
+    std::shared_ptr<Platform> createFloatingPlatform(float x, float y) const;
+};
@@ -1,54 +1,115 @@
 #pragma once
+#include <atomic>
 #include <iostream>
 #include <memory>
+#include <thread>
 #include <vector>
 #include <string>
 #include <SFML/Window.hpp>
 #include <SFML/Graphics.hpp>
 #include "game/Player.hpp"
 #include "core/Physics.hpp"
+#include "core/Input.hpp"
+#include "core/Simulation.hpp"
+#include "core/SimulationThread.hpp"
+#include "core/MapParser.hpp"
+#include "core/MapDiff.hpp"
+#include "core/AssetWatcher.hpp"
+#include "core/AssetLoader.hpp"
+#include "core/LevelBuilder.hpp"
+#include "core/Ghost.hpp"
+#include "core/GhostRenderer.hpp"
+#include "core/Leaderboard.hpp"
+#include "core/ParticleSystem.hpp"
+#include "core/Replay.hpp"
+#include "core/FramePacer.hpp"
+#include "core/InputLatency.hpp"
+#include "core/UiScreen.hpp"
+#include "core/Telemetry.hpp"
+#include "core/MapIndex.hpp"
+#include "core/MapThumbnails.hpp"
+#include "core/Heatmap.hpp"
 #include "game/AnimatedSprite.hpp"
 #include "game/Platform.hpp"
-#include "game/Pickup.hpp"
-#include "game/Coin.hpp"
-#include "game/Checkpoint.hpp"
-#include "game/WinPickup.hpp"
+#include "net/GameClient.hpp"
+#include "net/GameServer.hpp"
 
 enum class GameState
 {
     Menu,
+    Connecting,
     Playing,
     Paused,
     WinScreen
 };
 
-struct MapButton
+// One row of the map list. The rows stay put and show whichever maps are
+// scrolled to.
+struct MapRow
 {
-    sf::RectangleShape shape;
-    std::unique_ptr<sf::Text> text;
+    UiScreen::WidgetId button = UiScreen::NONE;
+    UiScreen::WidgetId nameText = UiScreen::NONE;
+    UiScreen::WidgetId infoText = UiScreen::NONE;
+    sf::Vector2f thumbnailPosition;
+};
+
+// Set from the command line: host a race in this process and play in it,
+// or join someone else's
+struct RaceOptions
+{
+    enum class Mode
+    {
+        None,
+        Host,
+        Join
+    };
+    
+    Mode mode = Mode::None;
     std::string mapFile;
+    std::string address = "127.0.0.1";
+    unsigned short port = DEFAULT_PORT;
+};
+
+// Set from the command line: how frames are paced, and whether the time
+// from a key press to the frame showing it is measured and printed
+struct FrameOptions
+{
+    // 0 draws frames as fast as it can
+    float targetFps = 0;
+    bool vsync = false;
+    bool reportLatency = false;
 };
 
 class MainWindow 
 {
 public:
     MainWindow(unsigned int width = 1200, unsigned int height = 800, const std::string& title = "HookLeap");
+    ~MainWindow();
+    
+    void setRaceOptions(const RaceOptions& options);
+    // Plays a recorded run on its map instead of opening the menu
+    void setReplayFile(const std::string& path);
+    void setFrameOptions(const FrameOptions& options);
+    // Where gameplay events go; the caller keeps it open for the whole run
+    void setTelemetry(Telemetry& telemetry_);
     void run();
     
 private:
     sf::RenderWindow window;
     sf::View camera;
     sf::Clock clock;
-    sf::Clock gameTimer;
     
     GameState currentState;
+    InputSystem input;
+    
+    // Declared before anything loaded from it; fonts keep reading from the pack
+    AssetLoader assets;
     
     // Game objects
-    std::unique_ptr<Player> player;
     sf::Texture characterTexture;
-    Physics physics;
-    std::vector<std::shared_ptr<Platform>> platforms;
-    std::vector<std::shared_ptr<Pickup>> pickups;
+    std::unique_ptr<Simulation> simulation;
+    std::unique_ptr<SimulationThread> simulationThread;
+    std::unique_ptr<sf::Sprite> playerSprite;
     
     // Textures
     sf::Texture platformTexture;
@@ -58,66 +119,181 @@ private:
     sf::Texture checkpointTexture;
     sf::Texture winPickupTexture;
     sf::Texture backgroundTexture;
+    LevelBuilder levelBuilder;
     
     // Background sprite
     std::unique_ptr<sf::Sprite> background;
     std::string currentTileset;
     
-    // Game stats
-    int score;
-    int deaths;
-    float currentTime;
-    sf::Vector2f lastCheckpoint;
+    // Loaded level, kept so a changed map file can be diffed against it.
+    // levelEntities[i] is what currentMap.objects[i] became.
+    std::string currentMapFile;
+    std::uint64_t currentMapHash;
+    MapData currentMap;
+    std::vector<Entity> levelEntities;
+    
+    // Hot reload
+    AssetWatcher assetWatcher;
+    std::vector<std::string> changedAssets;
+    
+    // Ghosts of the fastest runs on this map, and the run being recorded.
+    // An edited map ends the recording, the run no longer fits either version.
+    GhostLibrary ghostLibrary;
+    std::vector<std::unique_ptr<GhostPlayback>> ghosts;
+    GhostRecorder ghostRecorder;
+    bool recordingGhost;
+    GhostRenderer ghostRenderer;
+    
+    // Every finished run, by map hash
+    Leaderboard leaderboard;
+    
+    // Bursts for pickups, deaths and hook hits in single player
+    ParticleSystem particles;
+    std::size_t coinEffect;
+    std::size_t checkpointEffect;
+    std::size_t deathEffect;
+    std::size_t hookEffect;
+    
+    // Where runs of this map died, hooked and went, as hookleap_heatmap
+    // counted them. H cycles the layer drawn over the level, the file is
+    // read on the first press. heatmapLayer is LAYER_COUNT while hidden.
+    Heatmap heatmap;
+    bool heatmapLoaded;
+    std::size_t heatmapLayer;
+    sf::Texture heatmapTexture;
+    std::unique_ptr<sf::Sprite> heatmapSprite;
+    
+    // A replay plays its recorded input, one tick at its own tick time, in
+    // place of the keyboard. Its runs are not recorded or ranked.
+    std::string replayFile;
+    Replay replay;
+    std::size_t replayTick;
+    float replayLag;
+    bool playingReplay;
+    
+    // Race mode. The local player is simulated on this thread by the client,
+    // so simulationThread sits idle while racing.
+    RaceOptions raceOptions;
+    std::unique_ptr<GameServer> server;
+    std::thread serverThread;
+    std::atomic<bool> serverRunning;
+    std::unique_ptr<GameClient> client;
+    RenderSnapshot raceSnapshot;
+    std::vector<NetPlayerState> remotePlayers;
+    std::unique_ptr<sf::Sprite> remoteSprite;
     
     // UI
     sf::Font font;
     std::unique_ptr<sf::Text> scoreText;
     std::unique_ptr<sf::Text> timeText;
-    std::unique_ptr<sf::Text> winScoreText;
-    std::unique_ptr<sf::Text> winTimeText;
-    std::unique_ptr<sf::Text> winDeathsText;
-    
-    // Menu
-    std::unique_ptr<sf::Text> logoText;
-    std::vector<MapButton> mapButtons;
-    sf::RectangleShape quitButton;
-    std::unique_ptr<sf::Text> quitButtonText;
-    
-    // Win screen buttons
-    sf::RectangleShape restartButton;
-    std::unique_ptr<sf::Text> restartButtonText;
-    sf::RectangleShape menuButton;
-    std::unique_ptr<sf::Text> menuButtonText;
-    sf::RectangleShape winQuitButton;
-    std::unique_ptr<sf::Text> winQuitButtonText;
+    std::unique_ptr<sf::Text> netStatsText;
+    
+    // Menu, win and pause screens only change when something happens, so
+    // the loop sleeps in waitEvent and draws them when needsRedraw is set or
+    // the state changes. The paused level is drawn once into pausedFrame.
+    bool needsRedraw;
+    GameState renderedState;
+    bool windowFocused;
+    sf::RenderTexture pausedFrame;
+    bool pausedFrameReady;
+    
+    // Frames start on the pacer's schedule, so input is read right before
+    // the tick it goes into. Presses are followed until their frame is shown.
+    FrameOptions frameOptions;
+    FramePacer pacer;
+    InputLatency inputLatency;
+    sf::Clock latencyReportClock;
+    
+    // Level loads, deaths, pickups, hook use and hitches, if set
+    Telemetry* telemetry;
+    
+    // Menu. The maps are listed from mapIndex as its worker finds them, and
+    // only the rows on screen ask for thumbnails.
+    UiScreen menuScreen;
+    MapIndex mapIndex;
+    MapThumbnails mapThumbnails;
+    std::vector<MapInfo> maps;
+    bool mapsChanged;
+    bool indexingMaps;
+    std::size_t firstMapRow;
+    std::vector<MapRow> mapRows;
+    UiScreen::WidgetId mapListText = UiScreen::NONE;
+    UiScreen::WidgetId quitButton = UiScreen::NONE;
+    
+    UiScreen connectingScreen;
+    UiScreen::WidgetId connectingText = UiScreen::NONE;
+    
+    // Win screen
+    UiScreen winScreen;
+    UiScreen::WidgetId winScoreText = UiScreen::NONE;
+    UiScreen::WidgetId winTimeText = UiScreen::NONE;
+    UiScreen::WidgetId winDeathsText = UiScreen::NONE;
+    UiScreen::WidgetId winRankText = UiScreen::NONE;
+    UiScreen::WidgetId winTopText = UiScreen::NONE;
+    UiScreen::WidgetId restartButton = UiScreen::NONE;
+    UiScreen::WidgetId menuButton = UiScreen::NONE;
+    UiScreen::WidgetId winQuitButton = UiScreen::NONE;
+    
+    // Drawn over the paused level
+    UiScreen pauseScreen;
     
     void init();
     void handleEvents();
+    void handleEvent(const sf::Event& event);
     void handleMenuEvents(const sf::Event& event);
     void handlePlayingEvents(const sf::Event& event);
     void handleWinScreenEvents(const sf::Event& event);
     
     void update(sf::Time& elapsed);
     void updateMenu(sf::Time& elapsed);
+    void updateConnecting(sf::Time& elapsed);
     void updatePlaying(sf::Time& elapsed);
+    void updateRace(sf::Time& elapsed);
     void updateWinScreen(sf::Time& elapsed);
+    void finishUpdate();
     
     void render();
     void renderMenu();
-    void renderPlaying();
+    void renderConnecting();
+    void renderPlaying(sf::RenderTarget& target);
+    void renderRemotePlayers(sf::RenderTarget& target, const RenderSnapshot& snapshot);
+    void renderPaused();
     void renderWinScreen();
     
     void loadMap(const std::string& mapFile);
+    bool readMap(const std::string& mapFile, MapData& map, std::uint64_t& hash);
+    void loadTilesetTextures();
     void clearMap();
+    
+    void checkAssetChanges();
+    void reloadMap();
+    void reloadTexture(const std::string& path);
     void setupMenu();
+    void updateMapRows();
+    void scrollMaps(int rows);
+    void setupConnectingScreen();
     void setupWinScreen();
-    void updateCamera();
-    void updateUI();
-    void drawHookRope(const sf::Vector2f& start, const sf::Vector2f& end);
+    void setupPauseScreen();
+    void setupParticles();
+    void updateCamera(const RenderSnapshot& snapshot);
+    void updateUI(const RenderSnapshot& snapshot);
+    void updateNetStats();
+    void updateGhosts(const RenderSnapshot& snapshot);
+    void emitEffects(const SimulationEvents& events);
+    void recordEvents(const SimulationEvents& events, const RenderSnapshot& snapshot);
+    void cycleHeatmap();
     
-    void respawnPlayer();
-    void collectPickup(std::shared_ptr<Pickup> pickup);
-    void triggerWinScreen();
+    void triggerWinScreen(const RenderSnapshot& snapshot);
     void restartLevel();
     void returnToMenu();
+    
+    void startRace();
+    void leaveRace();
+    void startReplay();
+    
+    bool isIdle() const;
+    bool isLoadingMaps() const;
+    bool needsRender() const;
+    void throttle();
+    void reportLatency(bool final);
 };
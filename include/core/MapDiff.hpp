@@ -0,0 +1,24 @@
+#pragma once
+#include <cstddef>
+#include <utility>
+#include <vector>
+#include "core/MapParser.hpp"
+
+// What changed between two versions of a map file. Objects are matched by
+// type and values in file order. A static object whose only change is its
+// position counts as moved, so the live one can be moved instead of rebuilt;
+// moving platforms are always replaced since their path depends on the start.
+struct MapDiff
+{
+    // Indices into the old map
+    std::vector<std::size_t> removed;
+    // Indices into the new map
+    std::vector<std::size_t> added;
+    // Old index, new index
+    std::vector<std::pair<std::size_t, std::size_t>> moved;
+    std::vector<std::pair<std::size_t, std::size_t>> unchanged;
+
+    bool empty() const { return removed.empty() && added.empty() && moved.empty(); }
+};
+
+void diffMaps(const MapData& before, const MapData& after, MapDiff& diff);
@@ -0,0 +1,77 @@
+#pragma once
+#include <SFML/Graphics.hpp>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+#include "core/AssetLoader.hpp"
+#include "core/MapParser.hpp"
+
+constexpr std::size_t MAP_OBJECT_TYPE_COUNT = static_cast<std::size_t>(MapObjectType::Win) + 1;
+
+// What the map browser shows about a map without loading it
+struct MapInfo
+{
+    // Relative to maps/, as loadMap takes it
+    std::string file;
+    // Of the file's bytes, the same key the leaderboard and ghosts use
+    std::uint64_t hash = 0;
+    std::string tileset;
+    // Objects of each MapObjectType
+    std::array<std::uint32_t, MAP_OBJECT_TYPE_COUNT> counts{};
+    // Everything the level can reach, moving platforms' paths included
+    sf::FloatRect bounds;
+    bool valid = false;
+
+    std::uint32_t count(MapObjectType type) const { return counts[static_cast<std::size_t>(type)]; }
+};
+
+// The maps in assets/maps, indexed on a worker thread. The index is kept on
+// disk, so a start first publishes what the last run knew, then checks
+// every file's hash and parses only the new and edited ones.
+//
+//   header  "HLMI", u32 version, u32 map count
+//   maps    string file, u64 hash, string tileset, u8 valid, four f32
+//           bounds, then a varint count per object type
+class MapIndex
+{
+public:
+    static constexpr const char* DEFAULT_PATH = "cache/maps.index";
+    static constexpr std::uint32_t VERSION = 1;
+
+    explicit MapIndex(const std::string& path = DEFAULT_PATH);
+    ~MapIndex();
+
+    MapIndex(const MapIndex&) = delete;
+    MapIndex& operator=(const MapIndex&) = delete;
+
+    // Indexes again from the start; the loader has to outlive the scan
+    void start(const AssetLoader& assets);
+    // Takes the newest list if one was published since the last call
+    bool poll(std::vector<MapInfo>& maps);
+    bool isScanning() const { return scanning; }
+
+    // Summarises one parsed map
+    static void describe(const MapData& map, MapInfo& info);
+    // The area of one object at rest
+    static sf::FloatRect objectBounds(const MapObject& object);
+
+private:
+    std::string path;
+    std::thread worker;
+    std::atomic<bool> scanning;
+    std::atomic<bool> stopping;
+
+    std::mutex mutex;
+    std::vector<MapInfo> published;
+    bool hasPublished;
+
+    void scan(const AssetLoader& assets);
+    void publish(const std::vector<MapInfo>& maps);
+    bool load(std::vector<MapInfo>& maps) const;
+    bool save(const std::vector<MapInfo>& maps) const;
+};
@@ -0,0 +1,77 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+enum class MapObjectType : std::uint8_t
+{
+    Ground,
+    Platform,
+    Mover,
+    Oscillator,
+    Crumble,
+    Obstacle,
+    Pickup,
+    Checkpoint,
+    Win
+};
+
+// One line of a map file. Every object starts with x and y; the rest of
+// values depends on the type, in file order:
+//   ground      x y width height
+//   mover       x y endX endY speed
+//   oscillator  x y amplitudeX amplitudeY period
+//   crumble     x y delay respawnTime
+struct MapObject
+{
+    static constexpr std::size_t MAX_VALUES = 5;
+    
+    MapObjectType type;
+    std::array<float, MAX_VALUES> values;
+    
+    float x() const { return values[0]; }
+    float y() const { return values[1]; }
+};
+
+struct MapError
+{
+    std::size_t line;
+    std::size_t column;
+    std::string message;
+};
+
+struct MapData
+{
+    std::string tileset;
+    std::vector<MapObject> objects;
+};
+
+// Parses the text map format straight from one buffer: no per-line strings or
+// streams, numbers read with from_chars. Big files are cut into line-aligned
+// chunks that are parsed on separate threads and joined in file order.
+class MapParser
+{
+public:
+    static constexpr std::size_t PARALLEL_CHUNK_SIZE = 256 * 1024;
+    static constexpr std::size_t MAX_ERRORS = 100;
+    
+    MapParser();
+    
+    // Maps the file and parses it. False if it cannot be opened or has errors;
+    // valid lines are still parsed when others have errors.
+    bool loadFile(const std::string& path, MapData& data);
+    bool parse(std::string_view text, MapData& data);
+    
+    // 0 picks the hardware thread count
+    void setThreadCount(unsigned threadCount_);
+    
+    const std::vector<MapError>& getErrors() const { return errors; }
+    
+    static std::size_t valueCount(MapObjectType type);
+
+private:
+    unsigned threadCount;
+    std::vector<MapError> errors;
+};
@@ -0,0 +1,81 @@
+#pragma once
+#include <SFML/Graphics.hpp>
+#include <condition_variable>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+#include "core/AssetLoader.hpp"
+#include "core/MapIndex.hpp"
+
+// Small pictures of maps for the map browser, drawn when a row first asks
+// for one. A worker thread parses the map and paints every object as a
+// coloured box into an image, so nothing on the main thread waits on a
+// file; update() then uploads the finished ones. Textures are kept for the
+// most recently shown maps only, and requests for maps scrolled past are
+// dropped before their turn comes.
+class MapThumbnails
+{
+public:
+    static constexpr unsigned int WIDTH = 96;
+    static constexpr unsigned int HEIGHT = 54;
+    static constexpr std::size_t CAPACITY = 48;
+
+    // The loader has to outlive the thumbnails
+    explicit MapThumbnails(const AssetLoader& assets);
+    ~MapThumbnails();
+
+    MapThumbnails(const MapThumbnails&) = delete;
+    MapThumbnails& operator=(const MapThumbnails&) = delete;
+
+    // The map's thumbnail, or nullptr while it is being drawn
+    const sf::Texture* get(const MapInfo& info);
+    // Uploads what the worker finished; true if any new thumbnail arrived
+    bool update();
+    bool isBusy() const;
+
+    // Paints one map, the worker's job
+    static void paint(const MapData& map, const sf::FloatRect& bounds, sf::Image& image);
+
+private:
+    struct Request
+    {
+        std::uint64_t hash;
+        std::string file;
+        sf::FloatRect bounds;
+    };
+
+    struct Finished
+    {
+        std::uint64_t hash;
+        sf::Image image;
+    };
+
+    struct Entry
+    {
+        std::uint64_t hash;
+        sf::Texture texture;
+    };
+
+    const AssetLoader& assets;
+
+    // Most recently used first
+    std::list<Entry> entries;
+    std::unordered_map<std::uint64_t, std::list<Entry>::iterator> byHash;
+
+    std::thread worker;
+    mutable std::mutex mutex;
+    std::condition_variable wake;
+    bool stopping;
+    // Newest request last; the worker takes from the back
+    std::vector<Request> requests;
+    std::vector<Finished> finished;
+    std::unordered_set<std::uint64_t> pending;
+    std::size_t painting;
+
+    void run();
+};
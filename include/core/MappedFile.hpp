@@ -0,0 +1,39 @@
+#pragma once
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+// Read-only view of a whole file, memory mapped so large files are not copied
+class MappedFile
+{
+public:
+    MappedFile() = default;
+    ~MappedFile();
+    
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+    
+    bool open(const std::string& path);
+    void close();
+    
+    bool isOpen() const { return opened; }
+    const char* getData() const { return data; }
+    std::size_t getSize() const { return size; }
+    std::string_view getView() const { return std::string_view(data, size); }
+
+private:
+    const char* data = nullptr;
+    std::size_t size = 0;
+    bool opened = false;
+    
+#ifdef _WIN32
+    void* fileHandle = nullptr;
+    void* mappingHandle = nullptr;
+#else
+    int descriptor = -1;
+#endif
+    
+    void swap(MappedFile& other) noexcept;
+};
@@ -0,0 +1,83 @@
+#pragma once
+#include <SFML/Graphics.hpp>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+// How one kind of particle is emitted, moves and fades. Angles in radians,
+// 0 pointing right and growing clockwise like screen coordinates.
+struct ParticleEffect
+{
+    // Untextured particles are plain squares
+    const sf::Texture* texture = nullptr;
+    sf::IntRect textureRect;
+
+    std::size_t count = 16;
+    float direction = 0;
+    float spread = 6.2831853f;
+    float speedMin = 50;
+    float speedMax = 200;
+    float lifeMin = 0.3f;
+    float lifeMax = 0.8f;
+    float gravity = 0;
+    // Share of the velocity lost per second
+    float drag = 0;
+    float sizeStart = 6;
+    float sizeEnd = 0;
+    sf::Color colorStart = sf::Color::White;
+    sf::Color colorEnd = sf::Color::Transparent;
+};
+
+// Short lived cosmetic particles. Particles sharing a texture live in one
+// fixed size pool stored as one array per attribute, so the update is a few
+// straight loops over floats the compiler can vectorize, and each pool is
+// drawn as a single vertex array. A full pool drops new particles rather
+// than growing.
+class ParticleSystem
+{
+public:
+    static constexpr std::size_t DEFAULT_CAPACITY = 131072;
+
+    explicit ParticleSystem(std::size_t capacity = DEFAULT_CAPACITY);
+
+    // Returns the id to emit it by
+    std::size_t addEffect(const ParticleEffect& effect);
+    // A burst of the effect's count, or of count if given. Returns how many fit.
+    std::size_t emit(std::size_t effect, const sf::Vector2f& position, std::size_t count = 0);
+
+    void update(float dt);
+    // Fills the vertex arrays from the live particles, once per drawn frame
+    void buildVertices();
+    void draw(sf::RenderTarget& target) const;
+
+    void clear();
+    std::size_t getCount() const;
+    std::size_t getCapacity() const { return capacity; }
+
+private:
+    struct Pool
+    {
+        const sf::Texture* texture = nullptr;
+        std::size_t count = 0;
+        std::vector<float> x;
+        std::vector<float> y;
+        std::vector<float> vx;
+        std::vector<float> vy;
+        std::vector<float> gravity;
+        std::vector<float> drag;
+        std::vector<float> age;
+        std::vector<float> inverseLife;
+        std::vector<std::uint16_t> effect;
+        sf::VertexArray vertices;
+    };
+
+    std::size_t capacity;
+    std::vector<ParticleEffect> effects;
+    std::vector<std::size_t> effectPools;
+    std::vector<Pool> pools;
+    std::minstd_rand random;
+
+    std::size_t findPool(const sf::Texture* texture);
+    float randomRange(float min, float max);
+    static void updatePool(Pool& pool, float dt);
+};
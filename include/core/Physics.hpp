@@ -3,8 +3,10 @@
 #include <vector>
 #include <memory>
 #include <cmath>
+#include <unordered_map>
 #include "game/Platform.hpp"
 #include "game/Character.hpp"
+#include "core/Broadphase.hpp"
 
 
 class Physics
@@ -14,19 +16,59 @@ public:
     static constexpr float MAX_FALL_SPEED = 600.0f;
     static constexpr float GROUND_FRICTION = 0.85f;
     static constexpr float AIR_FRICTION = 0.95f;
+    static constexpr float FIXED_TIMESTEP = 1.0f / 240.0f;
+    static constexpr float BROADPHASE_CELL_SIZE = 128.0f;
+    static constexpr float SUPPORT_TOLERANCE = 2.0f;
+    static constexpr float NO_PLATFORMS_LOWEST_POINT = -1000000.0f;
     
+    Physics();
+    
+    // Motion has to be set up before the platform is added
     void addPlatform(std::shared_ptr<Platform> platform);
     void clearPlatforms();
+    
+    // Drops the given platforms; the rest keep the order they were added in
+    void removePlatforms(const std::vector<const Platform*>& removed);
+    
+    // Call after moving static platforms by hand so collisions see them
+    void refreshPlatforms(const std::vector<const Platform*>& moved);
+    
+    // A copied Physics still shares its kinematic platforms with the original.
+    // This gives it its own and reports each original with its clone.
+    void cloneKinematicPlatforms(std::unordered_map<const Platform*, std::shared_ptr<Platform>>& clones);
 
     const std::vector<std::shared_ptr<Platform>>& getPlatforms() const;
     
+    // Moves kinematic platforms and refreshes only their broadphase entries
+    void updateKinematics(const sf::Time& elapsed);
+    
+    // Solid platforms overlapping area, in the order they were added
+    void queryPlatforms(const sf::FloatRect& area, std::vector<Platform*>& result) const;
+    
+    // Platform the box was standing on before this tick's platform motion
+    Platform* findSupport(const sf::FloatRect& bounds) const;
+    
     void applyGravity(sf::Vector2f& velocity, const sf::Time& elapsed);
     void applyFriction(sf::Vector2f& velocity, bool isOnGround);
     
     bool handleCollisions(Character& character, sf::Vector2f& velocity, bool& fellInPit, bool& hitDeadlyPlatform);
+    bool resolveCollisions(const sf::FloatRect& bounds, sf::Vector2f& velocity, sf::Vector2f& correction, bool& hitDeadlyPlatform);
+    float getLowestPoint() const;
     
 private:
     std::vector<std::shared_ptr<Platform>> platforms;
+    std::vector<int> proxies;
+    std::vector<std::size_t> kinematicPlatforms;
+    Broadphase broadphase;
+    float largestMotion;
+    
+    float staticLowestPoint;
+    float kinematicLowestPoint;
+    
+    mutable std::vector<std::uint32_t> candidates;
+    
+    void gatherCandidates(const sf::FloatRect& area) const;
+    void rebuildPlatformInfo();
     
     bool checkPlatformCollision(const sf::FloatRect& bounds, Platform& platform, sf::Vector2f& velocity, sf::Vector2f& correction);
 };
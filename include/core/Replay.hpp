@@ -0,0 +1,42 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "core/Input.hpp"
+
+// The input of a run, one InputState per fixed tick, so the run can be played
+// again exactly by stepping a Simulation of the same map with the same tick.
+// Written by hookleap_bot and played with HookLeap --replay.
+//
+// A replay file is
+//   header  "HLRP", u8 version, u64 map hash, string map file, f32 tick time,
+//           u32 tick count
+//   inputs  runs of equal ticks: varint length, then held, pressed and
+//           released as varints and the aim as two raw floats
+static constexpr std::uint8_t REPLAY_VERSION = 3;
+
+class Replay
+{
+public:
+    Replay();
+
+    void clear();
+    void setMap(const std::string& mapFile_, std::uint64_t mapHash_);
+    void setTickTime(float tickTime_) { tickTime = tickTime_; }
+    void add(const InputState& input);
+
+    bool save(const std::string& path) const;
+    bool load(const std::string& path);
+
+    const std::string& getMapFile() const { return mapFile; }
+    std::uint64_t getMapHash() const { return mapHash; }
+    float getTickTime() const { return tickTime; }
+    std::size_t getTickCount() const { return inputs.size(); }
+    const std::vector<InputState>& getInputs() const { return inputs; }
+
+private:
+    std::string mapFile;
+    std::uint64_t mapHash;
+    float tickTime;
+    std::vector<InputState> inputs;
+};
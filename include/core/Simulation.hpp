@@ -0,0 +1,122 @@
+#pragma once
+#include <SFML/Graphics.hpp>
+#include <memory>
+#include <utility>
+#include <vector>
+#include "game/Player.hpp"
+#include "game/Platform.hpp"
+#include "core/Physics.hpp"
+#include "core/Input.hpp"
+#include "ecs/Registry.hpp"
+#include "ecs/Components.hpp"
+#include "ecs/Systems.hpp"
+
+// Something worth a visual effect, where it happened
+enum class EffectType : std::uint8_t
+{
+    CoinCollected,
+    CheckpointReached,
+    PlayerDied,
+    HookAttached
+};
+
+struct EffectEvent
+{
+    EffectType type;
+    sf::Vector2f position;
+};
+
+struct SimulationEvents
+{
+    bool won = false;
+    bool died = false;
+    // The hook let go during the tick, whatever made it
+    bool hookReleased = false;
+    std::vector<EffectEvent> effects;
+};
+
+// Everything the renderer needs from one tick, copied out of the simulation
+// so it can be drawn while the next tick runs
+struct RenderSnapshot
+{
+    RenderSystem world;
+    
+    sf::Transform playerTransform;
+    sf::IntRect playerTextureRect;
+    sf::FloatRect playerHitbox;
+    sf::Vector2f playerPosition;
+    PlayerState playerState = PlayerState::Idle;
+    bool playerFacingLeft = false;
+    
+    Hook hook;
+    std::vector<sf::Vertex> rope;
+    
+    int score = 0;
+    int deaths = 0;
+    float time = 0;
+};
+
+// The gameplay state of one level: the player, platforms, pickups and the
+// level stats. It does not touch the window, so it can run on any thread or
+// without one.
+//
+// Copies are independent worlds that share only the static platforms, which
+// nothing changes during play; use them to rewind or branch a simulation.
+class Simulation
+{
+public:
+    explicit Simulation(const sf::Texture& characterTexture);
+    Simulation(const Simulation& other);
+    Simulation& operator=(const Simulation& other);
+    
+    void clear();
+    Entity addPlatform(const std::shared_ptr<Platform>& platform);
+    Entity addPickup(PickupType type, const sf::Texture& texture, const sf::Vector2f& position);
+    
+    // Edits to a running level, used by hot reload. The player, score and
+    // timer are left alone; the hook lets go if its anchor disappears.
+    void removeObjects(const std::vector<Entity>& entities);
+    void moveObjects(const std::vector<std::pair<Entity, sf::Vector2f>>& moves);
+    
+    // Puts the player on the spawn point and zeroes score, deaths and time
+    void restart(const sf::Vector2f& spawn);
+    
+    SimulationEvents step(const InputState& input, const sf::Time& elapsed);
+    // Same, reusing the caller's events so a steady loop does not allocate
+    void step(const InputState& input, const sf::Time& elapsed, SimulationEvents& events);
+    void buildSnapshot(RenderSnapshot& snapshot);
+    
+    Player& getPlayer() { return player; }
+    const Player& getPlayer() const { return player; }
+    Physics& getPhysics() { return physics; }
+    const Physics& getPhysics() const { return physics; }
+    Registry& getRegistry() { return registry; }
+    
+    int getScore() const { return score; }
+    int getDeaths() const { return deaths; }
+    float getTime() const { return time; }
+    sf::Vector2f getLastCheckpoint() const { return lastCheckpoint; }
+    
+    // Overwrites the level stats, e.g. with a server's authoritative values
+    void setProgress(int score_, int deaths_, float time_, const sf::Vector2f& lastCheckpoint_);
+
+private:
+    Player player;
+    Physics physics;
+    
+    Registry registry;
+    MovementSystem movementSystem;
+    PlatformSystem platformSystem;
+    PickupSystem pickupSystem;
+    AnimationSystem animationSystem;
+    std::vector<PickupEvent> pickupEvents;
+    
+    int score;
+    int deaths;
+    float time;
+    sf::Vector2f lastCheckpoint;
+    
+    void respawnPlayer();
+    void releaseDetachedHook();
+    void cloneKinematicPlatforms();
+};
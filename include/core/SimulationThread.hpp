@@ -0,0 +1,57 @@
+#pragma once
+#include <array>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include "core/Simulation.hpp"
+
+// Runs Simulation::step on a worker thread so the next tick is simulated
+// while the main thread draws the previous one.
+//
+// Between submit() and wait() the simulation and the back snapshot belong to
+// the worker; the main thread may only read getFront(). Outside that window
+// the worker is idle and the simulation can be changed directly.
+class SimulationThread
+{
+public:
+    explicit SimulationThread(Simulation& simulation);
+    ~SimulationThread();
+    
+    SimulationThread(const SimulationThread&) = delete;
+    SimulationThread& operator=(const SimulationThread&) = delete;
+    
+    // Starts a tick into the back snapshot
+    void submit(const InputState& input, const sf::Time& elapsed);
+    
+    // Blocks until the submitted tick is done, then makes its snapshot the
+    // front one. Returns what happened during that tick.
+    SimulationEvents wait();
+    
+    // Rebuilds the front snapshot from the simulation, e.g. after loading a map
+    void refresh();
+    
+    bool isBusy() const { return busy; }
+    const RenderSnapshot& getFront() const { return snapshots[front]; }
+
+private:
+    Simulation& simulation;
+    std::array<RenderSnapshot, 2> snapshots;
+    int front;
+    
+    std::thread worker;
+    std::mutex mutex;
+    std::condition_variable workReady;
+    std::condition_variable workDone;
+    
+    // Guarded by mutex
+    bool hasWork;
+    bool stopping;
+    InputState pendingInput;
+    sf::Time pendingElapsed;
+    SimulationEvents pendingEvents;
+    
+    // Main thread only
+    bool busy;
+    
+    void workerLoop();
+};
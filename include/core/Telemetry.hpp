@@ -0,0 +1,157 @@
+#pragma once
+#include <SFML/System.hpp>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <thread>
+
+enum class LogLevel : std::uint8_t
+{
+    Info,
+    Warning,
+    Error
+};
+
+enum class TelemetryType : std::uint8_t
+{
+    // A LogLine; text is the message
+    Message,
+    // text is the map file, value its hash
+    LevelLoaded,
+    // value is the run time in ms
+    LevelFinished,
+    Died,
+    Checkpoint,
+    Pickup,
+    HookAttached,
+    // Let go, torn off or landed on; the hook is gone either way
+    HookReleased,
+    // value is the frame time in µs
+    FrameHitch,
+    // Written by the writer thread; value is how many events the full
+    // buffer turned away
+    Dropped
+};
+
+// Fixed size, so an event is copied into the ring without allocating.
+// Longer text is cut off in the file.
+struct TelemetryEvent
+{
+    static constexpr std::size_t TEXT_SIZE = 208;
+
+    // Since the telemetry was opened
+    std::uint64_t timeNs = 0;
+    std::uint64_t value = 0;
+    sf::Vector2f position;
+    TelemetryType type = TelemetryType::Message;
+    LogLevel level = LogLevel::Info;
+    // A message already printed by its producer
+    bool printed = false;
+    std::uint16_t length = 0;
+    std::array<char, TEXT_SIZE> text;
+};
+
+// Diagnostics and gameplay events, queued by any thread and written by a
+// background one, so the game never waits on a flush. Producers claim a slot
+// in a fixed ring with one compare-and-swap and publish it with its sequence
+// number (a bounded multi-producer queue, Vyukov's design); the single
+// writer drains it in order to a JSON lines file, printing messages to
+// std::cout or std::cerr on the way. A full ring drops the event and says
+// so later instead of blocking.
+//
+// One Telemetry at a time is the active one LogLine sends to. Without one,
+// as in the tools, messages are printed directly.
+class Telemetry
+{
+public:
+    static constexpr const char* DEFAULT_PATH = "logs/telemetry.jsonl";
+    // A power of two
+    static constexpr std::size_t CAPACITY = 4096;
+
+    Telemetry();
+    ~Telemetry();
+
+    Telemetry(const Telemetry&) = delete;
+    Telemetry& operator=(const Telemetry&) = delete;
+
+    // Truncates the file, starts the writer and becomes the active
+    // telemetry. Messages are still printed if the file can't be opened.
+    bool open(const std::string& path = DEFAULT_PATH);
+    // Writes out everything queued and stops the writer
+    void close();
+    bool isOpen() const { return writer.joinable(); }
+
+    // Never blocks; false if the ring was full
+    bool record(TelemetryType type, const sf::Vector2f& position = {}, std::uint64_t value = 0,
+                std::string_view text = {});
+    bool message(LogLevel level, std::string_view text);
+
+    std::uint64_t getDropped() const { return dropped; }
+
+    static Telemetry* getActive() { return active; }
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    // Own cache line each, so producers on different slots don't share one
+    struct alignas(64) Slot
+    {
+        std::atomic<std::uint64_t> sequence;
+        TelemetryEvent event;
+    };
+
+    static std::atomic<Telemetry*> active;
+
+    std::unique_ptr<Slot[]> slots;
+    alignas(64) std::atomic<std::uint64_t> head;
+    alignas(64) std::uint64_t tail;
+    std::atomic<std::uint64_t> dropped;
+    std::uint64_t droppedReported;
+
+    Clock::time_point start;
+    std::ofstream file;
+    std::thread writer;
+    // Set by close(): producers turn events away once stopping is set, and
+    // the writer stops once finishing is, after producers already inside
+    // record() or message() have pushed
+    std::atomic<bool> stopping;
+    std::atomic<bool> finishing;
+    std::atomic<int> producers;
+
+    std::uint64_t elapsedNs() const;
+    bool enter();
+    void leave();
+    bool push(const TelemetryEvent& event);
+    bool pop(TelemetryEvent& event);
+    void run();
+    void write(const TelemetryEvent& event);
+};
+
+// One message for the player or developer, sent when the statement ends:
+//   LogLine(LogLevel::Error) << "Could not open " << path;
+class LogLine
+{
+public:
+    explicit LogLine(LogLevel level);
+    ~LogLine();
+
+    LogLine(const LogLine&) = delete;
+    LogLine& operator=(const LogLine&) = delete;
+
+    template <typename T>
+    LogLine& operator<<(const T& value)
+    {
+        stream << value;
+        return *this;
+    }
+
+private:
+    LogLevel level;
+    std::ostringstream stream;
+};
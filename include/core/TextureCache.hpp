@@ -0,0 +1,33 @@
+#pragma once
+#include <SFML/Graphics.hpp>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+// Decoded textures on disk, so later runs upload raw pixels instead of
+// inflating PNGs. One file per asset name:
+//   64 byte header  "HLTC", u32 version, u64 source hash, u32 width, u32 height
+//   pixels          width * height RGBA, rows packed (always 4 byte aligned)
+// An entry only counts if its hash matches the current source bytes, so an
+// edited PNG is decoded again and its entry rewritten.
+class TextureCache
+{
+public:
+    static constexpr const char* DEFAULT_DIRECTORY = "cache/textures";
+    static constexpr std::uint32_t VERSION = 1;
+
+    explicit TextureCache(const std::string& directory = DEFAULT_DIRECTORY);
+
+    // Empty turns the cache off
+    void setDirectory(const std::string& directory_);
+    bool isEnabled() const { return !directory.empty(); }
+
+    bool load(const std::string& name, std::uint64_t sourceHash, sf::Texture& texture) const;
+    void store(const std::string& name, std::uint64_t sourceHash, const sf::Image& image) const;
+
+private:
+    std::string directory;
+    mutable bool reportedWriteError;
+
+    std::string entryPath(const std::string& name) const;
+};
@@ -0,0 +1,97 @@
+#pragma once
+#include <SFML/Graphics.hpp>
+#include <cstddef>
+#include <map>
+#include <string>
+#include <vector>
+
+enum class UiAlign
+{
+    // Text starts at the rect's top left, where sf::Text would put it
+    Left,
+    // Text is centred in the rect both ways
+    Center
+};
+
+// Lays out widgets of a fixed size one below the other, centred on a column
+class UiColumn
+{
+public:
+    UiColumn(float centerX, float top, float gap);
+
+    sf::FloatRect next(const sf::Vector2f& size);
+
+private:
+    float centerX;
+    float y;
+    float gap;
+};
+
+// A retained screen of panels, labels and buttons, e.g. the menu. Each
+// widget keeps its own quads, rebuilt only when its text, colour or
+// visibility changes; the screen then copies them into one vertex array
+// for every panel and one per character size for text, so it draws in a few
+// calls whatever it holds. Clicks are matched against a flat list of the
+// buttons.
+class UiScreen
+{
+public:
+    using WidgetId = std::size_t;
+    static constexpr WidgetId NONE = static_cast<WidgetId>(-1);
+
+    explicit UiScreen(const sf::Font& font);
+
+    void clear();
+
+    WidgetId addPanel(const sf::FloatRect& rect, sf::Color color);
+    WidgetId addLabel(const sf::FloatRect& rect, const std::string& text, unsigned int characterSize, sf::Color color,
+                      UiAlign align = UiAlign::Left);
+    // A panel with a centred label that hitTest reports
+    WidgetId addButton(const sf::FloatRect& rect, const std::string& text, unsigned int characterSize, sf::Color color);
+
+    // Each marks the widget for rebuilding only if something changed
+    void setText(WidgetId id, const std::string& text);
+    void setColor(WidgetId id, sf::Color color);
+    void setVisible(WidgetId id, bool visible);
+
+    // The button at a point in screen coordinates, or NONE
+    WidgetId hitTest(const sf::Vector2f& point) const;
+
+    void draw(sf::RenderTarget& target);
+
+private:
+    enum class Kind
+    {
+        Panel,
+        Label,
+        Button
+    };
+
+    struct Widget
+    {
+        Kind kind;
+        sf::FloatRect rect;
+        std::string text;
+        unsigned int characterSize = 0;
+        sf::Color color;
+        UiAlign align = UiAlign::Left;
+        bool visible = true;
+        bool dirty = true;
+        std::vector<sf::Vertex> quads;
+        std::vector<sf::Vertex> textQuads;
+    };
+
+    const sf::Font& font;
+    std::vector<Widget> widgets;
+    std::vector<WidgetId> buttons;
+    bool dirty;
+
+    sf::VertexArray panels;
+    std::map<unsigned int, sf::VertexArray> texts;
+
+    WidgetId add(Widget widget);
+    void markDirty(Widget& widget);
+    void tessellate(Widget& widget) const;
+    void tessellateText(Widget& widget, sf::Color textColor) const;
+    void rebuild();
+};
@@ -0,0 +1,73 @@
+#pragma once
+#include <SFML/Graphics.hpp>
+#include <cstdint>
+#include <memory>
+#include "game/Platform.hpp"
+
+enum class PickupType : std::uint8_t
+{
+    Coin,
+    Checkpoint,
+    Win
+};
+
+struct TransformComponent
+{
+    sf::Vector2f position;
+};
+
+struct VelocityComponent
+{
+    sf::Vector2f value;
+    bool gravity = true;
+    bool onGround = false;
+};
+
+// Axis-aligned box relative to the transform
+struct AabbComponent
+{
+    sf::Vector2f offset;
+    sf::Vector2f size;
+
+    sf::FloatRect getBounds(const TransformComponent& transform) const
+    {
+        return sf::FloatRect(transform.position + offset, size);
+    }
+};
+
+struct SpriteComponent
+{
+    const sf::Texture* texture = nullptr;
+    sf::IntRect textureRect;
+    sf::Vector2f size;
+    sf::Color color = sf::Color::White;
+    std::uint8_t layer = 0;
+    bool visible = true;
+};
+
+// Frames are laid out left to right in one row of the sprite's texture
+struct AnimationComponent
+{
+    sf::Vector2i frameOrigin;
+    sf::Vector2i frameSize;
+    std::uint16_t frameCount = 1;
+    std::uint16_t frame = 0;
+    float fps = 10.0f;
+    float timer = 0;
+    bool loop = true;
+    bool playing = true;
+};
+
+struct PickupComponent
+{
+    PickupType type = PickupType::Coin;
+    bool collected = false;
+    bool remainVisible = false;
+};
+
+// Render-side mirror of a Platform owned by Physics
+struct PlatformComponent
+{
+    PlatformType type = PlatformType::Floating;
+    std::shared_ptr<Platform> platform;
+};
@@ -0,0 +1,11 @@
+#pragma once
+#include <SFML/Graphics.hpp>
+#include <memory>
+#include "ecs/Registry.hpp"
+#include "ecs/Components.hpp"
+
+constexpr std::uint8_t PLATFORM_LAYER = 0;
+constexpr std::uint8_t PICKUP_LAYER = 1;
+
+Entity createPlatformEntity(Registry& registry, const std::shared_ptr<Platform>& platform);
+Entity createPickupEntity(Registry& registry, PickupType type, const sf::Texture& texture, const sf::Vector2f& position);
@@ -0,0 +1,265 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+using Entity = std::uint32_t;
+
+constexpr Entity NULL_ENTITY = 0xFFFFFFFF;
+
+class ComponentPoolBase
+{
+public:
+    virtual ~ComponentPoolBase() = default;
+
+    virtual void remove(Entity entity) = 0;
+    virtual void clear() = 0;
+    virtual std::unique_ptr<ComponentPoolBase> clone() const = 0;
+};
+
+// Sparse set: components live packed in `dense`, `sparse` maps an entity to
+// its slot. Iteration only touches the packed arrays.
+template <typename T>
+class ComponentPool : public ComponentPoolBase
+{
+public:
+    T& add(Entity entity, T component)
+    {
+        if (entity >= sparse.size())
+            sparse.resize(entity + 1, INVALID_INDEX);
+
+        if (sparse[entity] != INVALID_INDEX)
+        {
+            dense[sparse[entity]] = std::move(component);
+            return dense[sparse[entity]];
+        }
+
+        sparse[entity] = static_cast<std::uint32_t>(dense.size());
+        denseEntities.push_back(entity);
+        dense.push_back(std::move(component));
+        return dense.back();
+    }
+
+    bool has(Entity entity) const
+    {
+        return entity < sparse.size() && sparse[entity] != INVALID_INDEX;
+    }
+
+    T& get(Entity entity) { return dense[sparse[entity]]; }
+    const T& get(Entity entity) const { return dense[sparse[entity]]; }
+
+    T* tryGet(Entity entity) { return has(entity) ? &dense[sparse[entity]] : nullptr; }
+
+    void remove(Entity entity) override
+    {
+        if (!has(entity))
+            return;
+
+        // Swap with the last element to keep the arrays packed
+        std::uint32_t index = sparse[entity];
+        std::uint32_t last = static_cast<std::uint32_t>(dense.size() - 1);
+        if (index != last)
+        {
+            dense[index] = std::move(dense[last]);
+            denseEntities[index] = denseEntities[last];
+            sparse[denseEntities[index]] = index;
+        }
+        dense.pop_back();
+        denseEntities.pop_back();
+        sparse[entity] = INVALID_INDEX;
+    }
+
+    void clear() override
+    {
+        sparse.clear();
+        dense.clear();
+        denseEntities.clear();
+    }
+
+    std::unique_ptr<ComponentPoolBase> clone() const override
+    {
+        return std::make_unique<ComponentPool<T>>(*this);
+    }
+
+    std::size_t size() const { return dense.size(); }
+    Entity entityAt(std::size_t index) const { return denseEntities[index]; }
+    T& at(std::size_t index) { return dense[index]; }
+    const T& at(std::size_t index) const { return dense[index]; }
+
+    std::vector<T>& components() { return dense; }
+    const std::vector<Entity>& entities() const { return denseEntities; }
+
+private:
+    static constexpr std::uint32_t INVALID_INDEX = 0xFFFFFFFF;
+
+    std::vector<std::uint32_t> sparse;
+    std::vector<Entity> denseEntities;
+    std::vector<T> dense;
+};
+
+inline std::size_t nextComponentTypeId()
+{
+    static std::atomic<std::size_t> counter{0};
+    return counter++;
+}
+
+template <typename T>
+std::size_t componentTypeId()
+{
+    static const std::size_t id = nextComponentTypeId();
+    return id;
+}
+
+// Owns entities and one pool per component type. Copying a registry deep
+// copies every pool, which is how whole worlds get cloned.
+class Registry
+{
+public:
+    Registry() = default;
+
+    Registry(const Registry& other)
+        : freeEntities(other.freeEntities), alive(other.alive)
+    {
+        copyPools(other);
+    }
+
+    Registry& operator=(const Registry& other)
+    {
+        if (this != &other)
+        {
+            freeEntities = other.freeEntities;
+            alive = other.alive;
+            copyPools(other);
+        }
+        return *this;
+    }
+
+    Registry(Registry&&) = default;
+    Registry& operator=(Registry&&) = default;
+
+    Entity create()
+    {
+        if (!freeEntities.empty())
+        {
+            Entity entity = freeEntities.back();
+            freeEntities.pop_back();
+            alive[entity] = true;
+            return entity;
+        }
+
+        alive.push_back(true);
+        return static_cast<Entity>(alive.size() - 1);
+    }
+
+    void destroy(Entity entity)
+    {
+        if (!isAlive(entity))
+            return;
+
+        for (auto& pool : pools)
+        {
+            if (pool)
+                pool->remove(entity);
+        }
+        alive[entity] = false;
+        freeEntities.push_back(entity);
+    }
+
+    bool isAlive(Entity entity) const
+    {
+        return entity < alive.size() && alive[entity];
+    }
+
+    std::size_t getEntityCount() const
+    {
+        return alive.size() - freeEntities.size();
+    }
+
+    void clear()
+    {
+        for (auto& pool : pools)
+        {
+            if (pool)
+                pool->clear();
+        }
+        alive.clear();
+        freeEntities.clear();
+    }
+
+    template <typename T>
+    T& add(Entity entity, T component = T())
+    {
+        return pool<T>().add(entity, std::move(component));
+    }
+
+    template <typename T>
+    void remove(Entity entity)
+    {
+        pool<T>().remove(entity);
+    }
+
+    template <typename T>
+    bool has(Entity entity)
+    {
+        return pool<T>().has(entity);
+    }
+
+    template <typename T>
+    T& get(Entity entity)
+    {
+        return pool<T>().get(entity);
+    }
+
+    template <typename T>
+    T* tryGet(Entity entity)
+    {
+        return pool<T>().tryGet(entity);
+    }
+
+    template <typename T>
+    ComponentPool<T>& pool()
+    {
+        std::size_t id = componentTypeId<T>();
+        if (id >= pools.size())
+            pools.resize(id + 1);
+
+        if (!pools[id])
+            pools[id] = std::make_unique<ComponentPool<T>>();
+
+        return static_cast<ComponentPool<T>&>(*pools[id]);
+    }
+
+    // Calls func(entity, first, rest...) for every entity that has all the
+    // listed components, walking the packed array of the first one
+    template <typename First, typename... Rest, typename Func>
+    void each(Func&& func)
+    {
+        ComponentPool<First>& firstPool = pool<First>();
+        for (std::size_t i = 0; i < firstPool.size(); ++i)
+        {
+            Entity entity = firstPool.entityAt(i);
+            if ((pool<Rest>().has(entity) && ...))
+            {
+                func(entity, firstPool.at(i), pool<Rest>().get(entity)...);
+            }
+        }
+    }
+
+private:
+    std::vector<std::unique_ptr<ComponentPoolBase>> pools;
+    std::vector<Entity> freeEntities;
+    std::vector<bool> alive;
+
+    void copyPools(const Registry& other)
+    {
+        pools.clear();
+        pools.resize(other.pools.size());
+        for (std::size_t i = 0; i < other.pools.size(); ++i)
+        {
+            if (other.pools[i])
+                pools[i] = other.pools[i]->clone();
+        }
+    }
+};
@@ -0,0 +1,67 @@
+#pragma once
+#include <SFML/Graphics.hpp>
+#include <vector>
+#include "ecs/Registry.hpp"
+#include "ecs/Components.hpp"
+
+class Physics;
+
+struct PickupEvent
+{
+    Entity entity;
+    PickupType type;
+    sf::Vector2f position;
+    // Middle of the pickup's box
+    sf::Vector2f center;
+};
+
+// Gravity, integration and platform collisions for every entity that has a
+// transform, a velocity and a box
+class MovementSystem
+{
+public:
+    void update(Registry& registry, Physics& physics, const sf::Time& elapsed);
+};
+
+// Copies kinematic platform positions and crumble state into their sprites
+class PlatformSystem
+{
+public:
+    void update(Registry& registry);
+};
+
+class PickupSystem
+{
+public:
+    // Marks every pickup overlapping bounds as collected and reports it
+    void collect(Registry& registry, const sf::FloatRect& bounds, std::vector<PickupEvent>& events);
+};
+
+class AnimationSystem
+{
+public:
+    void update(Registry& registry, const sf::Time& elapsed);
+};
+
+// Turns every visible sprite into quads, one vertex array per layer and
+// texture, so a whole level draws in a handful of calls
+class RenderSystem
+{
+public:
+    void build(Registry& registry);
+    void draw(sf::RenderTarget& target) const;
+    
+    std::size_t getBatchCount() const;
+
+private:
+    struct Batch
+    {
+        const sf::Texture* texture;
+        std::uint8_t layer;
+        sf::VertexArray vertices;
+    };
+
+    std::vector<Batch> batches;
+
+    Batch& findBatch(const sf::Texture* texture, std::uint8_t layer);
+};
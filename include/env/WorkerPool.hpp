@@ -0,0 +1,54 @@
+#pragma once
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Splits a range into one contiguous slice per thread and runs a job over
+// all slices, the calling thread taking the first. The threads live as long
+// as the pool, so running a job allocates nothing and starts no thread.
+class WorkerPool
+{
+public:
+    // 0 picks the hardware thread count
+    explicit WorkerPool(unsigned threadCount);
+    ~WorkerPool();
+
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+
+    // Calls job(begin, end) once per slice of [0, count) and returns when all
+    // slices are done
+    template <typename Job>
+    void run(std::size_t count, Job& job)
+    {
+        dispatch(count, [](void* context, std::size_t begin, std::size_t end)
+        {
+            (*static_cast<Job*>(context))(begin, end);
+        }, &job);
+    }
+
+    unsigned getThreadCount() const { return static_cast<unsigned>(threads.size()) + 1; }
+
+private:
+    using Task = void (*)(void* context, std::size_t begin, std::size_t end);
+
+    std::vector<std::thread> threads;
+    std::mutex mutex;
+    std::condition_variable workReady;
+    std::condition_variable workDone;
+
+    // Guarded by mutex
+    std::uint64_t generation;
+    std::size_t pending;
+    bool stopping;
+    Task task;
+    void* context;
+    std::size_t count;
+
+    void dispatch(std::size_t count_, Task task_, void* context_);
+    void runSlice(std::size_t slice) const;
+    void workerLoop(std::size_t slice);
+};
@@ -0,0 +1,41 @@
+#pragma once
+#include <SFML/Graphics.hpp>
+#include <cstdint>
+#include <vector>
+#include "core/MapParser.hpp"
+#include "core/Simulation.hpp"
+#include "env/WorkerPool.hpp"
+
+// Many copies of one level stepped together, behind the hookleap_env C API.
+//
+// The worlds are the game's Simulation, so an agent learns the exact game,
+// and they share the level's static platforms like any other copies. Worlds
+// sit next to each other in one vector and every thread steps one contiguous
+// run of them. Buffers are laid out field by field as hookleap_env.h
+// describes; events are reused per world, so stepping does not allocate.
+class WorldBatch
+{
+public:
+    WorldBatch(const MapData& map, std::size_t worldCount, unsigned threadCount, float tickTime);
+
+    // mask may be null for every world
+    void reset(const std::uint8_t* mask);
+    void step(const std::uint16_t* buttons, const float* aim, std::uint8_t* events);
+    void observe(float* observations);
+
+    std::size_t getWorldCount() const { return worlds.size(); }
+    float getTickTime() const { return tickTime; }
+
+private:
+    // Outlives every Simulation, they point at it
+    sf::Texture emptyTexture;
+    Simulation start;
+    std::vector<Simulation> worlds;
+    std::vector<SimulationEvents> worldEvents;
+    std::vector<std::uint16_t> previousButtons;
+    float tickTime;
+    WorkerPool workers;
+
+    void stepWorld(std::size_t world, const std::uint16_t* buttons, const float* aim, std::uint8_t* events);
+    void observeWorld(std::size_t world, float* observations) const;
+};
@@ -0,0 +1,116 @@
+#pragma once
+#include <stdint.h>
+
+/*
+ * C interface to a batch of independent HookLeap worlds, for training agents.
+ *
+ * Every world is the game's own Simulation of one map, stepped at the race
+ * tick. A step takes one input per world and steps all of them on the
+ * library's worker threads. Inputs, events and observations pass through
+ * buffers the caller owns, laid out field by field (structure of arrays).
+ * Worlds reuse their buffers, so once each has fired its hook a step no
+ * longer allocates; a reset copies the level again.
+ *
+ *   HookLeapEnv* env = hookleap_env_create("assets/maps/map1.txt", 1024, 0);
+ *   hookleap_env_reset(env, NULL);
+ *   hookleap_env_step(env, buttons, aim, events);
+ *   hookleap_env_observe(env, observations);
+ *   hookleap_env_destroy(env);
+ */
+
+#if defined(_WIN32)
+#if defined(HOOKLEAP_ENV_BUILD)
+#define HOOKLEAP_ENV_API __declspec(dllexport)
+#else
+#define HOOKLEAP_ENV_API __declspec(dllimport)
+#endif
+#else
+#define HOOKLEAP_ENV_API __attribute__((visibility("default")))
+#endif
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/* Buttons held during a step, one uint16_t per world */
+enum
+{
+    HOOKLEAP_BUTTON_LEFT = 1 << 0,
+    HOOKLEAP_BUTTON_RIGHT = 1 << 1,
+    HOOKLEAP_BUTTON_JUMP = 1 << 2,
+    HOOKLEAP_BUTTON_HOOK = 1 << 3,
+    HOOKLEAP_BUTTON_RELEASE = 1 << 4
+};
+
+/* What happened to a world during a step, one uint8_t per world */
+enum
+{
+    HOOKLEAP_EVENT_WON = 1 << 0,
+    HOOKLEAP_EVENT_DIED = 1 << 1,
+    HOOKLEAP_EVENT_COIN = 1 << 2,
+    HOOKLEAP_EVENT_CHECKPOINT = 1 << 3,
+    HOOKLEAP_EVENT_HOOK_ATTACHED = 1 << 4
+};
+
+/* Observation fields. Field f of world w is observations[f * world_count + w]. */
+enum
+{
+    /* Centre of the player's hitbox, in pixels, y down */
+    HOOKLEAP_OBS_X,
+    HOOKLEAP_OBS_Y,
+    /* Pixels a second */
+    HOOKLEAP_OBS_VELOCITY_X,
+    HOOKLEAP_OBS_VELOCITY_Y,
+    HOOKLEAP_OBS_ON_GROUND,
+    /* 0 inactive, 1 flying, 2 attached, 3 breaking */
+    HOOKLEAP_OBS_HOOK_STATE,
+    /* Where the hook is, or where it holds */
+    HOOKLEAP_OBS_HOOK_X,
+    HOOKLEAP_OBS_HOOK_Y,
+    HOOKLEAP_OBS_SCORE,
+    HOOKLEAP_OBS_DEATHS,
+    /* Level time in seconds */
+    HOOKLEAP_OBS_TIME,
+    /* Where the player respawns */
+    HOOKLEAP_OBS_CHECKPOINT_X,
+    HOOKLEAP_OBS_CHECKPOINT_Y,
+    HOOKLEAP_OBSERVATION_SIZE
+};
+
+typedef struct HookLeapEnv HookLeapEnv;
+
+/*
+ * Loads a map file and makes world_count copies of its level, all at the
+ * spawn point. thread_count 0 uses one thread per core. Returns NULL on
+ * failure, see hookleap_env_last_error().
+ */
+HOOKLEAP_ENV_API HookLeapEnv* hookleap_env_create(const char* map_path, uint32_t world_count, uint32_t thread_count);
+HOOKLEAP_ENV_API void hookleap_env_destroy(HookLeapEnv* env);
+
+HOOKLEAP_ENV_API uint32_t hookleap_env_world_count(const HookLeapEnv* env);
+/* Seconds one step simulates */
+HOOKLEAP_ENV_API float hookleap_env_tick_time(const HookLeapEnv* env);
+
+/* Puts worlds back at the start of the level: those whose mask byte is not
+ * zero, or all of them when mask is NULL */
+HOOKLEAP_ENV_API void hookleap_env_reset(HookLeapEnv* env, const uint8_t* mask);
+
+/*
+ * Steps every world once.
+ *   buttons  world_count HOOKLEAP_BUTTON_* masks
+ *   aim      2 * world_count floats, all x then all y, where the hook is
+ *            fired at in level pixels; NULL aims straight up
+ *   events   world_count HOOKLEAP_EVENT_* masks written back, or NULL
+ */
+HOOKLEAP_ENV_API void hookleap_env_step(HookLeapEnv* env, const uint16_t* buttons, const float* aim, uint8_t* events);
+
+/* Writes HOOKLEAP_OBSERVATION_SIZE * world_count floats */
+HOOKLEAP_ENV_API void hookleap_env_observe(const HookLeapEnv* env, float* observations);
+
+/* Why the last hookleap_env_create on this thread failed */
+HOOKLEAP_ENV_API const char* hookleap_env_last_error(void);
+
+#ifdef __cplusplus
+}
+#endif
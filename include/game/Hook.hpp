@@ -18,7 +18,7 @@ public:
     
     void shoot(const sf::Vector2f& startPos, const sf::Vector2f& direction);
     void update(const sf::Time& elapsed, const sf::Vector2f& playerPos);
-    bool checkPlatformCollision(std::shared_ptr<Platform> platform, const sf::Vector2f& playerPos);
+    bool checkPlatformCollision(Platform& platform, const sf::Vector2f& playerPos);
     void attach(const sf::Vector2f& attachPoint);
     void release();
     bool shouldBreak(const sf::Vector2f& playerPos) const;
@@ -29,7 +29,11 @@ public:
     float getRopeLength() const { return ropeLength; }
     bool isAttached() const { return state == HookState::Attached; }
     
-    void draw(sf::RenderWindow& window) const;
+    // Moving platform the hook rides on, if any
+    std::shared_ptr<Platform> getAttachedPlatform() const { return attachedPlatform.lock(); }
+    void setAttachedPlatform(const std::shared_ptr<Platform>& platform) { attachedPlatform = platform; }
+    
+    void draw(sf::RenderTarget& target) const;
     
     static constexpr float HOOK_SPEED = 800.0f;
     static constexpr float MAX_ROPE_LENGTH = 400.0f;
@@ -44,4 +48,8 @@ private:
     sf::Vector2f shootDirection;
     float ropeLength;
     float attachTime;
+    
+    // The attach point rides along with a moving platform
+    std::weak_ptr<Platform> attachedPlatform;
+    sf::Vector2f attachOffset;
 };
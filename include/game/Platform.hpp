@@ -1,5 +1,7 @@
 #pragma once
 #include <SFML/Graphics.hpp>
+#include <memory>
+#include <vector>
 
 enum class PlatformType
 {
@@ -8,7 +10,15 @@ enum class PlatformType
     DeathPit
 };
 
-class Platform : public sf::Sprite
+enum class PlatformMotion
+{
+    Static,
+    Linear,
+    Oscillating,
+    Crumbling
+};
+
+class Platform : public sf::Sprite, public std::enable_shared_from_this<Platform>
 {
 public:
     Platform(const sf::Texture& texture, PlatformType type = PlatformType::Floating);
@@ -20,8 +30,46 @@ public:
     void setType(PlatformType type);
     
     bool isDeadly() const;
+    
+    // Moves back and forth along waypoints, starting at the current position
+    void setLinearPath(const std::vector<sf::Vector2f>& waypoints, float speed);
+    // Swings around the current position by amplitude, period in seconds
+    void setOscillation(const sf::Vector2f& amplitude, float period, float phase = 0.0f);
+    // Falls away delay seconds after it is first stood on, back after respawnTime
+    void setCrumbling(float delay, float respawnTime);
+    
+    PlatformMotion getMotion() const { return motion; }
+    bool isKinematic() const { return motion != PlatformMotion::Static; }
+    bool isSolid() const { return solid; }
+    
+    // Advances the motion and returns whether the bounds moved
+    bool updateMotion(float dt);
+    sf::Vector2f getMotionDelta() const { return motionDelta; }
+    
+    // Something is standing on the platform
+    void touch();
 
 private:
     PlatformType platformType;
     sf::Vector2f size;
+    
+    PlatformMotion motion;
+    sf::Vector2f origin;
+    sf::Vector2f motionDelta;
+    bool solid;
+    
+    std::vector<sf::Vector2f> waypoints;
+    std::size_t targetWaypoint;
+    int pathDirection;
+    float speed;
+    
+    sf::Vector2f amplitude;
+    float period;
+    float phase;
+    float motionTime;
+    
+    float crumbleDelay;
+    float respawnTime;
+    float crumbleTimer;
+    bool touched;
 };
@@ -1,8 +1,12 @@
 #pragma once
 #include "game/Character.hpp"
 #include "game/Hook.hpp"
+#include "game/Rope.hpp"
+#include "core/Input.hpp"
 #include <map>
 
+class Physics;
+
 enum class PlayerState
 {
     Idle,
@@ -24,11 +28,11 @@ class Player : public Character
 public:
     Player(const sf::Texture& texture);
     
-    void handleInput(const sf::RenderWindow& window);
+    void handleInput(const InputState& input);
     void jump();
     void animate(const sf::Time &elapsed);
     void updateState();
-    void updateHook(const sf::Time& elapsed, const std::vector<std::shared_ptr<Platform>>& platforms);
+    void updateHook(const sf::Time& elapsed, const Physics& physics);
     
     bool isOnGround() const;
     void setOnGround(bool onGround_);
@@ -41,8 +45,9 @@ public:
     bool isHooked() const { return hook.isAttached(); }
     Hook& getHook() { return hook; }
     const Hook& getHook() const { return hook; }
+    const Rope& getRope() const { return rope; }
     
-    void applySwingPhysics(const sf::Time& elapsed);
+    void applySwingPhysics(const sf::Time& elapsed, const Physics& physics);
     
     void setAnimationRow(PlayerState state, int row, int frameCount, bool shouldLoop = true);
     
@@ -51,11 +56,20 @@ public:
     
     // Force a state change (useful for resets)
     void forceState(PlayerState newState);
+    PlayerState getState() const { return currentState; }
+    Direction getDirection() const { return currentDirection; }
     
     static constexpr float MOVE_SPEED = 200.0f;
     static constexpr float JUMP_FORCE = -500.0f;
     static constexpr float SWING_ACCELERATION = 400.0f;
     static constexpr float MAX_SWING_SPEED = 600.0f;
+    // The hook fires from and the rope pulls on this point of the sprite
+    static constexpr float CENTER_OFFSET = 64.0f;
+    // Collision box within the 128 px sprite
+    static constexpr float HITBOX_LEFT = 54.0f;
+    static constexpr float HITBOX_TOP = 44.0f;
+    static constexpr float HITBOX_WIDTH = 20.0f;
+    static constexpr float HITBOX_HEIGHT = 37.0f;
     
 private:
     int score;
@@ -63,6 +77,9 @@ private:
     bool wasOnGround;
     
     Hook hook;
+    Rope rope;
+    float swingInput;
+    std::vector<Platform*> nearbyPlatforms;
     
     PlayerState currentState;
     Direction currentDirection;
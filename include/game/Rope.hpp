@@ -0,0 +1,87 @@
+#pragma once
+#include <SFML/Graphics.hpp>
+#include <array>
+#include <memory>
+#include <vector>
+#include "game/Platform.hpp"
+
+class Physics;
+
+// Multi-segment position-based rope used by the grappling hook.
+// Point 0 is pinned to the current pivot (the hook anchor or the last corner
+// the rope wrapped around), the last point is the swinging body. The rope
+// steps at Physics::FIXED_TIMESTEP with a capped number of sub-steps per
+// frame, so the cost per tick is bounded by MAX_SUBSTEPS * iterations * segments.
+class Rope
+{
+public:
+    static constexpr int MAX_SEGMENTS = 16;
+    static constexpr int MAX_WRAP_POINTS = 8;
+    static constexpr int MAX_SUBSTEPS = 8;
+    static constexpr int DEFAULT_SEGMENTS = 8;
+    static constexpr int DEFAULT_ITERATIONS = 6;
+    static constexpr float BODY_INVERSE_MASS = 1.0f;
+    static constexpr float SEGMENT_INVERSE_MASS = 20.0f;
+    static constexpr float SEGMENT_DAMPING = 0.98f;
+    static constexpr float MIN_FREE_LENGTH = 4.0f;
+    static constexpr float WRAP_OFFSET = 0.5f;
+
+    Rope(int segmentCount = DEFAULT_SEGMENTS, int iterations = DEFAULT_ITERATIONS);
+
+    void attach(const sf::Vector2f& anchor, const sf::Vector2f& bodyPosition, const sf::Vector2f& bodyVelocity, float maxLength);
+    void release();
+    bool isActive() const { return active; }
+
+    // Advances the rope in fixed sub-steps. bodyPosition/bodyVelocity are the
+    // swinging body's center and velocity, read on entry and written back.
+    void update(const sf::Time& elapsed, sf::Vector2f& bodyPosition, sf::Vector2f& bodyVelocity,
+                float swingAcceleration, const Physics& physics);
+
+    // Moves the anchor, e.g. when the hook is attached to a moving platform
+    void setAnchor(const sf::Vector2f& anchor_);
+
+    void setIterations(int iterations_);
+    void setSegmentCount(int segmentCount_);
+    void setMaxSpeed(float maxSpeed_);
+
+    int getIterations() const { return iterations; }
+    int getSegmentCount() const { return segmentCount; }
+    float getLength() const { return length; }
+    float getFreeLength() const;
+    float getStretch() const;
+
+    sf::Vector2f getAnchor() const { return anchor; }
+    sf::Vector2f getPivot() const;
+    int getWrapCount() const { return wrapCount; }
+    sf::Vector2f getWrapPoint(int index) const { return wraps[index].position; }
+
+    // Free span points, from the pivot (0) to the body (getSegmentCount())
+    sf::Vector2f getPoint(int index) const { return points[index]; }
+
+private:
+    struct WrapPoint
+    {
+        sf::Vector2f position;
+        float side;
+    };
+
+    bool active;
+    int segmentCount;
+    int iterations;
+    float length;
+    float maxSpeed;
+    float accumulator;
+    sf::Vector2f anchor;
+
+    std::array<sf::Vector2f, MAX_SEGMENTS + 1> points;
+    std::array<sf::Vector2f, MAX_SEGMENTS + 1> previousPoints;
+    std::array<WrapPoint, MAX_WRAP_POINTS> wraps;
+    int wrapCount;
+
+    std::vector<Platform*> nearbyPlatforms;
+
+    void step(float dt, sf::Vector2f& bodyVelocity, float swingAcceleration, const Physics& physics);
+    void solveConstraints();
+    void updateWrapping(const sf::Vector2f& previousBody, const Physics& physics);
+    void layoutFreeSpan();
+};
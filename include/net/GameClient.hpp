@@ -0,0 +1,126 @@
+#pragma once
+#include <SFML/Graphics.hpp>
+#include <SFML/Network.hpp>
+#include <array>
+#include <deque>
+#include <memory>
+#include <string>
+#include <vector>
+#include "core/AssetLoader.hpp"
+#include "core/LevelBuilder.hpp"
+#include "core/Simulation.hpp"
+#include "net/NetStats.hpp"
+#include "net/Protocol.hpp"
+
+// One player's side of a race. The local player is predicted: inputs are
+// stepped right away at the server's tick rate and also sent to the server.
+// A second simulation replays only the inputs the server has confirmed; when
+// it disagrees with a snapshot it takes the server's state and the pending
+// inputs are replayed on top of it.
+//
+// Other players are drawn INTERPOLATION_DELAY in the past, between the two
+// snapshots around that time.
+class GameClient
+{
+public:
+    enum class Status
+    {
+        Connecting,
+        Connected,
+        Rejected,
+        Disconnected
+    };
+
+    static constexpr float CONNECT_RETRY = 0.25f;
+    static constexpr float INTERPOLATION_DELAY = 0.1f;
+    // More catch up steps than this in one frame and the rest are dropped
+    static constexpr int MAX_STEPS_PER_UPDATE = 8;
+    static constexpr std::size_t MAX_PENDING_INPUTS = TICK_RATE * 2;
+
+    explicit GameClient(const sf::Texture& characterTexture);
+
+    bool connect(const sf::IpAddress& address, unsigned short port = DEFAULT_PORT);
+    void disconnect();
+
+    Status getStatus() const { return status; }
+    // Why the server refused us or why the connection ended
+    const std::string& getError() const { return error; }
+    const std::string& getMapFile() const { return mapFile; }
+    std::uint64_t getMapHash() const { return mapHash; }
+    std::uint8_t getPlayerId() const { return playerId; }
+
+    // Reads the map the server announced. Fails if it is missing or is not
+    // the same file the server has.
+    bool readLevel(const AssetLoader& assets, MapData& map);
+    void buildLevel(const LevelBuilder& builder, const MapData& map);
+    bool isLevelLoaded() const { return predicted != nullptr; }
+
+    // Reads the network, then runs as many fixed ticks as elapsed covers.
+    // Presses and releases between two ticks are kept for the next one.
+    void update(const InputState& input, const sf::Time& elapsed);
+
+    Simulation& getPredicted() { return *predicted; }
+    // The server saw our player reach the win pickup
+    bool hasFinished() const { return finished; }
+
+    // Interpolated states of everyone else, for drawing
+    void getRemotePlayers(std::vector<NetPlayerState>& players) const;
+
+    const NetStats& getStats() const { return stats; }
+
+private:
+    struct PendingInput
+    {
+        std::uint32_t sequence;
+        InputState input;
+    };
+
+    struct ReceivedSnapshot
+    {
+        std::uint32_t sequence = 0;
+        float time = 0;
+        std::vector<NetPlayerState> states;
+    };
+
+    const sf::Texture& characterTexture;
+
+    sf::UdpSocket socket;
+    sf::IpAddress serverAddress;
+    unsigned short serverPort;
+
+    Status status;
+    std::string error;
+    std::string mapFile;
+    std::uint64_t mapHash;
+    std::uint8_t playerId;
+
+    std::unique_ptr<Simulation> predicted;
+    std::unique_ptr<Simulation> confirmed;
+    std::deque<PendingInput> pending;
+    std::uint32_t inputSequence;
+    InputState nextInput;
+    sf::Time accumulator;
+    bool finished;
+
+    std::array<ReceivedSnapshot, SNAPSHOT_HISTORY> history;
+    std::uint32_t newestSnapshot;
+
+    sf::Clock clock;
+    sf::Clock lastSent;
+    sf::Clock lastHeard;
+
+    ByteWriter writer;
+    std::array<std::uint8_t, MAX_PACKET_SIZE> buffer;
+    NetStats stats;
+
+    void receive();
+    void handleAccept(ByteReader& reader);
+    void handleSnapshot(ByteReader& reader);
+    void reconcile(const NetPlayerState& server, std::uint32_t lastAppliedInput);
+
+    void step();
+    void sendConnect();
+    void sendInputs();
+    void send();
+    std::uint32_t now() const;
+};
@@ -0,0 +1,115 @@
+#pragma once
+#include <SFML/Graphics.hpp>
+#include <SFML/Network.hpp>
+#include <array>
+#include <atomic>
+#include <deque>
+#include <memory>
+#include <string>
+#include <vector>
+#include "core/AssetLoader.hpp"
+#include "core/LevelBuilder.hpp"
+#include "core/Simulation.hpp"
+#include "net/NetStats.hpp"
+#include "net/Protocol.hpp"
+
+// Authoritative host of one race. Players race the same level without
+// touching each other, so every client gets its own Simulation, stepped once
+// per input it sends, and every snapshot carries all players so each client
+// can draw the others.
+//
+// Runs headless: the level is built with empty textures and LevelBuilder's
+// fixed collision sizes.
+class GameServer
+{
+public:
+    // Steps one client may catch up in a tick after its inputs bunched up
+    static constexpr std::size_t MAX_STEPS_PER_TICK = 4;
+    static constexpr std::size_t MAX_QUEUED_INPUTS = TICK_RATE;
+
+    GameServer();
+
+    bool loadLevel(const AssetLoader& assets, const std::string& mapFile);
+    // For many servers on one map, parsed and hashed once
+    void setLevel(const std::string& mapFile, const MapData& map, std::uint64_t mapHash);
+    // Port 0 picks a free one
+    bool listen(unsigned short port = DEFAULT_PORT);
+    unsigned short getPort() const { return socket.getLocalPort(); }
+
+    // One fixed tick: receive() then update()
+    void tick();
+    // Reads every waiting packet; inputs are queued for the next update
+    void receive();
+    // Steps the players and sends snapshots on every SNAPSHOT_INTERVAL-th tick
+    void update();
+    // Ticks at TICK_RATE until running turns false, then says goodbye
+    void run(const std::atomic<bool>& running);
+    void disconnectAll();
+
+    std::size_t getClientCount() const { return clients.size(); }
+    const NetStats& getStats() const { return stats; }
+    // For waiting on many servers with one sf::SocketSelector
+    sf::UdpSocket& getSocket() { return socket; }
+
+private:
+    struct SentSnapshot
+    {
+        std::uint32_t sequence = 0;
+        std::vector<NetPlayerState> states;
+    };
+
+    struct QueuedInput
+    {
+        std::uint32_t sequence;
+        InputState input;
+    };
+
+    struct Client
+    {
+        sf::IpAddress address = sf::IpAddress::Any;
+        unsigned short port = 0;
+        std::uint8_t id = 0;
+        std::unique_ptr<Simulation> simulation;
+        bool finished = false;
+
+        // Received but not yet stepped, in sequence order. lastAppliedInput
+        // is the sequence of the last one stepped, which the client replays from.
+        std::deque<QueuedInput> inputs;
+        std::uint32_t lastQueuedInput = 0;
+        std::uint32_t lastAppliedInput = 0;
+
+        std::uint32_t ackedSnapshot = 0;
+        std::uint32_t snapshotSequence = 0;
+        std::array<SentSnapshot, SNAPSHOT_HISTORY> history;
+
+        // Echoed back with the time it waited here, for the client's RTT
+        std::uint32_t clientTime = 0;
+        sf::Clock clientTimeAge;
+        sf::Clock lastHeard;
+    };
+
+    sf::UdpSocket socket;
+    sf::Texture emptyTexture;
+    LevelBuilder builder;
+
+    std::string mapFile;
+    std::uint64_t mapHash;
+    MapData map;
+
+    std::vector<Client> clients;
+    std::uint32_t tickCount;
+
+    ByteWriter writer;
+    std::array<std::uint8_t, MAX_PACKET_SIZE> buffer;
+    std::vector<NetPlayerState> states;
+    NetStats stats;
+
+    void handleConnect(const sf::IpAddress& address, unsigned short port);
+    void handleInput(Client& client, ByteReader& reader);
+    void stepClients();
+    void sendSnapshots();
+    void dropSilentClients();
+
+    Client* findClient(const sf::IpAddress& address, unsigned short port);
+    void send(const sf::IpAddress& address, unsigned short port);
+};
@@ -0,0 +1,42 @@
+#pragma once
+#include <SFML/System.hpp>
+#include <cstddef>
+#include <cstdint>
+
+// Traffic and latency of one connection, averaged over one second windows
+// for the on screen readout
+class NetStats
+{
+public:
+    NetStats();
+
+    void addSent(std::size_t bytes);
+    void addReceived(std::size_t bytes);
+    void addRoundTrip(float milliseconds);
+    // Gaps in the sequence count as lost snapshots
+    void addSnapshot(std::uint32_t sequence);
+    void addCorrection() { ++corrections; }
+
+    // Closes the window once a second has passed
+    void update();
+
+    float getSentPerSecond() const { return sentPerSecond; }
+    float getReceivedPerSecond() const { return receivedPerSecond; }
+    float getRoundTrip() const { return roundTrip; }
+    float getSnapshotLoss() const { return snapshotLoss; }
+    std::uint32_t getCorrections() const { return corrections; }
+
+private:
+    sf::Clock window;
+    std::size_t sentBytes;
+    std::size_t receivedBytes;
+    std::uint32_t snapshotsReceived;
+    std::uint32_t snapshotsLost;
+    std::uint32_t lastSnapshot;
+
+    float sentPerSecond;
+    float receivedPerSecond;
+    float roundTrip;
+    float snapshotLoss;
+    std::uint32_t corrections;
+};
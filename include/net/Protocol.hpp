@@ -0,0 +1,118 @@
+#pragma once
+#include <SFML/System.hpp>
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "core/ByteStream.hpp"
+#include "core/Input.hpp"
+#include "core/Simulation.hpp"
+
+// Wire format of race mode. Every datagram starts with PROTOCOL_ID and a
+// MessageType:
+//   Connect     client -> server, resent until answered
+//   Accept      player id, map file, map hash
+//   Reject      reason
+//   Input       acked snapshot, client time, newest input sequence and the
+//               last few inputs so one lost packet loses nothing
+//   Snapshot    sequence, baseline, last input applied, echoed client time,
+//               then every player delta coded against the baseline
+//   Disconnect  either side, best effort
+
+static constexpr std::uint32_t PROTOCOL_ID = 0x484C5231; // "HLR1"
+static constexpr unsigned short DEFAULT_PORT = 47820;
+static constexpr int TICK_RATE = 60;
+static constexpr std::size_t MAX_PLAYERS = 8;
+static constexpr std::size_t MAX_PACKET_SIZE = 1200;
+
+// Inputs repeated in each Input packet
+static constexpr std::size_t INPUT_REDUNDANCY = 8;
+// Server ticks between two snapshots
+static constexpr int SNAPSHOT_INTERVAL = 2;
+// Snapshots kept on both sides as delta baselines
+static constexpr std::size_t SNAPSHOT_HISTORY = 64;
+static constexpr float CONNECTION_TIMEOUT = 5.0f;
+
+// Positions and velocities travel in 1/16 pixel units
+static constexpr float POSITION_SCALE = 16.0f;
+
+enum class MessageType : std::uint8_t
+{
+    Connect,
+    Accept,
+    Reject,
+    Input,
+    Snapshot,
+    Disconnect
+};
+
+inline sf::Time tickTime() { return sf::seconds(1.0f / TICK_RATE); }
+
+void writeHeader(ByteWriter& writer, MessageType type);
+bool readHeader(ByteReader& reader, MessageType& type);
+
+// Rounds the aim to what survives the wire. The client predicts with the
+// rounded input so it steps exactly what the server will.
+InputState quantizeInput(const InputState& input);
+void writeInput(ByteWriter& writer, const InputState& input);
+InputState readInput(ByteReader& reader);
+
+enum class StateField : std::uint8_t
+{
+    PositionX,
+    PositionY,
+    VelocityX,
+    VelocityY,
+    State,
+    // onGround in bit 0, HookState in bits 1-2
+    Flags,
+    FacingLeft,
+    FrameX,
+    FrameY,
+    // Attach point while hooked, the flying hook otherwise
+    HookX,
+    HookY,
+    CheckpointX,
+    CheckpointY,
+    Score,
+    Deaths,
+    TimeMs,
+    Finished,
+    Count
+};
+
+static constexpr std::size_t STATE_FIELD_COUNT = static_cast<std::size_t>(StateField::Count);
+
+// One player as the server sees it, already quantized. Delta coding works
+// field by field on these integers.
+struct NetPlayerState
+{
+    std::uint8_t id = 0;
+    std::array<std::int32_t, STATE_FIELD_COUNT> fields = {};
+
+    std::int32_t get(StateField field) const { return fields[static_cast<std::size_t>(field)]; }
+    void set(StateField field, std::int32_t value) { fields[static_cast<std::size_t>(field)] = value; }
+
+    sf::Vector2f getPosition() const;
+    sf::Vector2f getHookPoint() const;
+    HookState getHookState() const;
+    bool isOnGround() const;
+};
+
+NetPlayerState captureState(const Simulation& simulation, std::uint8_t id);
+
+// Puts the simulation where the server says it is. The rope is rebuilt from
+// the attach point, so wrapped corners are lost until the next wrap.
+void applyState(Simulation& simulation, const NetPlayerState& state);
+
+// Whether a prediction is close enough to the server to keep. Animation
+// frames and facing are cosmetic and never force a correction.
+bool statesMatch(const NetPlayerState& predicted, const NetPlayerState& server);
+
+// Each player is its id, a mask of the fields that differ from the baseline
+// and the zigzag varint difference of each of those. Players missing from
+// the baseline are coded against zero.
+void writeStates(ByteWriter& writer, const std::vector<NetPlayerState>& states,
+                 const std::vector<NetPlayerState>* baseline);
+bool readStates(ByteReader& reader, const std::vector<NetPlayerState>* baseline,
+                std::vector<NetPlayerState>& states);
@@ -0,0 +1,118 @@
+#include "core/AssetLoader.hpp"
+#include "core/Hash.hpp"
+#include "core/Telemetry.hpp"
+#include <algorithm>
+#include <filesystem>
+
+AssetLoader::AssetLoader()
+    : directory(ASSET_DIRECTORY)
+{
+}
+
+void AssetLoader::open(const std::string& packPath, const std::string& directory_)
+{
+    directory = directory_;
+    pack.close();
+
+    std::error_code error;
+    if (!std::filesystem::exists(packPath, error))
+        return;
+
+    if (pack.open(packPath))
+    {
+        LogLine(LogLevel::Info) << "Loaded " << pack.getEntryCount() << " assets from " << packPath;
+    }
+    else
+    {
+        LogLine(LogLevel::Error) << "Could not open " << packPath << ", using " << directory << "/";
+    }
+}
+
+bool AssetLoader::read(const std::string& name, AssetData& data) const
+{
+    if (isPacked())
+        return pack.find(name, data.view);
+
+    if (!data.file.open(directory + "/" + name))
+        return false;
+
+    data.view = data.file.getView();
+    return true;
+}
+
+std::vector<std::string> AssetLoader::list(const std::string& directoryName) const
+{
+    std::vector<std::string> names;
+    std::string prefix = directoryName + "/";
+    if (isPacked())
+    {
+        pack.list(prefix, names);
+        // Only direct children, like the directory listing
+        names.erase(std::remove_if(names.begin(), names.end(),
+                                   [&](const std::string& name) { return name.find('/', prefix.size()) != std::string::npos; }),
+                    names.end());
+    }
+    else
+    {
+        std::error_code error;
+        for (std::filesystem::directory_iterator it(directory + "/" + directoryName, error), end; !error && it != end; it.increment(error))
+        {
+            if (it->is_regular_file(error))
+                names.push_back(prefix + it->path().filename().generic_string());
+        }
+    }
+
+    std::sort(names.begin(), names.end());
+    return names;
+}
+
+bool AssetLoader::readMap(const std::string& mapFile, MapData& map, std::uint64_t& hash) const
+{
+    AssetData file;
+    if (!read("maps/" + mapFile, file))
+    {
+        LogLine(LogLevel::Error) << "Failed to open map file: " << mapFile;
+        return false;
+    }
+
+    hash = contentHash(file.getView());
+
+    MapParser parser;
+    bool valid = parser.parse(file.getView(), map);
+    for (const auto& error : parser.getErrors())
+    {
+        LogLine(LogLevel::Warning) << mapFile << ":" << error.line << ":" << error.column << ": " << error.message;
+    }
+    return valid;
+}
+
+bool AssetLoader::loadTexture(sf::Texture& texture, const std::string& name) const
+{
+    AssetData data;
+    if (!read(name, data))
+        return false;
+
+    std::string_view bytes = data.getView();
+    std::uint64_t hash = contentHash(bytes);
+    if (textureCache.load(name, hash, texture))
+        return true;
+
+    sf::Image image;
+    if (!image.loadFromMemory(bytes.data(), bytes.size()) || !texture.loadFromImage(image))
+        return false;
+
+    textureCache.store(name, hash, image);
+    return true;
+}
+
+bool AssetLoader::loadFont(sf::Font& font, const std::string& name) const
+{
+    if (!isPacked())
+        return font.openFromFile(directory + "/" + name);
+
+    std::string_view data;
+    if (!pack.find(name, data))
+        return false;
+
+    return font.openFromMemory(data.data(), data.size());
+}
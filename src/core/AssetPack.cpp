@@ -0,0 +1,137 @@
+#include "core/AssetPack.hpp"
+#include "core/Telemetry.hpp"
+#include <cstring>
+
+namespace
+{
+    // Magic, version and entry count
+    constexpr std::size_t HEADER_SIZE = 12;
+    // Offset, length and name length of an entry with an empty name
+    constexpr std::size_t MIN_ENTRY_SIZE = 20;
+
+    // Reads little endian integers and refuses to run past the end
+    class Reader
+    {
+    public:
+        Reader(const char* data, std::size_t size)
+            : data(reinterpret_cast<const unsigned char*>(data)), size(size), offset(0)
+        {
+        }
+
+        bool read(std::uint64_t& value, std::size_t bytes)
+        {
+            if (size - offset < bytes)
+                return false;
+
+            value = 0;
+            for (std::size_t i = 0; i < bytes; ++i)
+            {
+                value |= static_cast<std::uint64_t>(data[offset + i]) << (i * 8);
+            }
+            offset += bytes;
+            return true;
+        }
+
+        bool skip(std::size_t bytes, const char*& start)
+        {
+            if (size - offset < bytes)
+                return false;
+
+            start = reinterpret_cast<const char*>(data + offset);
+            offset += bytes;
+            return true;
+        }
+
+    private:
+        const unsigned char* data;
+        std::size_t size;
+        std::size_t offset;
+    };
+}
+
+bool AssetPack::open(const std::string& path)
+{
+    close();
+
+    if (!file.open(path))
+        return false;
+
+    const char* data = file.getData();
+    std::size_t size = file.getSize();
+    Reader reader(data, size);
+
+    const char* magic = nullptr;
+    std::uint64_t version = 0;
+    std::uint64_t count = 0;
+    if (!reader.skip(sizeof(MAGIC), magic) || std::memcmp(magic, MAGIC, sizeof(MAGIC)) != 0 ||
+        !reader.read(version, 4) || !reader.read(count, 4))
+    {
+        LogLine(LogLevel::Warning) << "Not an asset pack: " << path;
+        close();
+        return false;
+    }
+
+    if (version != VERSION)
+    {
+        LogLine(LogLevel::Warning) << "Asset pack " << path << " has version " << version << ", expected " << VERSION;
+        close();
+        return false;
+    }
+
+    // Every entry takes at least its offset, length and name length, so a
+    // count the file cannot hold is damage, not a reason to allocate
+    if (count > (size - HEADER_SIZE) / MIN_ENTRY_SIZE)
+    {
+        LogLine(LogLevel::Error) << "Asset pack " << path << " is truncated or corrupt";
+        close();
+        return false;
+    }
+
+    entries.reserve(static_cast<std::size_t>(count));
+    for (std::uint64_t i = 0; i < count; ++i)
+    {
+        std::uint64_t offset = 0;
+        std::uint64_t length = 0;
+        std::uint64_t nameLength = 0;
+        const char* name = nullptr;
+
+        if (!reader.read(offset, 8) || !reader.read(length, 8) || !reader.read(nameLength, 4) ||
+            !reader.skip(static_cast<std::size_t>(nameLength), name) ||
+            offset > size || length > size - offset)
+        {
+            LogLine(LogLevel::Error) << "Asset pack " << path << " is truncated or corrupt";
+            close();
+            return false;
+        }
+
+        entries.emplace(std::string(name, static_cast<std::size_t>(nameLength)),
+                        std::string_view(data + offset, static_cast<std::size_t>(length)));
+    }
+
+    return true;
+}
+
+void AssetPack::close()
+{
+    entries.clear();
+    file.close();
+}
+
+bool AssetPack::find(const std::string& name, std::string_view& data) const
+{
+    auto it = entries.find(name);
+    if (it == entries.end())
+        return false;
+
+    data = it->second;
+    return true;
+}
+
+void AssetPack::list(const std::string& prefix, std::vector<std::string>& names) const
+{
+    for (const auto& [name, data] : entries)
+    {
+        if (name.compare(0, prefix.size(), prefix) == 0)
+            names.push_back(name);
+    }
+}
@@ -0,0 +1,137 @@
+#include "core/AssetWatcher.hpp"
+#include "core/Telemetry.hpp"
+#include <algorithm>
+
+#ifdef __linux__
+#include <sys/inotify.h>
+#include <unistd.h>
+#include <cerrno>
+#endif
+
+#ifdef __linux__
+
+AssetWatcher::AssetWatcher()
+    : descriptor(inotify_init1(IN_NONBLOCK | IN_CLOEXEC))
+{
+    if (descriptor < 0)
+    {
+        LogLine(LogLevel::Error) << "Could not start inotify, asset hot reload is off";
+    }
+}
+
+AssetWatcher::~AssetWatcher()
+{
+    if (descriptor >= 0)
+        ::close(descriptor);
+}
+
+bool AssetWatcher::watch(const std::string& directory)
+{
+    if (descriptor < 0)
+        return false;
+
+    // Editors either write in place or write a temp file and rename it over
+    int handle = inotify_add_watch(descriptor, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO);
+    if (handle < 0)
+    {
+        LogLine(LogLevel::Error) << "Could not watch " << directory;
+        return false;
+    }
+
+    directories[handle] = directory;
+    return true;
+}
+
+void AssetWatcher::poll(std::vector<std::string>& changed)
+{
+    if (descriptor < 0)
+        return;
+
+    std::size_t first = changed.size();
+    alignas(inotify_event) char buffer[4096];
+
+    while (true)
+    {
+        ssize_t length = ::read(descriptor, buffer, sizeof(buffer));
+        if (length <= 0)
+            break;
+
+        for (char* cursor = buffer; cursor < buffer + length; )
+        {
+            const inotify_event* event = reinterpret_cast<const inotify_event*>(cursor);
+            cursor += sizeof(inotify_event) + event->len;
+
+            auto directory = directories.find(event->wd);
+            if (directory == directories.end() || event->len == 0)
+                continue;
+
+            std::string path = directory->second + "/" + event->name;
+            if (std::find(changed.begin() + first, changed.end(), path) == changed.end())
+                changed.push_back(std::move(path));
+        }
+    }
+}
+
+#else
+
+AssetWatcher::AssetWatcher()
+    : lastScan(std::chrono::steady_clock::now())
+{
+}
+
+AssetWatcher::~AssetWatcher()
+{
+}
+
+bool AssetWatcher::watch(const std::string& directory)
+{
+    std::error_code error;
+    if (!std::filesystem::is_directory(directory, error))
+    {
+        LogLine(LogLevel::Error) << "Could not watch " << directory;
+        return false;
+    }
+
+    directories.push_back(directory);
+    scan(directory, nullptr);
+    return true;
+}
+
+void AssetWatcher::poll(std::vector<std::string>& changed)
+{
+    auto now = std::chrono::steady_clock::now();
+    if (now - lastScan < POLL_INTERVAL)
+        return;
+    lastScan = now;
+
+    for (const auto& directory : directories)
+    {
+        scan(directory, &changed);
+    }
+}
+
+void AssetWatcher::scan(const std::string& directory, std::vector<std::string>* changed)
+{
+    std::error_code error;
+    for (const auto& entry : std::filesystem::directory_iterator(directory, error))
+    {
+        if (!entry.is_regular_file(error))
+            continue;
+
+        std::string path = directory + "/" + entry.path().filename().string();
+        auto writeTime = entry.last_write_time(error);
+        if (error)
+            continue;
+
+        auto known = writeTimes.find(path);
+        if (known == writeTimes.end() || known->second != writeTime)
+        {
+            // The scan from watch() only records what is already there
+            if (changed)
+                changed->push_back(path);
+            writeTimes[path] = writeTime;
+        }
+    }
+}
+
+#endif
@@ -0,0 +1,34 @@
+#include "core/AtomicFile.hpp"
+#include <filesystem>
+#include <fstream>
+
+bool writeFileAtomic(const std::string& path, std::initializer_list<std::string_view> parts)
+{
+    std::error_code error;
+    std::filesystem::path parent = std::filesystem::path(path).parent_path();
+    if (!parent.empty())
+        std::filesystem::create_directories(parent, error);
+
+    std::string temporary = path + ".tmp";
+    {
+        std::ofstream out(temporary, std::ios::binary | std::ios::trunc);
+        for (std::string_view part : parts)
+        {
+            out.write(part.data(), static_cast<std::streamsize>(part.size()));
+        }
+        if (!out)
+        {
+            out.close();
+            std::filesystem::remove(temporary, error);
+            return false;
+        }
+    }
+
+    std::filesystem::rename(temporary, path, error);
+    if (error)
+    {
+        std::filesystem::remove(temporary, error);
+        return false;
+    }
+    return true;
+}
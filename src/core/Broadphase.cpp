@@ -0,0 +1,172 @@
+#include "core/Broadphase.hpp"
+#include <algorithm>
+#include <cmath>
+
+Broadphase::Broadphase(float cellSize)
+    : cellSize(cellSize), queryStamp(0)
+{
+}
+
+std::uint64_t Broadphase::cellKey(int x, int y)
+{
+    return (static_cast<std::uint64_t>(static_cast<std::uint32_t>(x)) << 32) | static_cast<std::uint32_t>(y);
+}
+
+Broadphase::CellRange Broadphase::computeRange(const sf::FloatRect& bounds) const
+{
+    CellRange range;
+    range.minX = static_cast<int>(std::floor(bounds.position.x / cellSize));
+    range.minY = static_cast<int>(std::floor(bounds.position.y / cellSize));
+    range.maxX = static_cast<int>(std::floor((bounds.position.x + bounds.size.x) / cellSize));
+    range.maxY = static_cast<int>(std::floor((bounds.position.y + bounds.size.y) / cellSize));
+    return range;
+}
+
+void Broadphase::addToCells(int proxy, const CellRange& range)
+{
+    for (int x = range.minX; x <= range.maxX; ++x)
+    {
+        for (int y = range.minY; y <= range.maxY; ++y)
+        {
+            cells[cellKey(x, y)].push_back(proxy);
+        }
+    }
+}
+
+void Broadphase::removeFromCells(int proxy, const CellRange& range)
+{
+    for (int x = range.minX; x <= range.maxX; ++x)
+    {
+        for (int y = range.minY; y <= range.maxY; ++y)
+        {
+            auto it = cells.find(cellKey(x, y));
+            if (it == cells.end())
+                continue;
+
+            std::vector<int>& cell = it->second;
+            auto found = std::find(cell.begin(), cell.end(), proxy);
+            if (found != cell.end())
+            {
+                *found = cell.back();
+                cell.pop_back();
+            }
+        }
+    }
+}
+
+int Broadphase::insert(const sf::FloatRect& bounds, std::uint32_t userData)
+{
+    int proxy;
+    if (!freeProxies.empty())
+    {
+        proxy = freeProxies.back();
+        freeProxies.pop_back();
+    }
+    else
+    {
+        proxy = static_cast<int>(proxies.size());
+        proxies.emplace_back();
+        queryMarks.push_back(0);
+    }
+
+    Proxy& p = proxies[proxy];
+    p.bounds = bounds;
+    p.cells = computeRange(bounds);
+    p.userData = userData;
+    p.active = true;
+
+    addToCells(proxy, p.cells);
+    return proxy;
+}
+
+void Broadphase::update(int proxy, const sf::FloatRect& bounds)
+{
+    Proxy& p = proxies[proxy];
+    p.bounds = bounds;
+
+    CellRange range = computeRange(bounds);
+    if (range == p.cells)
+        return;
+
+    removeFromCells(proxy, p.cells);
+    p.cells = range;
+    addToCells(proxy, p.cells);
+}
+
+void Broadphase::remove(int proxy)
+{
+    Proxy& p = proxies[proxy];
+    if (!p.active)
+        return;
+
+    removeFromCells(proxy, p.cells);
+    p.active = false;
+    freeProxies.push_back(proxy);
+}
+
+void Broadphase::clear()
+{
+    proxies.clear();
+    freeProxies.clear();
+    cells.clear();
+    queryMarks.clear();
+    queryStamp = 0;
+}
+
+void Broadphase::setUserData(int proxy, std::uint32_t userData)
+{
+    proxies[proxy].userData = userData;
+}
+
+std::uint32_t Broadphase::getUserData(int proxy) const
+{
+    return proxies[proxy].userData;
+}
+
+const sf::FloatRect& Broadphase::getBounds(int proxy) const
+{
+    return proxies[proxy].bounds;
+}
+
+std::size_t Broadphase::getProxyCount() const
+{
+    return proxies.size() - freeProxies.size();
+}
+
+void Broadphase::query(const sf::FloatRect& area, std::vector<std::uint32_t>& result) const
+{
+    if (++queryStamp == 0)
+    {
+        std::fill(queryMarks.begin(), queryMarks.end(), 0);
+        queryStamp = 1;
+    }
+
+    const float areaRight = area.position.x + area.size.x;
+    const float areaBottom = area.position.y + area.size.y;
+    CellRange range = computeRange(area);
+
+    for (int x = range.minX; x <= range.maxX; ++x)
+    {
+        for (int y = range.minY; y <= range.maxY; ++y)
+        {
+            auto it = cells.find(cellKey(x, y));
+            if (it == cells.end())
+                continue;
+
+            for (int proxy : it->second)
+            {
+                if (queryMarks[proxy] == queryStamp)
+                    continue;
+                queryMarks[proxy] = queryStamp;
+
+                // Inclusive test so boxes that only touch still count as contacts
+                const sf::FloatRect& b = proxies[proxy].bounds;
+                if (b.position.x <= areaRight && b.position.x + b.size.x >= area.position.x &&
+                    b.position.y <= areaBottom && b.position.y + b.size.y >= area.position.y)
+                {
+                    result.push_back(proxies[proxy].userData);
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,144 @@
+#include "core/ByteStream.hpp"
+#include <cstring>
+
+namespace
+{
+    constexpr std::size_t MAX_STRING_SIZE = 255;
+}
+
+void ByteWriter::writeU8(std::uint8_t value)
+{
+    bytes.push_back(value);
+}
+
+void ByteWriter::writeU16(std::uint16_t value)
+{
+    writeU8(static_cast<std::uint8_t>(value));
+    writeU8(static_cast<std::uint8_t>(value >> 8));
+}
+
+void ByteWriter::writeU32(std::uint32_t value)
+{
+    writeU16(static_cast<std::uint16_t>(value));
+    writeU16(static_cast<std::uint16_t>(value >> 16));
+}
+
+void ByteWriter::writeU64(std::uint64_t value)
+{
+    writeU32(static_cast<std::uint32_t>(value));
+    writeU32(static_cast<std::uint32_t>(value >> 32));
+}
+
+void ByteWriter::writeVarint(std::uint32_t value)
+{
+    while (value >= 0x80)
+    {
+        writeU8(static_cast<std::uint8_t>(value | 0x80));
+        value >>= 7;
+    }
+    writeU8(static_cast<std::uint8_t>(value));
+}
+
+void ByteWriter::writeSignedVarint(std::int32_t value)
+{
+    std::uint32_t bits = static_cast<std::uint32_t>(value);
+    writeVarint((bits << 1) ^ (value < 0 ? 0xFFFFFFFFu : 0u));
+}
+
+void ByteWriter::writeF32(float value)
+{
+    std::uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    writeU32(bits);
+}
+
+void ByteWriter::writeString(const std::string& value)
+{
+    std::size_t length = value.size() < MAX_STRING_SIZE ? value.size() : MAX_STRING_SIZE;
+    writeU8(static_cast<std::uint8_t>(length));
+    bytes.insert(bytes.end(), value.begin(), value.begin() + length);
+}
+
+ByteReader::ByteReader(const std::uint8_t* data, std::size_t size)
+    : data(data), size(size), position(0), failed(false)
+{
+}
+
+bool ByteReader::has(std::size_t count)
+{
+    if (failed || size - position < count)
+    {
+        failed = true;
+        return false;
+    }
+    return true;
+}
+
+std::uint8_t ByteReader::readU8()
+{
+    if (!has(1))
+        return 0;
+    return data[position++];
+}
+
+std::uint16_t ByteReader::readU16()
+{
+    std::uint16_t low = readU8();
+    std::uint16_t high = readU8();
+    return static_cast<std::uint16_t>(low | (high << 8));
+}
+
+std::uint32_t ByteReader::readU32()
+{
+    std::uint32_t low = readU16();
+    std::uint32_t high = readU16();
+    return low | (high << 16);
+}
+
+std::uint64_t ByteReader::readU64()
+{
+    std::uint64_t low = readU32();
+    std::uint64_t high = readU32();
+    return low | (high << 32);
+}
+
+std::uint32_t ByteReader::readVarint()
+{
+    std::uint32_t value = 0;
+    for (int shift = 0; shift < 35; shift += 7)
+    {
+        std::uint8_t byte = readU8();
+        value |= static_cast<std::uint32_t>(byte & 0x7F) << shift;
+        if ((byte & 0x80) == 0)
+            return value;
+    }
+
+    // More than five bytes is not something ByteWriter produces
+    failed = true;
+    return 0;
+}
+
+std::int32_t ByteReader::readSignedVarint()
+{
+    std::uint32_t bits = readVarint();
+    return static_cast<std::int32_t>((bits >> 1) ^ (~(bits & 1) + 1));
+}
+
+float ByteReader::readF32()
+{
+    std::uint32_t bits = readU32();
+    float value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+std::string ByteReader::readString()
+{
+    std::size_t length = readU8();
+    if (!has(length))
+        return {};
+
+    std::string value(reinterpret_cast<const char*>(data + position), length);
+    position += length;
+    return value;
+}
@@ -0,0 +1,40 @@
+#include "core/FramePacer.hpp"
+#include <thread>
+
+FramePacer::FramePacer()
+    : targetFps(0), frameTime(Clock::duration::zero()), deadline(Clock::now())
+{
+}
+
+void FramePacer::setTargetFps(float fps)
+{
+    targetFps = fps > 0 ? fps : 0;
+    frameTime = targetFps > 0
+        ? std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / targetFps))
+        : Clock::duration::zero();
+    deadline = Clock::now();
+}
+
+void FramePacer::wait()
+{
+    if (targetFps <= 0)
+        return;
+
+    deadline += frameTime;
+    Clock::time_point now = Clock::now();
+
+    // More than a frame late, e.g. after a hitch: start counting again from
+    // now rather than rushing frames to catch up
+    if (now > deadline + frameTime)
+    {
+        deadline = now;
+        return;
+    }
+
+    if (deadline - now > SPIN_MARGIN)
+        std::this_thread::sleep_until(deadline - SPIN_MARGIN);
+    while (Clock::now() < deadline)
+    {
+        std::this_thread::yield();
+    }
+}
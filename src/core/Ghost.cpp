@@ -0,0 +1,340 @@
+#include "core/Ghost.hpp"
+#include "core/AtomicFile.hpp"
+#include "core/Telemetry.hpp"
+#include <algorithm>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+namespace
+{
+    enum Field
+    {
+        TimeMs,
+        PositionX,
+        PositionY,
+        State,
+        FacingLeft,
+        FrameX,
+        FrameY,
+        Hooked,
+        HookX,
+        HookY
+    };
+
+    constexpr std::uint32_t GHOST_MAGIC = 0x48474C48; // "HLGH"
+    constexpr std::size_t HEADER_SIZE = 4 + 1 + 8 + 4 + 4;
+    constexpr float POSITION_SCALE = 16.0f;
+
+    std::int32_t quantize(float value)
+    {
+        return static_cast<std::int32_t>(std::lround(value * POSITION_SCALE));
+    }
+
+    float dequantize(std::int32_t value)
+    {
+        return static_cast<float>(value) / POSITION_SCALE;
+    }
+
+    GhostFields toFields(const GhostFrame& frame, const GhostFields& last)
+    {
+        GhostFields fields;
+        fields[TimeMs] = static_cast<std::int32_t>(std::lround(frame.time * 1000.0f));
+        fields[PositionX] = quantize(frame.position.x);
+        fields[PositionY] = quantize(frame.position.y);
+        fields[State] = static_cast<std::int32_t>(frame.state);
+        fields[FacingLeft] = frame.facingLeft ? 1 : 0;
+        fields[FrameX] = frame.frame.x;
+        fields[FrameY] = frame.frame.y;
+        fields[Hooked] = frame.hooked ? 1 : 0;
+        // Unhooked frames keep the old point, it is not drawn and costs nothing
+        fields[HookX] = frame.hooked ? quantize(frame.hookPoint.x) : last[HookX];
+        fields[HookY] = frame.hooked ? quantize(frame.hookPoint.y) : last[HookY];
+        return fields;
+    }
+
+    GhostFrame toFrame(const GhostFields& fields)
+    {
+        GhostFrame frame;
+        frame.time = static_cast<float>(fields[TimeMs]) / 1000.0f;
+        frame.position = {dequantize(fields[PositionX]), dequantize(fields[PositionY])};
+        frame.state = static_cast<PlayerState>(fields[State]);
+        frame.facingLeft = fields[FacingLeft] != 0;
+        frame.frame = {fields[FrameX], fields[FrameY]};
+        frame.hooked = fields[Hooked] != 0;
+        frame.hookPoint = {dequantize(fields[HookX]), dequantize(fields[HookY])};
+        return frame;
+    }
+
+    // Time and position keep their last step, the rest stays put
+    GhostFields predict(const GhostFields& last, const GhostFields& beforeLast)
+    {
+        GhostFields predicted = last;
+        for (Field field : {TimeMs, PositionX, PositionY})
+        {
+            predicted[field] = addDelta(last[field], deltaBetween(last[field], beforeLast[field]));
+        }
+        return predicted;
+    }
+
+    // The first frame has no step yet, so the second is predicted to repeat it
+    void advance(GhostFields& last, GhostFields& beforeLast, const GhostFields& fields, std::uint32_t count)
+    {
+        beforeLast = count == 0 ? fields : last;
+        last = fields;
+    }
+}
+
+GhostFrame GhostFrame::fromSnapshot(const RenderSnapshot& snapshot)
+{
+    GhostFrame frame;
+    frame.time = snapshot.time;
+    frame.position = snapshot.playerPosition;
+    frame.state = snapshot.playerState;
+    frame.facingLeft = snapshot.playerFacingLeft;
+    frame.frame = snapshot.playerTextureRect.position;
+    frame.hooked = snapshot.hook.isAttached();
+    frame.hookPoint = snapshot.hook.getAttachPoint();
+    return frame;
+}
+
+GhostRecorder::GhostRecorder()
+{
+    clear();
+}
+
+void GhostRecorder::clear()
+{
+    frames.clear();
+    frameCount = 0;
+    duration = 0;
+    nextFrameTime = 0;
+    last = {};
+    beforeLast = {};
+}
+
+void GhostRecorder::record(const GhostFrame& frame)
+{
+    duration = frame.time;
+    if (frameCount > 0 && frame.time < nextFrameTime)
+        return;
+
+    // A slow frame doesn't make the following ones bunch up
+    nextFrameTime = std::max(nextFrameTime + 1.0f / RECORD_RATE, frame.time);
+
+    GhostFields fields = toFields(frame, last);
+    GhostFields predicted = predict(last, beforeLast);
+
+    std::uint32_t mask = 0;
+    for (std::size_t i = 0; i < GHOST_FIELD_COUNT; ++i)
+    {
+        if (fields[i] != predicted[i])
+            mask |= 1u << i;
+    }
+
+    frames.writeVarint(mask);
+    for (std::size_t i = 0; i < GHOST_FIELD_COUNT; ++i)
+    {
+        if (mask & (1u << i))
+            frames.writeSignedVarint(deltaBetween(fields[i], predicted[i]));
+    }
+
+    advance(last, beforeLast, fields, frameCount);
+    frameCount++;
+}
+
+bool GhostRecorder::save(const std::string& path, std::uint64_t mapHash) const
+{
+    ByteWriter header;
+    header.writeU32(GHOST_MAGIC);
+    header.writeU8(GHOST_VERSION);
+    header.writeU64(mapHash);
+    header.writeU32(frameCount);
+    header.writeU32(static_cast<std::uint32_t>(std::lround(duration * 1000.0f)));
+
+    if (!writeFileAtomic(path, {header.getView(), frames.getView()}))
+    {
+        LogLine(LogLevel::Error) << "Could not write ghost " << path;
+        return false;
+    }
+    return true;
+}
+
+GhostPlayback::GhostPlayback()
+    : reader(nullptr, 0), mapHash(0), frameCount(0), decodedCount(0), duration(0), last{}, beforeLast{}
+{
+}
+
+bool GhostPlayback::open(const std::string& path)
+{
+    if (!file.open(path) || file.getSize() < HEADER_SIZE)
+        return false;
+
+    reader = ByteReader(reinterpret_cast<const std::uint8_t*>(file.getData()), file.getSize());
+    if (reader.readU32() != GHOST_MAGIC || reader.readU8() != GHOST_VERSION)
+        return false;
+
+    mapHash = reader.readU64();
+    frameCount = reader.readU32();
+    duration = static_cast<float>(reader.readU32()) / 1000.0f;
+    decodedCount = 0;
+    last = {};
+    beforeLast = {};
+
+    // The first frame is needed before anything can be drawn
+    return reader.isValid() && frameCount > 0 && decodeNext();
+}
+
+bool GhostPlayback::decodeNext()
+{
+    std::uint32_t mask = reader.readVarint();
+    GhostFields fields = predict(last, beforeLast);
+    for (std::size_t i = 0; i < GHOST_FIELD_COUNT; ++i)
+    {
+        if (mask & (1u << i))
+            fields[i] = addDelta(fields[i], reader.readSignedVarint());
+    }
+
+    if (!reader.isValid())
+        return false;
+
+    advance(last, beforeLast, fields, decodedCount);
+    decodedCount++;
+    return true;
+}
+
+bool GhostPlayback::sample(float time, GhostFrame& frame)
+{
+    if (decodedCount == 0 || time > duration)
+        return false;
+
+    std::int32_t milliseconds = static_cast<std::int32_t>(std::lround(time * 1000.0f));
+    while (last[TimeMs] < milliseconds && decodedCount < frameCount)
+    {
+        // A truncated file plays up to where it breaks off
+        if (!decodeNext())
+        {
+            frameCount = decodedCount;
+            break;
+        }
+    }
+
+    // beforeLast and last now surround the time, unless it is past the last frame
+    frame = toFrame(beforeLast);
+    std::int32_t span = last[TimeMs] - beforeLast[TimeMs];
+    if (span <= 0 || milliseconds >= last[TimeMs])
+    {
+        frame = toFrame(last);
+        return true;
+    }
+
+    float t = std::clamp(static_cast<float>(milliseconds - beforeLast[TimeMs]) / static_cast<float>(span), 0.0f, 1.0f);
+    GhostFrame next = toFrame(last);
+    frame.time = time;
+    frame.position += (next.position - frame.position) * t;
+    return true;
+}
+
+GhostLibrary::GhostLibrary(const std::string& directory)
+    : directory(directory)
+{
+}
+
+std::string GhostLibrary::mapDirectory(const std::string& mapFile) const
+{
+    return directory + "/" + std::filesystem::path(mapFile).stem().string();
+}
+
+void GhostLibrary::listRuns(const std::string& mapFile, std::uint64_t mapHash,
+                            std::vector<std::string>& current, std::vector<std::string>& stale) const
+{
+    current.clear();
+    stale.clear();
+
+    std::error_code error;
+    std::filesystem::directory_iterator entries(mapDirectory(mapFile), error);
+    if (error)
+        return;
+
+    for (const auto& entry : entries)
+    {
+        if (entry.path().extension() != ".ghost")
+            continue;
+
+        // Only the header is read here; frames are streamed during play
+        std::string path = entry.path().string();
+        std::ifstream in(path, std::ios::binary);
+        std::array<std::uint8_t, HEADER_SIZE> bytes = {};
+        in.read(reinterpret_cast<char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+
+        ByteReader header(bytes.data(), static_cast<std::size_t>(in.gcount()));
+        bool valid = header.readU32() == GHOST_MAGIC && header.readU8() == GHOST_VERSION &&
+                     header.readU64() == mapHash && header.isValid();
+        (valid ? current : stale).push_back(path);
+    }
+
+    // Named by finish time, zero padded, so this is fastest first
+    std::sort(current.begin(), current.end());
+}
+
+void GhostLibrary::load(const std::string& mapFile, std::uint64_t mapHash,
+                        std::vector<std::unique_ptr<GhostPlayback>>& ghosts) const
+{
+    ghosts.clear();
+
+    std::vector<std::string> current;
+    std::vector<std::string> stale;
+    listRuns(mapFile, mapHash, current, stale);
+
+    for (const auto& path : current)
+    {
+        if (ghosts.size() >= MAX_GHOSTS)
+            break;
+
+        auto ghost = std::make_unique<GhostPlayback>();
+        if (ghost->open(path))
+            ghosts.push_back(std::move(ghost));
+        else
+            LogLine(LogLevel::Warning) << "Skipping broken ghost " << path;
+    }
+}
+
+bool GhostLibrary::save(const std::string& mapFile, std::uint64_t mapHash, const GhostRecorder& run) const
+{
+    if (run.getFrameCount() == 0)
+        return false;
+
+    std::vector<std::string> current;
+    std::vector<std::string> stale;
+    listRuns(mapFile, mapHash, current, stale);
+
+    std::error_code error;
+    for (const auto& path : stale)
+    {
+        std::filesystem::remove(path, error);
+    }
+
+    std::ostringstream name;
+    name << mapDirectory(mapFile) << "/" << std::setw(9) << std::setfill('0')
+         << std::lround(run.getDuration() * 1000.0f) << ".ghost";
+    std::string path = name.str();
+
+    if (current.size() >= MAX_GHOSTS && path >= current[MAX_GHOSTS - 1])
+        return false;
+
+    std::filesystem::create_directories(mapDirectory(mapFile), error);
+    if (!run.save(path, mapHash))
+        return false;
+
+    // Drop whoever got pushed out of the list
+    current.push_back(path);
+    std::sort(current.begin(), current.end());
+    current.erase(std::unique(current.begin(), current.end()), current.end());
+    for (std::size_t i = MAX_GHOSTS; i < current.size(); ++i)
+    {
+        std::filesystem::remove(current[i], error);
+    }
+    return true;
+}
@@ -0,0 +1,57 @@
+#include "core/GhostRenderer.hpp"
+
+GhostRenderer::GhostRenderer()
+    : sprites(sf::PrimitiveType::Triangles), ropes(sf::PrimitiveType::Lines)
+{
+}
+
+void GhostRenderer::clear()
+{
+    // Storage is kept, so a steady number of ghosts never reallocates
+    sprites.clear();
+    ropes.clear();
+}
+
+void GhostRenderer::add(const GhostFrame& frame, const sf::Vector2i& frameSize, const sf::Vector2f& ropeOffset, sf::Color color)
+{
+    color.a = ALPHA;
+
+    if (frame.hooked)
+    {
+        sf::Color ropeColor(100, 100, 100, ALPHA);
+        ropes.append(sf::Vertex{frame.hookPoint, ropeColor});
+        ropes.append(sf::Vertex{frame.position + ropeOffset, ropeColor});
+    }
+
+    const sf::Vector2f p = frame.position;
+    const sf::Vector2f s(static_cast<float>(frameSize.x), static_cast<float>(frameSize.y));
+    const sf::Vector2f t(static_cast<float>(frame.frame.x), static_cast<float>(frame.frame.y));
+
+    // Facing left mirrors the frame in place, the same as Player's flip
+    float left = frame.facingLeft ? t.x + s.x : t.x;
+    float right = frame.facingLeft ? t.x : t.x + s.x;
+
+    const sf::Vertex topLeft{p, color, {left, t.y}};
+    const sf::Vertex topRight{{p.x + s.x, p.y}, color, {right, t.y}};
+    const sf::Vertex bottomRight{p + s, color, {right, t.y + s.y}};
+    const sf::Vertex bottomLeft{{p.x, p.y + s.y}, color, {left, t.y + s.y}};
+
+    sprites.append(topLeft);
+    sprites.append(topRight);
+    sprites.append(bottomRight);
+    sprites.append(topLeft);
+    sprites.append(bottomRight);
+    sprites.append(bottomLeft);
+}
+
+void GhostRenderer::draw(sf::RenderTarget& target, const sf::Texture& characterTexture) const
+{
+    if (ropes.getVertexCount() > 0)
+        target.draw(ropes);
+
+    if (sprites.getVertexCount() > 0)
+    {
+        sf::RenderStates states(&characterTexture);
+        target.draw(sprites, states);
+    }
+}
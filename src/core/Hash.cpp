@@ -0,0 +1,12 @@
+#include "core/Hash.hpp"
+
+std::uint64_t contentHash(std::string_view data)
+{
+    std::uint64_t value = 14695981039346656037ull;
+    for (char c : data)
+    {
+        value ^= static_cast<unsigned char>(c);
+        value *= 1099511628211ull;
+    }
+    return value;
+}
@@ -0,0 +1,261 @@
+#include "core/Heatmap.hpp"
+#include "core/AtomicFile.hpp"
+#include "core/ByteStream.hpp"
+#include "core/MappedFile.hpp"
+#include "core/Telemetry.hpp"
+#include <algorithm>
+#include <cmath>
+#include <filesystem>
+
+namespace
+{
+    constexpr std::uint32_t HEATMAP_MAGIC = 0x4D484C48; // "HLHM"
+    // The least opacity of a cell where anything happened, so single events show
+    constexpr float MIN_ALPHA = 40.0f;
+
+    std::uint64_t cellsAcross(float length, float cellSize)
+    {
+        return static_cast<std::uint64_t>(std::max(1.0f, std::ceil(length / cellSize)));
+    }
+
+    float fitCellSize(const sf::FloatRect& area, float cellSize, std::uint32_t maxSide)
+    {
+        std::uint64_t side = std::clamp<std::uint64_t>(maxSide, 1, Heatmap::MAX_CELLS);
+        while (cellsAcross(area.size.x, cellSize) > side || cellsAcross(area.size.y, cellSize) > side ||
+               cellsAcross(area.size.x, cellSize) * cellsAcross(area.size.y, cellSize) > Heatmap::MAX_CELLS)
+        {
+            cellSize *= 2.0f;
+        }
+        return cellSize;
+    }
+}
+
+Heatmap::Heatmap()
+    : mapHash(0), cellSize(DEFAULT_CELL_SIZE), columns(0), rows(0), runCount(0)
+{
+}
+
+Heatmap::Heatmap(std::uint64_t mapHash, const sf::FloatRect& area, float cellSize, std::uint32_t maxSide)
+    : mapHash(mapHash), origin(area.position), cellSize(fitCellSize(area, cellSize, maxSide)), runCount(0)
+{
+    columns = static_cast<std::uint32_t>(cellsAcross(area.size.x, getCellSize()));
+    rows = static_cast<std::uint32_t>(cellsAcross(area.size.y, getCellSize()));
+    for (auto& layer : layers)
+    {
+        layer.assign(static_cast<std::size_t>(columns) * rows, 0);
+    }
+}
+
+void Heatmap::add(HeatmapLayer layer, const sf::Vector2f& position)
+{
+    if (isEmpty())
+        return;
+
+    sf::Vector2f cell = (position - origin) / cellSize;
+    std::uint32_t column = static_cast<std::uint32_t>(std::clamp(cell.x, 0.0f, static_cast<float>(columns - 1)));
+    std::uint32_t row = static_cast<std::uint32_t>(std::clamp(cell.y, 0.0f, static_cast<float>(rows - 1)));
+    ++layers[static_cast<std::size_t>(layer)][static_cast<std::size_t>(row) * columns + column];
+}
+
+void Heatmap::clear()
+{
+    for (auto& layer : layers)
+    {
+        std::fill(layer.begin(), layer.end(), 0);
+    }
+    runCount = 0;
+}
+
+bool Heatmap::merge(const Heatmap& other)
+{
+    if (other.mapHash != mapHash || other.origin != origin || other.cellSize != cellSize ||
+        other.columns != columns || other.rows != rows)
+        return false;
+
+    for (std::size_t i = 0; i < LAYER_COUNT; ++i)
+    {
+        std::vector<std::uint32_t>& counts = layers[i];
+        const std::vector<std::uint32_t>& added = other.layers[i];
+        for (std::size_t cell = 0; cell < counts.size(); ++cell)
+        {
+            counts[cell] += added[cell];
+        }
+    }
+    runCount += other.runCount;
+    return true;
+}
+
+void Heatmap::shrinkToFit(std::uint32_t maxSide)
+{
+    std::uint32_t factor = 1;
+    while (!isEmpty() && ((columns + factor - 1) / factor > maxSide || (rows + factor - 1) / factor > maxSide))
+    {
+        factor *= 2;
+    }
+    if (factor == 1)
+        return;
+
+    std::uint32_t newColumns = (columns + factor - 1) / factor;
+    std::uint32_t newRows = (rows + factor - 1) / factor;
+    for (auto& counts : layers)
+    {
+        std::vector<std::uint64_t> sums(static_cast<std::size_t>(newColumns) * newRows, 0);
+        for (std::uint32_t row = 0; row < rows; ++row)
+        {
+            for (std::uint32_t column = 0; column < columns; ++column)
+            {
+                sums[static_cast<std::size_t>(row / factor) * newColumns + column / factor] +=
+                    counts[static_cast<std::size_t>(row) * columns + column];
+            }
+        }
+
+        counts.resize(sums.size());
+        for (std::size_t cell = 0; cell < sums.size(); ++cell)
+        {
+            counts[cell] = static_cast<std::uint32_t>(std::min<std::uint64_t>(sums[cell], UINT32_MAX));
+        }
+    }
+    columns = newColumns;
+    rows = newRows;
+    cellSize *= static_cast<float>(factor);
+}
+
+bool Heatmap::save(const std::string& path) const
+{
+    ByteWriter writer;
+    writer.writeU32(HEATMAP_MAGIC);
+    writer.writeU32(VERSION);
+    writer.writeU64(mapHash);
+    writer.writeF32(origin.x);
+    writer.writeF32(origin.y);
+    writer.writeF32(cellSize);
+    writer.writeU32(columns);
+    writer.writeU32(rows);
+    writer.writeU64(runCount);
+
+    // Most of a level is empty sky; only cells that counted are written
+    for (const auto& counts : layers)
+    {
+        std::uint32_t used = static_cast<std::uint32_t>(std::count_if(counts.begin(), counts.end(),
+                                                                      [](std::uint32_t count) { return count != 0; }));
+        writer.writeU32(used);
+
+        std::size_t next = 0;
+        for (std::size_t cell = 0; cell < counts.size(); ++cell)
+        {
+            if (counts[cell] == 0)
+                continue;
+            writer.writeVarint(static_cast<std::uint32_t>(cell - next));
+            writer.writeVarint(counts[cell]);
+            next = cell + 1;
+        }
+    }
+
+    if (!writeFileAtomic(path, {writer.getView()}))
+    {
+        LogLine(LogLevel::Error) << "Could not write heatmap " << path;
+        return false;
+    }
+    return true;
+}
+
+bool Heatmap::load(const std::string& path)
+{
+    MappedFile file;
+    if (!file.open(path))
+        return false;
+
+    ByteReader reader(reinterpret_cast<const std::uint8_t*>(file.getData()), file.getSize());
+    if (reader.readU32() != HEATMAP_MAGIC || reader.readU32() != VERSION)
+    {
+        LogLine(LogLevel::Error) << "Not a heatmap file: " << path;
+        return false;
+    }
+
+    Heatmap loaded;
+    loaded.mapHash = reader.readU64();
+    loaded.origin.x = reader.readF32();
+    loaded.origin.y = reader.readF32();
+    loaded.cellSize = reader.readF32();
+    loaded.columns = reader.readU32();
+    loaded.rows = reader.readU32();
+    loaded.runCount = reader.readU64();
+
+    std::uint64_t cellCount = static_cast<std::uint64_t>(loaded.columns) * loaded.rows;
+    bool valid = reader.isValid() && loaded.cellSize > 0 && cellCount > 0 && cellCount <= MAX_CELLS;
+    for (std::size_t i = 0; i < LAYER_COUNT && valid; ++i)
+    {
+        std::vector<std::uint32_t>& counts = loaded.layers[i];
+        counts.assign(static_cast<std::size_t>(cellCount), 0);
+
+        std::uint32_t used = reader.readU32();
+        std::uint64_t cell = 0;
+        for (std::uint32_t j = 0; j < used && valid; ++j)
+        {
+            cell += reader.readVarint();
+            std::uint32_t count = reader.readVarint();
+            valid = reader.isValid() && cell < cellCount;
+            if (valid)
+                counts[static_cast<std::size_t>(cell++)] = count;
+        }
+    }
+
+    if (!valid)
+    {
+        LogLine(LogLevel::Error) << "Heatmap " << path << " is damaged";
+        return false;
+    }
+    *this = std::move(loaded);
+    return true;
+}
+
+void Heatmap::buildImage(HeatmapLayer layer, sf::Color color, sf::Image& image) const
+{
+    image.resize({std::max(columns, 1u), std::max(rows, 1u)}, sf::Color::Transparent);
+    std::uint32_t max = getMax(layer);
+    if (max == 0)
+        return;
+
+    // Logarithmic, or one spot everyone dies at would hide all the others
+    const std::vector<std::uint32_t>& counts = layers[static_cast<std::size_t>(layer)];
+    float scale = (255.0f - MIN_ALPHA) / std::log1p(static_cast<float>(max));
+    for (std::uint32_t row = 0; row < rows; ++row)
+    {
+        for (std::uint32_t column = 0; column < columns; ++column)
+        {
+            std::uint32_t count = counts[static_cast<std::size_t>(row) * columns + column];
+            if (count == 0)
+                continue;
+            color.a = static_cast<std::uint8_t>(MIN_ALPHA + std::log1p(static_cast<float>(count)) * scale);
+            image.setPixel({column, row}, color);
+        }
+    }
+}
+
+std::uint32_t Heatmap::getCount(HeatmapLayer layer, std::uint32_t column, std::uint32_t row) const
+{
+    if (column >= columns || row >= rows)
+        return 0;
+    return layers[static_cast<std::size_t>(layer)][static_cast<std::size_t>(row) * columns + column];
+}
+
+std::uint32_t Heatmap::getMax(HeatmapLayer layer) const
+{
+    const std::vector<std::uint32_t>& counts = layers[static_cast<std::size_t>(layer)];
+    return counts.empty() ? 0 : *std::max_element(counts.begin(), counts.end());
+}
+
+std::uint64_t Heatmap::getTotal(HeatmapLayer layer) const
+{
+    std::uint64_t total = 0;
+    for (std::uint32_t count : layers[static_cast<std::size_t>(layer)])
+    {
+        total += count;
+    }
+    return total;
+}
+
+std::string Heatmap::pathFor(const std::string& mapFile)
+{
+    return std::string(DIRECTORY) + "/" + std::filesystem::path(mapFile).stem().string() + ".heatmap";
+}
@@ -0,0 +1,187 @@
+#include "core/Input.hpp"
+
+void InputState::setHeld(Action action, bool down)
+{
+    std::uint16_t mask = bit(action);
+    bool wasDown = (held & mask) != 0;
+
+    if (down && !wasDown)
+    {
+        held |= mask;
+        pressed |= mask;
+    }
+    else if (!down && wasDown)
+    {
+        held &= ~mask;
+        released |= mask;
+    }
+}
+
+InputSystem::InputSystem()
+    : held(0), pressedLatch(0), releasedLatch(0), mousePixel(0, 0)
+{
+    keyActions.fill(0);
+    buttonActions.fill(0);
+    sourcesDown.fill(0);
+    bindDefaults();
+}
+
+void InputSystem::bindDefaults()
+{
+    reset();
+    keyActions.fill(0);
+    buttonActions.fill(0);
+
+    bind(Action::MoveLeft, sf::Keyboard::Key::A);
+    bind(Action::MoveLeft, sf::Keyboard::Key::Left);
+    bind(Action::MoveRight, sf::Keyboard::Key::D);
+    bind(Action::MoveRight, sf::Keyboard::Key::Right);
+    bind(Action::Jump, sf::Keyboard::Key::W);
+    bind(Action::Jump, sf::Keyboard::Key::Space);
+    bind(Action::Jump, sf::Keyboard::Key::Up);
+    bind(Action::Hook, sf::Mouse::Button::Left);
+    bind(Action::ReleaseHook, sf::Mouse::Button::Right);
+    bind(Action::Pause, sf::Keyboard::Key::Escape);
+}
+
+void InputSystem::bind(Action action, sf::Keyboard::Key key)
+{
+    int index = static_cast<int>(key);
+    if (index < 0 || index >= static_cast<int>(keyActions.size()))
+        return;
+
+    reset();
+    keyActions[index] |= InputState::bit(action);
+}
+
+void InputSystem::bind(Action action, sf::Mouse::Button button)
+{
+    int index = static_cast<int>(button);
+    if (index < 0 || index >= static_cast<int>(buttonActions.size()))
+        return;
+
+    reset();
+    buttonActions[index] |= InputState::bit(action);
+}
+
+void InputSystem::clearBindings(Action action)
+{
+    reset();
+
+    std::uint16_t mask = static_cast<std::uint16_t>(~InputState::bit(action));
+    for (auto& actions : keyActions)
+        actions &= mask;
+    for (auto& actions : buttonActions)
+        actions &= mask;
+}
+
+void InputSystem::flush()
+{
+    pressedLatch = 0;
+    releasedLatch = 0;
+}
+
+void InputSystem::reset()
+{
+    // Report a release for everything that was down so edges stay balanced
+    releasedLatch |= held;
+    held = 0;
+    keysDown.reset();
+    buttonsDown.reset();
+    sourcesDown.fill(0);
+}
+
+void InputSystem::sourceDown(std::uint16_t actions)
+{
+    for (std::size_t i = 0; i < ACTION_COUNT; ++i)
+    {
+        std::uint16_t mask = static_cast<std::uint16_t>(1u << i);
+        if ((actions & mask) && sourcesDown[i]++ == 0)
+        {
+            held |= mask;
+            pressedLatch |= mask;
+        }
+    }
+}
+
+void InputSystem::sourceUp(std::uint16_t actions)
+{
+    for (std::size_t i = 0; i < ACTION_COUNT; ++i)
+    {
+        std::uint16_t mask = static_cast<std::uint16_t>(1u << i);
+        if ((actions & mask) && sourcesDown[i] > 0 && --sourcesDown[i] == 0)
+        {
+            held &= ~mask;
+            releasedLatch |= mask;
+        }
+    }
+}
+
+void InputSystem::handleEvent(const sf::Event& event)
+{
+    if (const auto* key = event.getIf<sf::Event::KeyPressed>())
+    {
+        int index = static_cast<int>(key->code);
+        // Key repeat sends more KeyPressed events for a key that is already down
+        if (index >= 0 && index < static_cast<int>(keyActions.size()) && !keysDown[index])
+        {
+            keysDown[index] = true;
+            sourceDown(keyActions[index]);
+        }
+    }
+    else if (const auto* key = event.getIf<sf::Event::KeyReleased>())
+    {
+        int index = static_cast<int>(key->code);
+        if (index >= 0 && index < static_cast<int>(keyActions.size()) && keysDown[index])
+        {
+            keysDown[index] = false;
+            sourceUp(keyActions[index]);
+        }
+    }
+    else if (const auto* button = event.getIf<sf::Event::MouseButtonPressed>())
+    {
+        int index = static_cast<int>(button->button);
+        mousePixel = button->position;
+        if (index >= 0 && index < static_cast<int>(buttonActions.size()) && !buttonsDown[index])
+        {
+            buttonsDown[index] = true;
+            sourceDown(buttonActions[index]);
+        }
+    }
+    else if (const auto* button = event.getIf<sf::Event::MouseButtonReleased>())
+    {
+        int index = static_cast<int>(button->button);
+        mousePixel = button->position;
+        if (index >= 0 && index < static_cast<int>(buttonActions.size()) && buttonsDown[index])
+        {
+            buttonsDown[index] = false;
+            sourceUp(buttonActions[index]);
+        }
+    }
+    else if (const auto* moved = event.getIf<sf::Event::MouseMoved>())
+    {
+        mousePixel = moved->position;
+    }
+    else if (event.is<sf::Event::FocusLost>())
+    {
+        reset();
+    }
+}
+
+InputState InputSystem::sample(const sf::RenderTarget& target, const sf::View& view)
+{
+    InputState state;
+    state.held = held;
+    state.pressed = pressedLatch;
+    state.released = releasedLatch;
+
+    // Only pay for the pixel to world mapping when something will aim with it
+    if (state.isHeld(Action::Hook) || state.wasPressed(Action::Hook))
+    {
+        state.aim = target.mapPixelToCoords(mousePixel, view);
+    }
+
+    pressedLatch = 0;
+    releasedLatch = 0;
+    return state;
+}
@@ -0,0 +1,97 @@
+#include "core/InputLatency.hpp"
+#include <algorithm>
+#include <iomanip>
+#include <sstream>
+
+LatencyStats::LatencyStats()
+{
+    clear();
+}
+
+void LatencyStats::add(float milliseconds)
+{
+    std::size_t bucket = static_cast<std::size_t>(std::max(milliseconds, 0.0f) / BUCKET_MS);
+    ++buckets[std::min(bucket, BUCKET_COUNT - 1)];
+    ++count;
+    total += milliseconds;
+    max = std::max(max, milliseconds);
+}
+
+void LatencyStats::clear()
+{
+    buckets.fill(0);
+    count = 0;
+    total = 0;
+    max = 0;
+}
+
+float LatencyStats::getPercentile(float fraction) const
+{
+    if (count == 0)
+        return 0.0f;
+
+    // Rank of the sample wanted, counted from 1
+    std::uint64_t rank = std::max<std::uint64_t>(1, static_cast<std::uint64_t>(fraction * count + 0.999f));
+    std::uint64_t seen = 0;
+    for (std::size_t i = 0; i < BUCKET_COUNT; ++i)
+    {
+        seen += buckets[i];
+        if (seen >= rank)
+            return std::min((i + 1) * BUCKET_MS, max);
+    }
+    return max;
+}
+
+std::string LatencyStats::format() const
+{
+    std::ostringstream stream;
+    stream << std::fixed << std::setprecision(1)
+           << count << " inputs: "
+           << "p50 " << getPercentile(0.5f) << "  "
+           << "p95 " << getPercentile(0.95f) << "  "
+           << "p99 " << getPercentile(0.99f) << "  "
+           << "max " << max << " ms";
+    return stream.str();
+}
+
+void InputLatency::inputSeen()
+{
+    if (!seen)
+        seen = Clock::now();
+}
+
+void InputLatency::tickSubmitted()
+{
+    // A tick already carrying an input answers it first
+    if (seen && !submitted)
+    {
+        submitted = seen;
+        seen.reset();
+    }
+}
+
+void InputLatency::tickFinished()
+{
+    if (submitted && !finished)
+    {
+        finished = submitted;
+        submitted.reset();
+    }
+}
+
+void InputLatency::framePresented()
+{
+    if (!finished)
+        return;
+
+    std::chrono::duration<float, std::milli> latency = Clock::now() - *finished;
+    stats.add(latency.count());
+    finished.reset();
+}
+
+void InputLatency::reset()
+{
+    seen.reset();
+    submitted.reset();
+    finished.reset();
+}
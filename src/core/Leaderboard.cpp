@@ -0,0 +1,422 @@
+#include "core/Leaderboard.hpp"
+#include "core/AtomicFile.hpp"
+#include "core/ByteStream.hpp"
+#include "core/Hash.hpp"
+#include "core/Telemetry.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace
+{
+    constexpr std::uint32_t LOG_MAGIC = 0x424C4C48;   // "HLLB"
+    constexpr std::uint32_t INDEX_MAGIC = 0x494C4C48; // "HLLI"
+    constexpr std::uint64_t LOG_HEADER_SIZE = 8;
+    constexpr std::size_t RECORD_SIZE = 8 + 8 + 4 + 4 + 4 + 8 + 4;
+    // Records read per chunk while replaying the log
+    constexpr std::size_t REPLAY_CHUNK = 4096;
+
+    std::uint32_t checksum(const std::uint8_t* data, std::size_t size)
+    {
+        return static_cast<std::uint32_t>(contentHash(std::string_view(reinterpret_cast<const char*>(data), size)));
+    }
+
+    void writeRecord(ByteWriter& writer, const RunRecord& run, std::uint64_t previous)
+    {
+        std::size_t start = writer.getSize();
+        writer.writeU64(run.mapHash);
+        writer.writeU64(previous);
+        writer.writeU32(run.timeMs);
+        writer.writeU32(static_cast<std::uint32_t>(run.score));
+        writer.writeU32(run.deaths);
+        writer.writeU64(static_cast<std::uint64_t>(run.finishedAt));
+        writer.writeU32(checksum(writer.getData() + start, RECORD_SIZE - 4));
+    }
+
+    // False for a record that was never completely written
+    bool readRecord(const std::uint8_t* data, RunRecord& run, std::uint64_t& previous)
+    {
+        ByteReader reader(data, RECORD_SIZE);
+        run.mapHash = reader.readU64();
+        previous = reader.readU64();
+        run.timeMs = reader.readU32();
+        run.score = static_cast<std::int32_t>(reader.readU32());
+        run.deaths = reader.readU32();
+        run.finishedAt = static_cast<std::int64_t>(reader.readU64());
+        return reader.readU32() == checksum(data, RECORD_SIZE - 4);
+    }
+
+    void writeTopEntry(ByteWriter& writer, const RunRecord& run)
+    {
+        writer.writeU32(run.timeMs);
+        writer.writeU32(static_cast<std::uint32_t>(run.score));
+        writer.writeU32(run.deaths);
+        writer.writeU64(static_cast<std::uint64_t>(run.finishedAt));
+    }
+
+    RunRecord readTopEntry(ByteReader& reader, std::uint64_t mapHash)
+    {
+        RunRecord run;
+        run.mapHash = mapHash;
+        run.timeMs = reader.readU32();
+        run.score = static_cast<std::int32_t>(reader.readU32());
+        run.deaths = reader.readU32();
+        run.finishedAt = static_cast<std::int64_t>(reader.readU64());
+        return run;
+    }
+
+    bool syncFile(std::FILE* file)
+    {
+#ifdef _WIN32
+        return _commit(_fileno(file)) == 0;
+#else
+        return fsync(fileno(file)) == 0;
+#endif
+    }
+}
+
+bool RunRecord::isBetterThan(const RunRecord& other) const
+{
+    if (timeMs != other.timeMs)
+        return timeMs < other.timeMs;
+    if (deaths != other.deaths)
+        return deaths < other.deaths;
+    return score > other.score;
+}
+
+Leaderboard::Leaderboard(const std::string& directory)
+    : directory(directory), logSize(0), opened(false)
+{
+}
+
+std::string Leaderboard::logPath() const
+{
+    return directory + "/runs.log";
+}
+
+std::string Leaderboard::indexPath() const
+{
+    return directory + "/index.bin";
+}
+
+bool Leaderboard::open()
+{
+    opened = false;
+    if (!readIndex())
+    {
+        boards.clear();
+        logSize = 0;
+    }
+
+    std::uint64_t indexed = logSize;
+    if (!replayLog())
+        return false;
+
+    if (logSize != indexed)
+        writeIndex();
+
+    opened = true;
+    return true;
+}
+
+bool Leaderboard::readIndex()
+{
+    boards.clear();
+    logSize = 0;
+
+    std::ifstream in(indexPath(), std::ios::binary);
+    if (!in)
+        return false;
+    std::vector<std::uint8_t> bytes((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    if (bytes.size() < 4)
+        return false;
+
+    ByteReader reader(bytes.data(), bytes.size() - 4);
+    ByteReader trailer(bytes.data() + bytes.size() - 4, 4);
+    if (trailer.readU32() != checksum(bytes.data(), bytes.size() - 4))
+        return false;
+
+    if (reader.readU32() != INDEX_MAGIC || reader.readU32() != VERSION)
+        return false;
+
+    logSize = reader.readU64();
+    std::uint32_t mapCount = reader.readU32();
+    for (std::uint32_t i = 0; i < mapCount && reader.isValid(); ++i)
+    {
+        std::uint64_t mapHash = reader.readU64();
+        MapBoard& board = boards[mapHash];
+        board.runCount = reader.readU64();
+        board.lastOffset = reader.readU64();
+
+        std::uint32_t topCount = std::min<std::uint32_t>(reader.readU32(), TOP_SIZE);
+        for (std::uint32_t j = 0; j < topCount; ++j)
+        {
+            board.top.push_back(readTopEntry(reader, mapHash));
+        }
+    }
+
+    return reader.isValid() && reader.atEnd();
+}
+
+bool Leaderboard::writeIndex() const
+{
+    ByteWriter writer;
+    writer.writeU32(INDEX_MAGIC);
+    writer.writeU32(VERSION);
+    writer.writeU64(logSize);
+    writer.writeU32(static_cast<std::uint32_t>(boards.size()));
+    for (const auto& [mapHash, board] : boards)
+    {
+        writer.writeU64(mapHash);
+        writer.writeU64(board.runCount);
+        writer.writeU64(board.lastOffset);
+        writer.writeU32(static_cast<std::uint32_t>(board.top.size()));
+        for (const auto& run : board.top)
+        {
+            writeTopEntry(writer, run);
+        }
+    }
+    writer.writeU32(checksum(writer.getData(), writer.getSize()));
+
+    // A crash leaves the old index, which open() catches up
+    std::string path = indexPath();
+    if (!writeFileAtomic(path, {writer.getView()}))
+    {
+        LogLine(LogLevel::Error) << "Could not write leaderboard index " << path;
+        return false;
+    }
+    return true;
+}
+
+bool Leaderboard::replayLog()
+{
+    std::error_code error;
+    std::uint64_t size = std::filesystem::exists(logPath(), error) ? std::filesystem::file_size(logPath(), error) : 0;
+    if (error)
+        size = 0;
+
+    // A log shorter than the index says was replaced; start over from it
+    if (size < logSize)
+    {
+        boards.clear();
+        logSize = 0;
+    }
+    if (size == 0)
+        return true;
+
+    // Crashed while creating the log
+    if (logSize == 0 && size < LOG_HEADER_SIZE)
+    {
+        std::filesystem::resize_file(logPath(), 0, error);
+        return !error;
+    }
+
+    std::ifstream in(logPath(), std::ios::binary);
+    if (logSize == 0)
+    {
+        std::uint8_t header[LOG_HEADER_SIZE] = {};
+        in.read(reinterpret_cast<char*>(header), sizeof(header));
+        ByteReader reader(header, static_cast<std::size_t>(in.gcount()));
+        if (reader.readU32() != LOG_MAGIC || reader.readU32() != VERSION || !reader.isValid())
+        {
+            LogLine(LogLevel::Warning) << logPath() << " is not a run log, leaving it alone";
+            return false;
+        }
+        logSize = LOG_HEADER_SIZE;
+    }
+
+    in.seekg(static_cast<std::streamoff>(logSize));
+    std::vector<std::uint8_t> chunk(RECORD_SIZE * REPLAY_CHUNK);
+    std::uint64_t skipped = 0;
+    while (size - logSize >= RECORD_SIZE)
+    {
+        std::size_t count = static_cast<std::size_t>(std::min<std::uint64_t>(REPLAY_CHUNK, (size - logSize) / RECORD_SIZE));
+        if (!in.read(reinterpret_cast<char*>(chunk.data()), static_cast<std::streamsize>(count * RECORD_SIZE)))
+            break;
+
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            RunRecord run;
+            std::uint64_t previous = 0;
+            if (readRecord(chunk.data() + i * RECORD_SIZE, run, previous))
+                indexRun(run, logSize);
+            else
+                skipped++;
+            logSize += RECORD_SIZE;
+        }
+    }
+
+    if (skipped > 0)
+        LogLine(LogLevel::Warning) << "Skipped " << skipped << " damaged runs in " << logPath();
+
+    // Half a record from a crash mid-write; cut it so new runs line up again
+    if (logSize < size)
+    {
+        std::filesystem::resize_file(logPath(), logSize, error);
+        if (error)
+        {
+            LogLine(LogLevel::Error) << "Could not repair " << logPath();
+            return false;
+        }
+    }
+    return true;
+}
+
+std::size_t Leaderboard::indexRun(const RunRecord& run, std::uint64_t offset)
+{
+    MapBoard& board = boards[run.mapHash];
+    board.runCount++;
+    board.lastOffset = offset;
+
+    // After runs it ties with, so the earlier run keeps its place
+    auto place = std::upper_bound(board.top.begin(), board.top.end(), run,
+                                  [](const RunRecord& a, const RunRecord& b) { return a.isBetterThan(b); });
+    std::size_t rank = static_cast<std::size_t>(place - board.top.begin()) + 1;
+    if (rank > TOP_SIZE)
+        return 0;
+
+    board.top.insert(place, run);
+    if (board.top.size() > TOP_SIZE)
+        board.top.pop_back();
+    return rank;
+}
+
+bool Leaderboard::appendRecords(const std::vector<RunRecord>& runs, std::vector<std::size_t>* ranks)
+{
+    if (!opened)
+        return false;
+
+    std::error_code error;
+    std::filesystem::create_directories(directory, error);
+
+    ByteWriter writer;
+    if (logSize == 0)
+    {
+        writer.writeU32(LOG_MAGIC);
+        writer.writeU32(VERSION);
+    }
+
+    // Chain each run to the one before it on the same map, including runs
+    // earlier in this batch
+    std::uint64_t start = logSize + writer.getSize();
+    std::unordered_map<std::uint64_t, std::uint64_t> lastOffsets;
+    for (std::size_t i = 0; i < runs.size(); ++i)
+    {
+        auto last = lastOffsets.find(runs[i].mapHash);
+        auto board = boards.find(runs[i].mapHash);
+        std::uint64_t previous = last != lastOffsets.end() ? last->second : board != boards.end() ? board->second.lastOffset : 0;
+        writeRecord(writer, runs[i], previous);
+        lastOffsets[runs[i].mapHash] = start + i * RECORD_SIZE;
+    }
+
+    std::FILE* file = std::fopen(logPath().c_str(), "ab");
+    if (!file)
+    {
+        LogLine(LogLevel::Error) << "Could not open " << logPath();
+        return false;
+    }
+
+    bool written = std::fwrite(writer.getData(), 1, writer.getSize(), file) == writer.getSize() &&
+                   std::fflush(file) == 0 && syncFile(file);
+    std::fclose(file);
+
+    if (!written)
+    {
+        // Whatever made it to disk is picked up, or cut off, like after a crash
+        LogLine(LogLevel::Error) << "Could not write " << logPath();
+        replayLog();
+        return false;
+    }
+
+    for (std::size_t i = 0; i < runs.size(); ++i)
+    {
+        std::size_t rank = indexRun(runs[i], start + i * RECORD_SIZE);
+        if (ranks)
+            ranks->push_back(rank);
+    }
+    logSize = start + runs.size() * RECORD_SIZE;
+    return true;
+}
+
+std::size_t Leaderboard::add(const RunRecord& run)
+{
+    std::vector<std::size_t> ranks;
+    if (!appendRecords({run}, &ranks))
+        return 0;
+
+    writeIndex();
+    return ranks.front();
+}
+
+bool Leaderboard::addRuns(const std::vector<RunRecord>& runs)
+{
+    if (runs.empty())
+        return true;
+    if (!appendRecords(runs, nullptr))
+        return false;
+    return writeIndex();
+}
+
+void Leaderboard::getTop(std::uint64_t mapHash, std::size_t count, std::vector<RunRecord>& runs) const
+{
+    runs.clear();
+    auto board = boards.find(mapHash);
+    if (board == boards.end())
+        return;
+
+    count = std::min(count, board->second.top.size());
+    runs.assign(board->second.top.begin(), board->second.top.begin() + count);
+}
+
+bool Leaderboard::getPersonalBest(std::uint64_t mapHash, RunRecord& run) const
+{
+    auto board = boards.find(mapHash);
+    if (board == boards.end() || board->second.top.empty())
+        return false;
+
+    run = board->second.top.front();
+    return true;
+}
+
+std::uint64_t Leaderboard::getRunCount(std::uint64_t mapHash) const
+{
+    auto board = boards.find(mapHash);
+    return board != boards.end() ? board->second.runCount : 0;
+}
+
+void Leaderboard::getRecent(std::uint64_t mapHash, std::size_t count, std::vector<RunRecord>& runs) const
+{
+    runs.clear();
+    auto board = boards.find(mapHash);
+    if (board == boards.end())
+        return;
+
+    std::ifstream in(logPath(), std::ios::binary);
+    std::uint8_t bytes[RECORD_SIZE];
+    std::uint64_t offset = board->second.lastOffset;
+    while (offset >= LOG_HEADER_SIZE && runs.size() < count)
+    {
+        in.seekg(static_cast<std::streamoff>(offset));
+        if (!in.read(reinterpret_cast<char*>(bytes), sizeof(bytes)))
+            break;
+
+        RunRecord run;
+        std::uint64_t previous = 0;
+        if (!readRecord(bytes, run, previous) || run.mapHash != mapHash)
+            break;
+
+        runs.push_back(run);
+        // Runs only ever point back, so a bad link can't loop
+        if (previous >= offset)
+            break;
+        offset = previous;
+    }
+}
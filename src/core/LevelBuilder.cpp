@@ -0,0 +1,76 @@
+#include "core/LevelBuilder.hpp"
+
+LevelBuilder::LevelBuilder(const Textures& textures)
+    : textures(textures)
+{
+}
+
+std::shared_ptr<Platform> LevelBuilder::createFloatingPlatform(float x, float y) const
+{
+    auto platform = std::make_shared<Platform>(*textures.platform, PlatformType::Floating);
+    platform->setPosition({x, y});
+    platform->setSize(PLATFORM_WIDTH, PLATFORM_HEIGHT);
+    return platform;
+}
+
+Entity LevelBuilder::createObject(Simulation& simulation, const MapObject& object) const
+{
+    const auto& v = object.values;
+
+    switch (object.type)
+    {
+        case MapObjectType::Ground:
+        {
+            auto ground = std::make_shared<Platform>(*textures.ground, PlatformType::Ground);
+            ground->setPosition({v[0], v[1]});
+            ground->setTextureRect(sf::IntRect({0, 0}, {static_cast<int>(v[2]), static_cast<int>(v[3])}));
+            return simulation.addPlatform(ground);
+        }
+        case MapObjectType::Platform:
+            return simulation.addPlatform(createFloatingPlatform(v[0], v[1]));
+        case MapObjectType::Mover:
+        {
+            auto platform = createFloatingPlatform(v[0], v[1]);
+            platform->setLinearPath({{v[2], v[3]}}, v[4]);
+            return simulation.addPlatform(platform);
+        }
+        case MapObjectType::Oscillator:
+        {
+            auto platform = createFloatingPlatform(v[0], v[1]);
+            platform->setOscillation({v[2], v[3]}, v[4]);
+            return simulation.addPlatform(platform);
+        }
+        case MapObjectType::Crumble:
+        {
+            auto platform = createFloatingPlatform(v[0], v[1]);
+            platform->setCrumbling(v[2], v[3]);
+            return simulation.addPlatform(platform);
+        }
+        case MapObjectType::Obstacle:
+        {
+            auto obstacle = std::make_shared<Platform>(*textures.obstacle, PlatformType::DeathPit);
+            obstacle->setPosition({v[0], v[1]});
+            obstacle->setSize(OBSTACLE_WIDTH, OBSTACLE_HEIGHT);
+            return simulation.addPlatform(obstacle);
+        }
+        case MapObjectType::Pickup:
+            return simulation.addPickup(PickupType::Coin, *textures.coin, {v[0], v[1]});
+        case MapObjectType::Checkpoint:
+            return simulation.addPickup(PickupType::Checkpoint, *textures.checkpoint, {v[0], v[1]});
+        case MapObjectType::Win:
+            return simulation.addPickup(PickupType::Win, *textures.win, {v[0], v[1]});
+    }
+
+    return NULL_ENTITY;
+}
+
+void LevelBuilder::build(Simulation& simulation, const MapData& map, std::vector<Entity>& entities) const
+{
+    entities.clear();
+    entities.reserve(map.objects.size());
+
+    for (const auto& object : map.objects)
+    {
+        entities.push_back(createObject(simulation, object));
+    }
+}
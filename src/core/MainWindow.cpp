@@ -1,11 +1,74 @@
 #include "core/MainWindow.hpp"
+#include <algorithm>
 #include <array>
-#include <fstream>
+#include <cmath>
+#include <ctime>
+#include <iomanip>
 #include <sstream>
+#include "core/Telemetry.hpp"
+
+namespace
+{
+    // How often an idle screen wakes up to look for edited assets
+    constexpr float IDLE_WAKE_SECONDS = 0.25f;
+    constexpr float BACKGROUND_IDLE_WAKE_SECONDS = 1.0f;
+    // While maps are indexed or thumbnails drawn, so each shows up as it comes
+    constexpr float LOADING_WAKE_SECONDS = 1.0f / 60.0f;
+    // Frame rate of a level left running behind another window
+    constexpr float BACKGROUND_FPS = 30.0f;
+    // How often --latency prints what it measured
+    constexpr float LATENCY_REPORT_SECONDS = 5.0f;
+    // A level frame taking longer than this is recorded as a hitch
+    constexpr float FRAME_HITCH_SECONDS = 0.05f;
+    // Rows of the map list on screen at once
+    constexpr std::size_t VISIBLE_MAP_ROWS = 6;
+    // Heatmap layers in HeatmapLayer order: deaths, hooks, trajectory
+    const sf::Color HEATMAP_COLORS[Heatmap::LAYER_COUNT] = {
+        sf::Color(230, 40, 40), sf::Color(255, 200, 0), sf::Color(40, 110, 255)};
+    
+    // m:ss.cc, as the timer shows it
+    std::string formatTime(float time)
+    {
+        int minutes = static_cast<int>(time) / 60;
+        int seconds = static_cast<int>(time) % 60;
+        int hundredths = static_cast<int>((time - static_cast<int>(time)) * 100);
+        
+        std::ostringstream stream;
+        stream << minutes << ":"
+               << (seconds < 10 ? "0" : "") << seconds << "."
+               << (hundredths < 10 ? "0" : "") << hundredths;
+        return stream.str();
+    }
+}
 
 MainWindow::MainWindow(unsigned int width, unsigned int height, const std::string& title)
-    : currentState(GameState::Menu), score(0), deaths(0), currentTime(0.0f),
-      lastCheckpoint(100, 250)
+    : currentState(GameState::Menu),
+      levelBuilder({&groundTexture, &platformTexture, &obstacleTexture, &coinTexture, &checkpointTexture, &winPickupTexture}),
+      currentMapHash(0),
+      recordingGhost(false),
+      coinEffect(0),
+      checkpointEffect(0),
+      deathEffect(0),
+      hookEffect(0),
+      heatmapLoaded(false),
+      heatmapLayer(Heatmap::LAYER_COUNT),
+      replayTick(0),
+      replayLag(0),
+      playingReplay(false),
+      serverRunning(false),
+      needsRedraw(true),
+      renderedState(GameState::Menu),
+      windowFocused(true),
+      pausedFrameReady(false),
+      telemetry(nullptr),
+      menuScreen(font),
+      mapThumbnails(assets),
+      mapsChanged(false),
+      indexingMaps(false),
+      firstMapRow(0),
+      connectingScreen(font),
+      winScreen(font),
+      pauseScreen(font)
 {
     window.create(sf::VideoMode({width, height}), title);
     
@@ -13,51 +76,149 @@ MainWindow::MainWindow(unsigned int width, unsigned int height, const std::strin
     camera.setCenter({static_cast<float>(width) / 2.0f, static_cast<float>(height) / 2.0f});
 }
 
-void MainWindow::clearMap()
+MainWindow::~MainWindow()
 {
-    platforms.clear();
-    pickups.clear();
-    physics.clearPlatforms();
+    leaveRace();
 }
 
-void MainWindow::loadMap(const std::string& mapFile)
+void MainWindow::setRaceOptions(const RaceOptions& options)
 {
-    clearMap();
+    raceOptions = options;
+}
+
+void MainWindow::setReplayFile(const std::string& path)
+{
+    replayFile = path;
+}
+
+void MainWindow::setFrameOptions(const FrameOptions& options)
+{
+    frameOptions = options;
+}
+
+void MainWindow::setTelemetry(Telemetry& telemetry_)
+{
+    telemetry = &telemetry_;
+}
+
+void MainWindow::startReplay()
+{
+    if (!replay.load(replayFile))
+        return;
+    
+    loadMap(replay.getMapFile());
+    if (currentState != GameState::Playing)
+        return;
     
-    std::ifstream file("assets/maps/" + mapFile);
-    if (!file.is_open())
+    if (currentMapHash != replay.getMapHash())
+        LogLine(LogLevel::Warning) << "Replay was recorded on another version of " << replay.getMapFile() << ", it may not finish";
+    
+    recordingGhost = false;
+    playingReplay = true;
+    replayTick = 0;
+    replayLag = 0;
+}
+
+void MainWindow::startRace()
+{
+    if (raceOptions.mode == RaceOptions::Mode::Host)
     {
-        std::cerr << "Failed to open map file: " << mapFile << std::endl;
+        server = std::make_unique<GameServer>();
+        if (!server->loadLevel(assets, raceOptions.mapFile) || !server->listen(raceOptions.port))
+        {
+            server.reset();
+            return;
+        }
+        LogLine(LogLevel::Info) << "Hosting " << raceOptions.mapFile << " on port " << server->getPort();
+        
+        serverRunning = true;
+        serverThread = std::thread([this] { server->run(serverRunning); });
+    }
+    
+    std::optional<sf::IpAddress> address = sf::IpAddress::resolve(raceOptions.address);
+    if (!address)
+    {
+        LogLine(LogLevel::Error) << "Unknown host: " << raceOptions.address;
+        leaveRace();
         return;
     }
     
-    std::string line;
+    client = std::make_unique<GameClient>(characterTexture);
+    if (!client->connect(*address, raceOptions.port))
+    {
+        leaveRace();
+        return;
+    }
     
-    // First line is tileset name
-    std::getline(file, line);
-    currentTileset = line;
+    connectingScreen.setText(connectingText, "Connecting to " + raceOptions.address + ":" + std::to_string(raceOptions.port) + "...");
+    currentState = GameState::Connecting;
+}
+
+void MainWindow::leaveRace()
+{
+    if (client)
+    {
+        client->disconnect();
+        client.reset();
+    }
     
-    // Load tileset textures
-    if (!groundTexture.loadFromFile("assets/" + currentTileset + "_ground.png"))
+    if (serverThread.joinable())
     {
-        std::cerr << "Could not load ground texture for tileset: " << currentTileset << std::endl;
+        serverRunning = false;
+        serverThread.join();
+    }
+    server.reset();
+    remotePlayers.clear();
+}
+
+void MainWindow::clearMap()
+{
+    if (simulation)
+        simulation->clear();
+    
+    currentMap.objects.clear();
+    levelEntities.clear();
+    ghosts.clear();
+    ghostRecorder.clear();
+    ghostRenderer.clear();
+    recordingGhost = false;
+    playingReplay = false;
+    particles.clear();
+    inputLatency.reset();
+    heatmap = Heatmap();
+    heatmapLoaded = false;
+    heatmapLayer = Heatmap::LAYER_COUNT;
+    heatmapSprite.reset();
+}
+
+bool MainWindow::readMap(const std::string& mapFile, MapData& map, std::uint64_t& hash)
+{
+    // Same reader as race mode; the hash tells ghosts of an older map apart
+    return assets.readMap(mapFile, map, hash);
+}
+
+void MainWindow::loadTilesetTextures()
+{
+    if (!assets.loadTexture(groundTexture, currentTileset + "_ground.png"))
+    {
+        LogLine(LogLevel::Error) << "Could not load ground texture for tileset: " << currentTileset;
     }
     groundTexture.setRepeated(true);
     
-    if (!platformTexture.loadFromFile("assets/" + currentTileset + "_platform.png"))
+    if (!assets.loadTexture(platformTexture, currentTileset + "_platform.png"))
     {
-        std::cerr << "Could not load platform texture for tileset: " << currentTileset << std::endl;
+        LogLine(LogLevel::Error) << "Could not load platform texture for tileset: " << currentTileset;
     }
     
-    if (!obstacleTexture.loadFromFile("assets/" + currentTileset + "_obstacle.png"))
+    if (!assets.loadTexture(obstacleTexture, currentTileset + "_obstacle.png"))
     {
-        std::cerr << "Could not load obstacle texture for tileset: " << currentTileset << std::endl;
+        LogLine(LogLevel::Error) << "Could not load obstacle texture for tileset: " << currentTileset;
     }
     
     // Load background
-    if (!backgroundTexture.loadFromFile("assets/" + currentTileset + ".png"))
+    if (!assets.loadTexture(backgroundTexture, currentTileset + ".png"))
     {
-        std::cerr << "Could not load background for tileset: " << currentTileset << std::endl;
+        LogLine(LogLevel::Error) << "Could not load background for tileset: " << currentTileset;
     }
     else
     {
@@ -68,243 +229,374 @@ void MainWindow::loadMap(const std::string& mapFile)
         // Make background large enough to cover the map
         
     }
+}
+
+void MainWindow::loadMap(const std::string& mapFile)
+{
+    // The worker must be idle while the level is rebuilt
+    simulationThread->wait();
+    clearMap();
+    
+    // Bad lines are skipped, the rest of the level still loads
+    MapData map;
+    std::uint64_t hash = 0;
+    if (!readMap(mapFile, map, hash) && map.tileset.empty())
+        return;
+    
+    currentMapFile = mapFile;
+    currentMapHash = hash;
+    currentTileset = map.tileset;
+    loadTilesetTextures();
+    
+    levelBuilder.build(*simulation, map, levelEntities);
+    currentMap = std::move(map);
+    
+    // Reset game state and player
+    simulation->restart({LevelBuilder::SPAWN_X, LevelBuilder::SPAWN_Y});
+    
+    // IMPORTANT: Re-bind the character texture to ensure it's still correct
+    // Loading other textures might affect sprite texture binding
+    simulation->getPlayer().setTexture(characterTexture);
+    playerSprite->setTexture(characterTexture);
+    
+    simulationThread->refresh();
+    updateUI(simulationThread->getFront());
+    
+    ghostLibrary.load(currentMapFile, currentMapHash, ghosts);
+    recordingGhost = true;
+    
+    if (telemetry)
+        telemetry->record(TelemetryType::LevelLoaded, {}, currentMapHash, currentMapFile);
+    
+    currentState = GameState::Playing;
+}
+
+void MainWindow::checkAssetChanges()
+{
+    changedAssets.clear();
+    assetWatcher.poll(changedAssets);
+    if (changedAssets.empty())
+        return;
     
-    // Parse map objects
-    while (std::getline(file, line))
+    // Any map added, removed or edited; the menu indexes them again
+    const std::string prefix = assets.getDirectory() + "/";
+    for (const auto& path : changedAssets)
     {
-        std::istringstream iss(line);
-        std::string type;
-        iss >> type;
+        if (path.compare(0, prefix.size() + 5, prefix + "maps/") == 0)
+            mapsChanged = true;
+    }
+    
+    // Changes made from the menu are picked up when the map is next loaded
+    if (currentState != GameState::Playing && currentState != GameState::Paused)
+        return;
+    
+    // Called between frames, so the simulation worker is idle
+    bool changed = false;
+    for (const auto& path : changedAssets)
+    {
+        if (path.compare(0, prefix.size(), prefix) != 0)
+            continue;
         
-        if (type == "ground")
-        {
-            float x, y, width, height;
-            iss >> x >> y >> width >> height;
-            
-            auto ground = std::make_shared<Platform>(groundTexture, PlatformType::Ground);
-            ground->setPosition({x, y});
-            ground->setTextureRect(sf::IntRect({0, 0}, {static_cast<int>(width), static_cast<int>(height)}));
-            platforms.push_back(ground);
-            physics.addPlatform(ground);
-        }
-        else if (type == "platform")
-        {
-            float x, y;
-            iss >> x >> y;
-            
-            auto platform = std::make_shared<Platform>(platformTexture, PlatformType::Floating);
-            platform->setPosition({x, y});
-            sf::Vector2f size = static_cast<sf::Vector2f>(platformTexture.getSize());
-            platform->setSize(size.x, size.y);
-            platforms.push_back(platform);
-            physics.addPlatform(platform);
-        }
-        else if (type == "obstacle")
-        {
-            float x, y;
-            iss >> x >> y;
-            
-            auto obstacle = std::make_shared<Platform>(obstacleTexture, PlatformType::DeathPit);
-            obstacle->setPosition({x, y});
-            sf::Vector2f size = static_cast<sf::Vector2f>(obstacleTexture.getSize());
-            obstacle->setSize(size.x, size.y);
-            platforms.push_back(obstacle);
-            physics.addPlatform(obstacle);
-        }
-        else if (type == "pickup")
-        {
-            float x, y;
-            iss >> x >> y;
-            
-            auto coin = std::make_shared<Coin>(coinTexture);
-            coin->setPosition({x, y});
-            pickups.push_back(coin);
-        }
-        else if (type == "checkpoint")
+        std::string name = path.substr(prefix.size());
+        // A race has to keep the level the server simulates
+        if (name == "maps/" + currentMapFile && !client)
         {
-            float x, y;
-            iss >> x >> y;
-            
-            auto checkpoint = std::make_shared<Checkpoint>(checkpointTexture);
-            checkpoint->setPosition({x, y});
-            pickups.push_back(checkpoint);
+            reloadMap();
+            changed = true;
         }
-        else if (type == "win")
+        else if (name.size() > 4 && name.compare(name.size() - 4, 4, ".png") == 0)
         {
-            float x, y;
-            iss >> x >> y;
-            
-            auto winPickup = std::make_shared<WinPickup>(winPickupTexture);
-            winPickup->setPosition({x, y});
-            pickups.push_back(winPickup);
+            reloadTexture(name);
+            changed = true;
         }
     }
     
-    file.close();
+    if (changed)
+    {
+        simulationThread->refresh();
+        pausedFrameReady = false;
+        needsRedraw = true;
+    }
+}
+
+void MainWindow::reloadMap()
+{
+    // Editors can save half-typed lines; keep playing the old version until it parses
+    MapData map;
+    std::uint64_t hash = 0;
+    if (!readMap(currentMapFile, map, hash))
+    {
+        LogLine(LogLevel::Warning) << "Not reloading " << currentMapFile << " until its errors are fixed";
+        return;
+    }
+    
+    if (map.tileset != currentTileset)
+    {
+        currentTileset = map.tileset;
+        loadTilesetTextures();
+    }
+    
+    MapDiff diff;
+    diffMaps(currentMap, map, diff);
+    if (diff.empty())
+        return;
     
-    // Reset game state
-    score = 0;
-    deaths = 0;
-    currentTime = 0.0f;
-    lastCheckpoint = sf::Vector2f(100, 250);
-    gameTimer.restart();
+    // Old ghosts ran a different level; restarting brings back the ones for this one
+    currentMapHash = hash;
+    ghosts.clear();
+    ghostRenderer.clear();
+    recordingGhost = false;
     
-    // Reset player
-    if (player)
+    std::vector<Entity> entities(map.objects.size(), NULL_ENTITY);
+    for (const auto& [before, after] : diff.unchanged)
     {
-        player->setPosition(lastCheckpoint);
-        player->reset();
-        
-        // IMPORTANT: Re-bind the character texture to ensure it's still correct
-        // Loading other textures might affect sprite texture binding
-        player->setTexture(characterTexture);
+        entities[after] = levelEntities[before];
     }
     
-    currentState = GameState::Playing;
+    std::vector<std::pair<Entity, sf::Vector2f>> moves;
+    moves.reserve(diff.moved.size());
+    for (const auto& [before, after] : diff.moved)
+    {
+        entities[after] = levelEntities[before];
+        moves.emplace_back(levelEntities[before], sf::Vector2f(map.objects[after].x(), map.objects[after].y()));
+    }
+    simulation->moveObjects(moves);
+    
+    std::vector<Entity> removed;
+    removed.reserve(diff.removed.size());
+    for (std::size_t before : diff.removed)
+    {
+        removed.push_back(levelEntities[before]);
+    }
+    simulation->removeObjects(removed);
+    
+    for (std::size_t after : diff.added)
+    {
+        entities[after] = levelBuilder.createObject(*simulation, map.objects[after]);
+    }
+    
+    levelEntities = std::move(entities);
+    currentMap = std::move(map);
+    
+    LogLine(LogLevel::Info) << "Reloaded " << currentMapFile << ": " << diff.added.size() << " added, "
+                            << diff.removed.size() << " removed, " << diff.moved.size() << " moved";
+}
+
+void MainWindow::reloadTexture(const std::string& name)
+{
+    // Textures are reloaded in place, so every sprite pointing at one keeps working
+    struct WatchedTexture
+    {
+        std::string name;
+        sf::Texture* texture;
+        bool repeated;
+    };
+    
+    const WatchedTexture watched[] = {
+        {"hero.png", &characterTexture, false},
+        {"coin.png", &coinTexture, false},
+        {"checkpoint.png", &checkpointTexture, false},
+        {"win.png", &winPickupTexture, false},
+        {currentTileset + "_ground.png", &groundTexture, true},
+        {currentTileset + "_platform.png", &platformTexture, false},
+        {currentTileset + "_obstacle.png", &obstacleTexture, false},
+        {currentTileset + ".png", &backgroundTexture, true}
+    };
+    
+    for (const auto& entry : watched)
+    {
+        if (entry.name != name)
+            continue;
+        
+        if (!assets.loadTexture(*entry.texture, name))
+        {
+            LogLine(LogLevel::Error) << "Could not reload texture: " << name;
+            return;
+        }
+        entry.texture->setRepeated(entry.repeated);
+        
+        LogLine(LogLevel::Info) << "Reloaded " << name;
+        return;
+    }
 }
 
 void MainWindow::setupMenu()
 {
-    // Setup logo
-    logoText = std::make_unique<sf::Text>(font);
-    logoText->setString("HOOKLEAP");
-    logoText->setCharacterSize(80);
-    logoText->setFillColor(sf::Color::White);
-    logoText->setPosition({window.getSize().x / 2.0f - 200, 100});
+    float width = static_cast<float>(window.getSize().x);
     
-    // Setup map buttons
-    mapButtons.clear();
-    std::vector<std::string> maps = {"map1.txt", "map2.txt"};
+    menuScreen.clear();
+    menuScreen.addLabel({{0, 80}, {width, 80}}, "HOOKLEAP", 80, sf::Color::White, UiAlign::Center);
     
-    float startY = 300;
-    float spacing = 80;
+    // A fixed set of rows; scrolling only changes their text
+    mapRows.clear();
+    UiColumn column(width / 2.0f, 200, 10);
+    for (std::size_t i = 0; i < VISIBLE_MAP_ROWS; ++i)
+    {
+        sf::FloatRect rect = column.next({560, 66});
+        
+        MapRow row;
+        row.button = menuScreen.addButton(rect, "", 30, sf::Color(100, 100, 100));
+        row.thumbnailPosition = {rect.position.x + 6, rect.position.y + 6};
+        row.nameText = menuScreen.addLabel({{rect.position.x + 118, rect.position.y + 6}, {430, 30}}, "", 26,
+                                           sf::Color::White);
+        row.infoText = menuScreen.addLabel({{rect.position.x + 118, rect.position.y + 40}, {430, 20}}, "", 16,
+                                           sf::Color(220, 220, 220));
+        mapRows.push_back(row);
+    }
+    mapListText = menuScreen.addLabel(column.next({560, 24}), "", 18, sf::Color(180, 180, 180), UiAlign::Center);
+    updateMapRows();
     
-    for (size_t i = 0; i < maps.size(); ++i)
+    quitButton = menuScreen.addButton(column.next({300, 60}), "Quit", 30, sf::Color(150, 50, 50));
+}
+
+void MainWindow::updateMapRows()
+{
+    for (std::size_t i = 0; i < mapRows.size(); ++i)
     {
-        MapButton btn;
-        btn.shape.setSize({300, 60});
-        btn.shape.setPosition({window.getSize().x / 2.0f - 150, startY + i * spacing});
-        btn.shape.setFillColor(sf::Color(100, 100, 100));
+        const MapRow& row = mapRows[i];
+        std::size_t index = firstMapRow + i;
+        bool shown = index < maps.size();
+        menuScreen.setVisible(row.button, shown);
+        menuScreen.setVisible(row.nameText, shown);
+        menuScreen.setVisible(row.infoText, shown);
+        if (!shown)
+            continue;
         
-        btn.text = std::make_unique<sf::Text>(font);
-        btn.text->setString("Level " + std::to_string(i + 1));
-        btn.text->setCharacterSize(30);
-        btn.text->setFillColor(sf::Color::White);
-        btn.text->setPosition({btn.shape.getPosition().x + 80, btn.shape.getPosition().y + 15});
+        const MapInfo& info = maps[index];
+        std::string name = info.file;
+        if (name.size() > 4 && name.compare(name.size() - 4, 4, ".txt") == 0)
+            name.resize(name.size() - 4);
+        menuScreen.setText(row.nameText, name);
         
-        btn.mapFile = maps[i];
-        mapButtons.push_back(std::move(btn));
+        if (!info.valid)
+        {
+            menuScreen.setText(row.infoText, "Has errors, fix them to play");
+            menuScreen.setColor(row.button, sf::Color(110, 70, 70));
+            continue;
+        }
+        menuScreen.setColor(row.button, sf::Color(100, 100, 100));
+        
+        std::ostringstream stream;
+        stream << (info.tileset.empty() ? "default" : info.tileset) << "  |  "
+               << info.count(MapObjectType::Platform) + info.count(MapObjectType::Crumble) << " platforms, "
+               << info.count(MapObjectType::Mover) + info.count(MapObjectType::Oscillator) << " moving, "
+               << info.count(MapObjectType::Obstacle) << " obstacles, "
+               << info.count(MapObjectType::Pickup) << " coins";
+        
+        // Keyed by the map's contents, so an edited map starts a fresh board
+        RunRecord best;
+        if (leaderboard.getPersonalBest(info.hash, best))
+            stream << "  |  Best " << formatTime(best.timeMs / 1000.0f);
+        menuScreen.setText(row.infoText, stream.str());
     }
     
-    // Setup quit button
-    quitButton.setSize({300, 60});
-    quitButton.setPosition({window.getSize().x / 2.0f - 150, startY + maps.size() * spacing});
-    quitButton.setFillColor(sf::Color(150, 50, 50));
+    std::string status;
+    if (maps.empty())
+        status = indexingMaps ? "Looking for maps..." : "No maps in " + assets.getDirectory() + "/maps";
+    else
+        status = std::to_string(firstMapRow + 1) + "-" + std::to_string(std::min(firstMapRow + mapRows.size(), maps.size())) +
+                 " of " + std::to_string(maps.size()) + (indexingMaps ? ", checking for changes..." : "");
+    menuScreen.setText(mapListText, status);
+}
+
+void MainWindow::scrollMaps(int rows)
+{
+    std::size_t last = maps.size() > mapRows.size() ? maps.size() - mapRows.size() : 0;
+    long target = static_cast<long>(firstMapRow) + rows;
+    std::size_t first = static_cast<std::size_t>(std::clamp<long>(target, 0, static_cast<long>(last)));
+    if (first == firstMapRow)
+        return;
+    
+    firstMapRow = first;
+    updateMapRows();
+    needsRedraw = true;
+}
+
+void MainWindow::setupConnectingScreen()
+{
+    sf::Vector2f size(window.getSize());
     
-    quitButtonText = std::make_unique<sf::Text>(font);
-    quitButtonText->setString("Quit");
-    quitButtonText->setCharacterSize(30);
-    quitButtonText->setFillColor(sf::Color::White);
-    quitButtonText->setPosition({quitButton.getPosition().x + 110, quitButton.getPosition().y + 15});
+    connectingScreen.clear();
+    connectingText = connectingScreen.addLabel({{0, 0}, size}, "", 30, sf::Color::White, UiAlign::Center);
 }
 
 void MainWindow::setupWinScreen()
 {
-    // Win screen text
-    winScoreText = std::make_unique<sf::Text>(font);
-    winScoreText->setCharacterSize(40);
-    winScoreText->setFillColor(sf::Color::White);
-    winScoreText->setPosition({window.getSize().x / 2.0f - 100, 200});
-    
-    winTimeText = std::make_unique<sf::Text>(font);
-    winTimeText->setCharacterSize(40);
-    winTimeText->setFillColor(sf::Color::White);
-    winTimeText->setPosition({window.getSize().x / 2.0f - 100, 260});
-    
-    winDeathsText = std::make_unique<sf::Text>(font);
-    winDeathsText->setCharacterSize(40);
-    winDeathsText->setFillColor(sf::Color::White);
-    winDeathsText->setPosition({window.getSize().x / 2.0f - 100, 320});
-    
-    // Buttons
-    float startY = 420;
-    float spacing = 80;
-    
-    restartButton.setSize({300, 60});
-    restartButton.setPosition({window.getSize().x / 2.0f - 150, startY});
-    restartButton.setFillColor(sf::Color(100, 150, 100));
-    
-    restartButtonText = std::make_unique<sf::Text>(font);
-    restartButtonText->setString("Restart");
-    restartButtonText->setCharacterSize(30);
-    restartButtonText->setFillColor(sf::Color::White);
-    restartButtonText->setPosition({restartButton.getPosition().x + 80, restartButton.getPosition().y + 15});
-    
-    menuButton.setSize({300, 60});
-    menuButton.setPosition({window.getSize().x / 2.0f - 150, startY + spacing});
-    menuButton.setFillColor(sf::Color(100, 100, 150));
-    
-    menuButtonText = std::make_unique<sf::Text>(font);
-    menuButtonText->setString("Main Menu");
-    menuButtonText->setCharacterSize(30);
-    menuButtonText->setFillColor(sf::Color::White);
-    menuButtonText->setPosition({menuButton.getPosition().x + 60, menuButton.getPosition().y + 15});
-    
-    winQuitButton.setSize({300, 60});
-    winQuitButton.setPosition({window.getSize().x / 2.0f - 150, startY + spacing * 2});
-    winQuitButton.setFillColor(sf::Color(150, 50, 50));
-    
-    winQuitButtonText = std::make_unique<sf::Text>(font);
-    winQuitButtonText->setString("Quit");
-    winQuitButtonText->setCharacterSize(30);
-    winQuitButtonText->setFillColor(sf::Color::White);
-    winQuitButtonText->setPosition({winQuitButton.getPosition().x + 110, winQuitButton.getPosition().y + 15});
+    float width = static_cast<float>(window.getSize().x);
+    float left = width / 2.0f - 100;
+    
+    winScreen.clear();
+    winScreen.addLabel({{0, 100}, {width, 60}}, "LEVEL COMPLETE!", 60, sf::Color::Yellow, UiAlign::Center);
+    
+    // Filled in when a run ends
+    winScoreText = winScreen.addLabel({{left, 200}, {300, 40}}, "", 40, sf::Color::White);
+    winTimeText = winScreen.addLabel({{left, 260}, {300, 40}}, "", 40, sf::Color::White);
+    winDeathsText = winScreen.addLabel({{left, 320}, {300, 40}}, "", 40, sf::Color::White);
+    winRankText = winScreen.addLabel({{left, 375}, {300, 26}}, "", 26, sf::Color::Yellow);
+    winTopText = winScreen.addLabel({{width - 330.0f, 200}, {300, 200}}, "", 24, sf::Color::White);
+    
+    UiColumn column(width / 2.0f, 420, 20);
+    restartButton = winScreen.addButton(column.next({300, 60}), "Restart", 30, sf::Color(100, 150, 100));
+    menuButton = winScreen.addButton(column.next({300, 60}), "Main Menu", 30, sf::Color(100, 100, 150));
+    winQuitButton = winScreen.addButton(column.next({300, 60}), "Quit", 30, sf::Color(150, 50, 50));
+}
+
+void MainWindow::setupPauseScreen()
+{
+    sf::FloatRect screen({0, 0}, window.getDefaultView().getSize());
+    
+    pauseScreen.clear();
+    pauseScreen.addPanel(screen, sf::Color(0, 0, 0, 120));
+    pauseScreen.addLabel(screen, "PAUSED", 60, sf::Color::White, UiAlign::Center);
 }
 
 void MainWindow::init()
 {
+    // assets.pak if the build shipped one, loose files otherwise
+    assets.open();
+    
     // Load font
-    auto fontResult = font.openFromFile("assets/font.otf");
+    auto fontResult = assets.loadFont(font, "font.otf");
     if (!fontResult)
     {
-        std::cerr << "Could not load font, using default" << std::endl;
+        LogLine(LogLevel::Error) << "Could not load font, using default";
     }
     
     // Load character texture
-    if(!characterTexture.loadFromFile("assets/hero.png"))
+    if(!assets.loadTexture(characterTexture, "hero.png"))
     {
-        std::cerr << "Could not load texture" << std::endl;
+        LogLine(LogLevel::Error) << "Could not load texture";
     }
     
     // Load pickup textures
-    if (!coinTexture.loadFromFile("assets/coin.png"))
+    if (!assets.loadTexture(coinTexture, "coin.png"))
     {
-        std::cerr << "Could not load coin texture" << std::endl;
+        LogLine(LogLevel::Error) << "Could not load coin texture";
     }
     
-    if (!checkpointTexture.loadFromFile("assets/checkpoint.png"))
+    if (!assets.loadTexture(checkpointTexture, "checkpoint.png"))
     {
-        std::cerr << "Could not load checkpoint texture" << std::endl;
+        LogLine(LogLevel::Error) << "Could not load checkpoint texture";
     }
     
-    if (!winPickupTexture.loadFromFile("assets/win.png"))
+    if (!assets.loadTexture(winPickupTexture, "win.png"))
     {
-        std::cerr << "Could not load win pickup texture" << std::endl;
+        LogLine(LogLevel::Error) << "Could not load win pickup texture";
     }
 
-    player = std::make_unique<Player>(characterTexture);
-    
-    // Setup animations
-    player->setAnimationRow(PlayerState::Idle, 1, 10, true);
-    player->setAnimationRow(PlayerState::Walking, 3, 10, true);
-    player->setAnimationRow(PlayerState::Jumping, 10, 6, false);
-    player->setAnimationRow(PlayerState::BeginFalling, 11, 4, false);
-    player->setAnimationRow(PlayerState::Falling, 12, 3, true); 
-    player->setAnimationRow(PlayerState::Hooked, 13, 4, true);
-    
-    player->setFps(20);
-    player->setPosition({100, 250});
-    player->setHitbox(54, 44, 20, 37);
+    // Edited maps and textures are applied while playing. A pack is a
+    // release build, so there is nothing to watch.
+    if (!assets.isPacked())
+    {
+        assetWatcher.watch(assets.getDirectory());
+        assetWatcher.watch(assets.getDirectory() + "/maps");
+    }
+
+    simulation = std::make_unique<Simulation>(characterTexture);
+    simulationThread = std::make_unique<SimulationThread>(*simulation);
+    playerSprite = std::make_unique<sf::Sprite>(characterTexture);
+    remoteSprite = std::make_unique<sf::Sprite>(characterTexture);
+    remoteSprite->setColor(sf::Color(255, 255, 255, 150));
     
     // Setup UI
     scoreText = std::make_unique<sf::Text>(font);
@@ -315,61 +607,101 @@ void MainWindow::init()
     timeText->setCharacterSize(30);
     timeText->setFillColor(sf::Color::White);
     
+    netStatsText = std::make_unique<sf::Text>(font);
+    netStatsText->setCharacterSize(18);
+    netStatsText->setFillColor(sf::Color::White);
+    
+    if (!leaderboard.open())
+    {
+        LogLine(LogLevel::Warning) << "Run history is unavailable, runs will not be saved";
+    }
+    
+    // Lists what the last run indexed straight away, then catches up
+    mapIndex.start(assets);
+    indexingMaps = true;
+    
     setupMenu();
+    setupConnectingScreen();
     setupWinScreen();
+    setupPauseScreen();
+    setupParticles();
+    
+    window.setVerticalSyncEnabled(frameOptions.vsync);
+    pacer.setTargetFps(frameOptions.targetFps);
+    
+    if (raceOptions.mode != RaceOptions::Mode::None)
+        startRace();
+    else if (!replayFile.empty())
+        startReplay();
 }
 
 void MainWindow::handleMenuEvents(const sf::Event& event)
 {
-    if (event.is<sf::Event::MouseButtonPressed>())
+    if (const auto* mouseEvent = event.getIf<sf::Event::MouseButtonPressed>())
     {
-        sf::Vector2i mousePos = sf::Mouse::getPosition(window);
+        UiScreen::WidgetId hit = menuScreen.hitTest(window.mapPixelToCoords(mouseEvent->position, window.getDefaultView()));
+        if (hit == UiScreen::NONE)
+            return;
         
-        // Check map buttons
-        for (const auto& btn : mapButtons)
+        if (hit == quitButton)
         {
-            if (btn.shape.getGlobalBounds().contains(static_cast<sf::Vector2f>(mousePos)))
-            {
-                loadMap(btn.mapFile);
-                return;
-            }
+            window.close();
+            return;
         }
         
-        // Check quit button
-        if (quitButton.getGlobalBounds().contains(static_cast<sf::Vector2f>(mousePos)))
+        for (std::size_t i = 0; i < mapRows.size(); ++i)
         {
-            window.close();
+            std::size_t index = firstMapRow + i;
+            if (hit == mapRows[i].button && index < maps.size() && maps[index].valid)
+            {
+                loadMap(maps[index].file);
+                return;
+            }
         }
     }
+    else if (const auto* wheelEvent = event.getIf<sf::Event::MouseWheelScrolled>())
+    {
+        scrollMaps(wheelEvent->delta > 0 ? -1 : 1);
+    }
+    else if (const auto* keyEvent = event.getIf<sf::Event::KeyPressed>())
+    {
+        int page = static_cast<int>(mapRows.size());
+        if (keyEvent->code == sf::Keyboard::Key::Up)
+            scrollMaps(-1);
+        else if (keyEvent->code == sf::Keyboard::Key::Down)
+            scrollMaps(1);
+        else if (keyEvent->code == sf::Keyboard::Key::PageUp)
+            scrollMaps(-page);
+        else if (keyEvent->code == sf::Keyboard::Key::PageDown)
+            scrollMaps(page);
+    }
 }
 
 void MainWindow::handlePlayingEvents(const sf::Event& event)
 {
-    if (event.is<sf::Event::KeyPressed>())
+    // Gameplay input is sampled once per tick from InputSystem in updatePlaying
+    if (const auto* keyEvent = event.getIf<sf::Event::KeyPressed>())
     {
-        const auto& keyEvent = *event.getIf<sf::Event::KeyPressed>();
-        if (keyEvent.code == sf::Keyboard::Key::Escape)
-        {
-            currentState = GameState::Paused;
-        }
+        if (keyEvent->code == sf::Keyboard::Key::H)
+            cycleHeatmap();
     }
 }
 
 void MainWindow::handleWinScreenEvents(const sf::Event& event)
 {
-    if (event.is<sf::Event::MouseButtonPressed>())
+    if (const auto* mouseEvent = event.getIf<sf::Event::MouseButtonPressed>())
     {
-        sf::Vector2i mousePos = sf::Mouse::getPosition(window);
+        UiScreen::WidgetId hit = winScreen.hitTest(window.mapPixelToCoords(mouseEvent->position, window.getDefaultView()));
         
-        if (restartButton.getGlobalBounds().contains(static_cast<sf::Vector2f>(mousePos)))
+        if (hit == restartButton)
         {
             restartLevel();
         }
-        else if (menuButton.getGlobalBounds().contains(static_cast<sf::Vector2f>(mousePos)))
+        else if (hit == menuButton)
         {
             returnToMenu();
         }
-        else if (winQuitButton.getGlobalBounds().contains(static_cast<sf::Vector2f>(mousePos)))
+        else if (hit == winQuitButton)
         {
             window.close();
         }
@@ -378,38 +710,70 @@ void MainWindow::handleWinScreenEvents(const sf::Event& event)
 
 void MainWindow::handleEvents()
 {
+    // Nothing to draw: sleep until there is, waking up now and then so
+    // edited assets are still noticed
+    if (!needsRender())
+    {
+        float wake = windowFocused ? IDLE_WAKE_SECONDS : BACKGROUND_IDLE_WAKE_SECONDS;
+        if (isLoadingMaps())
+            wake = LOADING_WAKE_SECONDS;
+        if (const std::optional event = window.waitEvent(sf::seconds(wake)))
+            handleEvent(*event);
+    }
+    
     while (const std::optional event = window.pollEvent())
     {
-        if (event->is<sf::Event::Closed>())
-            window.close();
-            
-        switch (currentState)
-        {
-            case GameState::Menu:
-                handleMenuEvents(*event);
-                break;
-            case GameState::Playing:
-                handlePlayingEvents(*event);
-                break;
-            case GameState::WinScreen:
-                handleWinScreenEvents(*event);
-                break;
-            case GameState::Paused:
-                if (event->is<sf::Event::KeyPressed>())
-                {
-                    currentState = GameState::Playing;
-                }
-                break;
-        }
+        handleEvent(*event);
     }
 }
 
-void MainWindow::updateCamera()
+void MainWindow::handleEvent(const sf::Event& event)
 {
-    if (!player->isAlive())
-        return;
-    
-    sf::FloatRect playerHitbox = player->getGlobalHitbox();
+    if (event.is<sf::Event::Closed>())
+        window.close();
+    else if (event.is<sf::Event::FocusLost>())
+        windowFocused = false;
+    else if (event.is<sf::Event::FocusGained>())
+        windowFocused = true;
+    
+    // Moving the mouse changes nothing on screen, anything else may
+    if (!event.is<sf::Event::MouseMoved>())
+        needsRedraw = true;
+    
+    input.handleEvent(event);
+    
+    // A replay plays itself, there is nothing to answer
+    if (currentState == GameState::Playing && !playingReplay &&
+        (event.is<sf::Event::KeyPressed>() || event.is<sf::Event::MouseButtonPressed>()))
+        inputLatency.inputSeen();
+        
+    switch (currentState)
+    {
+        case GameState::Menu:
+            handleMenuEvents(event);
+            break;
+        case GameState::Connecting:
+            break;
+        case GameState::Playing:
+            handlePlayingEvents(event);
+            break;
+        case GameState::WinScreen:
+            handleWinScreenEvents(event);
+            break;
+        case GameState::Paused:
+            if (event.is<sf::Event::KeyPressed>())
+            {
+                // The key that resumes must not pause again on the next tick
+                input.flush();
+                currentState = GameState::Playing;
+            }
+            break;
+    }
+}
+
+void MainWindow::updateCamera(const RenderSnapshot& snapshot)
+{
+    const sf::FloatRect& playerHitbox = snapshot.playerHitbox;
     
     sf::Vector2f hitboxCenter(
         playerHitbox.position.x + playerHitbox.size.x / 2.0f,
@@ -423,190 +787,449 @@ void MainWindow::updateCamera()
     camera.setCenter(newCenter);
 }
 
-void MainWindow::updateUI()
+void MainWindow::updateUI(const RenderSnapshot& snapshot)
 {
     // Update score text
-    scoreText->setString("Score: " + std::to_string(score));
+    scoreText->setString("Score: " + std::to_string(snapshot.score));
     sf::Vector2f topLeft = camera.getCenter() - camera.getSize() / 2.0f;
     scoreText->setPosition({topLeft.x + 20, topLeft.y + 20});
     
     // Update time text
-    int minutes = static_cast<int>(currentTime) / 60;
-    int seconds = static_cast<int>(currentTime) % 60;
-    int milliseconds = static_cast<int>((currentTime - static_cast<int>(currentTime)) * 100);
-    
-    std::ostringstream timeStream;
-    timeStream << minutes << ":" 
-               << (seconds < 10 ? "0" : "") << seconds << "."
-               << (milliseconds < 10 ? "0" : "") << milliseconds;
-    
-    timeText->setString(timeStream.str());
+    timeText->setString(formatTime(snapshot.time));
     sf::Vector2f topRight = camera.getCenter() + sf::Vector2f(camera.getSize().x / 2.0f, -camera.getSize().y / 2.0f);
     sf::FloatRect timeBounds = timeText->getLocalBounds();
     timeText->setPosition({topRight.x - timeBounds.size.x - 20, topRight.y + 20});
 }
 
-void MainWindow::respawnPlayer()
+void MainWindow::updateNetStats()
 {
-    deaths++;
-    player->setPosition({lastCheckpoint.x-16, lastCheckpoint.y-16});
-    player->reset();
+    const NetStats& stats = client->getStats();
+    
+    std::ostringstream statsStream;
+    statsStream << std::fixed << std::setprecision(1)
+                << "RTT " << stats.getRoundTrip() << " ms   "
+                << "down " << stats.getReceivedPerSecond() / 1024.0f << " KB/s   "
+                << "up " << stats.getSentPerSecond() / 1024.0f << " KB/s   "
+                << "loss " << stats.getSnapshotLoss() * 100.0f << "%   "
+                << "corrections " << stats.getCorrections();
+    
+    netStatsText->setString(statsStream.str());
+    sf::Vector2f bottomLeft = camera.getCenter() + sf::Vector2f(-camera.getSize().x / 2.0f, camera.getSize().y / 2.0f);
+    netStatsText->setPosition({bottomLeft.x + 20, bottomLeft.y - 40});
 }
 
-void MainWindow::collectPickup(std::shared_ptr<Pickup> pickup)
+void MainWindow::triggerWinScreen(const RenderSnapshot& snapshot)
 {
-    if (pickup->isCollected())
-        return;
+    currentState = GameState::WinScreen;
+    inputLatency.reset();
     
-    pickup->collect();
+    // Update win screen text
+    winScreen.setText(winScoreText, "Score: " + std::to_string(snapshot.score));
+    winScreen.setText(winTimeText, "Time: " + formatTime(snapshot.time));
+    winScreen.setText(winDeathsText, "Deaths: " + std::to_string(snapshot.deaths));
+    
+    RunRecord run;
+    run.mapHash = currentMapHash;
+    run.timeMs = static_cast<std::uint32_t>(std::lround(snapshot.time * 1000.0f));
+    run.score = snapshot.score;
+    run.deaths = static_cast<std::uint32_t>(snapshot.deaths);
+    run.finishedAt = static_cast<std::int64_t>(std::time(nullptr));
+    std::size_t rank = playingReplay ? 0 : leaderboard.add(run);
+    
+    std::uint64_t runCount = leaderboard.getRunCount(currentMapHash);
+    RunRecord best;
+    if (rank == 1)
+        winScreen.setText(winRankText, "New best time!");
+    else if (rank > 1)
+        winScreen.setText(winRankText, "#" + std::to_string(rank) + " of " + std::to_string(runCount) + " runs");
+    else if (leaderboard.getPersonalBest(currentMapHash, best))
+        winScreen.setText(winRankText, "Best " + formatTime(best.timeMs / 1000.0f) + " of " + std::to_string(runCount) + " runs");
+    else
+        winScreen.setText(winRankText, "");
     
-    // Check pickup type and handle accordingly
-    if (auto coin = std::dynamic_pointer_cast<Coin>(pickup))
+    std::vector<RunRecord> top;
+    leaderboard.getTop(currentMapHash, 5, top);
+    std::ostringstream topStream;
+    topStream << "Best times";
+    for (std::size_t i = 0; i < top.size(); ++i)
     {
-        score++;
+        topStream << "\n" << i + 1 << ".  " << formatTime(top[i].timeMs / 1000.0f)
+                  << "  " << top[i].deaths << (top[i].deaths == 1 ? " death" : " deaths");
     }
-    else if (auto checkpoint = std::dynamic_pointer_cast<Checkpoint>(pickup))
+    winScreen.setText(winTopText, topStream.str());
+}
+
+void MainWindow::restartLevel()
+{
+    // Only the server can restart a race
+    if (client)
+    {
+        returnToMenu();
+        return;
+    }
+    
+    if (playingReplay)
     {
-        lastCheckpoint = checkpoint->getPosition();
+        startReplay();
+        return;
     }
-    else if (auto winPickup = std::dynamic_pointer_cast<WinPickup>(pickup))
+    
+    // Reload current map
+    if (!currentMapFile.empty())
     {
-        triggerWinScreen();
+        loadMap(currentMapFile);
     }
 }
 
-void MainWindow::triggerWinScreen()
+void MainWindow::returnToMenu()
 {
-    currentState = GameState::WinScreen;
-    
-    // Update win screen text
-    winScoreText->setString("Score: " + std::to_string(score));
-    
-    int minutes = static_cast<int>(currentTime) / 60;
-    int seconds = static_cast<int>(currentTime) % 60;
-    int milliseconds = static_cast<int>((currentTime - static_cast<int>(currentTime)) * 100);
-    
-    std::ostringstream timeStream;
-    timeStream << "Time: " << minutes << ":" 
-               << (seconds < 10 ? "0" : "") << seconds << "."
-               << (milliseconds < 10 ? "0" : "") << milliseconds;
-    winTimeText->setString(timeStream.str());
-    
-    winDeathsText->setString("Deaths: " + std::to_string(deaths));
+    leaveRace();
+    simulationThread->wait();
+    clearMap();
+    updateMapRows();
+    currentState = GameState::Menu;
+    camera.setCenter({static_cast<float>(window.getSize().x) / 2.0f, 
+                      static_cast<float>(window.getSize().y) / 2.0f});
 }
 
-void MainWindow::restartLevel()
+void MainWindow::updateMenu(sf::Time& elapsed)
 {
-    // Reload current map
-    std::string currentMap;
-    for (const auto& btn : mapButtons)
+    // Maps added or edited while away are indexed when the menu is back
+    if (mapsChanged)
     {
-        // Find which map was loaded (you might want to track this)
-        currentMap = btn.mapFile;
-        break;
+        mapsChanged = false;
+        mapIndex.start(assets);
     }
     
-    if (!currentMap.empty())
+    bool changed = false;
+    if (mapIndex.poll(maps))
+    {
+        std::size_t last = maps.size() > mapRows.size() ? maps.size() - mapRows.size() : 0;
+        firstMapRow = std::min(firstMapRow, last);
+        changed = true;
+    }
+    if (indexingMaps != mapIndex.isScanning())
     {
-        loadMap(currentMap);
+        indexingMaps = mapIndex.isScanning();
+        changed = true;
     }
+    if (changed)
+    {
+        updateMapRows();
+        needsRedraw = true;
+    }
+    
+    if (mapThumbnails.update())
+        needsRedraw = true;
 }
 
-void MainWindow::returnToMenu()
+void MainWindow::updateConnecting(sf::Time& elapsed)
 {
+    client->update(InputState(), elapsed);
+    
+    if (client->getStatus() == GameClient::Status::Connecting)
+        return;
+    
+    MapData map;
+    if (client->getStatus() != GameClient::Status::Connected || !client->readLevel(assets, map))
+    {
+        LogLine(LogLevel::Error) << "Could not join the race: " << client->getError();
+        returnToMenu();
+        return;
+    }
+    
+    simulationThread->wait();
     clearMap();
-    currentState = GameState::Menu;
-    camera.setCenter({static_cast<float>(window.getSize().x) / 2.0f, 
-                      static_cast<float>(window.getSize().y) / 2.0f});
+    
+    // Textures first, the level's sprites are sized from them
+    currentMapFile = client->getMapFile();
+    currentMapHash = client->getMapHash();
+    currentTileset = map.tileset;
+    loadTilesetTextures();
+    client->buildLevel(levelBuilder, map);
+    currentMap = std::move(map);
+    client->getPredicted().buildSnapshot(raceSnapshot);
+    
+    playerSprite->setTexture(characterTexture);
+    input.flush();
+    currentState = GameState::Playing;
 }
 
-void MainWindow::updateMenu(sf::Time& elapsed)
+void MainWindow::updateRace(sf::Time& elapsed)
 {
-    // Menu doesn't need updates
+    // A race can't be paused; Escape leaves it
+    InputState inputState = input.sample(window, camera);
+    if (inputState.wasPressed(Action::Pause))
+    {
+        returnToMenu();
+        return;
+    }
+    
+    // The predicted tick is simulated here and drawn this frame
+    client->update(inputState, elapsed);
+    inputLatency.tickSubmitted();
+    inputLatency.tickFinished();
+    if (client->getStatus() != GameClient::Status::Connected)
+    {
+        LogLine(LogLevel::Warning) << "Left the race: " << client->getError();
+        returnToMenu();
+        return;
+    }
+    
+    client->getPredicted().buildSnapshot(raceSnapshot);
+    client->getRemotePlayers(remotePlayers);
+    
+    updateCamera(raceSnapshot);
+    updateUI(raceSnapshot);
+    updateNetStats();
+    
+    if (client->hasFinished())
+    {
+        triggerWinScreen(raceSnapshot);
+    }
 }
 
 void MainWindow::updatePlaying(sf::Time& elapsed)
 {
-    if (!player->isAlive())
+    if (client)
+    {
+        updateRace(elapsed);
         return;
-    
-    // Update game timer
-    currentTime = gameTimer.getElapsedTime().asSeconds();
+    }
     
     // Handle input
-    player->handleInput(window);
+    InputState inputState = input.sample(window, camera);
+    if (inputState.wasPressed(Action::Pause))
+    {
+        currentState = GameState::Paused;
+        pausedFrameReady = false;
+        inputLatency.reset();
+        return;
+    }
     
-    // Update hook
-    player->updateHook(elapsed, platforms);
+    particles.update(elapsed.asSeconds());
     
-    // Apply physics differently based on hook state
-    if (player->isHooked())
+    sf::Time step = elapsed;
+    if (playingReplay)
     {
-        player->applySwingPhysics(elapsed);
-        player->moveCharacter(elapsed);
+        // Recorded ticks keep their own length, at most one a frame
+        float tickTime = replay.getTickTime();
+        replayLag += elapsed.asSeconds();
+        if (replayLag < tickTime)
+            return;
+        replayLag = std::min(replayLag - tickTime, tickTime);
         
-        sf::Vector2f velocity = player->getVelocity();
-        bool fellInPit = false;
-        bool hitDeadlyPlatform = false;
-        bool onGround = physics.handleCollisions(*player, velocity, fellInPit, hitDeadlyPlatform);
-        player->setOnGround(onGround);
-        player->setVelocity(velocity);
+        inputState = replayTick < replay.getTickCount() ? replay.getInputs()[replayTick++] : InputState();
+        step = sf::seconds(tickTime);
+    }
+    
+    // Simulate the next tick while this frame draws the last one
+    simulationThread->submit(inputState, step);
+    inputLatency.tickSubmitted();
+}
+
+void MainWindow::finishUpdate()
+{
+    if (!simulationThread->isBusy())
+        return;
+    
+    SimulationEvents events = simulationThread->wait();
+    inputLatency.tickFinished();
+    const RenderSnapshot& snapshot = simulationThread->getFront();
+    
+    updateCamera(snapshot);
+    updateUI(snapshot);
+    updateGhosts(snapshot);
+    emitEffects(events);
+    recordEvents(events, snapshot);
+    
+    if (events.won)
+    {
+        if (recordingGhost && ghostLibrary.save(currentMapFile, currentMapHash, ghostRecorder))
+            LogLine(LogLevel::Info) << "Saved ghost of the run";
+        triggerWinScreen(snapshot);
+    }
+}
+
+void MainWindow::updateGhosts(const RenderSnapshot& snapshot)
+{
+    if (recordingGhost)
+        ghostRecorder.record(GhostFrame::fromSnapshot(snapshot));
+    
+    // Everyone shares the hero's frame size and hitbox
+    sf::Vector2f ropeOffset = snapshot.playerHitbox.position + snapshot.playerHitbox.size / 2.0f - snapshot.playerPosition;
+    
+    ghostRenderer.clear();
+    for (std::size_t i = 0; i < ghosts.size(); ++i)
+    {
+        GhostFrame frame;
+        if (!ghosts[i]->sample(snapshot.time, frame))
+            continue;
         
-        if (onGround)
+        // The best run stands out from the rest
+        sf::Color color = i == 0 ? sf::Color(255, 220, 80) : sf::Color(180, 220, 255);
+        ghostRenderer.add(frame, snapshot.playerTextureRect.size, ropeOffset, color);
+    }
+}
+
+void MainWindow::setupParticles()
+{
+    ParticleEffect coin;
+    coin.count = 20;
+    coin.speedMin = 60;
+    coin.speedMax = 220;
+    coin.drag = 3;
+    coin.lifeMin = 0.25f;
+    coin.lifeMax = 0.6f;
+    coin.sizeStart = 6;
+    coin.sizeEnd = 1;
+    coin.colorStart = sf::Color(255, 215, 0);
+    coin.colorEnd = sf::Color(255, 255, 150, 0);
+    coinEffect = particles.addEffect(coin);
+    
+    // A fountain going up
+    ParticleEffect checkpoint;
+    checkpoint.count = 40;
+    checkpoint.direction = -1.5707963f;
+    checkpoint.spread = 1.2f;
+    checkpoint.speedMin = 150;
+    checkpoint.speedMax = 350;
+    checkpoint.gravity = 600;
+    checkpoint.lifeMin = 0.5f;
+    checkpoint.lifeMax = 1.0f;
+    checkpoint.sizeStart = 7;
+    checkpoint.sizeEnd = 2;
+    checkpoint.colorStart = sf::Color(80, 255, 120);
+    checkpoint.colorEnd = sf::Color(200, 255, 200, 0);
+    checkpointEffect = particles.addEffect(checkpoint);
+    
+    ParticleEffect death;
+    death.count = 60;
+    death.speedMin = 100;
+    death.speedMax = 400;
+    death.gravity = 900;
+    death.drag = 1;
+    death.lifeMin = 0.4f;
+    death.lifeMax = 0.9f;
+    death.sizeStart = 8;
+    death.sizeEnd = 2;
+    death.colorStart = sf::Color(220, 40, 40);
+    death.colorEnd = sf::Color(80, 0, 0, 0);
+    deathEffect = particles.addEffect(death);
+    
+    // Dust falling off the surface the hook bit into
+    ParticleEffect hook;
+    hook.count = 14;
+    hook.direction = 1.5707963f;
+    hook.spread = 2.0f;
+    hook.speedMin = 40;
+    hook.speedMax = 160;
+    hook.gravity = 400;
+    hook.lifeMin = 0.2f;
+    hook.lifeMax = 0.45f;
+    hook.sizeStart = 4;
+    hook.sizeEnd = 1;
+    hook.colorStart = sf::Color(200, 200, 200);
+    hook.colorEnd = sf::Color(120, 120, 120, 0);
+    hookEffect = particles.addEffect(hook);
+}
+
+void MainWindow::emitEffects(const SimulationEvents& events)
+{
+    for (const auto& effect : events.effects)
+    {
+        switch (effect.type)
         {
-            player->releaseHook();
+            case EffectType::CoinCollected:
+                particles.emit(coinEffect, effect.position);
+                break;
+            case EffectType::CheckpointReached:
+                particles.emit(checkpointEffect, effect.position);
+                break;
+            case EffectType::PlayerDied:
+                particles.emit(deathEffect, effect.position);
+                break;
+            case EffectType::HookAttached:
+                particles.emit(hookEffect, effect.position);
+                break;
         }
     }
-    else
+    particles.buildVertices();
+}
+
+void MainWindow::recordEvents(const SimulationEvents& events, const RenderSnapshot& snapshot)
+{
+    // A replay's events were the recorded run's
+    if (!telemetry || playingReplay)
+        return;
+    
+    for (const auto& effect : events.effects)
     {
-        sf::Vector2f velocity = player->getVelocity();
-        physics.applyGravity(velocity, elapsed);
-        player->setVelocity(velocity);
-        
-        player->moveCharacter(elapsed);
-        
-        bool fellInPit = false;
-        bool hitDeadlyPlatform = false;
-        bool onGround = physics.handleCollisions(*player, velocity, fellInPit, hitDeadlyPlatform);
-        player->setOnGround(onGround);
-        player->setVelocity(velocity);
-        
-        velocity = player->getVelocity();
-        physics.applyFriction(velocity, onGround);
-        player->setVelocity(velocity);
-        
-        if (fellInPit || hitDeadlyPlatform)
+        switch (effect.type)
         {
-            respawnPlayer();
+            case EffectType::CoinCollected:
+                telemetry->record(TelemetryType::Pickup, effect.position);
+                break;
+            case EffectType::CheckpointReached:
+                telemetry->record(TelemetryType::Checkpoint, effect.position);
+                break;
+            case EffectType::PlayerDied:
+                telemetry->record(TelemetryType::Died, effect.position);
+                break;
+            case EffectType::HookAttached:
+                telemetry->record(TelemetryType::HookAttached, effect.position);
+                break;
         }
     }
     
-    // Check pickup collisions
-    sf::FloatRect playerBounds = player->getGlobalHitbox();
-    for (auto& pickup : pickups)
+    if (events.hookReleased)
+        telemetry->record(TelemetryType::HookReleased, snapshot.playerPosition);
+    if (events.won)
+        telemetry->record(TelemetryType::LevelFinished, snapshot.playerPosition, static_cast<std::uint64_t>(snapshot.time * 1000.0f));
+}
+
+void MainWindow::cycleHeatmap()
+{
+    if (!heatmapLoaded)
     {
-        if (!pickup->isCollected())
+        heatmapLoaded = true;
+        std::string path = Heatmap::pathFor(currentMapFile);
+        if (!heatmap.load(path))
         {
-            sf::FloatRect pickupBounds = pickup->getGlobalBounds();
-            if (playerBounds.findIntersection(pickupBounds))
-            {
-                collectPickup(pickup);
-            }
+            LogLine(LogLevel::Warning) << "No heatmap of " << currentMapFile << ", make one with hookleap_heatmap "
+                                       << currentMapFile;
         }
+        else if (heatmap.getMapHash() != currentMapHash)
+        {
+            // Still roughly right after small edits, so shown anyway
+            LogLine(LogLevel::Warning) << path << " was counted on another version of " << currentMapFile;
+        }
+        heatmap.shrinkToFit(sf::Texture::getMaximumSize());
     }
+    if (heatmap.isEmpty())
+        return;
     
-    // Update pickups
-    for (auto& pickup : pickups)
+    // Off, then each layer in turn
+    heatmapLayer = (heatmapLayer + 1) % (Heatmap::LAYER_COUNT + 1);
+    if (heatmapLayer == Heatmap::LAYER_COUNT)
     {
-        pickup->animate(elapsed);
+        heatmapSprite.reset();
+        return;
     }
     
-    // Update player
-    player->updateState();
-    player->animate(elapsed);
-    
-    updateCamera();
-    updateUI();
+    // One texel per cell, stretched over the level in a single quad
+    sf::Image image;
+    heatmap.buildImage(static_cast<HeatmapLayer>(heatmapLayer), HEATMAP_COLORS[heatmapLayer], image);
+    if (!heatmapTexture.loadFromImage(image))
+    {
+        LogLine(LogLevel::Warning) << "Could not upload the heatmap of " << currentMapFile;
+        heatmapLayer = Heatmap::LAYER_COUNT;
+        heatmapSprite.reset();
+        return;
+    }
+    heatmapSprite = std::make_unique<sf::Sprite>(heatmapTexture);
+    heatmapSprite->setPosition(heatmap.getOrigin());
+    heatmapSprite->setScale({heatmap.getCellSize(), heatmap.getCellSize()});
 }
 
 void MainWindow::updateWinScreen(sf::Time& elapsed)
@@ -616,11 +1239,16 @@ void MainWindow::updateWinScreen(sf::Time& elapsed)
 
 void MainWindow::update(sf::Time& elapsed)
 {
+    checkAssetChanges();
+    
     switch (currentState)
     {
         case GameState::Menu:
             updateMenu(elapsed);
             break;
+        case GameState::Connecting:
+            updateConnecting(elapsed);
+            break;
         case GameState::Playing:
             updatePlaying(elapsed);
             break;
@@ -633,88 +1261,142 @@ void MainWindow::update(sf::Time& elapsed)
     }
 }
 
-void MainWindow::drawHookRope(const sf::Vector2f& start, const sf::Vector2f& end)
+void MainWindow::renderMenu()
 {
-    std::array<sf::Vertex, 2> line;
-    line[0].position = start;
-    line[0].color = sf::Color(100, 100, 100);
-    line[1].position = end;
-    line[1].color = sf::Color(100, 100, 100);
+    window.clear(sf::Color(50, 50, 50));
     
-    window.draw(line.data(), 2, sf::PrimitiveType::Lines);
+    // Use default view for menu
+    window.setView(window.getDefaultView());
+    menuScreen.draw(window);
+    
+    // Asking is what queues a thumbnail, so only the rows shown are drawn
+    for (std::size_t i = 0; i < mapRows.size() && firstMapRow + i < maps.size(); ++i)
+    {
+        const sf::Texture* thumbnail = mapThumbnails.get(maps[firstMapRow + i]);
+        if (!thumbnail)
+            continue;
+        
+        sf::Sprite sprite(*thumbnail);
+        sprite.setPosition(mapRows[i].thumbnailPosition);
+        window.draw(sprite);
+    }
 }
 
-void MainWindow::renderMenu()
+void MainWindow::renderConnecting()
 {
     window.clear(sf::Color(50, 50, 50));
     
-    // Use default view for menu
     window.setView(window.getDefaultView());
+    connectingScreen.draw(window);
+}
+
+void MainWindow::renderRemotePlayers(sf::RenderTarget& target, const RenderSnapshot& snapshot)
+{
+    // Everyone shares the hero's frame size and hitbox
+    const Player& localPlayer = client->getPredicted().getPlayer();
+    sf::FloatRect hitbox = localPlayer.getGlobalHitbox();
+    sf::Vector2f ropeOffset = hitbox.position + hitbox.size / 2.0f - localPlayer.getPosition();
+    sf::Vector2i frameSize = snapshot.playerTextureRect.size;
     
-    if (logoText)
-        window.draw(*logoText);
-    
-    for (const auto& btn : mapButtons)
+    for (const auto& remote : remotePlayers)
     {
-        window.draw(btn.shape);
-        if (btn.text)
+        sf::Vector2f position = remote.getPosition();
+        
+        if (remote.getHookState() == HookState::Attached)
         {
-            window.draw(*btn.text);
+            std::array<sf::Vertex, 2> rope;
+            rope[0].position = remote.getHookPoint();
+            rope[1].position = position + ropeOffset;
+            rope[0].color = rope[1].color = sf::Color(100, 100, 100, 150);
+            target.draw(rope.data(), rope.size(), sf::PrimitiveType::Lines);
         }
+        
+        // Same flip as Player: mirrored around the frame's right edge
+        bool facingLeft = remote.get(StateField::FacingLeft) != 0;
+        remoteSprite->setTextureRect(sf::IntRect({remote.get(StateField::FrameX), remote.get(StateField::FrameY)}, frameSize));
+        remoteSprite->setOrigin({facingLeft ? static_cast<float>(frameSize.x) : 0.0f, 0.0f});
+        remoteSprite->setScale({facingLeft ? -1.0f : 1.0f, 1.0f});
+        remoteSprite->setPosition(position);
+        target.draw(*remoteSprite);
     }
-    
-    window.draw(quitButton);
-    if (quitButtonText)
-        window.draw(*quitButtonText);
 }
 
-void MainWindow::renderPlaying()
+void MainWindow::renderPlaying(sf::RenderTarget& target)
 {
-    window.clear(sf::Color(135, 206, 235));
+    target.clear(sf::Color(135, 206, 235));
     
-    window.setView(camera);
+    target.setView(camera);
     
     // Draw background (moves with camera)
     if (background)
     {
         //background->setPosition({camera.getCenter().x-window.getSize().x/2, camera.getCenter().y-window.getSize().y/2});
-        window.draw(*background);
+        target.draw(*background);
     }
     
-    // Draw platforms
-    for (const auto& platform : platforms)
-    {
-        window.draw(*platform);
-    }
+    const RenderSnapshot& snapshot = client ? raceSnapshot : simulationThread->getFront();
     
-    // Draw pickups
-    for (const auto& pickup : pickups)
-    {
-        if (!pickup->isCollected() || pickup->shouldRemainVisible())
-        {
-            window.draw(*pickup);
-        }
-    }
+    // Draw platforms and pickups
+    snapshot.world.draw(target);
+    
+    if (heatmapSprite)
+        target.draw(*heatmapSprite);
     
     // Draw hook rope if attached
-    if (player->isHooked())
+    if (!snapshot.rope.empty())
     {
-        sf::Vector2f playerCenter = player->getPosition() + sf::Vector2f(64, 64);
-        sf::Vector2f attachPoint = player->getHook().getAttachPoint();
-        drawHookRope(playerCenter, attachPoint);
+        target.draw(snapshot.rope.data(), snapshot.rope.size(), sf::PrimitiveType::LineStrip);
     }
     
     // Draw hook projectile
-    player->getHook().draw(window);
+    snapshot.hook.draw(target);
+    
+    // Other racers, or ghosts of past runs, behind the local player
+    if (client)
+        renderRemotePlayers(target, snapshot);
+    else
+        ghostRenderer.draw(target, characterTexture);
     
     // Draw player
-    window.draw(*player);
+    playerSprite->setTextureRect(snapshot.playerTextureRect);
+    target.draw(*playerSprite, snapshot.playerTransform);
+    
+    if (!client)
+        particles.draw(target);
     
     // Draw UI
     if (scoreText)
-        window.draw(*scoreText);
+        target.draw(*scoreText);
     if (timeText)
-        window.draw(*timeText);
+        target.draw(*timeText);
+    if (client && netStatsText)
+        target.draw(*netStatsText);
+}
+
+void MainWindow::renderPaused()
+{
+    // The level doesn't move while paused: draw it once, then reuse the frame
+    sf::Vector2u size = window.getSize();
+    if (!pausedFrameReady && (pausedFrame.getSize() == size || pausedFrame.resize(size)))
+    {
+        renderPlaying(pausedFrame);
+        pausedFrame.display();
+        pausedFrameReady = true;
+    }
+    
+    if (pausedFrameReady && pausedFrame.getSize() == size)
+    {
+        // One texture pixel to one window pixel
+        window.setView(sf::View(sf::FloatRect({0, 0}, sf::Vector2f(size))));
+        window.draw(sf::Sprite(pausedFrame.getTexture()));
+    }
+    else
+    {
+        renderPlaying(window);
+    }
+    
+    window.setView(window.getDefaultView());
+    pauseScreen.draw(window);
 }
 
 void MainWindow::renderWinScreen()
@@ -722,31 +1404,7 @@ void MainWindow::renderWinScreen()
     window.clear(sf::Color(30, 30, 50));
     
     window.setView(window.getDefaultView());
-    
-    // Draw win text
-    sf::Text winTitle(font);
-    winTitle.setString("LEVEL COMPLETE!");
-    winTitle.setCharacterSize(60);
-    winTitle.setFillColor(sf::Color::Yellow);
-    winTitle.setPosition({window.getSize().x / 2.0f - 250, 100});
-    window.draw(winTitle);
-    
-    if (winScoreText)
-        window.draw(*winScoreText);
-    if (winTimeText)
-        window.draw(*winTimeText);
-    if (winDeathsText)
-        window.draw(*winDeathsText);
-    
-    window.draw(restartButton);
-    if (restartButtonText)
-        window.draw(*restartButtonText);
-    window.draw(menuButton);
-    if (menuButtonText)
-        window.draw(*menuButtonText);
-    window.draw(winQuitButton);
-    if (winQuitButtonText)
-        window.draw(*winQuitButtonText);
+    winScreen.draw(window);
 }
 
 void MainWindow::render()
@@ -756,19 +1414,27 @@ void MainWindow::render()
         case GameState::Menu:
             renderMenu();
             break;
+        case GameState::Connecting:
+            renderConnecting();
+            break;
         case GameState::Playing:
-            renderPlaying();
+            renderPlaying(window);
             break;
         case GameState::WinScreen:
             renderWinScreen();
             break;
         case GameState::Paused:
-            renderPlaying(); // Still show game when paused
-            // TODO: Add pause overlay
+            renderPaused();
             break;
     }
     
     window.display();
+    inputLatency.framePresented();
+    renderedState = currentState;
+    needsRedraw = false;
+    
+    if (frameOptions.reportLatency && latencyReportClock.getElapsedTime().asSeconds() >= LATENCY_REPORT_SECONDS)
+        reportLatency(false);
 }
 
 void MainWindow::run()
@@ -777,9 +1443,61 @@ void MainWindow::run()
 
     while (window.isOpen())
     {
-        sf::Time elapsed = clock.restart();
+        // Wait before reading input, not after drawing, so the input is fresh
+        if (!isIdle())
+            pacer.wait();
         handleEvents();
+        sf::Time elapsed = clock.restart();
+        // Only between two level frames; the first after a pause waited on it
+        if (telemetry && currentState == GameState::Playing && renderedState == GameState::Playing &&
+            elapsed.asSeconds() > FRAME_HITCH_SECONDS)
+            telemetry->record(TelemetryType::FrameHitch, {}, static_cast<std::uint64_t>(elapsed.asMicroseconds()));
         update(elapsed);
-        render();
+        if (needsRender())
+            render();
+        finishUpdate();
+        
+        if (!windowFocused && !isIdle())
+            throttle();
     }
+    
+    if (frameOptions.reportLatency)
+        reportLatency(true);
+}
+
+void MainWindow::reportLatency(bool final)
+{
+    latencyReportClock.restart();
+    const LatencyStats& stats = inputLatency.getStats();
+    if (stats.getCount() == 0)
+        return;
+    
+    LogLine(LogLevel::Info) << (final ? "Input to present, last " : "Input to present, ") << stats.format();
+    inputLatency.clearStats();
+}
+
+bool MainWindow::isIdle() const
+{
+    return currentState == GameState::Menu || currentState == GameState::WinScreen ||
+           currentState == GameState::Paused;
+}
+
+bool MainWindow::isLoadingMaps() const
+{
+    return currentState == GameState::Menu && (mapIndex.isScanning() || mapThumbnails.isBusy());
+}
+
+bool MainWindow::needsRender() const
+{
+    return !isIdle() || needsRedraw || renderedState != currentState;
+}
+
+void MainWindow::throttle()
+{
+    // A level left running in the background keeps going, but at a lower
+    // frame rate. clock was restarted at the top of this frame.
+    sf::Time frame = sf::seconds(1.0f / BACKGROUND_FPS);
+    sf::Time spent = clock.getElapsedTime();
+    if (spent < frame)
+        sf::sleep(frame - spent);
 }
\ No newline at end of file
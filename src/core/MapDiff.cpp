@@ -0,0 +1,157 @@
+#include "core/MapDiff.hpp"
+#include <cstdint>
+#include <cstring>
+#include <unordered_map>
+
+namespace
+{
+    constexpr std::size_t POSITION_VALUES = 2;
+
+    bool isMovable(MapObjectType type)
+    {
+        switch (type)
+        {
+            case MapObjectType::Mover:
+            case MapObjectType::Oscillator:
+            case MapObjectType::Crumble:
+                return false;
+            default:
+                return true;
+        }
+    }
+
+    // FNV-1a over the type and the bits of values[first..]
+    std::uint64_t hashObject(const MapObject& object, std::size_t first)
+    {
+        std::uint64_t hash = 14695981039346656037ull;
+        auto mix = [&hash](std::uint32_t word)
+        {
+            for (int i = 0; i < 4; ++i)
+            {
+                hash ^= (word >> (i * 8)) & 0xFF;
+                hash *= 1099511628211ull;
+            }
+        };
+
+        mix(static_cast<std::uint32_t>(object.type));
+        for (std::size_t i = first; i < MapObject::MAX_VALUES; ++i)
+        {
+            std::uint32_t bits;
+            std::memcpy(&bits, &object.values[i], sizeof(bits));
+            mix(bits);
+        }
+        return hash;
+    }
+
+    bool sameValues(const MapObject& a, const MapObject& b, std::size_t first)
+    {
+        return a.type == b.type &&
+               std::memcmp(&a.values[first], &b.values[first], (MapObject::MAX_VALUES - first) * sizeof(float)) == 0;
+    }
+
+    // Old objects still waiting for a partner, grouped by hash in file order
+    class Matcher
+    {
+    public:
+        Matcher(const MapData& before, const std::vector<bool>& taken, std::size_t first)
+            : objects(before.objects), first(first)
+        {
+            for (std::size_t i = 0; i < objects.size(); ++i)
+            {
+                if (taken[i])
+                    continue;
+                if (first > 0 && !isMovable(objects[i].type))
+                    continue;
+                buckets[hashObject(objects[i], first)].indices.push_back(i);
+            }
+        }
+
+        // Index of the first unmatched old object equal to object, or -1
+        std::ptrdiff_t take(const MapObject& object, std::vector<bool>& taken)
+        {
+            auto it = buckets.find(hashObject(object, first));
+            if (it == buckets.end())
+                return -1;
+
+            Bucket& bucket = it->second;
+            while (bucket.next < bucket.indices.size() && taken[bucket.indices[bucket.next]])
+                ++bucket.next;
+
+            for (std::size_t i = bucket.next; i < bucket.indices.size(); ++i)
+            {
+                std::size_t index = bucket.indices[i];
+                if (!taken[index] && sameValues(objects[index], object, first))
+                {
+                    taken[index] = true;
+                    return static_cast<std::ptrdiff_t>(index);
+                }
+            }
+            return -1;
+        }
+
+    private:
+        struct Bucket
+        {
+            std::vector<std::size_t> indices;
+            std::size_t next = 0;
+        };
+
+        const std::vector<MapObject>& objects;
+        std::size_t first;
+        std::unordered_map<std::uint64_t, Bucket> buckets;
+    };
+}
+
+void diffMaps(const MapData& before, const MapData& after, MapDiff& diff)
+{
+    diff.removed.clear();
+    diff.added.clear();
+    diff.moved.clear();
+    diff.unchanged.clear();
+
+    std::vector<bool> oldTaken(before.objects.size(), false);
+    std::vector<bool> newTaken(after.objects.size(), false);
+
+    // Identical objects first, so a move is only reported for what really moved
+    {
+        Matcher exact(before, oldTaken, 0);
+        for (std::size_t i = 0; i < after.objects.size(); ++i)
+        {
+            std::ptrdiff_t match = exact.take(after.objects[i], oldTaken);
+            if (match >= 0)
+            {
+                diff.unchanged.emplace_back(static_cast<std::size_t>(match), i);
+                newTaken[i] = true;
+            }
+        }
+    }
+
+    // Then everything that differs only in position
+    {
+        Matcher shape(before, oldTaken, POSITION_VALUES);
+        for (std::size_t i = 0; i < after.objects.size(); ++i)
+        {
+            if (newTaken[i] || !isMovable(after.objects[i].type))
+                continue;
+
+            std::ptrdiff_t match = shape.take(after.objects[i], oldTaken);
+            if (match >= 0)
+            {
+                diff.moved.emplace_back(static_cast<std::size_t>(match), i);
+                newTaken[i] = true;
+            }
+        }
+    }
+
+    for (std::size_t i = 0; i < before.objects.size(); ++i)
+    {
+        if (!oldTaken[i])
+            diff.removed.push_back(i);
+    }
+
+    for (std::size_t i = 0; i < after.objects.size(); ++i)
+    {
+        if (!newTaken[i])
+            diff.added.push_back(i);
+    }
+}
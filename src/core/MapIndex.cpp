@@ -0,0 +1,243 @@
+#include "core/MapIndex.hpp"
+#include "core/AtomicFile.hpp"
+#include "core/ByteStream.hpp"
+#include "core/Hash.hpp"
+#include "core/LevelBuilder.hpp"
+#include "core/MappedFile.hpp"
+#include "core/Telemetry.hpp"
+#include <algorithm>
+#include <cmath>
+#include <unordered_map>
+
+namespace
+{
+    constexpr std::uint32_t INDEX_MAGIC = 0x494D4C48; // "HLMI"
+    const std::string MAPS_DIRECTORY = "maps";
+
+    // Pickup sizes from createPickupEntity
+    constexpr float PICKUP_SIZE = 32.0f;
+    constexpr float WIN_SIZE = 16.0f;
+
+    sf::FloatRect merge(const sf::FloatRect& a, const sf::FloatRect& b)
+    {
+        sf::Vector2f min(std::min(a.position.x, b.position.x), std::min(a.position.y, b.position.y));
+        sf::Vector2f max(std::max(a.position.x + a.size.x, b.position.x + b.size.x),
+                         std::max(a.position.y + a.size.y, b.position.y + b.size.y));
+        return sf::FloatRect(min, max - min);
+    }
+}
+
+MapIndex::MapIndex(const std::string& path)
+    : path(path), scanning(false), stopping(false), hasPublished(false)
+{
+}
+
+MapIndex::~MapIndex()
+{
+    stopping = true;
+    if (worker.joinable())
+        worker.join();
+}
+
+void MapIndex::start(const AssetLoader& assets)
+{
+    stopping = true;
+    if (worker.joinable())
+        worker.join();
+
+    stopping = false;
+    scanning = true;
+    worker = std::thread([this, &assets] { scan(assets); });
+}
+
+bool MapIndex::poll(std::vector<MapInfo>& maps)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!hasPublished)
+        return false;
+
+    maps = std::move(published);
+    published.clear();
+    hasPublished = false;
+    return true;
+}
+
+void MapIndex::publish(const std::vector<MapInfo>& maps)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    published = maps;
+    hasPublished = true;
+}
+
+sf::FloatRect MapIndex::objectBounds(const MapObject& object)
+{
+    sf::Vector2f position(object.x(), object.y());
+    switch (object.type)
+    {
+        case MapObjectType::Ground:
+            return sf::FloatRect(position, {object.values[2], object.values[3]});
+        case MapObjectType::Platform:
+        case MapObjectType::Mover:
+        case MapObjectType::Oscillator:
+        case MapObjectType::Crumble:
+            return sf::FloatRect(position, {LevelBuilder::PLATFORM_WIDTH, LevelBuilder::PLATFORM_HEIGHT});
+        case MapObjectType::Obstacle:
+            return sf::FloatRect(position, {LevelBuilder::OBSTACLE_WIDTH, LevelBuilder::OBSTACLE_HEIGHT});
+        case MapObjectType::Win:
+            return sf::FloatRect(position, {WIN_SIZE, WIN_SIZE});
+        default:
+            return sf::FloatRect(position, {PICKUP_SIZE, PICKUP_SIZE});
+    }
+}
+
+void MapIndex::describe(const MapData& map, MapInfo& info)
+{
+    info.tileset = map.tileset;
+    info.counts.fill(0);
+
+    // The spawn point is always part of the level
+    sf::FloatRect bounds({LevelBuilder::SPAWN_X, LevelBuilder::SPAWN_Y}, {0, 0});
+    for (const auto& object : map.objects)
+    {
+        ++info.counts[static_cast<std::size_t>(object.type)];
+
+        sf::FloatRect rest = objectBounds(object);
+        bounds = merge(bounds, rest);
+        if (object.type == MapObjectType::Mover)
+        {
+            bounds = merge(bounds, sf::FloatRect({object.values[2], object.values[3]}, rest.size));
+        }
+        else if (object.type == MapObjectType::Oscillator)
+        {
+            sf::Vector2f amplitude(std::abs(object.values[2]), std::abs(object.values[3]));
+            bounds = merge(bounds, sf::FloatRect(rest.position - amplitude, rest.size + amplitude * 2.0f));
+        }
+    }
+    info.bounds = bounds;
+}
+
+void MapIndex::scan(const AssetLoader& assets)
+{
+    // What the last run knew, shown while the files are checked
+    std::vector<MapInfo> known;
+    if (load(known))
+        publish(known);
+
+    std::unordered_map<std::string, const MapInfo*> byFile;
+    for (const auto& info : known)
+    {
+        byFile[info.file] = &info;
+    }
+
+    std::vector<MapInfo> maps;
+    bool changed = false;
+    MapParser parser;
+    parser.setThreadCount(1);
+    for (const auto& name : assets.list(MAPS_DIRECTORY))
+    {
+        if (stopping)
+            break;
+
+        AssetData data;
+        if (!assets.read(name, data))
+            continue;
+
+        MapInfo info;
+        info.file = name.substr(MAPS_DIRECTORY.size() + 1);
+        info.hash = contentHash(data.getView());
+
+        auto cached = byFile.find(info.file);
+        if (cached != byFile.end() && cached->second->hash == info.hash)
+        {
+            maps.push_back(*cached->second);
+            continue;
+        }
+
+        // New or edited; a map with errors is listed but can't be played
+        MapData map;
+        info.valid = parser.parse(data.getView(), map);
+        describe(map, info);
+        maps.push_back(std::move(info));
+        changed = true;
+    }
+
+    if (!stopping)
+    {
+        changed = changed || maps.size() != known.size();
+        publish(maps);
+        if (changed)
+            save(maps);
+    }
+    scanning = false;
+}
+
+bool MapIndex::load(std::vector<MapInfo>& maps) const
+{
+    MappedFile file;
+    if (path.empty() || !file.open(path))
+        return false;
+
+    ByteReader reader(reinterpret_cast<const std::uint8_t*>(file.getData()), file.getSize());
+    if (reader.readU32() != INDEX_MAGIC || reader.readU32() != VERSION)
+        return false;
+
+    std::uint32_t count = reader.readU32();
+    for (std::uint32_t i = 0; i < count && reader.isValid(); ++i)
+    {
+        MapInfo info;
+        info.file = reader.readString();
+        info.hash = reader.readU64();
+        info.tileset = reader.readString();
+        info.valid = reader.readU8() != 0;
+        info.bounds.position.x = reader.readF32();
+        info.bounds.position.y = reader.readF32();
+        info.bounds.size.x = reader.readF32();
+        info.bounds.size.y = reader.readF32();
+        for (auto& typeCount : info.counts)
+        {
+            typeCount = reader.readVarint();
+        }
+        maps.push_back(std::move(info));
+    }
+
+    // A damaged index is rebuilt from the files
+    if (!reader.isValid())
+    {
+        maps.clear();
+        return false;
+    }
+    return true;
+}
+
+bool MapIndex::save(const std::vector<MapInfo>& maps) const
+{
+    if (path.empty())
+        return false;
+
+    ByteWriter writer;
+    writer.writeU32(INDEX_MAGIC);
+    writer.writeU32(VERSION);
+    writer.writeU32(static_cast<std::uint32_t>(maps.size()));
+    for (const auto& info : maps)
+    {
+        writer.writeString(info.file);
+        writer.writeU64(info.hash);
+        writer.writeString(info.tileset);
+        writer.writeU8(info.valid ? 1 : 0);
+        writer.writeF32(info.bounds.position.x);
+        writer.writeF32(info.bounds.position.y);
+        writer.writeF32(info.bounds.size.x);
+        writer.writeF32(info.bounds.size.y);
+        for (std::uint32_t typeCount : info.counts)
+        {
+            writer.writeVarint(typeCount);
+        }
+    }
+
+    if (!writeFileAtomic(path, {writer.getView()}))
+    {
+        LogLine(LogLevel::Error) << "Could not write map index " << path;
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,326 @@
+#include "core/MapParser.hpp"
+#include "core/MappedFile.hpp"
+#include <algorithm>
+#include <charconv>
+#include <cstdint>
+#include <cstring>
+#include <thread>
+
+namespace
+{
+    struct Chunk
+    {
+        const char* begin;
+        const char* end;
+        std::size_t lineCount;
+        std::vector<MapObject> objects;
+        std::vector<MapError> errors;
+    };
+    
+    bool isBlank(char c)
+    {
+        return c == ' ' || c == '\t' || c == '\r';
+    }
+    
+    bool matches(const char* begin, const char* end, const char* word, std::size_t length)
+    {
+        return static_cast<std::size_t>(end - begin) == length && std::memcmp(begin, word, length) == 0;
+    }
+    
+    bool parseType(const char* begin, const char* end, MapObjectType& type)
+    {
+        // Switch on the first letter so each token costs at most two compares
+        switch (*begin)
+        {
+            case 'c':
+                if (matches(begin, end, "checkpoint", 10)) { type = MapObjectType::Checkpoint; return true; }
+                if (matches(begin, end, "crumble", 7)) { type = MapObjectType::Crumble; return true; }
+                return false;
+            case 'g':
+                if (matches(begin, end, "ground", 6)) { type = MapObjectType::Ground; return true; }
+                return false;
+            case 'm':
+                if (matches(begin, end, "mover", 5)) { type = MapObjectType::Mover; return true; }
+                return false;
+            case 'o':
+                if (matches(begin, end, "obstacle", 8)) { type = MapObjectType::Obstacle; return true; }
+                if (matches(begin, end, "oscillator", 10)) { type = MapObjectType::Oscillator; return true; }
+                return false;
+            case 'p':
+                if (matches(begin, end, "platform", 8)) { type = MapObjectType::Platform; return true; }
+                if (matches(begin, end, "pickup", 6)) { type = MapObjectType::Pickup; return true; }
+                return false;
+            case 'w':
+                if (matches(begin, end, "win", 3)) { type = MapObjectType::Win; return true; }
+                return false;
+            default:
+                return false;
+        }
+    }
+    
+    constexpr float POWERS_OF_TEN[] = {1e0f, 1e1f, 1e2f, 1e3f, 1e4f, 1e5f, 1e6f, 1e7f, 1e8f, 1e9f, 1e10f};
+    
+    // Map numbers are short decimals like "1280" or "-37.5". When the digits
+    // fit a float mantissa exactly (under 2^24) and there are at most ten
+    // decimals, one float division is correctly rounded, so those skip
+    // from_chars. Anything else (exponents, long mantissas) falls back to it.
+    std::from_chars_result parseNumber(const char* begin, const char* end, float& value)
+    {
+        const char* p = begin;
+        bool negative = p < end && *p == '-';
+        if (negative)
+            ++p;
+        
+        std::uint32_t mantissa = 0;
+        int digits = 0;
+        int decimals = 0;
+        while (p < end && static_cast<unsigned>(*p - '0') < 10 && digits < 8)
+        {
+            mantissa = mantissa * 10 + static_cast<std::uint32_t>(*p - '0');
+            ++digits;
+            ++p;
+        }
+        if (p < end && *p == '.')
+        {
+            ++p;
+            while (p < end && static_cast<unsigned>(*p - '0') < 10 && digits < 8)
+            {
+                mantissa = mantissa * 10 + static_cast<std::uint32_t>(*p - '0');
+                ++digits;
+                ++decimals;
+                ++p;
+            }
+        }
+        
+        bool simple = digits > 0 && mantissa < (1u << 24) && decimals <= 10
+            && (p == end || isBlank(*p) || *p == '\n');
+        if (!simple)
+            return std::from_chars(begin, end, value);
+        
+        value = static_cast<float>(mantissa) / POWERS_OF_TEN[decimals];
+        if (negative)
+            value = -value;
+        return {p, std::errc()};
+    }
+    
+    void addError(std::vector<MapError>& errors, std::size_t line, const char* lineStart, const char* at, const char* message)
+    {
+        if (errors.size() < MapParser::MAX_ERRORS)
+            errors.push_back({line, static_cast<std::size_t>(at - lineStart) + 1, message});
+    }
+    
+    // Line numbers are relative to the chunk start and fixed up after joining
+    void parseChunk(Chunk& chunk)
+    {
+        const char* cursor = chunk.begin;
+        std::size_t line = 0;
+        
+        while (cursor < chunk.end)
+        {
+            const char* lineStart = cursor;
+            const char* lineEnd = static_cast<const char*>(std::memchr(cursor, '\n', chunk.end - cursor));
+            if (!lineEnd)
+                lineEnd = chunk.end;
+            cursor = lineEnd < chunk.end ? lineEnd + 1 : chunk.end;
+            ++line;
+            
+            const char* p = lineStart;
+            while (p < lineEnd && isBlank(*p))
+                ++p;
+            if (p == lineEnd)
+                continue;
+            
+            const char* token = p;
+            while (p < lineEnd && !isBlank(*p))
+                ++p;
+            
+            MapObject object;
+            if (!parseType(token, p, object.type))
+            {
+                addError(chunk.errors, line, lineStart, token, "unknown object type");
+                continue;
+            }
+            
+            std::size_t count = MapParser::valueCount(object.type);
+            bool valid = true;
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                while (p < lineEnd && isBlank(*p))
+                    ++p;
+                
+                if (p == lineEnd)
+                {
+                    addError(chunk.errors, line, lineStart, p, "missing value");
+                    valid = false;
+                    break;
+                }
+                
+                // from_chars does not accept a leading plus sign
+                const char* number = (*p == '+') ? p + 1 : p;
+                auto result = parseNumber(number, lineEnd, object.values[i]);
+                if (result.ec != std::errc() || (result.ptr < lineEnd && !isBlank(*result.ptr)))
+                {
+                    addError(chunk.errors, line, lineStart, p, "invalid number");
+                    valid = false;
+                    break;
+                }
+                p = result.ptr;
+            }
+            
+            if (!valid)
+                continue;
+            
+            while (p < lineEnd && isBlank(*p))
+                ++p;
+            if (p != lineEnd)
+            {
+                addError(chunk.errors, line, lineStart, p, "unexpected text after values");
+                continue;
+            }
+            
+            for (std::size_t i = count; i < MapObject::MAX_VALUES; ++i)
+                object.values[i] = 0;
+            
+            chunk.objects.push_back(object);
+        }
+        
+        chunk.lineCount = line;
+    }
+}
+
+MapParser::MapParser()
+    : threadCount(0)
+{
+}
+
+void MapParser::setThreadCount(unsigned threadCount_)
+{
+    threadCount = threadCount_;
+}
+
+std::size_t MapParser::valueCount(MapObjectType type)
+{
+    switch (type)
+    {
+        case MapObjectType::Ground:
+        case MapObjectType::Crumble:
+            return 4;
+        case MapObjectType::Mover:
+        case MapObjectType::Oscillator:
+            return 5;
+        default:
+            return 2;
+    }
+}
+
+bool MapParser::loadFile(const std::string& path, MapData& data)
+{
+    errors.clear();
+    
+    MappedFile file;
+    if (!file.open(path))
+    {
+        errors.push_back({0, 0, "could not open " + path});
+        return false;
+    }
+    
+    return parse(file.getView(), data);
+}
+
+bool MapParser::parse(std::string_view text, MapData& data)
+{
+    errors.clear();
+    data.tileset.clear();
+    data.objects.clear();
+    
+    // First line is the tileset name
+    const char* begin = text.data();
+    const char* end = begin + text.size();
+    const char* firstLineEnd = static_cast<const char*>(std::memchr(begin, '\n', text.size()));
+    if (!firstLineEnd)
+        firstLineEnd = end;
+    
+    const char* nameBegin = begin;
+    const char* nameEnd = firstLineEnd;
+    while (nameBegin < nameEnd && isBlank(*nameBegin))
+        ++nameBegin;
+    while (nameEnd > nameBegin && isBlank(*(nameEnd - 1)))
+        --nameEnd;
+    data.tileset.assign(nameBegin, nameEnd);
+    
+    if (data.tileset.empty())
+        errors.push_back({1, 1, "missing tileset name"});
+    
+    const char* body = firstLineEnd < end ? firstLineEnd + 1 : end;
+    std::size_t bodySize = static_cast<std::size_t>(end - body);
+    
+    unsigned workers = threadCount ? threadCount : std::max(1u, std::thread::hardware_concurrency());
+    std::size_t chunkCount = std::max<std::size_t>(1, std::min<std::size_t>(workers, bodySize / PARALLEL_CHUNK_SIZE));
+    
+    // Cut at the first newline after each even split so no line is shared
+    std::vector<Chunk> chunks(chunkCount);
+    const char* chunkBegin = body;
+    for (std::size_t i = 0; i < chunkCount; ++i)
+    {
+        const char* chunkEnd = end;
+        if (i + 1 < chunkCount)
+        {
+            const char* split = std::max(chunkBegin, body + bodySize / chunkCount * (i + 1));
+            const char* newline = static_cast<const char*>(std::memchr(split, '\n', end - split));
+            chunkEnd = newline ? newline + 1 : end;
+        }
+        
+        chunks[i].begin = chunkBegin;
+        chunks[i].end = chunkEnd;
+        chunks[i].lineCount = 0;
+        
+        // Roughly one object per 20 bytes of text
+        chunks[i].objects.reserve(static_cast<std::size_t>(chunkEnd - chunkBegin) / 20 + 1);
+        chunkBegin = chunkEnd;
+    }
+    
+    if (chunkCount == 1)
+    {
+        parseChunk(chunks[0]);
+    }
+    else
+    {
+        std::vector<std::thread> threads;
+        threads.reserve(chunkCount - 1);
+        for (std::size_t i = 1; i < chunkCount; ++i)
+        {
+            threads.emplace_back(parseChunk, std::ref(chunks[i]));
+        }
+        parseChunk(chunks[0]);
+        
+        for (auto& thread : threads)
+        {
+            thread.join();
+        }
+    }
+    
+    // Join in file order, turning chunk-relative lines into file lines
+    std::size_t totalObjects = 0;
+    for (const auto& chunk : chunks)
+    {
+        totalObjects += chunk.objects.size();
+    }
+    data.objects.reserve(totalObjects);
+    
+    std::size_t lineOffset = 1;
+    for (auto& chunk : chunks)
+    {
+        data.objects.insert(data.objects.end(), chunk.objects.begin(), chunk.objects.end());
+        
+        for (auto& error : chunk.errors)
+        {
+            if (errors.size() >= MAX_ERRORS)
+                break;
+            error.line += lineOffset;
+            errors.push_back(std::move(error));
+        }
+        lineOffset += chunk.lineCount;
+    }
+    
+    return errors.empty();
+}
@@ -0,0 +1,181 @@
+#include "core/MapThumbnails.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+    // Rows scrolled past are not worth drawing; the oldest requests go first
+    constexpr std::size_t MAX_REQUESTS = 16;
+
+    const sf::Color SKY_COLOR(135, 206, 235);
+
+    sf::Color objectColor(MapObjectType type)
+    {
+        switch (type)
+        {
+            case MapObjectType::Ground: return sf::Color(110, 80, 50);
+            case MapObjectType::Platform: return sf::Color(90, 90, 90);
+            case MapObjectType::Mover:
+            case MapObjectType::Oscillator: return sf::Color(70, 70, 150);
+            case MapObjectType::Crumble: return sf::Color(160, 120, 80);
+            case MapObjectType::Obstacle: return sf::Color(200, 50, 50);
+            case MapObjectType::Pickup: return sf::Color(255, 215, 0);
+            case MapObjectType::Checkpoint: return sf::Color(60, 140, 255);
+            case MapObjectType::Win: return sf::Color(40, 200, 80);
+        }
+        return sf::Color::White;
+    }
+}
+
+MapThumbnails::MapThumbnails(const AssetLoader& assets)
+    : assets(assets), stopping(false), painting(0)
+{
+}
+
+MapThumbnails::~MapThumbnails()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    if (worker.joinable())
+        worker.join();
+}
+
+const sf::Texture* MapThumbnails::get(const MapInfo& info)
+{
+    auto found = byHash.find(info.hash);
+    if (found != byHash.end())
+    {
+        entries.splice(entries.begin(), entries, found->second);
+        return &found->second->texture;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!pending.insert(info.hash).second)
+            return nullptr;
+
+        requests.push_back({info.hash, info.file, info.bounds});
+        if (requests.size() > MAX_REQUESTS)
+        {
+            pending.erase(requests.front().hash);
+            requests.erase(requests.begin());
+        }
+    }
+
+    // Started on the first request, so a run that never opens the menu
+    // never has the thread
+    if (!worker.joinable())
+        worker = std::thread([this] { run(); });
+    wake.notify_one();
+    return nullptr;
+}
+
+bool MapThumbnails::update()
+{
+    std::vector<Finished> done;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        done.swap(finished);
+        for (const auto& thumbnail : done)
+        {
+            pending.erase(thumbnail.hash);
+        }
+    }
+
+    for (auto& thumbnail : done)
+    {
+        Entry entry;
+        entry.hash = thumbnail.hash;
+        if (!entry.texture.loadFromImage(thumbnail.image))
+            continue;
+        entry.texture.setSmooth(true);
+
+        entries.push_front(std::move(entry));
+        byHash[thumbnail.hash] = entries.begin();
+        if (entries.size() > CAPACITY)
+        {
+            byHash.erase(entries.back().hash);
+            entries.pop_back();
+        }
+    }
+    return !done.empty();
+}
+
+bool MapThumbnails::isBusy() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return !requests.empty() || painting > 0 || !finished.empty();
+}
+
+void MapThumbnails::run()
+{
+    MapParser parser;
+    parser.setThreadCount(1);
+
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true)
+    {
+        wake.wait(lock, [this] { return stopping || !requests.empty(); });
+        if (stopping)
+            return;
+
+        // Newest first: that is the row the player is looking at
+        Request request = std::move(requests.back());
+        requests.pop_back();
+        ++painting;
+        lock.unlock();
+
+        Finished thumbnail;
+        thumbnail.hash = request.hash;
+        thumbnail.image.resize({WIDTH, HEIGHT}, SKY_COLOR);
+
+        AssetData data;
+        MapData map;
+        if (assets.read("maps/" + request.file, data))
+        {
+            // Whatever parsed is drawn, errors or not
+            parser.parse(data.getView(), map);
+            paint(map, request.bounds, thumbnail.image);
+        }
+
+        lock.lock();
+        --painting;
+        finished.push_back(std::move(thumbnail));
+    }
+}
+
+void MapThumbnails::paint(const MapData& map, const sf::FloatRect& bounds, sf::Image& image)
+{
+    sf::Vector2u size = image.getSize();
+    if (size.x == 0 || size.y == 0 || bounds.size.x <= 0 || bounds.size.y <= 0)
+        return;
+
+    // The whole level fits, centred, keeping its shape
+    float scale = std::min(size.x / bounds.size.x, size.y / bounds.size.y);
+    sf::Vector2f offset((size.x - bounds.size.x * scale) / 2.0f, (size.y - bounds.size.y * scale) / 2.0f);
+
+    for (const auto& object : map.objects)
+    {
+        sf::FloatRect rect = MapIndex::objectBounds(object);
+        sf::Vector2f min = (rect.position - bounds.position) * scale + offset;
+        sf::Vector2f max = min + rect.size * scale;
+
+        // Everything covers at least one pixel, or coins would vanish
+        int left = std::clamp(static_cast<int>(std::floor(min.x)), 0, static_cast<int>(size.x) - 1);
+        int top = std::clamp(static_cast<int>(std::floor(min.y)), 0, static_cast<int>(size.y) - 1);
+        int right = std::clamp(static_cast<int>(std::ceil(max.x)), left + 1, static_cast<int>(size.x));
+        int bottom = std::clamp(static_cast<int>(std::ceil(max.y)), top + 1, static_cast<int>(size.y));
+
+        sf::Color color = objectColor(object.type);
+        for (int y = top; y < bottom; ++y)
+        {
+            for (int x = left; x < right; ++x)
+            {
+                image.setPixel({static_cast<unsigned int>(x), static_cast<unsigned int>(y)}, color);
+            }
+        }
+    }
+}
@@ -0,0 +1,160 @@
+#include "core/MappedFile.hpp"
+#include <utility>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+MappedFile::~MappedFile()
+{
+    close();
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept
+{
+    swap(other);
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept
+{
+    if (this != &other)
+    {
+        close();
+        swap(other);
+    }
+    return *this;
+}
+
+void MappedFile::swap(MappedFile& other) noexcept
+{
+    std::swap(data, other.data);
+    std::swap(size, other.size);
+    std::swap(opened, other.opened);
+#ifdef _WIN32
+    std::swap(fileHandle, other.fileHandle);
+    std::swap(mappingHandle, other.mappingHandle);
+#else
+    std::swap(descriptor, other.descriptor);
+#endif
+}
+
+#ifdef _WIN32
+
+bool MappedFile::open(const std::string& path)
+{
+    close();
+    
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+        return false;
+    
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(file, &fileSize))
+    {
+        CloseHandle(file);
+        return false;
+    }
+    
+    fileHandle = file;
+    size = static_cast<std::size_t>(fileSize.QuadPart);
+    opened = true;
+    
+    // Empty files cannot be mapped, they are just an empty view
+    if (size == 0)
+        return true;
+    
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!mapping)
+    {
+        close();
+        return false;
+    }
+    mappingHandle = mapping;
+    
+    data = static_cast<const char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+    if (!data)
+    {
+        close();
+        return false;
+    }
+    
+    return true;
+}
+
+void MappedFile::close()
+{
+    if (data)
+        UnmapViewOfFile(data);
+    if (mappingHandle)
+        CloseHandle(mappingHandle);
+    if (fileHandle)
+        CloseHandle(fileHandle);
+    
+    data = nullptr;
+    size = 0;
+    opened = false;
+    fileHandle = nullptr;
+    mappingHandle = nullptr;
+}
+
+#else
+
+bool MappedFile::open(const std::string& path)
+{
+    close();
+    
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+        return false;
+    
+    struct stat info;
+    if (fstat(fd, &info) != 0)
+    {
+        ::close(fd);
+        return false;
+    }
+    
+    descriptor = fd;
+    size = static_cast<std::size_t>(info.st_size);
+    opened = true;
+    
+    // Empty files cannot be mapped, they are just an empty view
+    if (size == 0)
+        return true;
+    
+    void* mapped = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (mapped == MAP_FAILED)
+    {
+        close();
+        return false;
+    }
+    data = static_cast<const char*>(mapped);
+    
+    // Parsers read front to back
+    madvise(mapped, size, MADV_SEQUENTIAL);
+    
+    return true;
+}
+
+void MappedFile::close()
+{
+    if (data)
+        munmap(const_cast<char*>(data), size);
+    if (descriptor >= 0)
+        ::close(descriptor);
+    
+    data = nullptr;
+    size = 0;
+    opened = false;
+    descriptor = -1;
+}
+
+#endif
@@ -0,0 +1,202 @@
+#include "core/ParticleSystem.hpp"
+#include <algorithm>
+#include <cmath>
+
+ParticleSystem::ParticleSystem(std::size_t capacity)
+    : capacity(capacity)
+{
+}
+
+std::size_t ParticleSystem::findPool(const sf::Texture* texture)
+{
+    for (std::size_t i = 0; i < pools.size(); ++i)
+    {
+        if (pools[i].texture == texture)
+            return i;
+    }
+
+    // All storage is taken up front; emitting never allocates
+    Pool& pool = pools.emplace_back();
+    pool.texture = texture;
+    for (auto* array : {&pool.x, &pool.y, &pool.vx, &pool.vy, &pool.gravity, &pool.drag, &pool.age, &pool.inverseLife})
+    {
+        array->resize(capacity);
+    }
+    pool.effect.resize(capacity);
+    pool.vertices.setPrimitiveType(sf::PrimitiveType::Triangles);
+    return pools.size() - 1;
+}
+
+std::size_t ParticleSystem::addEffect(const ParticleEffect& effect)
+{
+    effects.push_back(effect);
+    effectPools.push_back(findPool(effect.texture));
+    return effects.size() - 1;
+}
+
+float ParticleSystem::randomRange(float min, float max)
+{
+    return std::uniform_real_distribution<float>(min, max)(random);
+}
+
+std::size_t ParticleSystem::emit(std::size_t effectId, const sf::Vector2f& position, std::size_t count)
+{
+    const ParticleEffect& effect = effects[effectId];
+    Pool& pool = pools[effectPools[effectId]];
+
+    if (count == 0)
+        count = effect.count;
+    count = std::min(count, capacity - pool.count);
+
+    for (std::size_t n = 0; n < count; ++n)
+    {
+        std::size_t i = pool.count++;
+        float angle = effect.direction + randomRange(-effect.spread / 2.0f, effect.spread / 2.0f);
+        float speed = randomRange(effect.speedMin, effect.speedMax);
+
+        pool.x[i] = position.x;
+        pool.y[i] = position.y;
+        pool.vx[i] = std::cos(angle) * speed;
+        pool.vy[i] = std::sin(angle) * speed;
+        pool.gravity[i] = effect.gravity;
+        pool.drag[i] = effect.drag;
+        pool.age[i] = 0;
+        pool.inverseLife[i] = 1.0f / randomRange(effect.lifeMin, effect.lifeMax);
+        pool.effect[i] = static_cast<std::uint16_t>(effectId);
+    }
+    return count;
+}
+
+void ParticleSystem::updatePool(Pool& pool, float dt)
+{
+    std::size_t count = pool.count;
+    float* x = pool.x.data();
+    float* y = pool.y.data();
+    float* vx = pool.vx.data();
+    float* vy = pool.vy.data();
+    const float* gravity = pool.gravity.data();
+    const float* drag = pool.drag.data();
+    float* age = pool.age.data();
+
+    // Branch free passes over a few arrays each. The compiler vectorizes
+    // them after checking the arrays don't overlap, and gives up when one
+    // loop would need too many of those checks, hence three loops, not one.
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        float keep = 1.0f - drag[i] * dt;
+        keep = keep > 0.0f ? keep : 0.0f;
+        vx[i] *= keep;
+        vy[i] = vy[i] * keep + gravity[i] * dt;
+    }
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        x[i] += vx[i] * dt;
+        y[i] += vy[i] * dt;
+    }
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        age[i] += dt;
+    }
+
+    // The last live particle takes each dead one's place, so the live ones
+    // stay packed at the front
+    const float* inverseLife = pool.inverseLife.data();
+    for (std::size_t i = 0; i < count;)
+    {
+        if (age[i] * inverseLife[i] < 1.0f)
+        {
+            ++i;
+            continue;
+        }
+
+        --count;
+        pool.x[i] = pool.x[count];
+        pool.y[i] = pool.y[count];
+        pool.vx[i] = pool.vx[count];
+        pool.vy[i] = pool.vy[count];
+        pool.gravity[i] = pool.gravity[count];
+        pool.drag[i] = pool.drag[count];
+        pool.age[i] = pool.age[count];
+        pool.inverseLife[i] = pool.inverseLife[count];
+        pool.effect[i] = pool.effect[count];
+    }
+    pool.count = count;
+}
+
+void ParticleSystem::update(float dt)
+{
+    for (auto& pool : pools)
+    {
+        updatePool(pool, dt);
+    }
+}
+
+void ParticleSystem::buildVertices()
+{
+    for (auto& pool : pools)
+    {
+        pool.vertices.resize(pool.count * 6);
+        sf::Vertex* quad = pool.count > 0 ? &pool.vertices[0] : nullptr;
+
+        for (std::size_t i = 0; i < pool.count; ++i, quad += 6)
+        {
+            const ParticleEffect& effect = effects[pool.effect[i]];
+            float t = pool.age[i] * pool.inverseLife[i];
+
+            float half = (effect.sizeStart + (effect.sizeEnd - effect.sizeStart) * t) / 2.0f;
+            auto mix = [t](std::uint8_t from, std::uint8_t to)
+            {
+                return static_cast<std::uint8_t>(from + (to - from) * t);
+            };
+            sf::Color color(mix(effect.colorStart.r, effect.colorEnd.r), mix(effect.colorStart.g, effect.colorEnd.g),
+                            mix(effect.colorStart.b, effect.colorEnd.b), mix(effect.colorStart.a, effect.colorEnd.a));
+
+            float left = pool.x[i] - half;
+            float right = pool.x[i] + half;
+            float top = pool.y[i] - half;
+            float bottom = pool.y[i] + half;
+            float u0 = static_cast<float>(effect.textureRect.position.x);
+            float v0 = static_cast<float>(effect.textureRect.position.y);
+            float u1 = u0 + static_cast<float>(effect.textureRect.size.x);
+            float v1 = v0 + static_cast<float>(effect.textureRect.size.y);
+
+            quad[0] = {{left, top}, color, {u0, v0}};
+            quad[1] = {{right, top}, color, {u1, v0}};
+            quad[2] = {{right, bottom}, color, {u1, v1}};
+            quad[3] = quad[0];
+            quad[4] = quad[2];
+            quad[5] = {{left, bottom}, color, {u0, v1}};
+        }
+    }
+}
+
+void ParticleSystem::draw(sf::RenderTarget& target) const
+{
+    for (const auto& pool : pools)
+    {
+        if (pool.vertices.getVertexCount() == 0)
+            continue;
+
+        sf::RenderStates states(pool.texture);
+        target.draw(pool.vertices, states);
+    }
+}
+
+void ParticleSystem::clear()
+{
+    for (auto& pool : pools)
+    {
+        pool.count = 0;
+        pool.vertices.clear();
+    }
+}
+
+std::size_t ParticleSystem::getCount() const
+{
+    std::size_t count = 0;
+    for (const auto& pool : pools)
+    {
+        count += pool.count;
+    }
+    return count;
+}
@@ -1,13 +1,114 @@
 #include "core/Physics.hpp"
+#include <algorithm>
+#include <unordered_set>
+
+Physics::Physics()
+    : broadphase(BROADPHASE_CELL_SIZE), largestMotion(0),
+      staticLowestPoint(NO_PLATFORMS_LOWEST_POINT), kinematicLowestPoint(NO_PLATFORMS_LOWEST_POINT)
+{
+}
 
 void Physics::addPlatform(std::shared_ptr<Platform> platform)
 {
+    std::uint32_t index = static_cast<std::uint32_t>(platforms.size());
+    sf::FloatRect bounds = platform->getBounds();
+    proxies.push_back(broadphase.insert(bounds, index));
+    
+    // Static platforms never move, so only the kinematic part is recomputed per tick
+    if (platform->isKinematic())
+    {
+        kinematicPlatforms.push_back(index);
+        kinematicLowestPoint = std::max(kinematicLowestPoint, bounds.position.y + bounds.size.y);
+    }
+    else
+    {
+        staticLowestPoint = std::max(staticLowestPoint, bounds.position.y + bounds.size.y);
+    }
+    
     platforms.push_back(platform);
 }
 
 void Physics::clearPlatforms()
 {
     platforms.clear();
+    proxies.clear();
+    kinematicPlatforms.clear();
+    broadphase.clear();
+    largestMotion = 0;
+    staticLowestPoint = NO_PLATFORMS_LOWEST_POINT;
+    kinematicLowestPoint = NO_PLATFORMS_LOWEST_POINT;
+}
+
+void Physics::removePlatforms(const std::vector<const Platform*>& removed)
+{
+    std::unordered_set<const Platform*> lookup(removed.begin(), removed.end());
+    
+    // Compact in place; survivors that shift down get their new index as user data
+    std::size_t kept = 0;
+    for (std::size_t i = 0; i < platforms.size(); ++i)
+    {
+        if (lookup.count(platforms[i].get()))
+        {
+            broadphase.remove(proxies[i]);
+            continue;
+        }
+        
+        if (kept != i)
+        {
+            platforms[kept] = std::move(platforms[i]);
+            proxies[kept] = proxies[i];
+            broadphase.setUserData(proxies[kept], static_cast<std::uint32_t>(kept));
+        }
+        ++kept;
+    }
+    platforms.erase(platforms.begin() + kept, platforms.end());
+    proxies.erase(proxies.begin() + kept, proxies.end());
+    
+    rebuildPlatformInfo();
+}
+
+void Physics::refreshPlatforms(const std::vector<const Platform*>& moved)
+{
+    std::unordered_set<const Platform*> lookup(moved.begin(), moved.end());
+    
+    for (std::size_t i = 0; i < platforms.size(); ++i)
+    {
+        if (lookup.count(platforms[i].get()))
+            broadphase.update(proxies[i], platforms[i]->getBounds());
+    }
+    
+    rebuildPlatformInfo();
+}
+
+void Physics::cloneKinematicPlatforms(std::unordered_map<const Platform*, std::shared_ptr<Platform>>& clones)
+{
+    for (std::size_t index : kinematicPlatforms)
+    {
+        auto clone = std::make_shared<Platform>(*platforms[index]);
+        clones[platforms[index].get()] = clone;
+        platforms[index] = std::move(clone);
+    }
+}
+
+void Physics::rebuildPlatformInfo()
+{
+    kinematicPlatforms.clear();
+    staticLowestPoint = NO_PLATFORMS_LOWEST_POINT;
+    kinematicLowestPoint = NO_PLATFORMS_LOWEST_POINT;
+    
+    for (std::size_t i = 0; i < platforms.size(); ++i)
+    {
+        sf::FloatRect bounds = platforms[i]->getBounds();
+        if (platforms[i]->isKinematic())
+        {
+            kinematicPlatforms.push_back(i);
+            kinematicLowestPoint = std::max(kinematicLowestPoint, bounds.position.y + bounds.size.y);
+        }
+        else
+        {
+            staticLowestPoint = std::max(staticLowestPoint, bounds.position.y + bounds.size.y);
+        }
+    }
 }
 
 const std::vector<std::shared_ptr<Platform>>& Physics::getPlatforms() const
@@ -80,37 +181,102 @@ bool Physics::checkPlatformCollision(const sf::FloatRect& bounds, Platform& plat
     return false;
 }
 
-bool Physics::handleCollisions(Character& character, sf::Vector2f& velocity, bool& fellInPit, bool& hitDeadlyPlatform)
+float Physics::getLowestPoint() const
 {
-    sf::FloatRect bounds = character.getGlobalHitbox();
-    bool isOnGround = false;
-    fellInPit = false;
-    hitDeadlyPlatform = false;
+    return std::max(staticLowestPoint, kinematicLowestPoint);
+}
+
+void Physics::updateKinematics(const sf::Time& elapsed)
+{
+    const float dt = elapsed.asSeconds();
+    largestMotion = 0;
+    kinematicLowestPoint = NO_PLATFORMS_LOWEST_POINT;
     
-    // Check for falling below all platforms (death pit)
-    float lowestPlatform = -1000000.0f;
-    for (const auto& platform : platforms)
+    for (std::size_t index : kinematicPlatforms)
     {
-        sf::FloatRect platformBounds = platform->getBounds();
-        if (platformBounds.position.y + platformBounds.size.y > lowestPlatform)
-            lowestPlatform = platformBounds.position.y + platformBounds.size.y;
+        Platform& platform = *platforms[index];
+        if (platform.updateMotion(dt))
+        {
+            broadphase.update(proxies[index], platform.getBounds());
+            
+            sf::Vector2f delta = platform.getMotionDelta();
+            largestMotion = std::max(largestMotion, std::max(std::abs(delta.x), std::abs(delta.y)));
+        }
+        
+        sf::FloatRect bounds = platform.getBounds();
+        kinematicLowestPoint = std::max(kinematicLowestPoint, bounds.position.y + bounds.size.y);
     }
+}
+
+void Physics::gatherCandidates(const sf::FloatRect& area) const
+{
+    candidates.clear();
+    broadphase.query(area, candidates);
+    
+    // Grid order depends on cell layout; keep results in insertion order so
+    // collision response does not change with the broadphase
+    std::sort(candidates.begin(), candidates.end());
+}
+
+void Physics::queryPlatforms(const sf::FloatRect& area, std::vector<Platform*>& result) const
+{
+    gatherCandidates(area);
     
-    if (bounds.position.y > lowestPlatform + 200.0f)
+    for (std::uint32_t index : candidates)
     {
-        fellInPit = true;
-        return false;
+        if (platforms[index]->isSolid())
+            result.push_back(platforms[index].get());
     }
+}
+
+Platform* Physics::findSupport(const sf::FloatRect& bounds) const
+{
+    const float feet = bounds.position.y + bounds.size.y;
     
-    // Check collisions with all platforms
-    sf::Vector2f totalCorrection(0, 0);
+    // Platforms that moved this tick are tested where they were before moving,
+    // so widen the query by the largest step any of them took
+    const float margin = SUPPORT_TOLERANCE + largestMotion;
+    sf::FloatRect area({bounds.position.x - largestMotion, feet - margin},
+                       {bounds.size.x + largestMotion * 2.0f, margin * 2.0f});
+    
+    gatherCandidates(area);
+    for (std::uint32_t index : candidates)
+    {
+        Platform& platform = *platforms[index];
+        if (!platform.isSolid())
+            continue;
+        
+        sf::FloatRect previous = platform.getBounds();
+        previous.position -= platform.getMotionDelta();
+        
+        if (std::abs(previous.position.y - feet) <= SUPPORT_TOLERANCE &&
+            bounds.position.x < previous.position.x + previous.size.x &&
+            bounds.position.x + bounds.size.x > previous.position.x)
+        {
+            return &platform;
+        }
+    }
+    
+    return nullptr;
+}
+
+bool Physics::resolveCollisions(const sf::FloatRect& bounds, sf::Vector2f& velocity, sf::Vector2f& correction, bool& hitDeadlyPlatform)
+{
+    bool isOnGround = false;
+    hitDeadlyPlatform = false;
+    correction = sf::Vector2f(0, 0);
     
-    for (auto& platform : platforms)
+    gatherCandidates(bounds);
+    for (std::uint32_t index : candidates)
     {
-        sf::Vector2f correction(0, 0);
-        bool groundContact = checkPlatformCollision(bounds, *platform, velocity, correction);
+        Platform* platform = platforms[index].get();
+        if (!platform->isSolid())
+            continue;
         
-        totalCorrection += correction;
+        sf::Vector2f platformCorrection(0, 0);
+        bool groundContact = checkPlatformCollision(bounds, *platform, velocity, platformCorrection);
+        
+        correction += platformCorrection;
         
         if (groundContact)
         {
@@ -122,6 +288,26 @@ bool Physics::handleCollisions(Character& character, sf::Vector2f& velocity, boo
         }
     }
     
+    return isOnGround;
+}
+
+bool Physics::handleCollisions(Character& character, sf::Vector2f& velocity, bool& fellInPit, bool& hitDeadlyPlatform)
+{
+    sf::FloatRect bounds = character.getGlobalHitbox();
+    fellInPit = false;
+    hitDeadlyPlatform = false;
+    
+    // Check for falling below all platforms (death pit)
+    if (bounds.position.y > getLowestPoint() + 200.0f)
+    {
+        fellInPit = true;
+        return false;
+    }
+    
+    // Check collisions with all platforms
+    sf::Vector2f totalCorrection(0, 0);
+    bool isOnGround = resolveCollisions(bounds, velocity, totalCorrection, hitDeadlyPlatform);
+    
     // Apply position correction
     if (totalCorrection.x != 0 || totalCorrection.y != 0)
     {
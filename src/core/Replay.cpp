@@ -0,0 +1,129 @@
+#include "core/Replay.hpp"
+#include <cstring>
+#include "core/AtomicFile.hpp"
+#include "core/ByteStream.hpp"
+#include "core/MappedFile.hpp"
+#include "core/Telemetry.hpp"
+
+namespace
+{
+    constexpr std::uint32_t REPLAY_MAGIC = 0x50524C48; // "HLRP"
+
+    bool sameInput(const InputState& a, const InputState& b)
+    {
+        return a.held == b.held && a.pressed == b.pressed && a.released == b.released &&
+               std::memcmp(&a.aim, &b.aim, sizeof(a.aim)) == 0;
+    }
+}
+
+Replay::Replay()
+    : mapHash(0), tickTime(0)
+{
+}
+
+void Replay::clear()
+{
+    inputs.clear();
+}
+
+void Replay::setMap(const std::string& mapFile_, std::uint64_t mapHash_)
+{
+    mapFile = mapFile_;
+    mapHash = mapHash_;
+}
+
+void Replay::add(const InputState& input)
+{
+    inputs.push_back(input);
+}
+
+bool Replay::save(const std::string& path) const
+{
+    ByteWriter writer;
+    writer.writeU32(REPLAY_MAGIC);
+    writer.writeU8(REPLAY_VERSION);
+    writer.writeU64(mapHash);
+    writer.writeString(mapFile);
+    writer.writeF32(tickTime);
+    writer.writeU32(static_cast<std::uint32_t>(inputs.size()));
+
+    for (std::size_t i = 0; i < inputs.size();)
+    {
+        std::size_t end = i + 1;
+        while (end < inputs.size() && sameInput(inputs[end], inputs[i]))
+            ++end;
+
+        const InputState& input = inputs[i];
+        writer.writeVarint(static_cast<std::uint32_t>(end - i));
+        writer.writeVarint(input.held);
+        writer.writeVarint(input.pressed);
+        writer.writeVarint(input.released);
+        writer.writeF32(input.aim.x);
+        writer.writeF32(input.aim.y);
+        i = end;
+    }
+
+    if (!writeFileAtomic(path, {writer.getView()}))
+    {
+        LogLine(LogLevel::Error) << "Could not write replay " << path;
+        return false;
+    }
+    return true;
+}
+
+bool Replay::load(const std::string& path)
+{
+    inputs.clear();
+
+    MappedFile file;
+    if (!file.open(path))
+    {
+        LogLine(LogLevel::Error) << "Could not open replay " << path;
+        return false;
+    }
+
+    ByteReader reader(reinterpret_cast<const std::uint8_t*>(file.getData()), file.getSize());
+    std::uint32_t magic = reader.readU32();
+    std::uint8_t version = reader.readU8();
+    if (magic != REPLAY_MAGIC || (version != REPLAY_VERSION && version != 2))
+    {
+        LogLine(LogLevel::Error) << "Not a replay file: " << path;
+        return false;
+    }
+
+    // Version 2 also stored whether physics ran in fixed point, which no
+    // build does any more
+    if (version == 2 && reader.readU8() != 0)
+    {
+        LogLine(LogLevel::Error) << "Replay " << path << " was recorded with fixed point physics";
+        return false;
+    }
+
+    mapHash = reader.readU64();
+    mapFile = reader.readString();
+    tickTime = reader.readF32();
+    std::uint32_t tickCount = reader.readU32();
+
+    while (reader.isValid() && inputs.size() < tickCount)
+    {
+        std::uint32_t length = reader.readVarint();
+        InputState input;
+        input.held = static_cast<std::uint16_t>(reader.readVarint());
+        input.pressed = static_cast<std::uint16_t>(reader.readVarint());
+        input.released = static_cast<std::uint16_t>(reader.readVarint());
+        input.aim.x = reader.readF32();
+        input.aim.y = reader.readF32();
+
+        if (length == 0 || length > tickCount - inputs.size())
+            break;
+        inputs.insert(inputs.end(), length, input);
+    }
+
+    if (!reader.isValid() || inputs.size() != tickCount || !(tickTime > 0))
+    {
+        LogLine(LogLevel::Warning) << "Replay " << path << " is damaged";
+        inputs.clear();
+        return false;
+    }
+    return true;
+}
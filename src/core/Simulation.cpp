@@ -0,0 +1,323 @@
+#include "core/Simulation.hpp"
+#include "ecs/Prefabs.hpp"
+
+Simulation::Simulation(const sf::Texture& characterTexture)
+    : player(characterTexture), score(0), deaths(0), time(0), lastCheckpoint(100, 250)
+{
+    // Setup animations
+    player.setAnimationRow(PlayerState::Idle, 1, 10, true);
+    player.setAnimationRow(PlayerState::Walking, 3, 10, true);
+    player.setAnimationRow(PlayerState::Jumping, 10, 6, false);
+    player.setAnimationRow(PlayerState::BeginFalling, 11, 4, false);
+    player.setAnimationRow(PlayerState::Falling, 12, 3, true); 
+    player.setAnimationRow(PlayerState::Hooked, 13, 4, true);
+    
+    player.setFps(20);
+    player.setPosition(lastCheckpoint);
+    player.setHitbox(Player::HITBOX_LEFT, Player::HITBOX_TOP, Player::HITBOX_WIDTH, Player::HITBOX_HEIGHT);
+}
+
+Simulation::Simulation(const Simulation& other)
+    : player(other.player), physics(other.physics), registry(other.registry),
+      score(other.score), deaths(other.deaths), time(other.time), lastCheckpoint(other.lastCheckpoint)
+{
+    cloneKinematicPlatforms();
+}
+
+Simulation& Simulation::operator=(const Simulation& other)
+{
+    if (this != &other)
+    {
+        player = other.player;
+        physics = other.physics;
+        registry = other.registry;
+        score = other.score;
+        deaths = other.deaths;
+        time = other.time;
+        lastCheckpoint = other.lastCheckpoint;
+        cloneKinematicPlatforms();
+    }
+    return *this;
+}
+
+void Simulation::cloneKinematicPlatforms()
+{
+    std::unordered_map<const Platform*, std::shared_ptr<Platform>> clones;
+    physics.cloneKinematicPlatforms(clones);
+    if (clones.empty())
+        return;
+    
+    // Point the render entities and the hook at this copy's platforms
+    registry.each<PlatformComponent>([&clones](Entity, PlatformComponent& component)
+    {
+        auto it = clones.find(component.platform.get());
+        if (it != clones.end())
+            component.platform = it->second;
+    });
+    
+    if (auto attached = player.getHook().getAttachedPlatform())
+    {
+        auto it = clones.find(attached.get());
+        if (it != clones.end())
+            player.getHook().setAttachedPlatform(it->second);
+    }
+}
+
+void Simulation::clear()
+{
+    registry.clear();
+    physics.clearPlatforms();
+}
+
+Entity Simulation::addPlatform(const std::shared_ptr<Platform>& platform)
+{
+    physics.addPlatform(platform);
+    return createPlatformEntity(registry, platform);
+}
+
+Entity Simulation::addPickup(PickupType type, const sf::Texture& texture, const sf::Vector2f& position)
+{
+    return createPickupEntity(registry, type, texture, position);
+}
+
+void Simulation::removeObjects(const std::vector<Entity>& entities)
+{
+    std::vector<const Platform*> removedPlatforms;
+    for (Entity entity : entities)
+    {
+        if (PlatformComponent* platform = registry.tryGet<PlatformComponent>(entity))
+            removedPlatforms.push_back(platform->platform.get());
+    }
+    
+    if (!removedPlatforms.empty())
+    {
+        physics.removePlatforms(removedPlatforms);
+        releaseDetachedHook();
+    }
+    
+    for (Entity entity : entities)
+    {
+        registry.destroy(entity);
+    }
+}
+
+void Simulation::moveObjects(const std::vector<std::pair<Entity, sf::Vector2f>>& moves)
+{
+    std::vector<const Platform*> movedPlatforms;
+    for (const auto& [entity, position] : moves)
+    {
+        if (TransformComponent* transform = registry.tryGet<TransformComponent>(entity))
+            transform->position = position;
+        
+        if (PlatformComponent* platform = registry.tryGet<PlatformComponent>(entity))
+        {
+            platform->platform->setPosition(position);
+            movedPlatforms.push_back(platform->platform.get());
+        }
+    }
+    
+    if (!movedPlatforms.empty())
+    {
+        physics.refreshPlatforms(movedPlatforms);
+        releaseDetachedHook();
+    }
+}
+
+void Simulation::releaseDetachedHook()
+{
+    if (!player.isHooked())
+        return;
+    
+    // The hook hangs from the underside of a platform, so a tiny box around
+    // the attach point still touches it if the platform is there
+    sf::Vector2f anchor = player.getHook().getAttachPoint();
+    std::vector<Platform*> found;
+    physics.queryPlatforms(sf::FloatRect({anchor.x - 1, anchor.y - 1}, {2, 2}), found);
+    
+    if (found.empty())
+        player.releaseHook();
+}
+
+void Simulation::restart(const sf::Vector2f& spawn)
+{
+    score = 0;
+    deaths = 0;
+    time = 0;
+    lastCheckpoint = spawn;
+    
+    player.setPosition(lastCheckpoint);
+    player.reset();
+}
+
+void Simulation::setProgress(int score_, int deaths_, float time_, const sf::Vector2f& lastCheckpoint_)
+{
+    score = score_;
+    deaths = deaths_;
+    time = time_;
+    lastCheckpoint = lastCheckpoint_;
+}
+
+void Simulation::respawnPlayer()
+{
+    deaths++;
+    player.setPosition({lastCheckpoint.x-16, lastCheckpoint.y-16});
+    player.reset();
+}
+
+SimulationEvents Simulation::step(const InputState& input, const sf::Time& elapsed)
+{
+    SimulationEvents events;
+    step(input, elapsed, events);
+    return events;
+}
+
+void Simulation::step(const InputState& input, const sf::Time& elapsed, SimulationEvents& events)
+{
+    events.won = false;
+    events.died = false;
+    events.hookReleased = false;
+    events.effects.clear();
+    
+    if (!player.isAlive())
+        return;
+    
+    time += elapsed.asSeconds();
+    
+    player.handleInput(input);
+    
+    // Move platforms first and carry the player with the one it stands on
+    physics.updateKinematics(elapsed);
+    platformSystem.update(registry);
+    
+    if (player.isOnGround())
+    {
+        if (Platform* support = physics.findSupport(player.getGlobalHitbox()))
+        {
+            player.setPosition(player.getPosition() + support->getMotionDelta());
+            support->touch();
+        }
+    }
+    
+    // Update hook
+    bool wasHooked = player.isHooked();
+    player.updateHook(elapsed, physics);
+    if (!wasHooked && player.isHooked())
+        events.effects.push_back({EffectType::HookAttached, player.getHook().getAttachPoint()});
+    
+    // Apply physics differently based on hook state
+    if (player.isHooked())
+    {
+        player.applySwingPhysics(elapsed, physics);
+        
+        sf::Vector2f velocity = player.getVelocity();
+        bool fellInPit = false;
+        bool hitDeadlyPlatform = false;
+        bool onGround = physics.handleCollisions(player, velocity, fellInPit, hitDeadlyPlatform);
+        player.setOnGround(onGround);
+        player.setVelocity(velocity);
+        
+        if (onGround)
+        {
+            player.releaseHook();
+        }
+    }
+    else
+    {
+        sf::Vector2f velocity = player.getVelocity();
+        physics.applyGravity(velocity, elapsed);
+        player.setVelocity(velocity);
+        
+        player.moveCharacter(elapsed);
+        
+        bool fellInPit = false;
+        bool hitDeadlyPlatform = false;
+        bool onGround = physics.handleCollisions(player, velocity, fellInPit, hitDeadlyPlatform);
+        player.setOnGround(onGround);
+        player.setVelocity(velocity);
+        
+        velocity = player.getVelocity();
+        physics.applyFriction(velocity, onGround);
+        player.setVelocity(velocity);
+        
+        if (fellInPit || hitDeadlyPlatform)
+        {
+            sf::FloatRect hitbox = player.getGlobalHitbox();
+            events.effects.push_back({EffectType::PlayerDied, hitbox.position + hitbox.size / 2.0f});
+            respawnPlayer();
+            events.died = true;
+        }
+    }
+    
+    // Other moving entities
+    movementSystem.update(registry, physics, elapsed);
+    
+    // Check pickup collisions
+    pickupEvents.clear();
+    pickupSystem.collect(registry, player.getGlobalHitbox(), pickupEvents);
+    for (const auto& pickup : pickupEvents)
+    {
+        switch (pickup.type)
+        {
+            case PickupType::Coin:
+                score++;
+                events.effects.push_back({EffectType::CoinCollected, pickup.center});
+                break;
+            case PickupType::Checkpoint:
+                lastCheckpoint = pickup.position;
+                events.effects.push_back({EffectType::CheckpointReached, pickup.center});
+                break;
+            case PickupType::Win:
+                events.won = true;
+                break;
+        }
+    }
+    
+    if (wasHooked && !player.isHooked())
+        events.hookReleased = true;
+    
+    // Update pickups
+    animationSystem.update(registry, elapsed);
+    
+    // Update player
+    player.updateState();
+    player.animate(elapsed);
+}
+
+void Simulation::buildSnapshot(RenderSnapshot& snapshot)
+{
+    snapshot.world.build(registry);
+    
+    snapshot.playerTransform = player.getTransform();
+    snapshot.playerTextureRect = player.getTextureRect();
+    snapshot.playerHitbox = player.getGlobalHitbox();
+    snapshot.playerPosition = player.getPosition();
+    snapshot.playerState = player.getState();
+    snapshot.playerFacingLeft = player.getDirection() == Direction::Left;
+    
+    snapshot.hook = player.getHook();
+    
+    // Rope runs from the anchor through every wrapped corner to the body
+    snapshot.rope.clear();
+    const Rope& rope = player.getRope();
+    if (player.isHooked() && rope.isActive())
+    {
+        snapshot.rope.emplace_back().position = rope.getAnchor();
+        for (int i = 0; i < rope.getWrapCount(); ++i)
+        {
+            snapshot.rope.emplace_back().position = rope.getWrapPoint(i);
+        }
+        for (int i = 1; i <= rope.getSegmentCount(); ++i)
+        {
+            snapshot.rope.emplace_back().position = rope.getPoint(i);
+        }
+        
+        for (auto& vertex : snapshot.rope)
+        {
+            vertex.color = sf::Color(100, 100, 100);
+        }
+    }
+    
+    snapshot.score = score;
+    snapshot.deaths = deaths;
+    snapshot.time = time;
+}
@@ -0,0 +1,77 @@
+#include "core/SimulationThread.hpp"
+
+SimulationThread::SimulationThread(Simulation& simulation)
+    : simulation(simulation), front(0), hasWork(false), stopping(false), busy(false)
+{
+    worker = std::thread(&SimulationThread::workerLoop, this);
+}
+
+SimulationThread::~SimulationThread()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    workReady.notify_one();
+    worker.join();
+}
+
+void SimulationThread::submit(const InputState& input, const sf::Time& elapsed)
+{
+    if (busy)
+        wait();
+    
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        pendingInput = input;
+        pendingElapsed = elapsed;
+        hasWork = true;
+    }
+    busy = true;
+    workReady.notify_one();
+}
+
+SimulationEvents SimulationThread::wait()
+{
+    if (!busy)
+        return SimulationEvents();
+    
+    std::unique_lock<std::mutex> lock(mutex);
+    workDone.wait(lock, [this] { return !hasWork; });
+    
+    busy = false;
+    front = 1 - front;
+    return pendingEvents;
+}
+
+void SimulationThread::refresh()
+{
+    wait();
+    simulation.buildSnapshot(snapshots[front]);
+}
+
+void SimulationThread::workerLoop()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    
+    while (true)
+    {
+        workReady.wait(lock, [this] { return hasWork || stopping; });
+        if (stopping)
+            return;
+        
+        InputState input = pendingInput;
+        sf::Time elapsed = pendingElapsed;
+        RenderSnapshot& back = snapshots[1 - front];
+        
+        // The main thread only reads the front snapshot while this runs
+        lock.unlock();
+        SimulationEvents events = simulation.step(input, elapsed);
+        simulation.buildSnapshot(back);
+        lock.lock();
+        
+        pendingEvents = events;
+        hasWork = false;
+        workDone.notify_one();
+    }
+}
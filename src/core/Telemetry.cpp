@@ -0,0 +1,333 @@
+#include "core/Telemetry.hpp"
+#include <algorithm>
+#include <cinttypes>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+
+namespace
+{
+    // How long the writer sleeps once the ring is empty. Messages show up at
+    // most this late.
+    constexpr std::chrono::milliseconds DRAIN_INTERVAL(5);
+
+    const char* typeName(TelemetryType type)
+    {
+        switch (type)
+        {
+            case TelemetryType::Message: return "message";
+            case TelemetryType::LevelLoaded: return "level";
+            case TelemetryType::LevelFinished: return "finish";
+            case TelemetryType::Died: return "death";
+            case TelemetryType::Checkpoint: return "checkpoint";
+            case TelemetryType::Pickup: return "pickup";
+            case TelemetryType::HookAttached: return "hook";
+            case TelemetryType::HookReleased: return "unhook";
+            case TelemetryType::FrameHitch: return "hitch";
+            case TelemetryType::Dropped: return "dropped";
+        }
+        return "unknown";
+    }
+
+    const char* levelName(LogLevel level)
+    {
+        switch (level)
+        {
+            case LogLevel::Info: return "info";
+            case LogLevel::Warning: return "warning";
+            case LogLevel::Error: return "error";
+        }
+        return "info";
+    }
+
+    void writeString(std::ostream& out, std::string_view text)
+    {
+        out << '"';
+        for (char c : text)
+        {
+            if (c == '"' || c == '\\')
+            {
+                out << '\\' << c;
+            }
+            else if (static_cast<unsigned char>(c) < 0x20)
+            {
+                char escaped[8];
+                std::snprintf(escaped, sizeof(escaped), "\\u%04x", static_cast<unsigned>(c));
+                out << escaped;
+            }
+            else
+            {
+                out << c;
+            }
+        }
+        out << '"';
+    }
+
+    void print(LogLevel level, std::string_view text)
+    {
+        std::ostream& out = level == LogLevel::Info ? std::cout : std::cerr;
+        out << text << std::endl;
+    }
+}
+
+std::atomic<Telemetry*> Telemetry::active{nullptr};
+
+Telemetry::Telemetry()
+    : slots(new Slot[CAPACITY]), head(0), tail(0), dropped(0), droppedReported(0), stopping(true),
+      finishing(true), producers(0)
+{
+    static_assert((CAPACITY & (CAPACITY - 1)) == 0, "Telemetry::CAPACITY must be a power of two");
+    for (std::size_t i = 0; i < CAPACITY; ++i)
+    {
+        slots[i].sequence.store(i, std::memory_order_relaxed);
+    }
+}
+
+Telemetry::~Telemetry()
+{
+    close();
+}
+
+bool Telemetry::open(const std::string& path)
+{
+    close();
+
+    std::error_code error;
+    std::filesystem::path parent = std::filesystem::path(path).parent_path();
+    if (!parent.empty())
+        std::filesystem::create_directories(parent, error);
+
+    file.open(path, std::ios::trunc);
+    bool opened = file.is_open();
+
+    start = Clock::now();
+    stopping = false;
+    finishing = false;
+    writer = std::thread([this] { run(); });
+    active = this;
+
+    if (!opened)
+        LogLine(LogLevel::Warning) << "Could not open " << path << ", telemetry is not saved";
+    return opened;
+}
+
+void Telemetry::close()
+{
+    if (!writer.joinable())
+        return;
+
+    // Messages from now on are printed directly
+    Telemetry* self = this;
+    active.compare_exchange_strong(self, nullptr);
+
+    stopping = true;
+    while (producers.load() != 0)
+    {
+        std::this_thread::yield();
+    }
+    finishing = true;
+    writer.join();
+    file.close();
+}
+
+bool Telemetry::enter()
+{
+    // Counted before stopping is read, so close() either sees this producer
+    // and waits for its push, or this producer sees stopping and turns away
+    producers.fetch_add(1);
+    if (!stopping.load())
+        return true;
+    producers.fetch_sub(1);
+    return false;
+}
+
+void Telemetry::leave()
+{
+    producers.fetch_sub(1);
+}
+
+bool Telemetry::record(TelemetryType type, const sf::Vector2f& position, std::uint64_t value, std::string_view text)
+{
+    if (!enter())
+        return false;
+
+    TelemetryEvent event;
+    event.timeNs = elapsedNs();
+    event.value = value;
+    event.position = position;
+    event.type = type;
+    event.length = static_cast<std::uint16_t>(std::min(text.size(), TelemetryEvent::TEXT_SIZE));
+    std::memcpy(event.text.data(), text.data(), event.length);
+    bool pushed = push(event);
+    leave();
+    return pushed;
+}
+
+bool Telemetry::message(LogLevel level, std::string_view text)
+{
+    if (!enter())
+        return false;
+
+    TelemetryEvent event;
+    event.timeNs = elapsedNs();
+    event.level = level;
+    event.length = static_cast<std::uint16_t>(std::min(text.size(), TelemetryEvent::TEXT_SIZE));
+    std::memcpy(event.text.data(), text.data(), event.length);
+
+    // Too long for a slot: printed whole now, only the start is saved
+    if (text.size() > TelemetryEvent::TEXT_SIZE)
+    {
+        print(level, text);
+        event.printed = true;
+        push(event);
+        leave();
+        return true;
+    }
+    bool pushed = push(event);
+    leave();
+    return pushed;
+}
+
+std::uint64_t Telemetry::elapsedNs() const
+{
+    return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count());
+}
+
+bool Telemetry::push(const TelemetryEvent& event)
+{
+    // A slot is free for the producer at position when its sequence equals
+    // position, and readable by the writer once it is position + 1
+    std::uint64_t position = head.load(std::memory_order_relaxed);
+    while (true)
+    {
+        Slot& slot = slots[position & (CAPACITY - 1)];
+        std::uint64_t sequence = slot.sequence.load(std::memory_order_acquire);
+        std::int64_t difference = static_cast<std::int64_t>(sequence - position);
+        if (difference == 0)
+        {
+            if (head.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+            {
+                slot.event = event;
+                slot.sequence.store(position + 1, std::memory_order_release);
+                return true;
+            }
+        }
+        else if (difference < 0)
+        {
+            // The writer is a whole ring behind
+            dropped.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        else
+        {
+            position = head.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+bool Telemetry::pop(TelemetryEvent& event)
+{
+    Slot& slot = slots[tail & (CAPACITY - 1)];
+    if (slot.sequence.load(std::memory_order_acquire) != tail + 1)
+        return false;
+
+    event = slot.event;
+    // Free again for the producer one lap later
+    slot.sequence.store(tail + CAPACITY, std::memory_order_release);
+    ++tail;
+    return true;
+}
+
+void Telemetry::run()
+{
+    TelemetryEvent event;
+    while (true)
+    {
+        // Read before draining, so everything queued before close() is written
+        bool stop = finishing.load();
+
+        bool wrote = false;
+        while (pop(event))
+        {
+            write(event);
+            wrote = true;
+        }
+
+        std::uint64_t lost = dropped.load(std::memory_order_relaxed);
+        if (lost != droppedReported)
+        {
+            TelemetryEvent report;
+            report.timeNs = elapsedNs();
+            report.type = TelemetryType::Dropped;
+            report.value = lost - droppedReported;
+            droppedReported = lost;
+            write(report);
+            wrote = true;
+        }
+
+        // Flushed once per batch, not per line
+        if (wrote && file.is_open())
+            file.flush();
+        if (stop)
+            return;
+        std::this_thread::sleep_for(DRAIN_INTERVAL);
+    }
+}
+
+void Telemetry::write(const TelemetryEvent& event)
+{
+    std::string_view text(event.text.data(), event.length);
+    if (event.type == TelemetryType::Message && !event.printed)
+        print(event.level, text);
+    if (!file.is_open())
+        return;
+
+    char number[64];
+    std::snprintf(number, sizeof(number), "%.6f", event.timeNs / 1e9);
+    file << "{\"t\":" << number << ",\"event\":\"" << typeName(event.type) << '"';
+
+    switch (event.type)
+    {
+        case TelemetryType::Message:
+            file << ",\"level\":\"" << levelName(event.level) << "\",\"text\":";
+            writeString(file, text);
+            break;
+        case TelemetryType::LevelLoaded:
+            std::snprintf(number, sizeof(number), "%016" PRIx64, event.value);
+            file << ",\"map\":";
+            writeString(file, text);
+            file << ",\"hash\":\"" << number << '"';
+            break;
+        case TelemetryType::LevelFinished:
+            file << ",\"ms\":" << event.value;
+            break;
+        case TelemetryType::FrameHitch:
+            std::snprintf(number, sizeof(number), "%.2f", event.value / 1000.0);
+            file << ",\"ms\":" << number;
+            break;
+        case TelemetryType::Dropped:
+            file << ",\"count\":" << event.value;
+            break;
+        default:
+            std::snprintf(number, sizeof(number), "%.1f,\"y\":%.1f", event.position.x, event.position.y);
+            file << ",\"x\":" << number;
+            break;
+    }
+    file << "}\n";
+}
+
+LogLine::LogLine(LogLevel level)
+    : level(level)
+{
+}
+
+LogLine::~LogLine()
+{
+    // Printed here if nothing is running or the ring is full; a message is
+    // never lost
+    Telemetry* telemetry = Telemetry::getActive();
+    std::string text = stream.str();
+    if (!telemetry || !telemetry->message(level, text))
+        print(level, text);
+}
@@ -0,0 +1,102 @@
+#include "core/TextureCache.hpp"
+#include "core/AtomicFile.hpp"
+#include "core/MappedFile.hpp"
+#include "core/Telemetry.hpp"
+#include <cstring>
+
+namespace
+{
+    // Written in native byte order; the cache never leaves the machine
+    struct CacheHeader
+    {
+        char magic[4];
+        std::uint32_t version;
+        std::uint64_t sourceHash;
+        std::uint32_t width;
+        std::uint32_t height;
+        std::uint8_t padding[40];
+    };
+
+    static_assert(sizeof(CacheHeader) == 64, "pixels start on a 64 byte boundary");
+
+    constexpr char CACHE_MAGIC[4] = {'H', 'L', 'T', 'C'};
+}
+
+TextureCache::TextureCache(const std::string& directory)
+    : directory(directory), reportedWriteError(false)
+{
+}
+
+void TextureCache::setDirectory(const std::string& directory_)
+{
+    directory = directory_;
+    reportedWriteError = false;
+}
+
+std::string TextureCache::entryPath(const std::string& name) const
+{
+    // Flatten sub directories into the file name
+    std::string file = name;
+    for (char& c : file)
+    {
+        if (c == '/' || c == '\\')
+            c = '_';
+    }
+    return directory + "/" + file + ".rgba";
+}
+
+bool TextureCache::load(const std::string& name, std::uint64_t sourceHash, sf::Texture& texture) const
+{
+    if (!isEnabled())
+        return false;
+
+    MappedFile file;
+    if (!file.open(entryPath(name)) || file.getSize() < sizeof(CacheHeader))
+        return false;
+
+    CacheHeader header;
+    std::memcpy(&header, file.getData(), sizeof(header));
+
+    std::size_t pixelBytes = static_cast<std::size_t>(header.width) * header.height * 4;
+    if (std::memcmp(header.magic, CACHE_MAGIC, sizeof(CACHE_MAGIC)) != 0 ||
+        header.version != VERSION ||
+        header.sourceHash != sourceHash ||
+        header.width == 0 || header.height == 0 ||
+        file.getSize() != sizeof(CacheHeader) + pixelBytes)
+    {
+        return false;
+    }
+
+    if (!texture.resize({header.width, header.height}))
+        return false;
+
+    texture.update(reinterpret_cast<const std::uint8_t*>(file.getData() + sizeof(CacheHeader)));
+    return true;
+}
+
+void TextureCache::store(const std::string& name, std::uint64_t sourceHash, const sf::Image& image) const
+{
+    if (!isEnabled())
+        return;
+
+    sf::Vector2u size = image.getSize();
+    if (size.x == 0 || size.y == 0)
+        return;
+
+    CacheHeader header = {};
+    std::memcpy(header.magic, CACHE_MAGIC, sizeof(CACHE_MAGIC));
+    header.version = VERSION;
+    header.sourceHash = sourceHash;
+    header.width = size.x;
+    header.height = size.y;
+
+    std::string_view headerBytes(reinterpret_cast<const char*>(&header), sizeof(header));
+    std::string_view pixels(reinterpret_cast<const char*>(image.getPixelsPtr()),
+                            static_cast<std::size_t>(size.x) * size.y * 4);
+    if (!writeFileAtomic(entryPath(name), {headerBytes, pixels}))
+    {
+        if (!reportedWriteError)
+            LogLine(LogLevel::Error) << "Could not write texture cache in " << directory;
+        reportedWriteError = true;
+    }
+}
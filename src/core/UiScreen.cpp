@@ -0,0 +1,284 @@
+#include "core/UiScreen.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+    // Glyph quads reach a pixel past the glyph, as sf::Text draws them, so
+    // smoothed edges are not cut off
+    constexpr float GLYPH_PADDING = 1.0f;
+
+    void addQuad(std::vector<sf::Vertex>& out, const sf::FloatRect& rect, sf::Color color,
+                 const sf::FloatRect& texture = sf::FloatRect())
+    {
+        sf::Vector2f p = rect.position;
+        sf::Vector2f s = rect.size;
+        sf::Vector2f t = texture.position;
+        sf::Vector2f ts = texture.size;
+
+        const sf::Vertex topLeft{p, color, t};
+        const sf::Vertex topRight{{p.x + s.x, p.y}, color, {t.x + ts.x, t.y}};
+        const sf::Vertex bottomRight{p + s, color, t + ts};
+        const sf::Vertex bottomLeft{{p.x, p.y + s.y}, color, {t.x, t.y + ts.y}};
+
+        out.push_back(topLeft);
+        out.push_back(topRight);
+        out.push_back(bottomRight);
+        out.push_back(topLeft);
+        out.push_back(bottomRight);
+        out.push_back(bottomLeft);
+    }
+}
+
+UiColumn::UiColumn(float centerX, float top, float gap)
+    : centerX(centerX), y(top), gap(gap)
+{
+}
+
+sf::FloatRect UiColumn::next(const sf::Vector2f& size)
+{
+    sf::FloatRect rect({centerX - size.x / 2.0f, y}, size);
+    y += size.y + gap;
+    return rect;
+}
+
+UiScreen::UiScreen(const sf::Font& font)
+    : font(font), dirty(true), panels(sf::PrimitiveType::Triangles)
+{
+}
+
+void UiScreen::clear()
+{
+    widgets.clear();
+    buttons.clear();
+    dirty = true;
+}
+
+UiScreen::WidgetId UiScreen::addPanel(const sf::FloatRect& rect, sf::Color color)
+{
+    Widget widget;
+    widget.kind = Kind::Panel;
+    widget.rect = rect;
+    widget.color = color;
+    return add(std::move(widget));
+}
+
+UiScreen::WidgetId UiScreen::addLabel(const sf::FloatRect& rect, const std::string& text, unsigned int characterSize,
+                                      sf::Color color, UiAlign align)
+{
+    Widget widget;
+    widget.kind = Kind::Label;
+    widget.rect = rect;
+    widget.text = text;
+    widget.characterSize = characterSize;
+    widget.color = color;
+    widget.align = align;
+    return add(std::move(widget));
+}
+
+UiScreen::WidgetId UiScreen::addButton(const sf::FloatRect& rect, const std::string& text, unsigned int characterSize,
+                                       sf::Color color)
+{
+    Widget widget;
+    widget.kind = Kind::Button;
+    widget.rect = rect;
+    widget.text = text;
+    widget.characterSize = characterSize;
+    widget.color = color;
+    widget.align = UiAlign::Center;
+    WidgetId id = add(std::move(widget));
+    buttons.push_back(id);
+    return id;
+}
+
+UiScreen::WidgetId UiScreen::add(Widget widget)
+{
+    widgets.push_back(std::move(widget));
+    dirty = true;
+    return widgets.size() - 1;
+}
+
+void UiScreen::markDirty(Widget& widget)
+{
+    widget.dirty = true;
+    dirty = true;
+}
+
+void UiScreen::setText(WidgetId id, const std::string& text)
+{
+    Widget& widget = widgets[id];
+    if (widget.text == text)
+        return;
+    widget.text = text;
+    markDirty(widget);
+}
+
+void UiScreen::setColor(WidgetId id, sf::Color color)
+{
+    Widget& widget = widgets[id];
+    if (widget.color == color)
+        return;
+    widget.color = color;
+    markDirty(widget);
+}
+
+void UiScreen::setVisible(WidgetId id, bool visible)
+{
+    Widget& widget = widgets[id];
+    if (widget.visible == visible)
+        return;
+    widget.visible = visible;
+    // Its quads are still good, only the batches change
+    dirty = true;
+}
+
+UiScreen::WidgetId UiScreen::hitTest(const sf::Vector2f& point) const
+{
+    for (WidgetId id : buttons)
+    {
+        const Widget& widget = widgets[id];
+        if (widget.visible && widget.rect.contains(point))
+            return id;
+    }
+    return NONE;
+}
+
+void UiScreen::tessellate(Widget& widget) const
+{
+    widget.quads.clear();
+    widget.textQuads.clear();
+
+    switch (widget.kind)
+    {
+        case Kind::Panel:
+            addQuad(widget.quads, widget.rect, widget.color);
+            break;
+        case Kind::Label:
+            tessellateText(widget, widget.color);
+            break;
+        case Kind::Button:
+            addQuad(widget.quads, widget.rect, widget.color);
+            tessellateText(widget, sf::Color::White);
+            break;
+    }
+    widget.dirty = false;
+}
+
+void UiScreen::tessellateText(Widget& widget, sf::Color textColor) const
+{
+    const unsigned int size = widget.characterSize;
+    const float whitespace = font.getGlyph(U' ', size, false).advance;
+    const float lineSpacing = font.getLineSpacing(size);
+
+    // Laid out like sf::Text, with the first baseline one character size down
+    float x = 0;
+    float y = static_cast<float>(size);
+    float minX = 0, minY = 0, maxX = 0, maxY = 0;
+    bool first = true;
+    char32_t previous = 0;
+    for (unsigned char byte : widget.text)
+    {
+        char32_t c = byte;
+        if (c == U'\r')
+            continue;
+
+        x += font.getKerning(previous, c, size);
+        previous = c;
+        if (c == U' ')
+        {
+            x += whitespace;
+            continue;
+        }
+        if (c == U'\t')
+        {
+            x += whitespace * 4;
+            continue;
+        }
+        if (c == U'\n')
+        {
+            y += lineSpacing;
+            x = 0;
+            continue;
+        }
+
+        const sf::Glyph& glyph = font.getGlyph(c, size, false);
+        sf::FloatRect quad({x + glyph.bounds.position.x - GLYPH_PADDING, y + glyph.bounds.position.y - GLYPH_PADDING},
+                           {glyph.bounds.size.x + 2 * GLYPH_PADDING, glyph.bounds.size.y + 2 * GLYPH_PADDING});
+        sf::FloatRect texture({glyph.textureRect.position.x - GLYPH_PADDING, glyph.textureRect.position.y - GLYPH_PADDING},
+                              {glyph.textureRect.size.x + 2 * GLYPH_PADDING, glyph.textureRect.size.y + 2 * GLYPH_PADDING});
+        addQuad(widget.textQuads, quad, textColor, texture);
+
+        float left = x + glyph.bounds.position.x;
+        float top = y + glyph.bounds.position.y;
+        minX = first ? left : std::min(minX, left);
+        minY = first ? top : std::min(minY, top);
+        maxX = first ? left + glyph.bounds.size.x : std::max(maxX, left + glyph.bounds.size.x);
+        maxY = first ? top + glyph.bounds.size.y : std::max(maxY, top + glyph.bounds.size.y);
+        first = false;
+        x += glyph.advance;
+    }
+
+    sf::Vector2f offset = widget.rect.position;
+    if (widget.align == UiAlign::Center)
+    {
+        // Whole pixels keep the glyphs sharp
+        sf::Vector2f center = widget.rect.position + widget.rect.size / 2.0f;
+        offset = {std::round(center.x - (minX + maxX) / 2.0f), std::round(center.y - (minY + maxY) / 2.0f)};
+    }
+    for (auto& vertex : widget.textQuads)
+    {
+        vertex.position += offset;
+    }
+}
+
+void UiScreen::rebuild()
+{
+    // Storage is kept, so rebuilding a screen of the same size never allocates
+    panels.clear();
+    for (auto& [size, batch] : texts)
+    {
+        batch.clear();
+    }
+
+    for (auto& widget : widgets)
+    {
+        if (!widget.visible)
+            continue;
+        if (widget.dirty)
+            tessellate(widget);
+
+        for (const auto& vertex : widget.quads)
+        {
+            panels.append(vertex);
+        }
+        if (widget.textQuads.empty())
+            continue;
+
+        auto batch = texts.find(widget.characterSize);
+        if (batch == texts.end())
+            batch = texts.emplace(widget.characterSize, sf::VertexArray(sf::PrimitiveType::Triangles)).first;
+        for (const auto& vertex : widget.textQuads)
+        {
+            batch->second.append(vertex);
+        }
+    }
+    dirty = false;
+}
+
+void UiScreen::draw(sf::RenderTarget& target)
+{
+    if (dirty)
+        rebuild();
+
+    if (panels.getVertexCount() > 0)
+        target.draw(panels);
+
+    // Every character size has its own glyph texture
+    for (const auto& [size, batch] : texts)
+    {
+        if (batch.getVertexCount() == 0)
+            continue;
+        sf::RenderStates states(&font.getTexture(size));
+        target.draw(batch, states);
+    }
+}
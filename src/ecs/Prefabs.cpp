@@ -0,0 +1,66 @@
+#include "ecs/Prefabs.hpp"
+
+Entity createPlatformEntity(Registry& registry, const std::shared_ptr<Platform>& platform)
+{
+    Entity entity = registry.create();
+    
+    registry.add<TransformComponent>(entity, {platform->getPosition()});
+    
+    SpriteComponent sprite;
+    sprite.texture = &platform->getTexture();
+    sprite.textureRect = platform->getTextureRect();
+    sprite.size = platform->getBounds().size;
+    sprite.layer = PLATFORM_LAYER;
+    registry.add<SpriteComponent>(entity, sprite);
+    
+    registry.add<PlatformComponent>(entity, {platform->getType(), platform});
+    
+    return entity;
+}
+
+Entity createPickupEntity(Registry& registry, PickupType type, const sf::Texture& texture, const sf::Vector2f& position)
+{
+    Entity entity = registry.create();
+    
+    AnimationComponent animation;
+    PickupComponent pickup;
+    pickup.type = type;
+    
+    switch (type)
+    {
+        case PickupType::Coin:
+            // Coin loops and disappears when collected
+            animation.frameSize = {32, 32};
+            animation.frameCount = 12;
+            pickup.remainVisible = false;
+            break;
+        case PickupType::Checkpoint:
+            // Checkpoint waits on its first frame, plays once when reached and holds
+            animation.frameSize = {32, 32};
+            animation.frameCount = 6;
+            animation.loop = false;
+            animation.playing = false;
+            pickup.remainVisible = true;
+            break;
+        case PickupType::Win:
+            animation.frameSize = {16, 16};
+            animation.frameCount = 6;
+            pickup.remainVisible = true;
+            break;
+    }
+    animation.fps = 10.0f;
+    
+    SpriteComponent sprite;
+    sprite.texture = &texture;
+    sprite.textureRect = sf::IntRect(animation.frameOrigin, animation.frameSize);
+    sprite.size = static_cast<sf::Vector2f>(animation.frameSize);
+    sprite.layer = PICKUP_LAYER;
+    
+    registry.add<TransformComponent>(entity, {position});
+    registry.add<AabbComponent>(entity, {{0, 0}, sprite.size});
+    registry.add<SpriteComponent>(entity, sprite);
+    registry.add<AnimationComponent>(entity, animation);
+    registry.add<PickupComponent>(entity, pickup);
+    
+    return entity;
+}
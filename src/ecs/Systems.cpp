@@ -0,0 +1,158 @@
+#include "ecs/Systems.hpp"
+#include "core/Physics.hpp"
+#include <algorithm>
+
+void MovementSystem::update(Registry& registry, Physics& physics, const sf::Time& elapsed)
+{
+    const float dt = elapsed.asSeconds();
+    
+    registry.each<VelocityComponent, TransformComponent, AabbComponent>(
+        [&](Entity, VelocityComponent& velocity, TransformComponent& transform, AabbComponent& aabb)
+        {
+            if (velocity.gravity)
+                physics.applyGravity(velocity.value, elapsed);
+            
+            transform.position += velocity.value * dt;
+            
+            sf::Vector2f correction;
+            bool hitDeadlyPlatform = false;
+            velocity.onGround = physics.resolveCollisions(aabb.getBounds(transform), velocity.value, correction, hitDeadlyPlatform);
+            transform.position += correction;
+            
+            physics.applyFriction(velocity.value, velocity.onGround);
+        });
+}
+
+void PlatformSystem::update(Registry& registry)
+{
+    registry.each<PlatformComponent, TransformComponent, SpriteComponent>(
+        [](Entity, PlatformComponent& platform, TransformComponent& transform, SpriteComponent& sprite)
+        {
+            if (!platform.platform || !platform.platform->isKinematic())
+                return;
+            
+            transform.position = platform.platform->getPosition();
+            sprite.visible = platform.platform->isSolid();
+        });
+}
+
+void PickupSystem::collect(Registry& registry, const sf::FloatRect& bounds, std::vector<PickupEvent>& events)
+{
+    ComponentPool<SpriteComponent>& sprites = registry.pool<SpriteComponent>();
+    ComponentPool<AnimationComponent>& animations = registry.pool<AnimationComponent>();
+    
+    registry.each<PickupComponent, TransformComponent, AabbComponent>(
+        [&](Entity entity, PickupComponent& pickup, TransformComponent& transform, AabbComponent& aabb)
+        {
+            if (pickup.collected || !bounds.findIntersection(aabb.getBounds(transform)))
+                return;
+            
+            pickup.collected = true;
+            
+            if (SpriteComponent* sprite = sprites.tryGet(entity))
+                sprite->visible = pickup.remainVisible;
+            
+            if (AnimationComponent* animation = animations.tryGet(entity))
+                animation->playing = true;
+            
+            sf::FloatRect box = aabb.getBounds(transform);
+            events.push_back({entity, pickup.type, transform.position, box.position + box.size / 2.0f});
+        });
+}
+
+void AnimationSystem::update(Registry& registry, const sf::Time& elapsed)
+{
+    const float dt = elapsed.asSeconds();
+    
+    registry.each<AnimationComponent, SpriteComponent>(
+        [dt](Entity, AnimationComponent& animation, SpriteComponent& sprite)
+        {
+            if (!animation.playing)
+                return;
+            
+            animation.timer += dt;
+            
+            if (animation.timer >= 1.0f / animation.fps)
+            {
+                if (animation.frame + 1 < animation.frameCount)
+                    animation.frame++;
+                else if (animation.loop)
+                    animation.frame = 0;
+                
+                animation.timer = 0;
+            }
+            
+            sprite.textureRect = sf::IntRect(
+                {animation.frameOrigin.x + animation.frame * animation.frameSize.x, animation.frameOrigin.y},
+                animation.frameSize);
+        });
+}
+
+RenderSystem::Batch& RenderSystem::findBatch(const sf::Texture* texture, std::uint8_t layer)
+{
+    for (auto& batch : batches)
+    {
+        if (batch.texture == texture && batch.layer == layer)
+            return batch;
+    }
+    
+    batches.push_back({texture, layer, sf::VertexArray(sf::PrimitiveType::Triangles)});
+    return batches.back();
+}
+
+void RenderSystem::build(Registry& registry)
+{
+    // Keep the arrays around between frames so their storage is reused
+    for (auto& batch : batches)
+    {
+        batch.vertices.clear();
+    }
+    
+    registry.each<SpriteComponent, TransformComponent>(
+        [this](Entity, SpriteComponent& sprite, TransformComponent& transform)
+        {
+            if (!sprite.visible || !sprite.texture)
+                return;
+            
+            sf::VertexArray& vertices = findBatch(sprite.texture, sprite.layer).vertices;
+            
+            const sf::Vector2f p = transform.position;
+            const sf::Vector2f s = sprite.size;
+            const sf::Vector2f t(static_cast<float>(sprite.textureRect.position.x), static_cast<float>(sprite.textureRect.position.y));
+            const sf::Vector2f ts(static_cast<float>(sprite.textureRect.size.x), static_cast<float>(sprite.textureRect.size.y));
+            
+            const sf::Vertex topLeft{p, sprite.color, t};
+            const sf::Vertex topRight{{p.x + s.x, p.y}, sprite.color, {t.x + ts.x, t.y}};
+            const sf::Vertex bottomRight{p + s, sprite.color, t + ts};
+            const sf::Vertex bottomLeft{{p.x, p.y + s.y}, sprite.color, {t.x, t.y + ts.y}};
+            
+            vertices.append(topLeft);
+            vertices.append(topRight);
+            vertices.append(bottomRight);
+            vertices.append(topLeft);
+            vertices.append(bottomRight);
+            vertices.append(bottomLeft);
+        });
+    
+    std::stable_sort(batches.begin(), batches.end(), [](const Batch& a, const Batch& b)
+    {
+        return a.layer < b.layer;
+    });
+}
+
+void RenderSystem::draw(sf::RenderTarget& target) const
+{
+    for (const auto& batch : batches)
+    {
+        if (batch.vertices.getVertexCount() == 0)
+            continue;
+        
+        sf::RenderStates states(batch.texture);
+        target.draw(batch.vertices, states);
+    }
+}
+
+std::size_t RenderSystem::getBatchCount() const
+{
+    return batches.size();
+}
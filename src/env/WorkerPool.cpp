@@ -0,0 +1,81 @@
+#include "env/WorkerPool.hpp"
+#include <algorithm>
+
+WorkerPool::WorkerPool(unsigned threadCount)
+    : generation(0), pending(0), stopping(false), task(nullptr), context(nullptr), count(0)
+{
+    if (threadCount == 0)
+        threadCount = std::max(1u, std::thread::hardware_concurrency());
+
+    threads.reserve(threadCount - 1);
+    for (unsigned i = 1; i < threadCount; ++i)
+    {
+        threads.emplace_back(&WorkerPool::workerLoop, this, static_cast<std::size_t>(i));
+    }
+}
+
+WorkerPool::~WorkerPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    workReady.notify_all();
+
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+}
+
+void WorkerPool::dispatch(std::size_t count_, Task task_, void* context_)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        task = task_;
+        context = context_;
+        count = count_;
+        pending = threads.size();
+        generation++;
+    }
+    if (!threads.empty())
+        workReady.notify_all();
+
+    runSlice(0);
+
+    std::unique_lock<std::mutex> lock(mutex);
+    workDone.wait(lock, [this] { return pending == 0; });
+}
+
+void WorkerPool::runSlice(std::size_t slice) const
+{
+    // Set before the workers were woken and left alone until they are done
+    std::size_t slices = threads.size() + 1;
+    std::size_t begin = count * slice / slices;
+    std::size_t end = count * (slice + 1) / slices;
+    if (begin < end)
+        task(context, begin, end);
+}
+
+void WorkerPool::workerLoop(std::size_t slice)
+{
+    std::uint64_t seen = 0;
+    while (true)
+    {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            workReady.wait(lock, [&] { return stopping || generation != seen; });
+            if (stopping)
+                return;
+            seen = generation;
+        }
+
+        runSlice(slice);
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            pending--;
+        }
+        workDone.notify_one();
+    }
+}
@@ -0,0 +1,146 @@
+#include "env/WorldBatch.hpp"
+#include "core/LevelBuilder.hpp"
+#include "env/hookleap_env.h"
+
+// The C buttons are InputState's action bits
+static_assert(HOOKLEAP_BUTTON_LEFT == InputState::bit(Action::MoveLeft), "button bits must match Action");
+static_assert(HOOKLEAP_BUTTON_RIGHT == InputState::bit(Action::MoveRight), "button bits must match Action");
+static_assert(HOOKLEAP_BUTTON_JUMP == InputState::bit(Action::Jump), "button bits must match Action");
+static_assert(HOOKLEAP_BUTTON_HOOK == InputState::bit(Action::Hook), "button bits must match Action");
+static_assert(HOOKLEAP_BUTTON_RELEASE == InputState::bit(Action::ReleaseHook), "button bits must match Action");
+
+namespace
+{
+    constexpr std::uint16_t BUTTON_MASK = HOOKLEAP_BUTTON_LEFT | HOOKLEAP_BUTTON_RIGHT | HOOKLEAP_BUTTON_JUMP |
+                                          HOOKLEAP_BUTTON_HOOK | HOOKLEAP_BUTTON_RELEASE;
+
+    sf::Vector2f hitboxCenter(const Player& player)
+    {
+        sf::FloatRect hitbox = player.getGlobalHitbox();
+        return hitbox.position + hitbox.size / 2.0f;
+    }
+}
+
+WorldBatch::WorldBatch(const MapData& map, std::size_t worldCount, unsigned threadCount, float tickTime)
+    : start(emptyTexture), tickTime(tickTime), workers(threadCount)
+{
+    // Built like the race server's level, without art
+    LevelBuilder builder({&emptyTexture, &emptyTexture, &emptyTexture, &emptyTexture, &emptyTexture, &emptyTexture});
+    std::vector<Entity> entities;
+    builder.build(start, map, entities);
+    start.restart({LevelBuilder::SPAWN_X, LevelBuilder::SPAWN_Y});
+
+    worlds.assign(worldCount, start);
+    worldEvents.resize(worldCount);
+    previousButtons.assign(worldCount, 0);
+}
+
+void WorldBatch::reset(const std::uint8_t* mask)
+{
+    auto job = [&](std::size_t begin, std::size_t end)
+    {
+        for (std::size_t world = begin; world < end; ++world)
+        {
+            if (mask && !mask[world])
+                continue;
+            worlds[world] = start;
+            previousButtons[world] = 0;
+        }
+    };
+    workers.run(worlds.size(), job);
+}
+
+void WorldBatch::step(const std::uint16_t* buttons, const float* aim, std::uint8_t* events)
+{
+    auto job = [&](std::size_t begin, std::size_t end)
+    {
+        for (std::size_t world = begin; world < end; ++world)
+        {
+            stepWorld(world, buttons, aim, events);
+        }
+    };
+    workers.run(worlds.size(), job);
+}
+
+void WorldBatch::observe(float* observations)
+{
+    auto job = [&](std::size_t begin, std::size_t end)
+    {
+        for (std::size_t world = begin; world < end; ++world)
+        {
+            observeWorld(world, observations);
+        }
+    };
+    workers.run(worlds.size(), job);
+}
+
+void WorldBatch::stepWorld(std::size_t world, const std::uint16_t* buttons, const float* aim, std::uint8_t* events)
+{
+    Simulation& simulation = worlds[world];
+
+    InputState input;
+    input.held = static_cast<std::uint16_t>(buttons[world] & BUTTON_MASK);
+    input.pressed = static_cast<std::uint16_t>(input.held & ~previousButtons[world]);
+    input.released = static_cast<std::uint16_t>(previousButtons[world] & ~input.held);
+    previousButtons[world] = input.held;
+    if (aim)
+        input.aim = {aim[world], aim[worlds.size() + world]};
+    else
+        input.aim = hitboxCenter(simulation.getPlayer()) - sf::Vector2f(0, 1);
+
+    SimulationEvents& happened = worldEvents[world];
+    simulation.step(input, sf::seconds(tickTime), happened);
+    if (!events)
+        return;
+
+    std::uint8_t mask = 0;
+    if (happened.won)
+        mask |= HOOKLEAP_EVENT_WON;
+    if (happened.died)
+        mask |= HOOKLEAP_EVENT_DIED;
+    for (const auto& effect : happened.effects)
+    {
+        switch (effect.type)
+        {
+            case EffectType::CoinCollected:
+                mask |= HOOKLEAP_EVENT_COIN;
+                break;
+            case EffectType::CheckpointReached:
+                mask |= HOOKLEAP_EVENT_CHECKPOINT;
+                break;
+            case EffectType::HookAttached:
+                mask |= HOOKLEAP_EVENT_HOOK_ATTACHED;
+                break;
+            default:
+                break;
+        }
+    }
+    events[world] = mask;
+}
+
+void WorldBatch::observeWorld(std::size_t world, float* observations) const
+{
+    const Simulation& simulation = worlds[world];
+    const Player& player = simulation.getPlayer();
+    const Hook& hook = player.getHook();
+    sf::Vector2f center = hitboxCenter(player);
+    sf::Vector2f velocity = player.getVelocity();
+    sf::Vector2f hookPoint = hook.isAttached() ? hook.getAttachPoint() : hook.getHookPosition();
+    sf::Vector2f checkpoint = simulation.getLastCheckpoint();
+
+    std::size_t stride = worlds.size();
+    auto write = [&](int field, float value) { observations[static_cast<std::size_t>(field) * stride + world] = value; };
+    write(HOOKLEAP_OBS_X, center.x);
+    write(HOOKLEAP_OBS_Y, center.y);
+    write(HOOKLEAP_OBS_VELOCITY_X, velocity.x);
+    write(HOOKLEAP_OBS_VELOCITY_Y, velocity.y);
+    write(HOOKLEAP_OBS_ON_GROUND, player.isOnGround() ? 1.0f : 0.0f);
+    write(HOOKLEAP_OBS_HOOK_STATE, static_cast<float>(hook.getState()));
+    write(HOOKLEAP_OBS_HOOK_X, hookPoint.x);
+    write(HOOKLEAP_OBS_HOOK_Y, hookPoint.y);
+    write(HOOKLEAP_OBS_SCORE, static_cast<float>(simulation.getScore()));
+    write(HOOKLEAP_OBS_DEATHS, static_cast<float>(simulation.getDeaths()));
+    write(HOOKLEAP_OBS_TIME, simulation.getTime());
+    write(HOOKLEAP_OBS_CHECKPOINT_X, checkpoint.x);
+    write(HOOKLEAP_OBS_CHECKPOINT_Y, checkpoint.y);
+}
@@ -0,0 +1,88 @@
+#include "env/hookleap_env.h"
+#include <exception>
+#include <memory>
+#include <string>
+#include "core/MapParser.hpp"
+#include "env/WorldBatch.hpp"
+#include "net/Protocol.hpp"
+
+struct HookLeapEnv
+{
+    std::unique_ptr<WorldBatch> batch;
+};
+
+namespace
+{
+    thread_local std::string lastError;
+}
+
+HookLeapEnv* hookleap_env_create(const char* map_path, uint32_t world_count, uint32_t thread_count)
+{
+    if (!map_path || world_count == 0)
+    {
+        lastError = "A map path and at least one world are needed";
+        return nullptr;
+    }
+
+    MapData map;
+    MapParser parser;
+    if (!parser.loadFile(map_path, map))
+    {
+        lastError = std::string("Could not load map: ") + map_path;
+        // Line 0 is the file itself, already named
+        if (!parser.getErrors().empty() && parser.getErrors().front().line > 0)
+        {
+            const auto& error = parser.getErrors().front();
+            lastError += " (line " + std::to_string(error.line) + ": " + error.message + ")";
+        }
+        return nullptr;
+    }
+
+    // Nothing may throw across the C boundary
+    try
+    {
+        auto env = std::make_unique<HookLeapEnv>();
+        env->batch = std::make_unique<WorldBatch>(map, world_count, thread_count, tickTime().asSeconds());
+        return env.release();
+    }
+    catch (const std::exception& error)
+    {
+        lastError = error.what();
+        return nullptr;
+    }
+}
+
+void hookleap_env_destroy(HookLeapEnv* env)
+{
+    delete env;
+}
+
+uint32_t hookleap_env_world_count(const HookLeapEnv* env)
+{
+    return static_cast<uint32_t>(env->batch->getWorldCount());
+}
+
+float hookleap_env_tick_time(const HookLeapEnv* env)
+{
+    return env->batch->getTickTime();
+}
+
+void hookleap_env_reset(HookLeapEnv* env, const uint8_t* mask)
+{
+    env->batch->reset(mask);
+}
+
+void hookleap_env_step(HookLeapEnv* env, const uint16_t* buttons, const float* aim, uint8_t* events)
+{
+    env->batch->step(buttons, aim, events);
+}
+
+void hookleap_env_observe(const HookLeapEnv* env, float* observations)
+{
+    env->batch->observe(observations);
+}
+
+const char* hookleap_env_last_error(void)
+{
+    return lastError.c_str();
+}
@@ -1,9 +1,10 @@
 #include "game/Hook.hpp"
 #include <cmath>
+#include "core/DeterministicMath.hpp"
 
 Hook::Hook()
     : state(HookState::Inactive), hookPosition(0, 0), attachPoint(0, 0),
-      shootDirection(0, 0), ropeLength(0), attachTime(0)
+      shootDirection(0, 0), ropeLength(0), attachTime(0), attachOffset(0, 0)
 {
 }
 
@@ -12,7 +13,7 @@ void Hook::shoot(const sf::Vector2f& startPos, const sf::Vector2f& direction)
     state = HookState::Shooting;
     hookPosition = startPos;
     
-    float length = std::sqrt(direction.x * direction.x + direction.y * direction.y);
+    float length = detSqrt(direction.x * direction.x + direction.y * direction.y);
     if (length > 0)
     {
         shootDirection = sf::Vector2f(direction.x / length, direction.y / length);
@@ -29,10 +30,8 @@ void Hook::update(const sf::Time& elapsed, const sf::Vector2f& playerPos)
     {
         hookPosition += shootDirection * HOOK_SPEED * elapsed.asSeconds();
         
-        float distance = std::sqrt(
-            std::pow(hookPosition.x - playerPos.x, 2) +
-            std::pow(hookPosition.y - playerPos.y, 2)
-        );
+        sf::Vector2f offset = hookPosition - playerPos;
+        float distance = detSqrt(offset.x * offset.x + offset.y * offset.y);
         
         if (distance > MAX_HOOK_RANGE)
         {
@@ -43,6 +42,16 @@ void Hook::update(const sf::Time& elapsed, const sf::Vector2f& playerPos)
     {
         attachTime += elapsed.asSeconds();
         
+        if (auto platform = attachedPlatform.lock())
+        {
+            if (!platform->isSolid())
+            {
+                release();
+                return;
+            }
+            attachPoint = platform->getPosition() + attachOffset;
+        }
+        
         if (attachTime >= HOOK_DURATION)
         {
             release();
@@ -50,18 +59,18 @@ void Hook::update(const sf::Time& elapsed, const sf::Vector2f& playerPos)
     }
 }
 
-bool Hook::checkPlatformCollision(std::shared_ptr<Platform> platform, const sf::Vector2f& playerPos)
+bool Hook::checkPlatformCollision(Platform& platform, const sf::Vector2f& playerPos)
 {
     if (state != HookState::Shooting)
         return false;
     
-    if (platform->getType() != PlatformType::Floating)
+    if (platform.getType() != PlatformType::Floating)
         return false;
     
-    if (platform->getBounds().position.y >= playerPos.y)
+    if (platform.getBounds().position.y >= playerPos.y)
         return false;
     
-    sf::FloatRect platformBounds = platform->getBounds();
+    sf::FloatRect platformBounds = platform.getBounds();
     
     if (hookPosition.x >= platformBounds.position.x &&
         hookPosition.x <= platformBounds.position.x + platformBounds.size.x &&
@@ -72,6 +81,12 @@ bool Hook::checkPlatformCollision(std::shared_ptr<Platform> platform, const sf::
             hookPosition.x,
             platformBounds.position.y + platformBounds.size.y
         ));
+        
+        if (platform.isKinematic())
+        {
+            attachedPlatform = platform.weak_from_this();
+            attachOffset = attachPoint - platform.getPosition();
+        }
         return true;
     }
     
@@ -83,6 +98,7 @@ void Hook::attach(const sf::Vector2f& point)
     state = HookState::Attached;
     attachPoint = point;
     attachTime = 0;
+    attachedPlatform.reset();
 }
 
 void Hook::release()
@@ -90,6 +106,7 @@ void Hook::release()
     state = HookState::Inactive;
     ropeLength = 0;
     attachTime = 0;
+    attachedPlatform.reset();
 }
 
 bool Hook::shouldBreak(const sf::Vector2f& playerPos) const
@@ -98,13 +115,13 @@ bool Hook::shouldBreak(const sf::Vector2f& playerPos) const
         return false;
     
     sf::Vector2f ropeVec = playerPos - attachPoint;
-    float angle = std::atan2(ropeVec.x, ropeVec.y) * 180.0f / 3.14159f;
+    float angle = detAtan2(ropeVec.x, ropeVec.y) * 180.0f / 3.14159f;
     angle = std::abs(angle);
     
     if (angle > MAX_ROPE_ANGLE)
         return true;
     
-    float currentLength = std::sqrt(ropeVec.x * ropeVec.x + ropeVec.y * ropeVec.y);
+    float currentLength = detSqrt(ropeVec.x * ropeVec.x + ropeVec.y * ropeVec.y);
     
     if (currentLength > MAX_ROPE_LENGTH * 1.2f)
         return true;
@@ -112,20 +129,20 @@ bool Hook::shouldBreak(const sf::Vector2f& playerPos) const
     return false;
 }
 
-void Hook::draw(sf::RenderWindow& window) const
+void Hook::draw(sf::RenderTarget& target) const
 {
     if (state == HookState::Shooting)
     {
         sf::CircleShape hookCircle(5);
         hookCircle.setPosition({hookPosition.x - 5, hookPosition.y - 5});
         hookCircle.setFillColor(sf::Color(150, 150, 150));
-        window.draw(hookCircle);
+        target.draw(hookCircle);
     }
     else if (state == HookState::Attached)
     {
         sf::CircleShape attachCircle(3);
         attachCircle.setPosition({attachPoint.x - 3, attachPoint.y - 3});
         attachCircle.setFillColor(sf::Color::Red);
-        window.draw(attachCircle);
+        target.draw(attachCircle);
     }
 }
@@ -1,7 +1,13 @@
 #include "game/Platform.hpp"
+#include <cmath>
+#include "core/DeterministicMath.hpp"
 
 Platform::Platform(const sf::Texture& texture, PlatformType type)
-    : sf::Sprite(texture), platformType(type), size(0, 0)
+    : sf::Sprite(texture), platformType(type), size(0, 0),
+      motion(PlatformMotion::Static), origin(0, 0), motionDelta(0, 0), solid(true),
+      targetWaypoint(0), pathDirection(1), speed(0),
+      amplitude(0, 0), period(1.0f), phase(0), motionTime(0),
+      crumbleDelay(0), respawnTime(0), crumbleTimer(0), touched(false)
 {
 }
 
@@ -42,3 +48,126 @@ bool Platform::isDeadly() const
 {
     return platformType == PlatformType::DeathPit;
 }
+
+void Platform::setLinearPath(const std::vector<sf::Vector2f>& waypoints_, float speed_)
+{
+    motion = PlatformMotion::Linear;
+    origin = getPosition();
+    waypoints.clear();
+    waypoints.push_back(origin);
+    waypoints.insert(waypoints.end(), waypoints_.begin(), waypoints_.end());
+    targetWaypoint = waypoints.size() > 1 ? 1 : 0;
+    pathDirection = 1;
+    speed = speed_;
+}
+
+void Platform::setOscillation(const sf::Vector2f& amplitude_, float period_, float phase_)
+{
+    motion = PlatformMotion::Oscillating;
+    origin = getPosition();
+    amplitude = amplitude_;
+    period = period_ > 0 ? period_ : 1.0f;
+    phase = phase_;
+    motionTime = 0;
+}
+
+void Platform::setCrumbling(float delay, float respawnTime_)
+{
+    motion = PlatformMotion::Crumbling;
+    origin = getPosition();
+    crumbleDelay = delay;
+    respawnTime = respawnTime_;
+    crumbleTimer = 0;
+    touched = false;
+    solid = true;
+}
+
+void Platform::touch()
+{
+    if (motion == PlatformMotion::Crumbling && solid && !touched)
+    {
+        touched = true;
+        crumbleTimer = 0;
+    }
+}
+
+bool Platform::updateMotion(float dt)
+{
+    motionDelta = sf::Vector2f(0, 0);
+    
+    switch (motion)
+    {
+        case PlatformMotion::Static:
+            return false;
+        
+        case PlatformMotion::Linear:
+        {
+            if (waypoints.size() < 2 || speed <= 0)
+                return false;
+            
+            sf::Vector2f position = getPosition();
+            float remaining = speed * dt;
+            
+            // Carry leftover distance past a waypoint so the speed stays even,
+            // bounded in case the path has zero-length legs
+            for (std::size_t legs = 0; remaining > 0 && legs < 2 * waypoints.size(); ++legs)
+            {
+                sf::Vector2f toTarget = waypoints[targetWaypoint] - position;
+                float distance = detSqrt(toTarget.x * toTarget.x + toTarget.y * toTarget.y);
+                
+                if (distance > remaining)
+                {
+                    position += toTarget / distance * remaining;
+                    break;
+                }
+                
+                position = waypoints[targetWaypoint];
+                remaining -= distance;
+                
+                // Ping-pong at the ends of the path
+                if (targetWaypoint + 1 == waypoints.size())
+                    pathDirection = -1;
+                else if (targetWaypoint == 0)
+                    pathDirection = 1;
+                targetWaypoint = static_cast<std::size_t>(static_cast<int>(targetWaypoint) + pathDirection);
+            }
+            
+            motionDelta = position - getPosition();
+            setPosition(position);
+            return true;
+        }
+        
+        case PlatformMotion::Oscillating:
+        {
+            motionTime = std::fmod(motionTime + dt, period);
+            float wave = detSin(2.0f * 3.14159265f * motionTime / period + phase);
+            sf::Vector2f position = origin + amplitude * wave;
+            
+            motionDelta = position - getPosition();
+            setPosition(position);
+            return true;
+        }
+        
+        case PlatformMotion::Crumbling:
+        {
+            if (!touched)
+                return false;
+            
+            crumbleTimer += dt;
+            if (solid && crumbleTimer >= crumbleDelay)
+            {
+                solid = false;
+                crumbleTimer = 0;
+            }
+            else if (!solid && crumbleTimer >= respawnTime)
+            {
+                solid = true;
+                touched = false;
+                crumbleTimer = 0;
+            }
+            return false;
+        }
+    }
+    
+    return false;
+}
@@ -1,12 +1,12 @@
 #include "game/Player.hpp"
-#include <SFML/Window/Keyboard.hpp>
-#include <SFML/Window/Mouse.hpp>
+#include "core/Physics.hpp"
 #include <cmath>
 
 Player::Player(const sf::Texture& texture)
     : Character(texture, 100.0f), score(0), onGround(false), wasOnGround(false),
-      currentState(PlayerState::Idle), currentDirection(Direction::Right)
+      swingInput(0), currentState(PlayerState::Idle), currentDirection(Direction::Right)
 {
+    rope.setMaxSpeed(MAX_SWING_SPEED);
 }
 
 void Player::setAnimationRow(PlayerState state, int row, int frameCount, bool shouldLoop)
@@ -85,7 +85,7 @@ void Player::shootHook(const sf::Vector2f& mousePos)
     if (hook.isAttached())
         return;
     
-    sf::Vector2f playerCenter = getPosition() + sf::Vector2f(64, 64);
+    sf::Vector2f playerCenter = getPosition() + sf::Vector2f(CENTER_OFFSET, CENTER_OFFSET);
     sf::Vector2f direction = mousePos - playerCenter;
     
     hook.shoot(playerCenter, direction);
@@ -94,87 +94,66 @@ void Player::shootHook(const sf::Vector2f& mousePos)
 void Player::releaseHook()
 {
     hook.release();
+    rope.release();
 }
 
-void Player::updateHook(const sf::Time& elapsed, const std::vector<std::shared_ptr<Platform>>& platforms)
+void Player::updateHook(const sf::Time& elapsed, const Physics& physics)
 {
-    sf::Vector2f playerCenter = getPosition() + sf::Vector2f(64, 64);
+    sf::Vector2f playerCenter = getPosition() + sf::Vector2f(CENTER_OFFSET, CENTER_OFFSET);
     
     hook.update(elapsed, playerCenter);
     
     if (hook.getState() == HookState::Shooting)
     {
-        for (const auto& platform : platforms)
+        nearbyPlatforms.clear();
+        physics.queryPlatforms(sf::FloatRect(hook.getHookPosition(), {0, 0}), nearbyPlatforms);
+        
+        for (Platform* platform : nearbyPlatforms)
         {
-            if (hook.checkPlatformCollision(platform, playerCenter))
+            if (hook.checkPlatformCollision(*platform, playerCenter))
             {
                 break;
             }
         }
     }
     
-    if (hook.isAttached())
+    if (hook.isAttached() && !rope.isActive())
+    {
+        rope.attach(hook.getAttachPoint(), playerCenter, getVelocity(), Hook::MAX_ROPE_LENGTH);
+    }
+    else if (hook.isAttached())
+    {
+        rope.setAnchor(hook.getAttachPoint());
+    }
+    
+    // Once wrapped around a corner the angle to the anchor no longer matters,
+    // the rope itself keeps the length bounded
+    if (hook.isAttached() && rope.getWrapCount() == 0)
     {
         if (hook.shouldBreak(playerCenter))
         {
             hook.release();
         }
     }
+    
+    if (!hook.isAttached() && rope.isActive())
+    {
+        rope.release();
+    }
 }
 
-void Player::applySwingPhysics(const sf::Time& elapsed)
+void Player::applySwingPhysics(const sf::Time& elapsed, const Physics& physics)
 {
-    if (!hook.isAttached())
-        return;
-    
-    sf::Vector2f playerCenter = getPosition() + sf::Vector2f(64, 64);
-    sf::Vector2f attachPoint = hook.getAttachPoint();
-    
-    sf::Vector2f ropeVec = playerCenter - attachPoint;
-    float ropeLength = std::sqrt(ropeVec.x * ropeVec.x + ropeVec.y * ropeVec.y);
-    
-    if (ropeLength < 0.1f)
+    if (!hook.isAttached() || !rope.isActive())
         return;
     
-    sf::Vector2f ropeDir = ropeVec / ropeLength;
-    sf::Vector2f tangent(-ropeDir.y, ropeDir.x);
-    
-    float swingInput = 0;
-    if (sf::Keyboard::isKeyPressed(sf::Keyboard::Key::A) || 
-        sf::Keyboard::isKeyPressed(sf::Keyboard::Key::Left))
-    {
-        swingInput = -1.0f;
-    }
-    else if (sf::Keyboard::isKeyPressed(sf::Keyboard::Key::D) || 
-             sf::Keyboard::isKeyPressed(sf::Keyboard::Key::Right))
-    {
-        swingInput = 1.0f;
-    }
-    
+    sf::Vector2f playerCenter = getPosition() + sf::Vector2f(CENTER_OFFSET, CENTER_OFFSET);
     sf::Vector2f vel = getVelocity();
-    vel += tangent * swingInput * SWING_ACCELERATION * elapsed.asSeconds();
-    vel.y += 980.0f * elapsed.asSeconds();
     
-    float radialVel = vel.x * ropeDir.x + vel.y * ropeDir.y;
-    vel -= ropeDir * radialVel;
-    
-    float speed = std::sqrt(vel.x * vel.x + vel.y * vel.y);
-    if (speed > MAX_SWING_SPEED)
-    {
-        vel = vel / speed * MAX_SWING_SPEED;
-    }
+    rope.update(elapsed, playerCenter, vel, swingInput * SWING_ACCELERATION, physics);
     
     setVelocity(vel);
-    
-    playerCenter = getPosition() + sf::Vector2f(64, 64);
-    ropeVec = playerCenter - attachPoint;
-    float currentLength = std::sqrt(ropeVec.x * ropeVec.x + ropeVec.y * ropeVec.y);
-    
-    if (currentLength > Hook::MAX_ROPE_LENGTH)
-    {
-        sf::Vector2f constrainedPos = attachPoint + (ropeVec / currentLength) * Hook::MAX_ROPE_LENGTH;
-        setPosition(constrainedPos - sf::Vector2f(64, 64));
-    }
+    setPosition(playerCenter - sf::Vector2f(CENTER_OFFSET, CENTER_OFFSET));
 }
 
 void Player::updateState()
@@ -279,24 +258,21 @@ void Player::animate(const sf::Time &elapsed)
     }
 }
 
-void Player::handleInput(const sf::RenderWindow& window)
+void Player::handleInput(const InputState& input)
 {
-    if (sf::Mouse::isButtonPressed(sf::Mouse::Button::Left))
+    swingInput = 0;
+    
+    if (input.isHeld(Action::Hook))
     {
         if (!hook.isAttached() && hook.getState() == HookState::Inactive)
         {
-            sf::Vector2i mousePixelPos = sf::Mouse::getPosition(window);
-            sf::Vector2f mouseWorldPos = window.mapPixelToCoords(mousePixelPos);
-            shootHook(mouseWorldPos);
+            shootHook(input.aim);
         }
     }
     
     if (hook.isAttached())
     {
-        if (sf::Keyboard::isKeyPressed(sf::Keyboard::Key::W) ||
-            sf::Keyboard::isKeyPressed(sf::Keyboard::Key::Space) ||
-            sf::Keyboard::isKeyPressed(sf::Keyboard::Key::Up) ||
-            sf::Mouse::isButtonPressed(sf::Mouse::Button::Right))
+        if (input.isHeld(Action::Jump) || input.isHeld(Action::ReleaseHook))
         {
             releaseHook();
         }
@@ -304,23 +280,20 @@ void Player::handleInput(const sf::RenderWindow& window)
     
     sf::Vector2f vel = getVelocity();
     
-    if (sf::Keyboard::isKeyPressed(sf::Keyboard::Key::A) || 
-        sf::Keyboard::isKeyPressed(sf::Keyboard::Key::Left))
+    if (input.isHeld(Action::MoveLeft))
     {
         if (!hook.isAttached())
             vel.x = -MOVE_SPEED;
+        swingInput = -1.0f;
     }
-    else if (sf::Keyboard::isKeyPressed(sf::Keyboard::Key::D) || 
-             sf::Keyboard::isKeyPressed(sf::Keyboard::Key::Right))
+    else if (input.isHeld(Action::MoveRight))
     {
         if (!hook.isAttached())
             vel.x = MOVE_SPEED;
+        swingInput = 1.0f;
     }
     
-    if (onGround && !hook.isAttached() &&
-        (sf::Keyboard::isKeyPressed(sf::Keyboard::Key::W) || 
-         sf::Keyboard::isKeyPressed(sf::Keyboard::Key::Space) ||
-         sf::Keyboard::isKeyPressed(sf::Keyboard::Key::Up)))
+    if (onGround && !hook.isAttached() && input.isHeld(Action::Jump))
     {
         vel.y = JUMP_FORCE;
         onGround = false;
@@ -386,6 +359,8 @@ void Player::reset()
     
     // Reset hook
     hook.release();
+    rope.release();
+    swingInput = 0;
     
     // Reset facing direction
     currentDirection = Direction::Right;
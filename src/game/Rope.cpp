@@ -0,0 +1,355 @@
+#include "game/Rope.hpp"
+#include "core/Physics.hpp"
+#include <algorithm>
+#include <cmath>
+#include "core/DeterministicMath.hpp"
+
+namespace
+{
+    float vectorLength(const sf::Vector2f& v)
+    {
+        return detSqrt(v.x * v.x + v.y * v.y);
+    }
+
+    float cross(const sf::Vector2f& a, const sf::Vector2f& b)
+    {
+        return a.x * b.y - a.y * b.x;
+    }
+
+    // Liang-Barsky clip of segment a-b against rect
+    bool segmentIntersectsRect(const sf::Vector2f& a, const sf::Vector2f& b, const sf::FloatRect& rect)
+    {
+        sf::Vector2f d = b - a;
+        const float p[4] = {-d.x, d.x, -d.y, d.y};
+        const float q[4] = {
+            a.x - rect.position.x,
+            rect.position.x + rect.size.x - a.x,
+            a.y - rect.position.y,
+            rect.position.y + rect.size.y - a.y
+        };
+
+        float t0 = 0.0f;
+        float t1 = 1.0f;
+        for (int i = 0; i < 4; ++i)
+        {
+            if (p[i] == 0.0f)
+            {
+                if (q[i] < 0.0f)
+                    return false;
+                continue;
+            }
+
+            float t = q[i] / p[i];
+            if (p[i] < 0.0f)
+                t0 = std::max(t0, t);
+            else
+                t1 = std::min(t1, t);
+
+            if (t0 > t1)
+                return false;
+        }
+        return true;
+    }
+
+    bool pointInTriangle(const sf::Vector2f& p, const sf::Vector2f& a, const sf::Vector2f& b, const sf::Vector2f& c)
+    {
+        float d1 = cross(b - a, p - a);
+        float d2 = cross(c - b, p - b);
+        float d3 = cross(a - c, p - c);
+        bool hasNegative = d1 < 0 || d2 < 0 || d3 < 0;
+        bool hasPositive = d1 > 0 || d2 > 0 || d3 > 0;
+        return !(hasNegative && hasPositive);
+    }
+}
+
+Rope::Rope(int segmentCount, int iterations)
+    : active(false), segmentCount(1), iterations(1), length(0), maxSpeed(1000000.0f),
+      accumulator(0), anchor(0, 0), wrapCount(0)
+{
+    setSegmentCount(segmentCount);
+    setIterations(iterations);
+}
+
+void Rope::setIterations(int iterations_)
+{
+    iterations = std::clamp(iterations_, 1, 64);
+}
+
+void Rope::setSegmentCount(int segmentCount_)
+{
+    segmentCount = std::clamp(segmentCount_, 1, MAX_SEGMENTS);
+    if (active)
+        layoutFreeSpan();
+}
+
+void Rope::setMaxSpeed(float maxSpeed_)
+{
+    maxSpeed = maxSpeed_;
+}
+
+void Rope::attach(const sf::Vector2f& anchor_, const sf::Vector2f& bodyPosition, const sf::Vector2f& bodyVelocity, float maxLength)
+{
+    active = true;
+    anchor = anchor_;
+    wrapCount = 0;
+    accumulator = 0;
+
+    // The rope locks at the distance it was fired from, capped by maxLength
+    length = std::min(vectorLength(bodyPosition - anchor), maxLength);
+
+    points[segmentCount] = bodyPosition;
+    layoutFreeSpan();
+    previousPoints[segmentCount] = bodyPosition - bodyVelocity * Physics::FIXED_TIMESTEP;
+}
+
+void Rope::setAnchor(const sf::Vector2f& anchor_)
+{
+    anchor = anchor_;
+    if (wrapCount == 0)
+    {
+        points[0] = anchor;
+        previousPoints[0] = anchor;
+    }
+}
+
+void Rope::release()
+{
+    active = false;
+    wrapCount = 0;
+    accumulator = 0;
+    length = 0;
+}
+
+sf::Vector2f Rope::getPivot() const
+{
+    return wrapCount > 0 ? wraps[wrapCount - 1].position : anchor;
+}
+
+float Rope::getFreeLength() const
+{
+    float wrapped = 0;
+    sf::Vector2f from = anchor;
+    for (int i = 0; i < wrapCount; ++i)
+    {
+        wrapped += vectorLength(wraps[i].position - from);
+        from = wraps[i].position;
+    }
+    return std::max(length - wrapped, MIN_FREE_LENGTH);
+}
+
+float Rope::getStretch() const
+{
+    float pathLength = 0;
+    for (int i = 0; i < segmentCount; ++i)
+    {
+        pathLength += vectorLength(points[i + 1] - points[i]);
+    }
+    return pathLength / getFreeLength() - 1.0f;
+}
+
+void Rope::layoutFreeSpan()
+{
+    sf::Vector2f pivot = getPivot();
+    sf::Vector2f body = points[segmentCount];
+
+    for (int i = 0; i < segmentCount; ++i)
+    {
+        float t = static_cast<float>(i) / segmentCount;
+        points[i] = pivot + (body - pivot) * t;
+        previousPoints[i] = points[i];
+    }
+}
+
+void Rope::update(const sf::Time& elapsed, sf::Vector2f& bodyPosition, sf::Vector2f& bodyVelocity,
+                  float swingAcceleration, const Physics& physics)
+{
+    if (!active)
+        return;
+
+    // The body may have been moved by collision response since the last tick
+    points[segmentCount] = bodyPosition;
+
+    accumulator += elapsed.asSeconds();
+
+    int substeps = 0;
+    while (accumulator >= Physics::FIXED_TIMESTEP && substeps < MAX_SUBSTEPS)
+    {
+        step(Physics::FIXED_TIMESTEP, bodyVelocity, swingAcceleration, physics);
+        accumulator -= Physics::FIXED_TIMESTEP;
+        ++substeps;
+    }
+
+    // Drop time we could not simulate after a hitch instead of spiralling
+    if (substeps == MAX_SUBSTEPS)
+        accumulator = std::min(accumulator, Physics::FIXED_TIMESTEP);
+
+    bodyPosition = points[segmentCount];
+}
+
+void Rope::step(float dt, sf::Vector2f& bodyVelocity, float swingAcceleration, const Physics& physics)
+{
+    const int n = segmentCount;
+    sf::Vector2f pivot = getPivot();
+    sf::Vector2f previousBody = points[n];
+
+    // Body: gravity plus swing input along the rope tangent
+    sf::Vector2f ropeVec = points[n] - pivot;
+    float ropeLength = vectorLength(ropeVec);
+    if (ropeLength > 0.1f)
+    {
+        sf::Vector2f tangent(-ropeVec.y / ropeLength, ropeVec.x / ropeLength);
+        bodyVelocity += tangent * swingAcceleration * dt;
+    }
+    bodyVelocity.y += Physics::GRAVITY * dt;
+
+    previousPoints[n] = points[n];
+    points[n] += bodyVelocity * dt;
+
+    // Rope points: damped Verlet
+    sf::Vector2f gravityStep(0, Physics::GRAVITY * dt * dt);
+    for (int i = 1; i < n; ++i)
+    {
+        sf::Vector2f current = points[i];
+        points[i] += (points[i] - previousPoints[i]) * SEGMENT_DAMPING + gravityStep;
+        previousPoints[i] = current;
+    }
+    points[0] = pivot;
+    previousPoints[0] = pivot;
+
+    solveConstraints();
+
+    bodyVelocity = (points[n] - previousPoints[n]) / dt;
+    float speed = vectorLength(bodyVelocity);
+    if (speed > maxSpeed)
+    {
+        bodyVelocity = bodyVelocity / speed * maxSpeed;
+    }
+
+    updateWrapping(previousBody, physics);
+}
+
+void Rope::solveConstraints()
+{
+    const int n = segmentCount;
+    const float restLength = getFreeLength() / n;
+
+    for (int iteration = 0; iteration < iterations; ++iteration)
+    {
+        for (int i = 0; i < n; ++i)
+        {
+            float w1 = (i == 0) ? 0.0f : SEGMENT_INVERSE_MASS;
+            float w2 = (i + 1 == n) ? BODY_INVERSE_MASS : SEGMENT_INVERSE_MASS;
+
+            sf::Vector2f delta = points[i + 1] - points[i];
+            float distance = vectorLength(delta);
+
+            // A rope only resists stretching, slack segments are left alone
+            if (distance <= restLength || distance < 0.0001f)
+                continue;
+
+            sf::Vector2f correction = delta * ((distance - restLength) / (distance * (w1 + w2)));
+            points[i] += correction * w1;
+            points[i + 1] -= correction * w2;
+        }
+    }
+
+    // Long-range attachments: no point may be further from the pivot than the
+    // rope between them, which bounds stretch regardless of iteration count
+    const sf::Vector2f pivot = points[0];
+    for (int i = 1; i <= n; ++i)
+    {
+        float maxDistance = restLength * i;
+        sf::Vector2f delta = points[i] - pivot;
+        float distance = vectorLength(delta);
+        if (distance > maxDistance)
+        {
+            points[i] = pivot + delta * (maxDistance / distance);
+        }
+    }
+}
+
+void Rope::updateWrapping(const sf::Vector2f& previousBody, const Physics& physics)
+{
+    const sf::Vector2f body = points[segmentCount];
+
+    // Unwrap once the body swings back past the line through the last two pivots
+    bool unwrapped = false;
+    while (wrapCount > 0)
+    {
+        sf::Vector2f previousPivot = wrapCount > 1 ? wraps[wrapCount - 2].position : anchor;
+        const WrapPoint& wrap = wraps[wrapCount - 1];
+        float side = cross(wrap.position - previousPivot, body - wrap.position);
+
+        if (side * wrap.side >= 0)
+            break;
+
+        --wrapCount;
+        unwrapped = true;
+    }
+
+    if (unwrapped)
+        layoutFreeSpan();
+
+    if (wrapCount >= MAX_WRAP_POINTS)
+        return;
+
+    // Only platforms inside the box swept by the free span can be hit
+    const sf::Vector2f pivot = getPivot();
+    sf::Vector2f low(std::min({pivot.x, previousBody.x, body.x}), std::min({pivot.y, previousBody.y, body.y}));
+    sf::Vector2f high(std::max({pivot.x, previousBody.x, body.x}), std::max({pivot.y, previousBody.y, body.y}));
+    
+    nearbyPlatforms.clear();
+    physics.queryPlatforms(sf::FloatRect(low, high - low), nearbyPlatforms);
+    
+    for (const Platform* platform : nearbyPlatforms)
+    {
+        sf::FloatRect bounds = platform->getBounds();
+
+        // Shrink so the edge the hook is attached to does not count as a hit
+        sf::FloatRect inner({bounds.position.x + 1.0f, bounds.position.y + 1.0f},
+                            {bounds.size.x - 2.0f, bounds.size.y - 2.0f});
+        if (inner.size.x <= 0 || inner.size.y <= 0 || !segmentIntersectsRect(pivot, body, inner))
+            continue;
+
+        // The first corner swept by the rope this step becomes the new pivot
+        const sf::Vector2f corners[4] = {
+            bounds.position,
+            {bounds.position.x + bounds.size.x, bounds.position.y},
+            {bounds.position.x, bounds.position.y + bounds.size.y},
+            bounds.position + bounds.size
+        };
+
+        sf::Vector2f sweepStart = previousBody - pivot;
+        int bestCorner = -1;
+        float bestAngle = 0;
+        for (int i = 0; i < 4; ++i)
+        {
+            if (!pointInTriangle(corners[i], pivot, previousBody, body))
+                continue;
+
+            sf::Vector2f toCorner = corners[i] - pivot;
+            float angle = std::abs(detAtan2(cross(sweepStart, toCorner), sweepStart.x * toCorner.x + sweepStart.y * toCorner.y));
+            if (bestCorner < 0 || angle < bestAngle)
+            {
+                bestCorner = i;
+                bestAngle = angle;
+            }
+        }
+
+        if (bestCorner < 0)
+            continue;
+
+        sf::Vector2f outward = corners[bestCorner] - (bounds.position + bounds.size / 2.0f);
+        float outwardLength = vectorLength(outward);
+        sf::Vector2f wrapPosition = corners[bestCorner];
+        if (outwardLength > 0)
+            wrapPosition += outward / outwardLength * WRAP_OFFSET;
+
+        wraps[wrapCount].position = wrapPosition;
+        wraps[wrapCount].side = cross(wrapPosition - pivot, body - wrapPosition);
+        ++wrapCount;
+
+        layoutFreeSpan();
+        return;
+    }
+}
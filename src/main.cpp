@@ -1,8 +1,113 @@
 #include "core/MainWindow.hpp"
+#include <charconv>
+#include <cstring>
 
-int main()
+namespace
 {
+    bool parsePort(const std::string& text, unsigned short& port)
+    {
+        const char* end = text.data() + text.size();
+        auto [ptr, error] = std::from_chars(text.data(), end, port);
+        return error == std::errc() && ptr == end && port != 0;
+    }
+
+    bool parseFps(const std::string& text, float& fps)
+    {
+        unsigned value = 0;
+        const char* end = text.data() + text.size();
+        auto [ptr, error] = std::from_chars(text.data(), end, value);
+        if (error != std::errc() || ptr != end)
+            return false;
+        fps = static_cast<float>(value);
+        return true;
+    }
+
+    void printUsage()
+    {
+        std::cerr << "Usage: HookLeap [--host <map> [--port <port>] | --join <address>[:<port>] | --replay <file>]\n"
+                  << "               [--fps <n>] [--vsync] [--latency] [--telemetry <file>]" << std::endl;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    RaceOptions race;
+    std::string replayFile;
+    FrameOptions frames;
+    std::string telemetryFile = Telemetry::DEFAULT_PATH;
+    for (int i = 1; i < argc; ++i)
+    {
+        bool hasValue = i + 1 < argc;
+        if (std::strcmp(argv[i], "--host") == 0 && hasValue)
+        {
+            race.mode = RaceOptions::Mode::Host;
+            race.mapFile = argv[++i];
+        }
+        else if (std::strcmp(argv[i], "--join") == 0 && hasValue)
+        {
+            race.mode = RaceOptions::Mode::Join;
+            race.address = argv[++i];
+            
+            std::size_t colon = race.address.rfind(':');
+            if (colon != std::string::npos)
+            {
+                if (!parsePort(race.address.substr(colon + 1), race.port))
+                {
+                    printUsage();
+                    return 1;
+                }
+                race.address.erase(colon);
+            }
+        }
+        else if (std::strcmp(argv[i], "--port") == 0 && hasValue)
+        {
+            if (!parsePort(argv[++i], race.port))
+            {
+                printUsage();
+                return 1;
+            }
+        }
+        else if (std::strcmp(argv[i], "--replay") == 0 && hasValue)
+        {
+            replayFile = argv[++i];
+        }
+        else if (std::strcmp(argv[i], "--fps") == 0 && hasValue)
+        {
+            if (!parseFps(argv[++i], frames.targetFps))
+            {
+                printUsage();
+                return 1;
+            }
+        }
+        else if (std::strcmp(argv[i], "--vsync") == 0)
+        {
+            frames.vsync = true;
+        }
+        else if (std::strcmp(argv[i], "--latency") == 0)
+        {
+            frames.reportLatency = true;
+        }
+        else if (std::strcmp(argv[i], "--telemetry") == 0 && hasValue)
+        {
+            telemetryFile = argv[++i];
+        }
+        else
+        {
+            printUsage();
+            return 1;
+        }
+    }
+    
+    // Opened first and closed last, so every message from the game goes
+    // through it
+    Telemetry telemetry;
+    telemetry.open(telemetryFile);
+    
     MainWindow mainWindow;
+    mainWindow.setTelemetry(telemetry);
+    mainWindow.setRaceOptions(race);
+    mainWindow.setReplayFile(replayFile);
+    mainWindow.setFrameOptions(frames);
     mainWindow.run();
     return 0;
 }
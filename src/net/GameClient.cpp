@@ -0,0 +1,361 @@
+#include "net/GameClient.hpp"
+#include "core/Telemetry.hpp"
+#include <algorithm>
+
+GameClient::GameClient(const sf::Texture& characterTexture)
+    : characterTexture(characterTexture), serverAddress(sf::IpAddress::LocalHost), serverPort(DEFAULT_PORT),
+      status(Status::Disconnected), mapHash(0), playerId(0), inputSequence(0), finished(false), newestSnapshot(0)
+{
+}
+
+std::uint32_t GameClient::now() const
+{
+    return static_cast<std::uint32_t>(clock.getElapsedTime().asMilliseconds());
+}
+
+bool GameClient::connect(const sf::IpAddress& address, unsigned short port)
+{
+    if (socket.bind(sf::Socket::AnyPort) != sf::Socket::Status::Done)
+    {
+        error = "could not open a UDP socket";
+        LogLine(LogLevel::Error) << "Could not open a UDP socket";
+        return false;
+    }
+
+    socket.setBlocking(false);
+    serverAddress = address;
+    serverPort = port;
+    status = Status::Connecting;
+    error.clear();
+
+    lastHeard.restart();
+    sendConnect();
+    return true;
+}
+
+void GameClient::disconnect()
+{
+    if (status == Status::Connecting || status == Status::Connected)
+    {
+        writeHeader(writer, MessageType::Disconnect);
+        send();
+    }
+
+    status = Status::Disconnected;
+    socket.unbind();
+}
+
+void GameClient::send()
+{
+    if (socket.send(writer.getData(), writer.getSize(), serverAddress, serverPort) == sf::Socket::Status::Done)
+        stats.addSent(writer.getSize());
+    lastSent.restart();
+}
+
+void GameClient::sendConnect()
+{
+    writeHeader(writer, MessageType::Connect);
+    send();
+}
+
+void GameClient::sendInputs()
+{
+    if (pending.empty())
+        return;
+
+    std::size_t count = std::min(pending.size(), INPUT_REDUNDANCY);
+
+    writeHeader(writer, MessageType::Input);
+    writer.writeVarint(newestSnapshot);
+    writer.writeU32(now());
+    writer.writeVarint(pending.back().sequence);
+    writer.writeU8(static_cast<std::uint8_t>(count));
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        writeInput(writer, pending[pending.size() - 1 - i].input);
+    }
+    send();
+}
+
+bool GameClient::readLevel(const AssetLoader& assets, MapData& map)
+{
+    std::uint64_t hash = 0;
+    if (!assets.readMap(mapFile, map, hash))
+    {
+        error = "could not load " + mapFile;
+        return false;
+    }
+
+    if (hash != mapHash)
+    {
+        error = mapFile + " is not the same as the server's";
+        LogLine(LogLevel::Warning) << "Map " << mapFile << " differs from the server's copy";
+        return false;
+    }
+
+    return true;
+}
+
+void GameClient::buildLevel(const LevelBuilder& builder, const MapData& map)
+{
+    confirmed = std::make_unique<Simulation>(characterTexture);
+    std::vector<Entity> entities;
+    builder.build(*confirmed, map, entities);
+    confirmed->restart({LevelBuilder::SPAWN_X, LevelBuilder::SPAWN_Y});
+
+    predicted = std::make_unique<Simulation>(*confirmed);
+}
+
+void GameClient::update(const InputState& input, const sf::Time& elapsed)
+{
+    receive();
+    stats.update();
+
+    if (status == Status::Connecting)
+    {
+        if (lastHeard.getElapsedTime().asSeconds() > CONNECTION_TIMEOUT)
+        {
+            status = Status::Disconnected;
+            error = "no answer from the server";
+        }
+        else if (lastSent.getElapsedTime().asSeconds() > CONNECT_RETRY)
+        {
+            sendConnect();
+        }
+        return;
+    }
+
+    if (status != Status::Connected)
+        return;
+
+    if (lastHeard.getElapsedTime().asSeconds() > CONNECTION_TIMEOUT)
+    {
+        status = Status::Disconnected;
+        error = "lost connection to the server";
+        return;
+    }
+
+    if (!predicted)
+        return;
+
+    // Frames and ticks don't line up, so edges wait for the next tick
+    nextInput.held = input.held;
+    nextInput.pressed |= input.pressed;
+    nextInput.released |= input.released;
+    if (input.isHeld(Action::Hook) || input.wasPressed(Action::Hook))
+        nextInput.aim = input.aim;
+
+    accumulator += elapsed;
+    int steps = 0;
+    while (accumulator >= tickTime() && steps < MAX_STEPS_PER_UPDATE)
+    {
+        accumulator -= tickTime();
+        step();
+        ++steps;
+    }
+
+    if (steps == MAX_STEPS_PER_UPDATE)
+        accumulator = sf::Time::Zero;
+}
+
+void GameClient::step()
+{
+    InputState input = quantizeInput(nextInput);
+    nextInput.pressed = 0;
+    nextInput.released = 0;
+
+    pending.push_back({++inputSequence, input});
+    if (pending.size() > MAX_PENDING_INPUTS)
+        pending.pop_front();
+
+    predicted->step(input, tickTime());
+    sendInputs();
+}
+
+void GameClient::receive()
+{
+    std::size_t received = 0;
+    std::optional<sf::IpAddress> address;
+    unsigned short port = 0;
+
+    while (socket.receive(buffer.data(), buffer.size(), received, address, port) == sf::Socket::Status::Done)
+    {
+        if (!address || *address != serverAddress || port != serverPort)
+            continue;
+
+        stats.addReceived(received);
+
+        ByteReader reader(buffer.data(), received);
+        MessageType type;
+        if (!readHeader(reader, type))
+            continue;
+
+        lastHeard.restart();
+
+        switch (type)
+        {
+            case MessageType::Accept:
+                handleAccept(reader);
+                break;
+            case MessageType::Reject:
+                status = Status::Rejected;
+                error = reader.readString();
+                break;
+            case MessageType::Snapshot:
+                handleSnapshot(reader);
+                break;
+            case MessageType::Disconnect:
+                status = Status::Disconnected;
+                error = "the server closed the race";
+                break;
+            default:
+                break;
+        }
+    }
+}
+
+void GameClient::handleAccept(ByteReader& reader)
+{
+    if (status != Status::Connecting)
+        return;
+
+    std::uint8_t id = reader.readU8();
+    std::string file = reader.readString();
+    std::uint64_t hash = reader.readU64();
+    if (!reader.isValid())
+        return;
+
+    playerId = id;
+    mapFile = file;
+    mapHash = hash;
+    status = Status::Connected;
+}
+
+void GameClient::handleSnapshot(ByteReader& reader)
+{
+    std::uint32_t sequence = reader.readVarint();
+    std::uint32_t baselineSequence = reader.readVarint();
+    std::uint32_t lastAppliedInput = reader.readVarint();
+    std::uint32_t echoedTime = reader.readU32();
+    std::uint32_t heldFor = reader.readVarint();
+
+    // Late or duplicated snapshots have nothing newer to say
+    if (!reader.isValid() || status != Status::Connected || sequence <= newestSnapshot)
+        return;
+
+    const std::vector<NetPlayerState>* baseline = nullptr;
+    if (baselineSequence != 0)
+    {
+        const ReceivedSnapshot& base = history[baselineSequence % SNAPSHOT_HISTORY];
+        if (base.sequence != baselineSequence)
+            return;
+        baseline = &base.states;
+    }
+
+    // Decoded aside first, the slot may still hold the baseline
+    std::vector<NetPlayerState> states;
+    if (!readStates(reader, baseline, states))
+        return;
+
+    ReceivedSnapshot& slot = history[sequence % SNAPSHOT_HISTORY];
+    slot.sequence = sequence;
+    slot.time = clock.getElapsedTime().asSeconds();
+    slot.states = std::move(states);
+    newestSnapshot = sequence;
+
+    stats.addSnapshot(sequence);
+    std::uint32_t sinceSent = now() - echoedTime;
+    if (echoedTime != 0 && sinceSent >= heldFor)
+        stats.addRoundTrip(static_cast<float>(sinceSent - heldFor));
+
+    for (const auto& state : slot.states)
+    {
+        if (state.id != playerId)
+            continue;
+
+        finished = state.get(StateField::Finished) != 0;
+        if (predicted)
+            reconcile(state, lastAppliedInput);
+    }
+}
+
+void GameClient::reconcile(const NetPlayerState& server, std::uint32_t lastAppliedInput)
+{
+    // Bring the confirmed simulation up to the input the server stopped at
+    while (!pending.empty() && pending.front().sequence <= lastAppliedInput)
+    {
+        confirmed->step(pending.front().input, tickTime());
+        pending.pop_front();
+    }
+
+    if (statesMatch(captureState(*confirmed, playerId), server))
+        return;
+
+    applyState(*confirmed, server);
+
+    *predicted = *confirmed;
+    for (const auto& input : pending)
+    {
+        predicted->step(input.input, tickTime());
+    }
+
+    stats.addCorrection();
+}
+
+void GameClient::getRemotePlayers(std::vector<NetPlayerState>& players) const
+{
+    players.clear();
+
+    // Newest snapshot at or before the render time, and the oldest after it
+    float renderTime = clock.getElapsedTime().asSeconds() - INTERPOLATION_DELAY;
+    const ReceivedSnapshot* from = nullptr;
+    const ReceivedSnapshot* to = nullptr;
+    for (const auto& snapshot : history)
+    {
+        if (snapshot.sequence == 0)
+            continue;
+
+        if (snapshot.time <= renderTime)
+        {
+            if (!from || snapshot.sequence > from->sequence)
+                from = &snapshot;
+        }
+        else if (!to || snapshot.sequence < to->sequence)
+        {
+            to = &snapshot;
+        }
+    }
+
+    if (!to)
+        to = from;
+    if (!from)
+        from = to;
+    if (!to)
+        return;
+
+    float t = to->time > from->time ? (renderTime - from->time) / (to->time - from->time) : 1.0f;
+    t = std::clamp(t, 0.0f, 1.0f);
+
+    const StateField smooth[] = {StateField::PositionX, StateField::PositionY, StateField::HookX, StateField::HookY};
+
+    for (const auto& state : to->states)
+    {
+        if (state.id == playerId)
+            continue;
+
+        NetPlayerState player = state;
+        for (const auto& previous : from->states)
+        {
+            if (previous.id != state.id)
+                continue;
+
+            for (StateField field : smooth)
+            {
+                float a = static_cast<float>(previous.get(field));
+                float b = static_cast<float>(state.get(field));
+                player.set(field, static_cast<std::int32_t>(a + (b - a) * t));
+            }
+        }
+        players.push_back(player);
+    }
+}
@@ -0,0 +1,316 @@
+#include "net/GameServer.hpp"
+#include "core/Telemetry.hpp"
+#include <algorithm>
+
+GameServer::GameServer()
+    : builder({&emptyTexture, &emptyTexture, &emptyTexture, &emptyTexture, &emptyTexture, &emptyTexture}),
+      mapHash(0), tickCount(0)
+{
+}
+
+bool GameServer::loadLevel(const AssetLoader& assets, const std::string& mapFile_)
+{
+    MapData loaded;
+    std::uint64_t hash = 0;
+    if (!assets.readMap(mapFile_, loaded, hash))
+        return false;
+
+    setLevel(mapFile_, loaded, hash);
+    return true;
+}
+
+void GameServer::setLevel(const std::string& mapFile_, const MapData& map_, std::uint64_t mapHash_)
+{
+    mapFile = mapFile_;
+    map = map_;
+    mapHash = mapHash_;
+}
+
+bool GameServer::listen(unsigned short port)
+{
+    if (socket.bind(port) != sf::Socket::Status::Done)
+    {
+        LogLine(LogLevel::Error) << "Could not bind UDP port " << port;
+        return false;
+    }
+
+    socket.setBlocking(false);
+    return true;
+}
+
+void GameServer::run(const std::atomic<bool>& running)
+{
+    sf::Clock clock;
+    sf::Time nextTick = clock.getElapsedTime();
+
+    while (running)
+    {
+        tick();
+
+        nextTick += tickTime();
+        sf::Time now = clock.getElapsedTime();
+        if (nextTick > now)
+        {
+            sf::sleep(nextTick - now);
+        }
+        else if (now - nextTick > sf::seconds(0.25f))
+        {
+            // Stalled (debugger, suspended machine); don't try to catch up
+            nextTick = now;
+        }
+    }
+
+    disconnectAll();
+}
+
+void GameServer::tick()
+{
+    receive();
+    update();
+}
+
+void GameServer::update()
+{
+    dropSilentClients();
+    stepClients();
+
+    if (++tickCount % SNAPSHOT_INTERVAL == 0)
+        sendSnapshots();
+
+    stats.update();
+}
+
+void GameServer::disconnectAll()
+{
+    writeHeader(writer, MessageType::Disconnect);
+    for (const auto& client : clients)
+    {
+        send(client.address, client.port);
+    }
+    clients.clear();
+}
+
+GameServer::Client* GameServer::findClient(const sf::IpAddress& address, unsigned short port)
+{
+    for (auto& client : clients)
+    {
+        if (client.address == address && client.port == port)
+            return &client;
+    }
+    return nullptr;
+}
+
+void GameServer::send(const sf::IpAddress& address, unsigned short port)
+{
+    if (socket.send(writer.getData(), writer.getSize(), address, port) == sf::Socket::Status::Done)
+        stats.addSent(writer.getSize());
+}
+
+void GameServer::receive()
+{
+    std::size_t received = 0;
+    std::optional<sf::IpAddress> address;
+    unsigned short port = 0;
+
+    while (socket.receive(buffer.data(), buffer.size(), received, address, port) == sf::Socket::Status::Done)
+    {
+        if (!address)
+            continue;
+
+        stats.addReceived(received);
+
+        ByteReader reader(buffer.data(), received);
+        MessageType type;
+        if (!readHeader(reader, type))
+            continue;
+
+        Client* client = findClient(*address, port);
+        if (client)
+            client->lastHeard.restart();
+
+        switch (type)
+        {
+            case MessageType::Connect:
+                handleConnect(*address, port);
+                break;
+            case MessageType::Input:
+                if (client)
+                    handleInput(*client, reader);
+                break;
+            case MessageType::Disconnect:
+                if (client)
+                {
+                    LogLine(LogLevel::Info) << "Player " << static_cast<int>(client->id) << " left";
+                    clients.erase(clients.begin() + (client - clients.data()));
+                }
+                break;
+            default:
+                break;
+        }
+    }
+}
+
+void GameServer::handleConnect(const sf::IpAddress& address, unsigned short port)
+{
+    Client* client = findClient(address, port);
+    if (!client)
+    {
+        if (clients.size() >= MAX_PLAYERS)
+        {
+            writeHeader(writer, MessageType::Reject);
+            writer.writeString("server full");
+            send(address, port);
+            return;
+        }
+
+        // Lowest free id, so a player who rejoins gets a small number again
+        std::uint8_t id = 0;
+        while (std::any_of(clients.begin(), clients.end(), [id](const Client& other) { return other.id == id; }))
+            ++id;
+
+        Client joined;
+        joined.address = address;
+        joined.port = port;
+        joined.id = id;
+        joined.simulation = std::make_unique<Simulation>(emptyTexture);
+
+        std::vector<Entity> entities;
+        builder.build(*joined.simulation, map, entities);
+        joined.simulation->restart({LevelBuilder::SPAWN_X, LevelBuilder::SPAWN_Y});
+
+        clients.push_back(std::move(joined));
+        client = &clients.back();
+        LogLine(LogLevel::Info) << "Player " << static_cast<int>(id) << " joined from " << address.toString() << ":" << port;
+    }
+
+    // Connect is resent until accepted, so a repeat just gets the answer again
+    writeHeader(writer, MessageType::Accept);
+    writer.writeU8(client->id);
+    writer.writeString(mapFile);
+    writer.writeU64(mapHash);
+    send(address, port);
+}
+
+void GameServer::handleInput(Client& client, ByteReader& reader)
+{
+    std::uint32_t ackedSnapshot = reader.readVarint();
+    std::uint32_t clientTime = reader.readU32();
+    std::uint32_t newest = reader.readVarint();
+    std::size_t count = reader.readU8();
+    if (!reader.isValid() || count == 0 || count > INPUT_REDUNDANCY || newest < count)
+        return;
+
+    // Newest first on the wire
+    std::array<InputState, INPUT_REDUNDANCY> received;
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        received[i] = readInput(reader);
+    }
+    if (!reader.isValid())
+        return;
+
+    if (ackedSnapshot > client.ackedSnapshot && ackedSnapshot <= client.snapshotSequence)
+        client.ackedSnapshot = ackedSnapshot;
+
+    client.clientTime = clientTime;
+    client.clientTimeAge.restart();
+
+    std::uint32_t oldest = newest - static_cast<std::uint32_t>(count) + 1;
+    for (std::uint32_t sequence = oldest; sequence <= newest; ++sequence)
+    {
+        if (sequence <= client.lastQueuedInput)
+            continue;
+        if (client.inputs.size() >= MAX_QUEUED_INPUTS)
+            break;
+
+        const InputState& input = received[newest - sequence];
+
+        // A gap longer than the queue has room for is given up: stepping
+        // resumes at this input, and the acks say so
+        std::size_t room = MAX_QUEUED_INPUTS - client.inputs.size();
+        if (sequence - client.lastQueuedInput > room)
+            client.lastQueuedInput = sequence - 1;
+
+        // Lost beyond what the redundancy covers: hold the keys, no edges.
+        // The client sees the difference in the next snapshot and corrects.
+        while (client.lastQueuedInput + 1 < sequence)
+        {
+            InputState held;
+            held.held = input.held;
+            held.aim = input.aim;
+            client.inputs.push_back({++client.lastQueuedInput, held});
+        }
+
+        client.inputs.push_back({sequence, input});
+        client.lastQueuedInput = sequence;
+    }
+}
+
+void GameServer::stepClients()
+{
+    for (auto& client : clients)
+    {
+        for (std::size_t step = 0; step < MAX_STEPS_PER_TICK && !client.inputs.empty(); ++step)
+        {
+            QueuedInput queued = client.inputs.front();
+            client.inputs.pop_front();
+            client.lastAppliedInput = queued.sequence;
+
+            if (client.finished)
+                continue;
+
+            SimulationEvents events = client.simulation->step(queued.input, tickTime());
+            if (events.won)
+            {
+                client.finished = true;
+                LogLine(LogLevel::Info) << "Player " << static_cast<int>(client.id) << " finished in "
+                                        << client.simulation->getTime() << "s";
+            }
+        }
+    }
+}
+
+void GameServer::sendSnapshots()
+{
+    states.clear();
+    for (const auto& client : clients)
+    {
+        NetPlayerState state = captureState(*client.simulation, client.id);
+        state.set(StateField::Finished, client.finished ? 1 : 0);
+        states.push_back(state);
+    }
+
+    for (auto& client : clients)
+    {
+        std::uint32_t sequence = ++client.snapshotSequence;
+
+        // Delta against the newest snapshot the client confirmed, if we still have it
+        const SentSnapshot& acked = client.history[client.ackedSnapshot % SNAPSHOT_HISTORY];
+        bool hasBaseline = client.ackedSnapshot != 0 && acked.sequence == client.ackedSnapshot;
+
+        writeHeader(writer, MessageType::Snapshot);
+        writer.writeVarint(sequence);
+        writer.writeVarint(hasBaseline ? acked.sequence : 0);
+        writer.writeVarint(client.lastAppliedInput);
+        writer.writeU32(client.clientTime);
+        writer.writeVarint(static_cast<std::uint32_t>(client.clientTimeAge.getElapsedTime().asMilliseconds()));
+        writeStates(writer, states, hasBaseline ? &acked.states : nullptr);
+        send(client.address, client.port);
+
+        SentSnapshot& sent = client.history[sequence % SNAPSHOT_HISTORY];
+        sent.sequence = sequence;
+        sent.states = states;
+    }
+}
+
+void GameServer::dropSilentClients()
+{
+    auto silent = [](const Client& client)
+    {
+        if (client.lastHeard.getElapsedTime().asSeconds() < CONNECTION_TIMEOUT)
+            return false;
+        LogLine(LogLevel::Info) << "Player " << static_cast<int>(client.id) << " timed out";
+        return true;
+    };
+    clients.erase(std::remove_if(clients.begin(), clients.end(), silent), clients.end());
+}
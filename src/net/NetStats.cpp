@@ -0,0 +1,53 @@
+#include "net/NetStats.hpp"
+
+NetStats::NetStats()
+    : sentBytes(0), receivedBytes(0), snapshotsReceived(0), snapshotsLost(0), lastSnapshot(0),
+      sentPerSecond(0), receivedPerSecond(0), roundTrip(0), snapshotLoss(0), corrections(0)
+{
+}
+
+void NetStats::addSent(std::size_t bytes)
+{
+    sentBytes += bytes;
+}
+
+void NetStats::addReceived(std::size_t bytes)
+{
+    receivedBytes += bytes;
+}
+
+void NetStats::addRoundTrip(float milliseconds)
+{
+    // Smoothed like TCP's RTT estimate so one late packet does not jump the readout
+    roundTrip = roundTrip == 0 ? milliseconds : roundTrip + (milliseconds - roundTrip) * 0.125f;
+}
+
+void NetStats::addSnapshot(std::uint32_t sequence)
+{
+    if (sequence <= lastSnapshot)
+        return;
+
+    if (lastSnapshot != 0)
+        snapshotsLost += sequence - lastSnapshot - 1;
+    snapshotsReceived++;
+    lastSnapshot = sequence;
+}
+
+void NetStats::update()
+{
+    float seconds = window.getElapsedTime().asSeconds();
+    if (seconds < 1.0f)
+        return;
+
+    sentPerSecond = static_cast<float>(sentBytes) / seconds;
+    receivedPerSecond = static_cast<float>(receivedBytes) / seconds;
+
+    std::uint32_t expected = snapshotsReceived + snapshotsLost;
+    snapshotLoss = expected > 0 ? static_cast<float>(snapshotsLost) / static_cast<float>(expected) : 0.0f;
+
+    sentBytes = 0;
+    receivedBytes = 0;
+    snapshotsReceived = 0;
+    snapshotsLost = 0;
+    window.restart();
+}
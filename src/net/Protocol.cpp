@@ -0,0 +1,251 @@
+#include "net/Protocol.hpp"
+#include "core/Telemetry.hpp"
+#include <cmath>
+
+namespace
+{
+    std::int32_t quantize(float value)
+    {
+        return static_cast<std::int32_t>(std::lround(value * POSITION_SCALE));
+    }
+
+    float dequantize(std::int32_t value)
+    {
+        return static_cast<float>(value) / POSITION_SCALE;
+    }
+
+    // Largest difference still accepted as a match; -1 never compares
+    constexpr std::array<std::int32_t, STATE_FIELD_COUNT> FIELD_TOLERANCE = {
+        4, 4,       // position, a quarter pixel
+        16, 16,     // velocity, one pixel per second
+        0, 0,       // state, flags
+        -1, -1, -1, // facing, animation frame
+        4, 4,       // hook
+        0, 0,       // checkpoint
+        0, 0,       // score, deaths
+        1,          // time
+        -1          // finished is only known to the server
+    };
+}
+
+void writeHeader(ByteWriter& writer, MessageType type)
+{
+    writer.clear();
+    writer.writeU32(PROTOCOL_ID);
+    writer.writeU8(static_cast<std::uint8_t>(type));
+}
+
+bool readHeader(ByteReader& reader, MessageType& type)
+{
+    if (reader.readU32() != PROTOCOL_ID)
+        return false;
+
+    std::uint8_t value = reader.readU8();
+    if (!reader.isValid() || value > static_cast<std::uint8_t>(MessageType::Disconnect))
+        return false;
+
+    type = static_cast<MessageType>(value);
+    return true;
+}
+
+InputState quantizeInput(const InputState& input)
+{
+    InputState result = input;
+    result.aim = {dequantize(quantize(input.aim.x)), dequantize(quantize(input.aim.y))};
+    return result;
+}
+
+void writeInput(ByteWriter& writer, const InputState& input)
+{
+    writer.writeVarint(input.held);
+    writer.writeVarint(input.pressed);
+    writer.writeVarint(input.released);
+    writer.writeSignedVarint(quantize(input.aim.x));
+    writer.writeSignedVarint(quantize(input.aim.y));
+}
+
+InputState readInput(ByteReader& reader)
+{
+    InputState input;
+    input.held = static_cast<std::uint16_t>(reader.readVarint());
+    input.pressed = static_cast<std::uint16_t>(reader.readVarint());
+    input.released = static_cast<std::uint16_t>(reader.readVarint());
+    input.aim.x = dequantize(reader.readSignedVarint());
+    input.aim.y = dequantize(reader.readSignedVarint());
+    return input;
+}
+
+sf::Vector2f NetPlayerState::getPosition() const
+{
+    return {dequantize(get(StateField::PositionX)), dequantize(get(StateField::PositionY))};
+}
+
+sf::Vector2f NetPlayerState::getHookPoint() const
+{
+    return {dequantize(get(StateField::HookX)), dequantize(get(StateField::HookY))};
+}
+
+HookState NetPlayerState::getHookState() const
+{
+    return static_cast<HookState>((get(StateField::Flags) >> 1) & 3);
+}
+
+bool NetPlayerState::isOnGround() const
+{
+    return (get(StateField::Flags) & 1) != 0;
+}
+
+NetPlayerState captureState(const Simulation& simulation, std::uint8_t id)
+{
+    const Player& player = simulation.getPlayer();
+    const Hook& hook = player.getHook();
+
+    NetPlayerState state;
+    state.id = id;
+
+    sf::Vector2f position = player.getPosition();
+    sf::Vector2f velocity = player.getVelocity();
+    state.set(StateField::PositionX, quantize(position.x));
+    state.set(StateField::PositionY, quantize(position.y));
+    state.set(StateField::VelocityX, quantize(velocity.x));
+    state.set(StateField::VelocityY, quantize(velocity.y));
+
+    state.set(StateField::State, static_cast<std::int32_t>(player.getState()));
+    state.set(StateField::Flags, (player.isOnGround() ? 1 : 0) | (static_cast<std::int32_t>(hook.getState()) << 1));
+    state.set(StateField::FacingLeft, player.getDirection() == Direction::Left ? 1 : 0);
+
+    sf::IntRect frame = player.getTextureRect();
+    state.set(StateField::FrameX, frame.position.x);
+    state.set(StateField::FrameY, frame.position.y);
+
+    sf::Vector2f hookPoint = hook.isAttached() ? hook.getAttachPoint() : hook.getHookPosition();
+    state.set(StateField::HookX, quantize(hookPoint.x));
+    state.set(StateField::HookY, quantize(hookPoint.y));
+
+    sf::Vector2f checkpoint = simulation.getLastCheckpoint();
+    state.set(StateField::CheckpointX, quantize(checkpoint.x));
+    state.set(StateField::CheckpointY, quantize(checkpoint.y));
+    state.set(StateField::Score, simulation.getScore());
+    state.set(StateField::Deaths, simulation.getDeaths());
+    state.set(StateField::TimeMs, static_cast<std::int32_t>(std::lround(simulation.getTime() * 1000.0f)));
+    return state;
+}
+
+void applyState(Simulation& simulation, const NetPlayerState& state)
+{
+    Player& player = simulation.getPlayer();
+
+    player.setPosition(state.getPosition());
+    player.setVelocity({dequantize(state.get(StateField::VelocityX)), dequantize(state.get(StateField::VelocityY))});
+    player.setOnGround(state.isOnGround());
+
+    // Restarting the animation on every correction would make it stutter
+    PlayerState playerState = static_cast<PlayerState>(state.get(StateField::State));
+    if (player.getState() != playerState)
+        player.forceState(playerState);
+
+    HookState hookState = state.getHookState();
+    if (hookState == HookState::Inactive && player.getHook().getState() != HookState::Inactive)
+    {
+        player.releaseHook();
+    }
+    else if (hookState == HookState::Attached)
+    {
+        sf::Vector2f offset = player.getHook().getAttachPoint() - state.getHookPoint();
+        if (!player.isHooked() || std::abs(offset.x) > 0.5f || std::abs(offset.y) > 0.5f)
+        {
+            // The rope is rebuilt from the new attach point on the next step
+            player.releaseHook();
+            player.getHook().attach(state.getHookPoint());
+        }
+    }
+
+    simulation.setProgress(state.get(StateField::Score), state.get(StateField::Deaths),
+                           static_cast<float>(state.get(StateField::TimeMs)) / 1000.0f,
+                           {dequantize(state.get(StateField::CheckpointX)), dequantize(state.get(StateField::CheckpointY))});
+}
+
+bool statesMatch(const NetPlayerState& predicted, const NetPlayerState& server)
+{
+    for (std::size_t i = 0; i < STATE_FIELD_COUNT; ++i)
+    {
+        if (FIELD_TOLERANCE[i] < 0)
+            continue;
+
+        std::int64_t difference = static_cast<std::int64_t>(predicted.fields[i]) - server.fields[i];
+        if (difference > FIELD_TOLERANCE[i] || difference < -FIELD_TOLERANCE[i])
+            return false;
+    }
+    return true;
+}
+
+void writeStates(ByteWriter& writer, const std::vector<NetPlayerState>& states,
+                 const std::vector<NetPlayerState>* baseline)
+{
+    static const NetPlayerState zero;
+
+    writer.writeU8(static_cast<std::uint8_t>(states.size()));
+    for (const auto& state : states)
+    {
+        const NetPlayerState* base = &zero;
+        if (baseline)
+        {
+            for (const auto& candidate : *baseline)
+            {
+                if (candidate.id == state.id)
+                    base = &candidate;
+            }
+        }
+
+        std::uint32_t changed = 0;
+        for (std::size_t i = 0; i < STATE_FIELD_COUNT; ++i)
+        {
+            if (state.fields[i] != base->fields[i])
+                changed |= 1u << i;
+        }
+
+        writer.writeU8(state.id);
+        writer.writeVarint(changed);
+        for (std::size_t i = 0; i < STATE_FIELD_COUNT; ++i)
+        {
+            if (changed & (1u << i))
+                writer.writeSignedVarint(deltaBetween(state.fields[i], base->fields[i]));
+        }
+    }
+}
+
+bool readStates(ByteReader& reader, const std::vector<NetPlayerState>* baseline,
+                std::vector<NetPlayerState>& states)
+{
+    static const NetPlayerState zero;
+
+    std::size_t count = reader.readU8();
+    if (count > MAX_PLAYERS)
+        return false;
+
+    states.resize(count);
+    for (auto& state : states)
+    {
+        state.id = reader.readU8();
+
+        const NetPlayerState* base = &zero;
+        if (baseline)
+        {
+            for (const auto& candidate : *baseline)
+            {
+                if (candidate.id == state.id)
+                    base = &candidate;
+            }
+        }
+
+        std::uint32_t changed = reader.readVarint();
+        for (std::size_t i = 0; i < STATE_FIELD_COUNT; ++i)
+        {
+            state.fields[i] = base->fields[i];
+            if (changed & (1u << i))
+                state.fields[i] = addDelta(state.fields[i], reader.readSignedVarint());
+        }
+    }
+
+    return reader.isValid();
+}
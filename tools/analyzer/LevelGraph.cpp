@@ -0,0 +1,370 @@
+#include "LevelGraph.hpp"
+#include "core/LevelBuilder.hpp"
+#include "game/Player.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <deque>
+#include <thread>
+
+namespace
+{
+    // Hook point relative to the player's hitbox
+    constexpr float HALF_WIDTH = Player::HITBOX_WIDTH / 2.0f;
+    constexpr float ABOVE = Player::CENTER_OFFSET - Player::HITBOX_TOP;
+    constexpr float BELOW = Player::HITBOX_TOP + Player::HITBOX_HEIGHT - Player::CENTER_OFFSET;
+
+    // Pickup sizes from createPickupEntity, and how far from the checkpoint
+    // Simulation::respawnPlayer puts the sprite
+    constexpr float PICKUP_SIZE = 32.0f;
+    constexpr float WIN_SIZE = 16.0f;
+    constexpr float RESPAWN_OFFSET = 16.0f;
+
+    constexpr std::size_t CHUNK_SIZE = 1024;
+
+    float gapBetween(float left, float right, float otherLeft, float otherRight)
+    {
+        return std::max({0.0f, otherLeft - right, left - otherRight});
+    }
+}
+
+LevelGraph::LevelGraph(const AnalyzerOptions& options)
+    : options(options),
+      jumpTable(ReachTable::jump(1.0f / options.frameRate, options.maxDrop)),
+      swingTable(ReachTable::swing(1.0f / options.frameRate, options.maxDrop)),
+      fallTable(ReachTable::fall(1.0f / options.frameRate, options.maxDrop))
+{
+}
+
+const ReachTable& LevelGraph::tableFor(Launch launch) const
+{
+    switch (launch)
+    {
+        case Launch::Stand:
+            return jumpTable;
+        case Launch::Swing:
+            return swingTable;
+        case Launch::Drop:
+            break;
+    }
+    return fallTable;
+}
+
+std::uint32_t LevelGraph::addNode(float left, float right, float y, Launch launch)
+{
+    nodes.push_back({left, right, y, launch, NO_NODE, NO_NODE});
+    return static_cast<std::uint32_t>(nodes.size() - 1);
+}
+
+std::uint32_t LevelGraph::addDrop(const sf::Vector2f& spritePosition)
+{
+    float x = spritePosition.x + Player::CENTER_OFFSET;
+    return addNode(x, x, spritePosition.y + Player::CENTER_OFFSET, Launch::Drop);
+}
+
+void LevelGraph::addFoothold(const sf::FloatRect& bounds, bool floating)
+{
+    float left = bounds.position.x;
+    float right = left + bounds.size.x;
+
+    Foothold foothold;
+    foothold.bounds = bounds;
+    foothold.stand = addNode(left - HALF_WIDTH, right + HALF_WIDTH, bounds.position.y - BELOW, Launch::Stand);
+    foothold.anchor = floating ? addNode(left, right, bounds.position.y + bounds.size.y, Launch::Swing) : NO_NODE;
+    footholds.push_back(foothold);
+}
+
+void LevelGraph::addPath(float x, float y, const sf::Vector2f& from, const sf::Vector2f& to)
+{
+    // Offsets from the map position, start and end included
+    sf::Vector2f path = to - from;
+    float length = std::sqrt(path.x * path.x + path.y * path.y);
+    int steps = std::max(1, static_cast<int>(std::ceil(length / PATH_STEP)));
+
+    const sf::Vector2f size(LevelBuilder::PLATFORM_WIDTH, LevelBuilder::PLATFORM_HEIGHT);
+    for (int i = 0; i <= steps; ++i)
+    {
+        sf::Vector2f offset = from + path * (static_cast<float>(i) / steps);
+        addFoothold({{x + offset.x, y + offset.y}, size}, true);
+
+        // Riding the platform, or hanging from it, carries the player along
+        if (i > 0)
+        {
+            const Foothold& previous = footholds[footholds.size() - 2];
+            const Foothold& current = footholds.back();
+            nodes[previous.stand].next = current.stand;
+            nodes[current.stand].previous = previous.stand;
+            nodes[previous.anchor].next = current.anchor;
+            nodes[current.anchor].previous = previous.anchor;
+        }
+    }
+}
+
+void LevelGraph::addItem(const MapObject& object, std::size_t index)
+{
+    float size = object.type == MapObjectType::Win ? WIN_SIZE : PICKUP_SIZE;
+
+    Item item;
+    item.bounds = sf::FloatRect({object.x(), object.y()}, {size, size});
+    item.object = index;
+    item.type = object.type;
+    item.respawn = NO_NODE;
+    if (object.type == MapObjectType::Checkpoint)
+        item.respawn = addDrop({object.x() - RESPAWN_OFFSET, object.y() - RESPAWN_OFFSET});
+    items.push_back(item);
+}
+
+void LevelGraph::build(const MapData& map)
+{
+    nodes.clear();
+    footholds.clear();
+    items.clear();
+    startNodes.clear();
+
+    // Restarting puts the sprite on spawn, dying before any checkpoint a
+    // little up and left of it
+    const sf::Vector2f spawn(LevelBuilder::SPAWN_X, LevelBuilder::SPAWN_Y);
+    startNodes.push_back(addDrop(spawn));
+    startNodes.push_back(addDrop(spawn - sf::Vector2f(RESPAWN_OFFSET, RESPAWN_OFFSET)));
+
+    const sf::Vector2f platformSize(LevelBuilder::PLATFORM_WIDTH, LevelBuilder::PLATFORM_HEIGHT);
+    for (std::size_t i = 0; i < map.objects.size(); ++i)
+    {
+        const MapObject& object = map.objects[i];
+        const auto& v = object.values;
+
+        switch (object.type)
+        {
+            case MapObjectType::Ground:
+                addFoothold({{v[0], v[1]}, {v[2], v[3]}}, false);
+                break;
+            case MapObjectType::Platform:
+            case MapObjectType::Crumble:
+                // A crumbled platform comes back, so it is always there to use
+                addFoothold({{v[0], v[1]}, platformSize}, true);
+                break;
+            case MapObjectType::Mover:
+                addPath(v[0], v[1], {0, 0}, {v[2] - v[0], v[3] - v[1]});
+                break;
+            case MapObjectType::Oscillator:
+                addPath(v[0], v[1], {-v[2], -v[3]}, {v[2], v[3]});
+                break;
+            case MapObjectType::Obstacle:
+                // Deadly to touch, never needed to get anywhere
+                break;
+            case MapObjectType::Pickup:
+            case MapObjectType::Checkpoint:
+            case MapObjectType::Win:
+                addItem(object, i);
+                break;
+        }
+    }
+
+    std::vector<sf::FloatRect> boxes;
+    boxes.reserve(footholds.size());
+    for (const auto& foothold : footholds)
+    {
+        boxes.push_back(foothold.bounds);
+    }
+    footholdGrid.build(boxes);
+
+    boxes.clear();
+    for (const auto& item : items)
+    {
+        boxes.push_back(item.bounds);
+    }
+    itemGrid.build(boxes);
+
+    buildEdges();
+}
+
+void LevelGraph::findEdges(std::uint32_t index, std::vector<std::uint32_t>& result) const
+{
+    const Node& node = nodes[index];
+    const ReachTable& table = tableFor(node.launch);
+
+    if (node.previous != NO_NODE)
+        result.push_back(node.previous);
+    if (node.next != NO_NODE)
+        result.push_back(node.next);
+
+    // Query in bands, each only as wide as the flight gets in it. A box
+    // reaching into a band from above was already seen in the band before.
+    bool firstBand = true;
+    for (int band = ReachTable::MIN_HOOK_DY; band <= table.getMaxDrop(); band += ReachTable::BAND_HEIGHT)
+    {
+        float width = table.bandWidth(band);
+        if (width <= 0)
+            continue;
+
+        sf::FloatRect area({node.left - width - HALF_WIDTH, node.y + static_cast<float>(band)},
+                           {node.right - node.left + 2.0f * (width + HALF_WIDTH), static_cast<float>(ReachTable::BAND_HEIGHT)});
+        auto seenBefore = [&](const sf::FloatRect& bounds)
+        {
+            return !firstBand && bounds.position.y < area.position.y;
+        };
+
+        footholdGrid.query(area, [&](std::uint32_t i)
+        {
+            const Foothold& foothold = footholds[i];
+            const sf::FloatRect& bounds = foothold.bounds;
+            if (seenBefore(bounds))
+                return;
+
+            float left = bounds.position.x;
+            float right = left + bounds.size.x;
+
+            // Landing: feet meet the top while the hitbox overlaps it
+            if (foothold.stand != index)
+            {
+                int dy = static_cast<int>(std::lround(bounds.position.y - BELOW - node.y));
+                if (table.at(dy) >= gapBetween(node.left, node.right, left - HALF_WIDTH, right + HALF_WIDTH))
+                    result.push_back(foothold.stand);
+            }
+
+            if (foothold.anchor != NO_NODE && foothold.anchor != index)
+            {
+                int dy = static_cast<int>(std::lround(bounds.position.y + bounds.size.y - node.y));
+                if (table.hookReach(dy) >= gapBetween(node.left, node.right, left, right))
+                    result.push_back(foothold.anchor);
+            }
+        });
+
+        itemGrid.query(area, [&](std::uint32_t i)
+        {
+            const sf::FloatRect& bounds = items[i].bounds;
+            if (seenBefore(bounds))
+                return;
+
+            // Any overlap of hitbox and pickup collects it
+            int from = static_cast<int>(std::floor(bounds.position.y - BELOW - node.y));
+            int to = static_cast<int>(std::ceil(bounds.position.y + bounds.size.y + ABOVE - node.y));
+            float gap = gapBetween(node.left, node.right, bounds.position.x - HALF_WIDTH, bounds.position.x + bounds.size.x + HALF_WIDTH);
+            if (table.maxOver(from, to) >= gap)
+                result.push_back(static_cast<std::uint32_t>(nodes.size() + i));
+        });
+
+        firstBand = false;
+    }
+}
+
+void LevelGraph::buildEdges()
+{
+    std::size_t chunkCount = (nodes.size() + CHUNK_SIZE - 1) / CHUNK_SIZE;
+    std::vector<std::vector<std::size_t>> chunkCounts(chunkCount);
+    std::vector<std::vector<std::uint32_t>> chunkEdges(chunkCount);
+
+    // Nodes only read the grids and tables, so chunks of them are handed out
+    // to every thread until none are left
+    std::atomic<std::size_t> nextChunk{0};
+    auto work = [&]()
+    {
+        std::vector<std::uint32_t> found;
+        for (std::size_t chunk = nextChunk++; chunk < chunkCount; chunk = nextChunk++)
+        {
+            std::size_t end = std::min(nodes.size(), (chunk + 1) * CHUNK_SIZE);
+            for (std::size_t node = chunk * CHUNK_SIZE; node < end; ++node)
+            {
+                found.clear();
+                findEdges(static_cast<std::uint32_t>(node), found);
+                chunkCounts[chunk].push_back(found.size());
+                chunkEdges[chunk].insert(chunkEdges[chunk].end(), found.begin(), found.end());
+            }
+        }
+    };
+
+    unsigned workers = options.threadCount ? options.threadCount : std::max(1u, std::thread::hardware_concurrency());
+    workers = static_cast<unsigned>(std::min<std::size_t>(workers, std::max<std::size_t>(chunkCount, 1)));
+
+    std::vector<std::thread> threads;
+    threads.reserve(workers - 1);
+    for (unsigned i = 1; i < workers; ++i)
+    {
+        threads.emplace_back(work);
+    }
+    work();
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+
+    edgeStart.assign(1, 0);
+    edgeStart.reserve(nodes.size() + 1);
+    edges.clear();
+    for (std::size_t chunk = 0; chunk < chunkCount; ++chunk)
+    {
+        for (std::size_t count : chunkCounts[chunk])
+        {
+            edgeStart.push_back(edgeStart.back() + count);
+        }
+        edges.insert(edges.end(), chunkEdges[chunk].begin(), chunkEdges[chunk].end());
+    }
+}
+
+ReachReport LevelGraph::analyze() const
+{
+    std::vector<bool> visited(nodes.size(), false);
+    std::vector<bool> collected(items.size(), false);
+    std::deque<std::uint32_t> queue(startNodes.begin(), startNodes.end());
+    for (std::uint32_t node : startNodes)
+    {
+        visited[node] = true;
+    }
+
+    while (!queue.empty())
+    {
+        std::uint32_t node = queue.front();
+        queue.pop_front();
+
+        for (std::size_t e = edgeStart[node]; e < edgeStart[node + 1]; ++e)
+        {
+            std::uint32_t target = edges[e];
+            if (target < nodes.size())
+            {
+                if (!visited[target])
+                {
+                    visited[target] = true;
+                    queue.push_back(target);
+                }
+                continue;
+            }
+
+            std::size_t item = target - nodes.size();
+            if (collected[item])
+                continue;
+            collected[item] = true;
+
+            // Dying after a checkpoint drops the player in at it again
+            std::uint32_t respawn = items[item].respawn;
+            if (respawn != NO_NODE && !visited[respawn])
+            {
+                visited[respawn] = true;
+                queue.push_back(respawn);
+            }
+        }
+    }
+
+    ReachReport report;
+    for (std::size_t i = 0; i < items.size(); ++i)
+    {
+        switch (items[i].type)
+        {
+            case MapObjectType::Checkpoint:
+                report.checkpoints++;
+                report.checkpointsReached += collected[i];
+                break;
+            case MapObjectType::Win:
+                report.wins++;
+                report.winsReached += collected[i];
+                break;
+            default:
+                report.coins++;
+                report.coinsReached += collected[i];
+                break;
+        }
+
+        if (!collected[i])
+            report.unreached.push_back(items[i].object);
+    }
+    return report;
+}
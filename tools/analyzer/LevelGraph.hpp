@@ -0,0 +1,124 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include "ReachTable.hpp"
+#include "SpatialGrid.hpp"
+#include "core/MapParser.hpp"
+#include "net/Protocol.hpp"
+
+struct AnalyzerOptions
+{
+    // Steps per second the movement envelopes are taken at; races tick at
+    // TICK_RATE, single player at the display's frame rate
+    float frameRate = static_cast<float>(TICK_RATE);
+    // Deepest single fall followed, in pixels
+    int maxDrop = 2000;
+    // 0 picks the hardware thread count
+    unsigned threadCount = 0;
+};
+
+struct ReachReport
+{
+    std::size_t coins = 0;
+    std::size_t coinsReached = 0;
+    std::size_t checkpoints = 0;
+    std::size_t checkpointsReached = 0;
+    std::size_t wins = 0;
+    std::size_t winsReached = 0;
+    // Indices into the map's objects
+    std::vector<std::size_t> unreached;
+
+    bool isCompletable() const { return wins > 0 && winsReached == wins && unreached.empty(); }
+};
+
+// Which platforms the player can get between, and which pickups it can
+// touch, from the map alone.
+//
+// Nodes are the ways a flight starts: standing on a platform or the ground,
+// hanging from a floating platform by the hook, or dropping in on spawn and
+// at a checkpoint's respawn point. Edges come from the ReachTable of each
+// kind, so they cover every jump, swing and fall the movement constants allow
+// but ignore whatever is in the way. Moving platforms are sampled along their
+// path and riding one links the samples. Unreachable therefore means no way
+// through exists; reachable means one may.
+class LevelGraph
+{
+public:
+    static constexpr std::uint32_t NO_NODE = 0xFFFFFFFF;
+    // Spacing of the samples along a moving platform's path
+    static constexpr float PATH_STEP = 16.0f;
+
+    explicit LevelGraph(const AnalyzerOptions& options);
+
+    // Builds the nodes and the spatial index, then the edges on all threads
+    void build(const MapData& map);
+    // Walks the graph from spawn
+    ReachReport analyze() const;
+
+    std::size_t getNodeCount() const { return nodes.size(); }
+    std::size_t getEdgeCount() const { return edges.size(); }
+
+private:
+    enum class Launch : std::uint8_t
+    {
+        Stand,
+        Swing,
+        Drop
+    };
+
+    // Where a flight can start: hook point x anywhere in [left, right] at y
+    struct Node
+    {
+        float left;
+        float right;
+        float y;
+        Launch launch;
+        // Neighbouring samples of a moving platform
+        std::uint32_t previous;
+        std::uint32_t next;
+    };
+
+    // Something to land on, and to hook if it floats
+    struct Foothold
+    {
+        sf::FloatRect bounds;
+        std::uint32_t stand;
+        std::uint32_t anchor;
+    };
+
+    struct Item
+    {
+        sf::FloatRect bounds;
+        std::size_t object;
+        MapObjectType type;
+        // Drop node of a checkpoint's respawn point
+        std::uint32_t respawn;
+    };
+
+    AnalyzerOptions options;
+    ReachTable jumpTable;
+    ReachTable swingTable;
+    ReachTable fallTable;
+
+    std::vector<Node> nodes;
+    std::vector<Foothold> footholds;
+    std::vector<Item> items;
+    std::vector<std::uint32_t> startNodes;
+    SpatialGrid footholdGrid;
+    SpatialGrid itemGrid;
+
+    // Edges of node i are edges[edgeStart[i]] up to edges[edgeStart[i + 1]].
+    // Targets past the last node are items.
+    std::vector<std::size_t> edgeStart;
+    std::vector<std::uint32_t> edges;
+
+    const ReachTable& tableFor(Launch launch) const;
+    std::uint32_t addNode(float left, float right, float y, Launch launch);
+    std::uint32_t addDrop(const sf::Vector2f& spritePosition);
+    void addFoothold(const sf::FloatRect& bounds, bool floating);
+    void addPath(float x, float y, const sf::Vector2f& from, const sf::Vector2f& to);
+    void addItem(const MapObject& object, std::size_t index);
+
+    void findEdges(std::uint32_t node, std::vector<std::uint32_t>& result) const;
+    void buildEdges();
+};
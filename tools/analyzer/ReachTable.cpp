@@ -0,0 +1,204 @@
+#include "ReachTable.hpp"
+#include "core/LevelBuilder.hpp"
+#include "core/Physics.hpp"
+#include "game/Hook.hpp"
+#include "game/Player.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <utility>
+
+namespace
+{
+    constexpr int HOOK_RANGE = static_cast<int>(Hook::MAX_HOOK_RANGE);
+    constexpr int HOOK_MIN_DY = ReachTable::MIN_HOOK_DY;
+    constexpr int BAND_PADDING = 72;
+
+    // Swing releases tried per anchor: every angle step, rope length step
+    // and speed, in both directions along the rope's tangent
+    constexpr float SWING_ANGLE_STEP = 2.0f;
+    constexpr float SWING_LENGTH_STEP = 8.0f;
+    constexpr int SWING_SPEED_STEPS = 4;
+}
+
+ReachTable::ReachTable(int maxDrop)
+    : maxDrop(maxDrop),
+      reach(static_cast<std::size_t>(maxDrop - MIN_DY + 1), -std::numeric_limits<float>::infinity()),
+      hook(static_cast<std::size_t>(maxDrop - HOOK_MIN_DY + 1), -1.0f)
+{
+}
+
+ReachTable ReachTable::jump(float frameTime, int maxDrop)
+{
+    ReachTable table(maxDrop);
+    table.addFlight(frameTime, 0, 0, Player::MOVE_SPEED, Player::JUMP_FORCE);
+    table.finish();
+    return table;
+}
+
+ReachTable ReachTable::fall(float frameTime, int maxDrop)
+{
+    ReachTable table(maxDrop);
+    table.addFlight(frameTime, 0, 0, 0, 0);
+    table.finish();
+    return table;
+}
+
+ReachTable ReachTable::swing(float frameTime, int maxDrop)
+{
+    ReachTable table(maxDrop);
+    const float degrees = 3.14159265f / 180.0f;
+
+    for (float angle = -Hook::MAX_ROPE_ANGLE; angle <= Hook::MAX_ROPE_ANGLE; angle += SWING_ANGLE_STEP)
+    {
+        // 0 is straight down from the anchor
+        float sine = std::sin(angle * degrees);
+        float cosine = std::cos(angle * degrees);
+
+        for (float length = SWING_LENGTH_STEP; length <= Hook::MAX_ROPE_LENGTH; length += SWING_LENGTH_STEP)
+        {
+            float x = length * sine;
+            float y = length * cosine;
+            table.addFlight(frameTime, x, y, 0, 0);
+
+            for (int step = 1; step <= SWING_SPEED_STEPS; ++step)
+            {
+                float speed = Player::MAX_SWING_SPEED * step / SWING_SPEED_STEPS;
+                table.addFlight(frameTime, x, y, speed * cosine, -speed * sine);
+                table.addFlight(frameTime, x, y, -speed * cosine, speed * sine);
+            }
+        }
+    }
+
+    table.finish();
+    return table;
+}
+
+void ReachTable::addFlight(float frameTime, float x, float y, float vx, float vy)
+{
+    record(y, y, x);
+
+    while (y <= maxDrop)
+    {
+        // Holding the key sets the speed outright, so it only pays once air
+        // friction has slowed a faster release below it
+        if (vx < Player::MOVE_SPEED)
+            vx = Player::MOVE_SPEED;
+
+        vy = std::min(vy + Physics::GRAVITY * frameTime, Physics::MAX_FALL_SPEED);
+        float nextX = x + vx * frameTime;
+        float nextY = y + vy * frameTime;
+        record(y, nextY, nextX);
+
+        x = nextX;
+        y = nextY;
+        vx *= Physics::AIR_FRICTION;
+    }
+}
+
+void ReachTable::record(float fromY, float toY, float x)
+{
+    int low = static_cast<int>(std::ceil(std::min(fromY, toY)));
+    int high = static_cast<int>(std::floor(std::max(fromY, toY)));
+    if (low > high)
+        low = high = static_cast<int>(std::lround(toY));
+
+    low = std::max(low, MIN_DY);
+    high = std::min(high, maxDrop);
+    for (int dy = low; dy <= high; ++dy)
+    {
+        float& best = reach[static_cast<std::size_t>(dy - MIN_DY)];
+        best = std::max(best, x);
+    }
+}
+
+void ReachTable::finish()
+{
+    // Anything reached counts from the start column on, the player can
+    // always hold back
+    for (float& value : reach)
+    {
+        value = std::isinf(value) ? -1.0f : std::max(value, 0.0f);
+    }
+
+    runMax.assign(1, reach);
+    for (std::size_t run = 2; run <= reach.size(); run *= 2)
+    {
+        const std::vector<float>& half = runMax.back();
+        std::vector<float> level(reach.size() - run + 1);
+        for (std::size_t i = 0; i < level.size(); ++i)
+        {
+            level[i] = std::max(half[i], half[i + run / 2]);
+        }
+        runMax.push_back(std::move(level));
+    }
+
+    // The hook only bites platforms whose top is above the hook point and
+    // flies MAX_HOOK_RANGE; every floating platform is PLATFORM_HEIGHT tall
+    const int height = static_cast<int>(LevelBuilder::PLATFORM_HEIGHT);
+    for (int underside = HOOK_MIN_DY; underside <= maxDrop; ++underside)
+    {
+        float best = -1.0f;
+        int last = std::min(underside + HOOK_RANGE, maxDrop);
+        for (int dy = std::max(underside - height + 1, MIN_DY); dy <= last; ++dy)
+        {
+            float sideways = at(dy);
+            if (sideways < 0)
+                continue;
+
+            float below = static_cast<float>(std::max(0, dy - underside));
+            best = std::max(best, sideways + std::sqrt(Hook::MAX_HOOK_RANGE * Hook::MAX_HOOK_RANGE - below * below));
+        }
+        hook[static_cast<std::size_t>(underside - HOOK_MIN_DY)] = best;
+    }
+
+    bands.clear();
+    for (int band = HOOK_MIN_DY; band <= maxDrop; band += BAND_HEIGHT)
+    {
+        float width = 0;
+        for (int dy = band - BAND_PADDING; dy < band + BAND_HEIGHT + BAND_PADDING; ++dy)
+        {
+            width = std::max({width, at(dy), hookReach(dy)});
+        }
+        bands.push_back(width);
+    }
+}
+
+float ReachTable::at(int dy) const
+{
+    if (dy < MIN_DY || dy > maxDrop)
+        return -1.0f;
+    return reach[static_cast<std::size_t>(dy - MIN_DY)];
+}
+
+float ReachTable::maxOver(int from, int to) const
+{
+    from = std::max(from, MIN_DY);
+    to = std::min(to, maxDrop);
+    if (from > to)
+        return -1.0f;
+
+    // Two runs of the largest power of two that fits cover the range
+    std::size_t first = static_cast<std::size_t>(from - MIN_DY);
+    std::size_t count = static_cast<std::size_t>(to - from + 1);
+    std::size_t level = 0;
+    while ((std::size_t(2) << level) <= count)
+    {
+        ++level;
+    }
+    return std::max(runMax[level][first], runMax[level][first + count - (std::size_t(1) << level)]);
+}
+
+float ReachTable::hookReach(int dy) const
+{
+    if (dy < HOOK_MIN_DY || dy > maxDrop)
+        return -1.0f;
+    return hook[static_cast<std::size_t>(dy - HOOK_MIN_DY)];
+}
+
+float ReachTable::bandWidth(int dy) const
+{
+    if (dy < HOOK_MIN_DY || dy > maxDrop)
+        return 0;
+    return bands[static_cast<std::size_t>((dy - HOOK_MIN_DY) / BAND_HEIGHT)];
+}
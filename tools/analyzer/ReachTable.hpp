@@ -0,0 +1,57 @@
+#pragma once
+#include <vector>
+#include "game/Hook.hpp"
+
+// How far sideways the player's hook point can get from where a flight
+// starts, for every whole pixel of height it passes through. Flights are
+// stepped frame by frame in the same order Simulation::step applies input,
+// gravity, movement and air friction, with the direction key held whenever
+// that is faster than coasting, so the table is the exact envelope at that
+// frame rate. Heights are screen y, so positive dy is below the start.
+class ReachTable
+{
+public:
+    // Highest a swing release can carry the player above its anchor, with
+    // room to spare
+    static constexpr int MIN_DY = -1024;
+    // Platforms the hook can reach start this far above
+    static constexpr int MIN_HOOK_DY = MIN_DY - static_cast<int>(Hook::MAX_HOOK_RANGE);
+    static constexpr int BAND_HEIGHT = 256;
+
+    // Standing and jumping, or walking off the edge, which reaches no farther
+    static ReachTable jump(float frameTime, int maxDrop);
+    // Dropped in mid-air with no speed, as on spawn and respawn
+    static ReachTable fall(float frameTime, int maxDrop);
+    // Released anywhere on a rope up to Hook::MAX_ROPE_LENGTH long, swung as
+    // far as Hook::MAX_ROPE_ANGLE at up to Player::MAX_SWING_SPEED. dy is
+    // measured from the anchor.
+    static ReachTable swing(float frameTime, int maxDrop);
+
+    // Negative when the flight never gets to that height
+    float at(int dy) const;
+    // Best of at() over [from, to]
+    float maxOver(int from, int to) const;
+    // Largest horizontal gap to a floating platform the hook can still
+    // reach, for a platform whose underside is dy from the start
+    float hookReach(int dy) const;
+    // Widest the flight or its hook gets in the BAND_HEIGHT rows from dy,
+    // padded both ways by a pickup and the hitbox, for spatial queries.
+    // Bands start at MIN_HOOK_DY.
+    float bandWidth(int dy) const;
+
+    int getMaxDrop() const { return maxDrop; }
+
+private:
+    int maxDrop;
+    std::vector<float> reach;
+    // runMax[k][i] is the best of reach[i] up to reach[i + 2^k - 1]
+    std::vector<std::vector<float>> runMax;
+    std::vector<float> hook;
+    std::vector<float> bands;
+
+    explicit ReachTable(int maxDrop);
+
+    void addFlight(float frameTime, float x, float y, float vx, float vy);
+    void record(float fromY, float toY, float x);
+    void finish();
+};
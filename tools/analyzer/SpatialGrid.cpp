@@ -0,0 +1,78 @@
+#include "SpatialGrid.hpp"
+
+SpatialGrid::SpatialGrid(float cellSize)
+    : cellSize(cellSize), origin(0, 0), columns(0), rows(0)
+{
+}
+
+SpatialGrid::CellRange SpatialGrid::computeRange(const sf::FloatRect& bounds) const
+{
+    return {static_cast<int>(std::floor((bounds.position.x - origin.x) / cellSize)),
+            static_cast<int>(std::floor((bounds.position.y - origin.y) / cellSize)),
+            static_cast<int>(std::floor((bounds.position.x + bounds.size.x - origin.x) / cellSize)),
+            static_cast<int>(std::floor((bounds.position.y + bounds.size.y - origin.y) / cellSize))};
+}
+
+void SpatialGrid::build(const std::vector<sf::FloatRect>& boxes_)
+{
+    boxes = boxes_;
+    ranges.clear();
+    cellStart.clear();
+    entries.clear();
+    columns = rows = 0;
+    if (boxes.empty())
+        return;
+
+    sf::Vector2f low = boxes[0].position;
+    sf::Vector2f high = boxes[0].position + boxes[0].size;
+    for (const auto& box : boxes)
+    {
+        low.x = std::min(low.x, box.position.x);
+        low.y = std::min(low.y, box.position.y);
+        high.x = std::max(high.x, box.position.x + box.size.x);
+        high.y = std::max(high.y, box.position.y + box.size.y);
+    }
+
+    origin = low;
+    auto cellsAcross = [&](float extent) { return static_cast<std::size_t>(extent / cellSize) + 1; };
+    while (cellsAcross(high.x - low.x) * cellsAcross(high.y - low.y) > MAX_CELLS)
+    {
+        cellSize *= 2.0f;
+    }
+    columns = static_cast<int>(cellsAcross(high.x - low.x));
+    rows = static_cast<int>(cellsAcross(high.y - low.y));
+
+    // Count, then fill each cell's slice of entries
+    ranges.reserve(boxes.size());
+    cellStart.assign(static_cast<std::size_t>(columns) * rows + 1, 0);
+    for (const auto& box : boxes)
+    {
+        CellRange range = computeRange(box);
+        ranges.push_back(range);
+        for (int y = range.minY; y <= range.maxY; ++y)
+        {
+            for (int x = range.minX; x <= range.maxX; ++x)
+            {
+                cellStart[static_cast<std::size_t>(y) * columns + x + 1]++;
+            }
+        }
+    }
+    for (std::size_t cell = 1; cell < cellStart.size(); ++cell)
+    {
+        cellStart[cell] += cellStart[cell - 1];
+    }
+
+    entries.resize(cellStart.back());
+    std::vector<std::uint32_t> fill(cellStart.begin(), cellStart.end() - 1);
+    for (std::size_t i = 0; i < ranges.size(); ++i)
+    {
+        const CellRange& range = ranges[i];
+        for (int y = range.minY; y <= range.maxY; ++y)
+        {
+            for (int x = range.minX; x <= range.maxX; ++x)
+            {
+                entries[fill[static_cast<std::size_t>(y) * columns + x]++] = static_cast<std::uint32_t>(i);
+            }
+        }
+    }
+}
@@ -0,0 +1,73 @@
+#pragma once
+#include <SFML/Graphics.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+// Uniform grid built once over a fixed set of boxes and stored as one flat
+// array per cell row. Unlike the game's Broadphase a query keeps no state, so
+// any number of threads can query one grid at the same time.
+class SpatialGrid
+{
+public:
+    // The cell size grows past this if the map would need more cells
+    static constexpr std::size_t MAX_CELLS = 1 << 22;
+
+    explicit SpatialGrid(float cellSize = 256.0f);
+
+    void build(const std::vector<sf::FloatRect>& boxes_);
+
+    // Calls visit(index) once for every box overlapping area
+    template <typename Visit>
+    void query(const sf::FloatRect& area, Visit&& visit) const
+    {
+        if (columns == 0)
+            return;
+
+        CellRange range = computeRange(area);
+        range.minX = std::max(range.minX, 0);
+        range.minY = std::max(range.minY, 0);
+        range.maxX = std::min(range.maxX, columns - 1);
+        range.maxY = std::min(range.maxY, rows - 1);
+
+        for (int y = range.minY; y <= range.maxY; ++y)
+        {
+            for (int x = range.minX; x <= range.maxX; ++x)
+            {
+                std::size_t cell = static_cast<std::size_t>(y) * columns + x;
+                for (std::uint32_t i = cellStart[cell]; i < cellStart[cell + 1]; ++i)
+                {
+                    // A box spanning several cells is reported from the first
+                    // cell it shares with the query only
+                    std::uint32_t index = entries[i];
+                    const CellRange& cells = ranges[index];
+                    if (x != std::max(cells.minX, range.minX) || y != std::max(cells.minY, range.minY))
+                        continue;
+                    if (boxes[index].findIntersection(area))
+                        visit(index);
+                }
+            }
+        }
+    }
+
+private:
+    struct CellRange
+    {
+        int minX;
+        int minY;
+        int maxX;
+        int maxY;
+    };
+
+    float cellSize;
+    sf::Vector2f origin;
+    int columns;
+    int rows;
+    std::vector<sf::FloatRect> boxes;
+    std::vector<CellRange> ranges;
+    std::vector<std::uint32_t> cellStart;
+    std::vector<std::uint32_t> entries;
+
+    CellRange computeRange(const sf::FloatRect& bounds) const;
+};
@@ -0,0 +1,157 @@
+// hookleap_analyzer: checks that every coin, checkpoint and the win pickup of
+// a map can be reached from spawn, without playing it
+//
+//   hookleap_analyzer assets/maps/stress.txt
+//
+// Exits with 0 when everything is reachable, 2 when something is not.
+#include "LevelGraph.hpp"
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+    double msSince(Clock::time_point start)
+    {
+        return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    }
+
+    const char* typeName(MapObjectType type)
+    {
+        switch (type)
+        {
+            case MapObjectType::Checkpoint:
+                return "checkpoint";
+            case MapObjectType::Win:
+                return "win";
+            default:
+                return "pickup";
+        }
+    }
+
+    void printUsage()
+    {
+        std::cerr << "Usage: hookleap_analyzer [options] map.txt\n"
+                  << "  --fps F         simulation steps per second to check at (default " << TICK_RATE << ", the race tick)\n"
+                  << "  --max-drop N    deepest single fall followed, in pixels (default 2000)\n"
+                  << "  --threads N     worker threads, 0 for one per core (default 0)\n"
+                  << "  --list N        unreachable pickups to print (default 20)\n";
+    }
+}
+
+int main(int argc, char** argv)
+{
+    AnalyzerOptions options;
+    std::size_t listCount = 20;
+    std::string mapFile;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string arg = argv[i];
+        if (arg == "--help" || arg == "-h")
+        {
+            printUsage();
+            return 0;
+        }
+
+        if (arg.rfind("--", 0) != 0)
+        {
+            mapFile = arg;
+            continue;
+        }
+
+        if (i + 1 >= argc)
+        {
+            std::cerr << "Missing value for " << arg << std::endl;
+            printUsage();
+            return 1;
+        }
+        const char* value = argv[++i];
+
+        if (arg == "--fps")
+            options.frameRate = std::strtof(value, nullptr);
+        else if (arg == "--max-drop")
+            options.maxDrop = std::atoi(value);
+        else if (arg == "--threads")
+            options.threadCount = static_cast<unsigned>(std::strtoul(value, nullptr, 10));
+        else if (arg == "--list")
+            listCount = static_cast<std::size_t>(std::strtoull(value, nullptr, 10));
+        else
+        {
+            std::cerr << "Unknown option: " << arg << std::endl;
+            printUsage();
+            return 1;
+        }
+    }
+
+    if (mapFile.empty())
+    {
+        printUsage();
+        return 1;
+    }
+
+    if (options.frameRate < 1 || options.maxDrop < 1)
+    {
+        std::cerr << "Frame rate and max drop must be positive" << std::endl;
+        return 1;
+    }
+
+    auto start = Clock::now();
+    MapData map;
+    MapParser parser;
+    if (!parser.loadFile(mapFile, map))
+    {
+        std::cerr << "Could not load map: " << mapFile << std::endl;
+        for (const auto& error : parser.getErrors())
+        {
+            std::cerr << "  line " << error.line << ":" << error.column << ": " << error.message << std::endl;
+        }
+        return 1;
+    }
+    double loadMs = msSince(start);
+
+    start = Clock::now();
+    LevelGraph graph(options);
+    double tableMs = msSince(start);
+
+    start = Clock::now();
+    graph.build(map);
+    double buildMs = msSince(start);
+
+    start = Clock::now();
+    ReachReport report = graph.analyze();
+    double analyzeMs = msSince(start);
+
+    std::cout << std::fixed << std::setprecision(1)
+              << mapFile << ": " << map.objects.size() << " objects, "
+              << graph.getNodeCount() << " nodes, " << graph.getEdgeCount() << " edges\n"
+              << "  load " << loadMs << " ms, envelopes " << tableMs << " ms, graph " << buildMs
+              << " ms, search " << analyzeMs << " ms\n"
+              << "  coins " << report.coinsReached << "/" << report.coins
+              << ", checkpoints " << report.checkpointsReached << "/" << report.checkpoints
+              << ", win " << report.winsReached << "/" << report.wins << "\n";
+
+    for (std::size_t i = 0; i < report.unreached.size() && i < listCount; ++i)
+    {
+        const MapObject& object = map.objects[report.unreached[i]];
+        std::cout << "  unreachable " << typeName(object.type) << " at "
+                  << object.x() << " " << object.y() << "\n";
+    }
+    if (report.unreached.size() > listCount)
+        std::cout << "  ... and " << report.unreached.size() - listCount << " more\n";
+
+    if (report.wins == 0)
+        std::cout << "No win pickup, the map cannot be finished" << std::endl;
+    else if (report.isCompletable())
+        std::cout << "Everything is reachable" << std::endl;
+    else
+        std::cout << (report.winsReached == report.wins ? "The win is reachable, some pickups are not"
+                                                        : "The win is not reachable")
+                  << std::endl;
+
+    return report.isCompletable() ? 0 : 2;
+}
@@ -0,0 +1,314 @@
+#include "RouteSearch.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <numeric>
+#include <thread>
+#include <unordered_map>
+
+namespace
+{
+    // A region of REGION_SIZE cells a side holds at most 1/REGION_SHARE of
+    // the beam, so it cannot all crowd onto one ledge
+    constexpr int REGION_SIZE = 4;
+    constexpr std::size_t REGION_SHARE = 16;
+    // With moving platforms waiting can pay off, so states are told apart by
+    // this much level time as well
+    constexpr float WAIT_STEP = 0.5f;
+
+    // Velocity buckets of the state key
+    constexpr float SPEED_STEP_X = 50.0f;
+    constexpr float SPEED_STEP_Y = 100.0f;
+
+    std::uint64_t field(int value, int bits)
+    {
+        return static_cast<std::uint64_t>(value) & ((std::uint64_t(1) << bits) - 1);
+    }
+
+    // splitmix64 finalizer
+    std::uint64_t mix(std::uint64_t value)
+    {
+        value ^= value >> 30;
+        value *= 0xBF58476D1CE4E5B9ull;
+        value ^= value >> 27;
+        value *= 0x94D049BB133111EBull;
+        return value ^ (value >> 31);
+    }
+}
+
+RouteSearch::RouteSearch(const Simulation& start, const sf::Vector2f& target, const SearchOptions& options)
+    : options(options), target(target), hasMovingPlatforms(false), won(false), bestTrace(NO_TRACE),
+      lastTicks(0), decisions(0), branchCount(0), bestDistance(0)
+{
+    if (this->options.threadCount == 0)
+        this->options.threadCount = std::max(1u, std::thread::hardware_concurrency());
+
+    const auto& platforms = start.getPhysics().getPlatforms();
+    hasMovingPlatforms = std::any_of(platforms.begin(), platforms.end(),
+                                     [](const std::shared_ptr<Platform>& platform) { return platform->isKinematic(); });
+
+    beam.push_back({std::make_unique<Simulation>(start), NO_TRACE});
+    reached.insert(stateKey(start));
+    sf::Vector2f offset = target - playerCenter(start);
+    bestDistance = std::hypot(offset.x, offset.y);
+}
+
+float RouteSearch::getTime() const
+{
+    int ticks = decisions == 0 ? 0 : static_cast<int>(decisions - 1) * options.decisionTicks + lastTicks;
+    return static_cast<float>(ticks) * options.tickTime;
+}
+
+bool RouteSearch::advance()
+{
+    if (won || beam.empty())
+        return false;
+    if (static_cast<float>(decisions * options.decisionTicks) * options.tickTime >= options.maxTime)
+        return false;
+
+    std::vector<Candidate> candidates;
+    for (std::uint32_t branch = 0; branch < beam.size(); ++branch)
+    {
+        addCandidates(branch, candidates);
+    }
+
+    parallelFor(candidates.size(), [&](std::size_t i) { evaluate(candidates[i]); });
+    branchCount += candidates.size();
+    decisions++;
+
+    // Every candidate ran the same number of ticks, so the earliest win is
+    // the fastest route
+    const Candidate* winner = nullptr;
+    for (const Candidate& candidate : candidates)
+    {
+        if (candidate.winTick >= 0 && (!winner || candidate.winTick < winner->winTick))
+            winner = &candidate;
+    }
+    if (winner)
+    {
+        traces.push_back({beam[winner->branch].trace, winner->input});
+        bestTrace = static_cast<std::uint32_t>(traces.size() - 1);
+        lastTicks = winner->winTick + 1;
+        bestDistance = 0;
+        won = true;
+        return false;
+    }
+
+    std::vector<std::uint32_t> order(candidates.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&](std::uint32_t a, std::uint32_t b)
+    {
+        return candidates[a].distance < candidates[b].distance;
+    });
+
+    // Closest first, so of the candidates sharing a new state the closest keeps it
+    std::size_t regionLimit = std::max<std::size_t>(1, options.beamWidth / REGION_SHARE);
+    std::unordered_map<std::uint64_t, std::size_t> regionCounts;
+    std::vector<std::uint32_t> kept;
+    for (std::uint32_t index : order)
+    {
+        if (kept.size() >= options.beamWidth)
+            break;
+
+        const Candidate& candidate = candidates[index];
+        if (candidate.died || reached.count(candidate.key) != 0)
+            continue;
+        if (++regionCounts[candidate.region] > regionLimit)
+            continue;
+
+        reached.insert(candidate.key);
+        kept.push_back(index);
+    }
+
+    std::vector<Branch> next(kept.size());
+    for (std::size_t i = 0; i < kept.size(); ++i)
+    {
+        const Candidate& candidate = candidates[kept[i]];
+        traces.push_back({beam[candidate.branch].trace, candidate.input});
+        next[i].trace = static_cast<std::uint32_t>(traces.size() - 1);
+    }
+
+    // Candidates were thrown away after scoring; stepping the survivors again
+    // is cheaper than keeping every copy
+    sf::Time elapsed = sf::seconds(options.tickTime);
+    parallelFor(kept.size(), [&](std::size_t i)
+    {
+        const Candidate& candidate = candidates[kept[i]];
+        next[i].simulation = std::make_unique<Simulation>(*beam[candidate.branch].simulation);
+        for (int tick = 0; tick < options.decisionTicks; ++tick)
+        {
+            next[i].simulation->step(candidate.input, elapsed);
+        }
+    });
+
+    beam = std::move(next);
+    if (!beam.empty())
+    {
+        bestTrace = beam.front().trace;
+        lastTicks = options.decisionTicks;
+        bestDistance = candidates[kept.front()].distance;
+    }
+    return !beam.empty();
+}
+
+void RouteSearch::getRoute(std::vector<InputState>& inputs) const
+{
+    inputs.clear();
+
+    std::vector<std::uint32_t> path;
+    for (std::uint32_t trace = bestTrace; trace != NO_TRACE; trace = traces[trace].parent)
+    {
+        path.push_back(trace);
+    }
+    std::reverse(path.begin(), path.end());
+
+    for (std::size_t i = 0; i < path.size(); ++i)
+    {
+        int ticks = i + 1 == path.size() ? lastTicks : options.decisionTicks;
+        inputs.insert(inputs.end(), static_cast<std::size_t>(ticks), traces[path[i]].input);
+    }
+
+    // Decisions only hold keys; presses and releases follow from the changes
+    std::uint16_t previous = 0;
+    for (InputState& input : inputs)
+    {
+        input.pressed = static_cast<std::uint16_t>(input.held & ~previous);
+        input.released = static_cast<std::uint16_t>(previous & ~input.held);
+        previous = input.held;
+    }
+}
+
+void RouteSearch::addCandidates(std::uint32_t branch, std::vector<Candidate>& candidates) const
+{
+    const Simulation& simulation = *beam[branch].simulation;
+    const Player& player = simulation.getPlayer();
+    sf::Vector2f center = playerCenter(simulation);
+
+    // The hook is only worth firing at the underside of a floating platform
+    // in range, as a player would aim it
+    std::vector<sf::Vector2f> aims;
+    if (player.getHook().getState() == HookState::Inactive)
+    {
+        sf::Vector2f origin = player.getPosition() + sf::Vector2f(Player::CENTER_OFFSET, Player::CENTER_OFFSET);
+        sf::FloatRect area(origin - sf::Vector2f(Hook::MAX_HOOK_RANGE, Hook::MAX_HOOK_RANGE),
+                           {2.0f * Hook::MAX_HOOK_RANGE, Hook::MAX_HOOK_RANGE});
+        std::vector<Platform*> platforms;
+        simulation.getPhysics().queryPlatforms(area, platforms);
+        for (const Platform* platform : platforms)
+        {
+            sf::FloatRect bounds = platform->getBounds();
+            sf::Vector2f aim(bounds.position.x + bounds.size.x / 2.0f, bounds.position.y + bounds.size.y);
+            sf::Vector2f offset = aim - origin;
+            if (platform->getType() == PlatformType::Floating && bounds.position.y < origin.y &&
+                std::hypot(offset.x, offset.y) < Hook::MAX_HOOK_RANGE)
+                aims.push_back(aim);
+        }
+    }
+
+    auto add = [&](std::uint16_t held, const sf::Vector2f& aim)
+    {
+        Candidate candidate{};
+        candidate.branch = branch;
+        candidate.input.held = held;
+        candidate.input.aim = aim;
+        candidate.winTick = -1;
+        candidates.push_back(candidate);
+    };
+
+    const std::uint16_t directions[] = {0, InputState::bit(Action::MoveLeft), InputState::bit(Action::MoveRight)};
+    for (std::uint16_t direction : directions)
+    {
+        add(direction, center);
+
+        // Jumping off the ground, or letting go of the rope
+        if (player.isOnGround() || player.isHooked())
+            add(static_cast<std::uint16_t>(direction | InputState::bit(Action::Jump)), center);
+
+        for (const sf::Vector2f& aim : aims)
+        {
+            add(static_cast<std::uint16_t>(direction | InputState::bit(Action::Hook)), aim);
+        }
+    }
+}
+
+void RouteSearch::evaluate(Candidate& candidate) const
+{
+    // The copy shares the static platforms and owns everything that moves
+    Simulation simulation(*beam[candidate.branch].simulation);
+    sf::Time elapsed = sf::seconds(options.tickTime);
+
+    for (int tick = 0; tick < options.decisionTicks; ++tick)
+    {
+        SimulationEvents events = simulation.step(candidate.input, elapsed);
+        if (events.won)
+        {
+            candidate.winTick = tick;
+            return;
+        }
+        if (events.died)
+        {
+            candidate.died = true;
+            return;
+        }
+    }
+
+    sf::Vector2f offset = target - playerCenter(simulation);
+    candidate.distance = std::hypot(offset.x, offset.y);
+    candidate.key = stateKey(simulation);
+
+    sf::Vector2f center = playerCenter(simulation);
+    float regionSize = options.cellSize * REGION_SIZE;
+    candidate.region = field(static_cast<int>(std::floor(center.x / regionSize)), 32) |
+                       field(static_cast<int>(std::floor(center.y / regionSize)), 32) << 32;
+}
+
+std::uint64_t RouteSearch::stateKey(const Simulation& simulation) const
+{
+    const Player& player = simulation.getPlayer();
+    sf::Vector2f center = playerCenter(simulation);
+    sf::Vector2f velocity = player.getVelocity();
+
+    int cellX = static_cast<int>(std::floor(center.x / options.cellSize));
+    int cellY = static_cast<int>(std::floor(center.y / options.cellSize));
+    int speedX = std::clamp(static_cast<int>(std::lround(velocity.x / SPEED_STEP_X)), -31, 31);
+    int speedY = std::clamp(static_cast<int>(std::lround(velocity.y / SPEED_STEP_Y)), -127, 127);
+
+    std::uint64_t key = field(cellX, 20) | field(cellY, 20) << 20 | field(speedX, 6) << 40 | field(speedY, 8) << 46 |
+                        field(static_cast<int>(player.getHook().getState()), 2) << 54 |
+                        field(player.isOnGround() ? 1 : 0, 1) << 56;
+    if (hasMovingPlatforms)
+        key = mix(key) ^ mix(static_cast<std::uint64_t>(simulation.getTime() / WAIT_STEP) + 1);
+    return key;
+}
+
+sf::Vector2f RouteSearch::playerCenter(const Simulation& simulation) const
+{
+    sf::FloatRect hitbox = simulation.getPlayer().getGlobalHitbox();
+    return hitbox.position + hitbox.size / 2.0f;
+}
+
+template <typename Work>
+void RouteSearch::parallelFor(std::size_t count, Work work) const
+{
+    std::atomic<std::size_t> nextIndex{0};
+    auto run = [&]()
+    {
+        for (std::size_t i = nextIndex++; i < count; i = nextIndex++)
+        {
+            work(i);
+        }
+    };
+
+    unsigned workers = static_cast<unsigned>(std::min<std::size_t>(options.threadCount, std::max<std::size_t>(count, 1)));
+    std::vector<std::thread> threads;
+    threads.reserve(workers - 1);
+    for (unsigned i = 1; i < workers; ++i)
+    {
+        threads.emplace_back(run);
+    }
+    run();
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+}
@@ -0,0 +1,102 @@
+#pragma once
+#include <cstdint>
+#include <memory>
+#include <unordered_set>
+#include <vector>
+#include "core/Simulation.hpp"
+
+struct SearchOptions
+{
+    // Seconds per simulation step, the race tick by default
+    float tickTime = 1.0f / 60.0f;
+    // Ticks one choice of input is held for
+    int decisionTicks = 6;
+    // Branches kept after every decision
+    std::size_t beamWidth = 2048;
+    // Size of the position cells a branch is told apart by
+    float cellSize = 16.0f;
+    // Level time after which the search gives up
+    float maxTime = 120.0f;
+    // 0 picks the hardware thread count
+    unsigned threadCount = 0;
+};
+
+// Beam search for the fastest input to the win pickup.
+//
+// Every decision each kept branch is copied once per choice of input -
+// direction, jump, firing the hook at a floating platform in range, letting
+// go - and the copy stepped decisionTicks ticks on a worker thread. Copies that
+// died are dropped, and so is any that lands in a state an earlier decision
+// already reached: the same position cell, a similar velocity and the same
+// hook state, and on levels with moving platforms the same half second. Of
+// the rest the beamWidth closest to the win are kept, a few per part of the
+// level. The first decision that touches the win gives the route.
+class RouteSearch
+{
+public:
+    RouteSearch(const Simulation& start, const sf::Vector2f& target, const SearchOptions& options);
+
+    // Runs one decision; false once the win is found or nothing is left
+    bool advance();
+
+    bool hasWon() const { return won; }
+    std::size_t getDecisionCount() const { return decisions; }
+    std::size_t getBeamSize() const { return beam.size(); }
+    std::uint64_t getBranchCount() const { return branchCount; }
+    float getBestDistance() const { return bestDistance; }
+    float getTime() const;
+
+    // Input of every tick up to the win, or to the closest branch so far
+    void getRoute(std::vector<InputState>& inputs) const;
+
+private:
+    static constexpr std::uint32_t NO_TRACE = 0xFFFFFFFF;
+
+    // One decision of a route; routes share their beginnings
+    struct Trace
+    {
+        std::uint32_t parent;
+        InputState input;
+    };
+
+    struct Branch
+    {
+        std::unique_ptr<Simulation> simulation;
+        std::uint32_t trace;
+    };
+
+    struct Candidate
+    {
+        std::uint32_t branch;
+        InputState input;
+        // Filled in by the workers
+        float distance;
+        std::uint64_t key;
+        std::uint64_t region;
+        int winTick;
+        bool died;
+    };
+
+    SearchOptions options;
+    sf::Vector2f target;
+    std::vector<Branch> beam;
+    std::vector<Trace> traces;
+    std::unordered_set<std::uint64_t> reached;
+    bool hasMovingPlatforms;
+
+    bool won;
+    std::uint32_t bestTrace;
+    int lastTicks;
+    std::size_t decisions;
+    std::uint64_t branchCount;
+    float bestDistance;
+
+    void addCandidates(std::uint32_t branch, std::vector<Candidate>& candidates) const;
+    void evaluate(Candidate& candidate) const;
+    std::uint64_t stateKey(const Simulation& simulation) const;
+    sf::Vector2f playerCenter(const Simulation& simulation) const;
+
+    // Calls work(i) for every i below count on all threads
+    template <typename Work>
+    void parallelFor(std::size_t count, Work work) const;
+};
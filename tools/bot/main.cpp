@@ -0,0 +1,215 @@
+// hookleap_bot: searches for a fast route through a map and writes it as a
+// replay the game can play back
+//
+//   hookleap_bot map1.txt
+//   HookLeap --replay replays/map1.replay
+//
+// Exits with 0 when a route to the win was found, 2 when none was.
+#include "RouteSearch.hpp"
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include "core/AssetLoader.hpp"
+#include "core/LevelBuilder.hpp"
+#include "core/Replay.hpp"
+#include "net/Protocol.hpp"
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+    double secondsSince(Clock::time_point start)
+    {
+        return std::chrono::duration<double>(Clock::now() - start).count();
+    }
+
+    void printUsage()
+    {
+        std::cerr << "Usage: hookleap_bot [options] map.txt\n"
+                  << "  map.txt is a map in assets/maps\n"
+                  << "  --beam N        branches kept after every decision (default 2048)\n"
+                  << "  --decision N    ticks each choice of input is held (default 6)\n"
+                  << "  --cell N        pixel size of the cells branches are told apart by (default 16)\n"
+                  << "  --max-time S    level seconds to search before giving up (default 120)\n"
+                  << "  --threads N     worker threads, 0 for one per core (default 0)\n"
+                  << "  --output FILE   replay to write (default replays/<map>.replay)\n"
+                  << "  --assets DIR    asset directory when no assets.pak is present (default assets)\n";
+    }
+
+    // Plays the route again from scratch, as the game will
+    bool verifyRoute(const Simulation& start, const std::vector<InputState>& inputs, float tickTime, float& time)
+    {
+        Simulation simulation(start);
+        sf::Time elapsed = sf::seconds(tickTime);
+        for (std::size_t i = 0; i < inputs.size(); ++i)
+        {
+            if (simulation.step(inputs[i], elapsed).won)
+            {
+                time = simulation.getTime();
+                return i + 1 == inputs.size();
+            }
+        }
+        return false;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    SearchOptions options;
+    options.tickTime = tickTime().asSeconds();
+    std::string mapFile;
+    std::string output;
+    std::string assetDirectory = AssetLoader::ASSET_DIRECTORY;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string arg = argv[i];
+        if (arg == "--help" || arg == "-h")
+        {
+            printUsage();
+            return 0;
+        }
+
+        if (arg.rfind("--", 0) != 0)
+        {
+            mapFile = arg;
+            continue;
+        }
+
+        if (i + 1 >= argc)
+        {
+            std::cerr << "Missing value for " << arg << std::endl;
+            printUsage();
+            return 1;
+        }
+        const char* value = argv[++i];
+
+        if (arg == "--beam")
+            options.beamWidth = static_cast<std::size_t>(std::strtoull(value, nullptr, 10));
+        else if (arg == "--decision")
+            options.decisionTicks = std::atoi(value);
+        else if (arg == "--cell")
+            options.cellSize = std::strtof(value, nullptr);
+        else if (arg == "--max-time")
+            options.maxTime = std::strtof(value, nullptr);
+        else if (arg == "--threads")
+            options.threadCount = static_cast<unsigned>(std::strtoul(value, nullptr, 10));
+        else if (arg == "--output")
+            output = value;
+        else if (arg == "--assets")
+            assetDirectory = value;
+        else
+        {
+            std::cerr << "Unknown option: " << arg << std::endl;
+            printUsage();
+            return 1;
+        }
+    }
+
+    if (mapFile.empty())
+    {
+        printUsage();
+        return 1;
+    }
+
+    if (options.beamWidth < 1 || options.decisionTicks < 1 || options.cellSize <= 0 || options.maxTime <= 0)
+    {
+        std::cerr << "Beam, decision ticks, cell size and max time must be positive" << std::endl;
+        return 1;
+    }
+
+    AssetLoader assets;
+    assets.open(AssetLoader::PACK_FILE, assetDirectory);
+
+    MapData map;
+    std::uint64_t mapHash = 0;
+    if (!assets.readMap(mapFile, map, mapHash))
+        return 1;
+
+    // Built like the race server's copy of a level, without art
+    sf::Texture emptyTexture;
+    LevelBuilder builder({&emptyTexture, &emptyTexture, &emptyTexture, &emptyTexture, &emptyTexture, &emptyTexture});
+    Simulation start(emptyTexture);
+    std::vector<Entity> entities;
+    builder.build(start, map, entities);
+    start.restart({LevelBuilder::SPAWN_X, LevelBuilder::SPAWN_Y});
+
+    // Aim for the nearest win pickup to spawn
+    const MapObject* win = nullptr;
+    float winDistance = 0;
+    for (const auto& object : map.objects)
+    {
+        if (object.type != MapObjectType::Win)
+            continue;
+        float distance = std::hypot(object.x() - LevelBuilder::SPAWN_X, object.y() - LevelBuilder::SPAWN_Y);
+        if (!win || distance < winDistance)
+        {
+            win = &object;
+            winDistance = distance;
+        }
+    }
+    if (!win)
+    {
+        std::cerr << mapFile << " has no win pickup" << std::endl;
+        return 1;
+    }
+    // Pickups are placed by their top left corner
+    sf::Vector2f target(win->x() + 16.0f, win->y() + 16.0f);
+
+    auto started = Clock::now();
+    RouteSearch search(start, target, options);
+    std::cout << std::fixed << std::setprecision(1);
+    while (search.advance())
+    {
+        if (search.getDecisionCount() % 50 == 0)
+        {
+            std::cout << "  " << search.getTime() << " s in, " << search.getBeamSize() << " branches, "
+                      << search.getBestDistance() << " px from the win" << std::endl;
+        }
+    }
+    double searchSeconds = secondsSince(started);
+
+    std::cout << mapFile << ": " << search.getBranchCount() << " branches in " << searchSeconds << " s, "
+              << std::setprecision(0) << search.getBranchCount() / std::max(searchSeconds, 1e-9) << " a second"
+              << std::setprecision(1) << std::endl;
+
+    if (!search.hasWon())
+    {
+        std::cout << "No route to the win found, closest " << search.getBestDistance() << " px" << std::endl;
+        return 2;
+    }
+
+    std::vector<InputState> route;
+    search.getRoute(route);
+    float time = 0;
+    if (!verifyRoute(start, route, options.tickTime, time))
+    {
+        std::cerr << "The route did not win when played again" << std::endl;
+        return 1;
+    }
+    std::cout << "Route wins in " << std::setprecision(2) << time << " s, " << route.size() << " ticks" << std::endl;
+
+    Replay replay;
+    replay.setMap(mapFile, mapHash);
+    replay.setTickTime(options.tickTime);
+    for (const InputState& input : route)
+    {
+        replay.add(input);
+    }
+
+    if (output.empty())
+    {
+        std::error_code error;
+        std::filesystem::create_directories("replays", error);
+        output = "replays/" + std::filesystem::path(mapFile).stem().string() + ".replay";
+    }
+    if (!replay.save(output))
+        return 1;
+
+    std::cout << "Wrote " << output << std::endl;
+    return 0;
+}
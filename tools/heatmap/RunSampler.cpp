@@ -0,0 +1,102 @@
+#include "RunSampler.hpp"
+#include <cmath>
+#include <random>
+
+namespace
+{
+    // Random play holds each choice this many ticks
+    constexpr int MIN_DECISION_TICKS = 6;
+    constexpr int MAX_DECISION_TICKS = 30;
+
+    sf::Vector2f hitboxCenter(const Player& player)
+    {
+        sf::FloatRect hitbox = player.getGlobalHitbox();
+        return hitbox.position + hitbox.size / 2.0f;
+    }
+}
+
+RunSampler::RunSampler(const Simulation& start, const SampleOptions& options)
+    : start(start), options(options)
+{
+}
+
+bool RunSampler::step(Simulation& simulation, const InputState& input, const sf::Time& elapsed, int tick,
+                      Heatmap& heatmap) const
+{
+    SimulationEvents events = simulation.step(input, elapsed);
+    for (const auto& effect : events.effects)
+    {
+        // The death effect is placed where the player was before respawning
+        if (effect.type == EffectType::PlayerDied)
+            heatmap.add(HeatmapLayer::Deaths, effect.position);
+        else if (effect.type == EffectType::HookAttached)
+            heatmap.add(HeatmapLayer::Hooks, effect.position);
+    }
+
+    if (tick % options.sampleTicks == 0)
+        heatmap.add(HeatmapLayer::Trajectory, hitboxCenter(simulation.getPlayer()));
+    return !events.won;
+}
+
+void RunSampler::addReplay(const Replay& replay, Heatmap& heatmap) const
+{
+    Simulation simulation(start);
+    sf::Time elapsed = sf::seconds(replay.getTickTime());
+    const std::vector<InputState>& inputs = replay.getInputs();
+    for (std::size_t tick = 0; tick < inputs.size(); ++tick)
+    {
+        if (!step(simulation, inputs[tick], elapsed, static_cast<int>(tick), heatmap))
+            break;
+    }
+    heatmap.addRun();
+}
+
+void RunSampler::addRandomRun(std::uint64_t seed, Heatmap& heatmap) const
+{
+    Simulation simulation(start);
+    std::mt19937_64 random(seed);
+    std::uniform_real_distribution<float> chance(0.0f, 1.0f);
+    std::uniform_int_distribution<int> decisionTicks(MIN_DECISION_TICKS, MAX_DECISION_TICKS);
+    // Anywhere in the upper half, not quite to the end of the rope
+    std::uniform_real_distribution<float> hookAngle(-2.8f, -0.35f);
+
+    sf::Time elapsed = sf::seconds(options.tickTime);
+    int ticks = static_cast<int>(options.randomSeconds / options.tickTime);
+    InputState input;
+    int decisionEnd = 0;
+    for (int tick = 0; tick < ticks; ++tick)
+    {
+        if (tick == decisionEnd)
+        {
+            const Player& player = simulation.getPlayer();
+            input = InputState();
+
+            float direction = chance(random);
+            if (direction < 0.6f)
+                input.setHeld(Action::MoveRight, true);
+            else if (direction < 0.8f)
+                input.setHeld(Action::MoveLeft, true);
+
+            // Jump is held for the whole choice and would let go of the rope
+            // at once, so a choice either throws the hook or jumps
+            sf::Vector2f center = hitboxCenter(player);
+            input.aim = center;
+            if (player.getHook().getState() == HookState::Inactive && chance(random) < 0.25f)
+            {
+                float angle = hookAngle(random);
+                float reach = Hook::MAX_HOOK_RANGE * 0.8f;
+                input.aim = center + sf::Vector2f(std::cos(angle) * reach, std::sin(angle) * reach);
+                input.setHeld(Action::Hook, true);
+            }
+            else if ((player.isOnGround() || player.isHooked()) && chance(random) < 0.3f)
+            {
+                input.setHeld(Action::Jump, true);
+            }
+            decisionEnd = tick + decisionTicks(random);
+        }
+
+        if (!step(simulation, input, elapsed, tick, heatmap))
+            break;
+    }
+    heatmap.addRun();
+}
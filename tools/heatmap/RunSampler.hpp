@@ -0,0 +1,38 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include "core/Heatmap.hpp"
+#include "core/Replay.hpp"
+#include "core/Simulation.hpp"
+
+struct SampleOptions
+{
+    // Seconds per simulation step of random runs, the race tick by default
+    float tickTime = 1.0f / 60.0f;
+    // Ticks between two trajectory samples
+    int sampleTicks = 2;
+    // Level seconds a random run plays for
+    float randomSeconds = 30.0f;
+};
+
+// Plays runs of one map headless, each on its own copy of the level, and
+// counts where the player died, where the hook bit and where the player went
+// into a heatmap. Const, so one sampler serves every thread.
+class RunSampler
+{
+public:
+    RunSampler(const Simulation& start, const SampleOptions& options);
+
+    // A recorded run at its own tick, until it wins or its input ends
+    void addReplay(const Replay& replay, Heatmap& heatmap) const;
+    // Random play of the kind a new player might try: mostly running right,
+    // jumping and throwing the hook upwards. The same seed plays the same run.
+    void addRandomRun(std::uint64_t seed, Heatmap& heatmap) const;
+
+private:
+    const Simulation& start;
+    SampleOptions options;
+
+    // False once the run has won
+    bool step(Simulation& simulation, const InputState& input, const sf::Time& elapsed, int tick, Heatmap& heatmap) const;
+};
@@ -0,0 +1,281 @@
+// hookleap_heatmap: plays recorded and random runs of a map headless and
+// counts where players die, where the hook bites and where players go, into
+// a heatmap the game lays over the level
+//
+//   hookleap_heatmap --random 5000 map1.txt
+//   HookLeap, then H while playing map1.txt
+//
+// Runs are shared out over threads, each counting into its own heatmap, and
+// the heatmaps are merged once every run is done.
+#include "RunSampler.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "core/AssetLoader.hpp"
+#include "core/LevelBuilder.hpp"
+#include "core/MapIndex.hpp"
+#include "net/Protocol.hpp"
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+    // Room around the level for falls and throws past its edge
+    constexpr float AREA_MARGIN = 64.0f;
+    constexpr int TOP_CELLS = 5;
+
+    double secondsSince(Clock::time_point start)
+    {
+        return std::chrono::duration<double>(Clock::now() - start).count();
+    }
+
+    void printUsage()
+    {
+        std::cerr << "Usage: hookleap_heatmap [options] map.txt\n"
+                  << "  map.txt is a map in assets/maps\n"
+                  << "  --replays DIR   directory searched for replays of the map (default replays)\n"
+                  << "  --random N      random runs to play besides the replays (default 1000)\n"
+                  << "  --seconds S     level seconds each random run plays for (default 30)\n"
+                  << "  --seed N        seed of the first random run (default 1)\n"
+                  << "  --cell N        pixel size of the heatmap's cells, doubled until large maps fit (default 16)\n"
+                  << "  --sample N      ticks between two trajectory samples (default 2)\n"
+                  << "  --threads N     worker threads, 0 for one per core (default 0)\n"
+                  << "  --output FILE   heatmap to write (default heatmaps/<map>.heatmap)\n"
+                  << "  --merge         add to the counts already in the output instead of replacing them\n"
+                  << "  --assets DIR    asset directory when no assets.pak is present (default assets)\n";
+    }
+
+    // Every replay under the directory recorded on this map
+    void loadReplays(const std::string& directory, std::uint64_t mapHash, std::vector<Replay>& replays)
+    {
+        std::error_code error;
+        if (!std::filesystem::is_directory(directory, error))
+            return;
+
+        for (const auto& entry : std::filesystem::recursive_directory_iterator(directory, error))
+        {
+            if (!entry.is_regular_file() || entry.path().extension() != ".replay")
+                continue;
+
+            Replay replay;
+            if (replay.load(entry.path().string()) && replay.getMapHash() == mapHash)
+                replays.push_back(std::move(replay));
+        }
+    }
+}
+
+int main(int argc, char** argv)
+{
+    SampleOptions options;
+    options.tickTime = tickTime().asSeconds();
+    std::string mapFile;
+    std::string replayDirectory = "replays";
+    std::string output;
+    std::string assetDirectory = AssetLoader::ASSET_DIRECTORY;
+    std::size_t randomRuns = 1000;
+    std::uint64_t seed = 1;
+    float cellSize = Heatmap::DEFAULT_CELL_SIZE;
+    unsigned threadCount = 0;
+    bool mergeExisting = false;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string arg = argv[i];
+        if (arg == "--help" || arg == "-h")
+        {
+            printUsage();
+            return 0;
+        }
+
+        if (arg == "--merge")
+        {
+            mergeExisting = true;
+            continue;
+        }
+
+        if (arg.rfind("--", 0) != 0)
+        {
+            mapFile = arg;
+            continue;
+        }
+
+        if (i + 1 >= argc)
+        {
+            std::cerr << "Missing value for " << arg << std::endl;
+            printUsage();
+            return 1;
+        }
+        const char* value = argv[++i];
+
+        if (arg == "--replays")
+            replayDirectory = value;
+        else if (arg == "--random")
+            randomRuns = static_cast<std::size_t>(std::strtoull(value, nullptr, 10));
+        else if (arg == "--seconds")
+            options.randomSeconds = std::strtof(value, nullptr);
+        else if (arg == "--seed")
+            seed = std::strtoull(value, nullptr, 10);
+        else if (arg == "--cell")
+            cellSize = std::strtof(value, nullptr);
+        else if (arg == "--sample")
+            options.sampleTicks = std::atoi(value);
+        else if (arg == "--threads")
+            threadCount = static_cast<unsigned>(std::strtoul(value, nullptr, 10));
+        else if (arg == "--output")
+            output = value;
+        else if (arg == "--assets")
+            assetDirectory = value;
+        else
+        {
+            std::cerr << "Unknown option: " << arg << std::endl;
+            printUsage();
+            return 1;
+        }
+    }
+
+    if (mapFile.empty())
+    {
+        printUsage();
+        return 1;
+    }
+
+    if (options.randomSeconds <= 0 || cellSize <= 0 || options.sampleTicks < 1)
+    {
+        std::cerr << "Seconds, cell size and sample ticks must be positive" << std::endl;
+        return 1;
+    }
+
+    AssetLoader assets;
+    assets.open(AssetLoader::PACK_FILE, assetDirectory);
+
+    MapData map;
+    std::uint64_t mapHash = 0;
+    if (!assets.readMap(mapFile, map, mapHash))
+        return 1;
+
+    // Built like the race server's copy of a level, without art
+    sf::Texture emptyTexture;
+    LevelBuilder builder({&emptyTexture, &emptyTexture, &emptyTexture, &emptyTexture, &emptyTexture, &emptyTexture});
+    Simulation start(emptyTexture);
+    std::vector<Entity> entities;
+    builder.build(start, map, entities);
+    start.restart({LevelBuilder::SPAWN_X, LevelBuilder::SPAWN_Y});
+
+    MapInfo info;
+    MapIndex::describe(map, info);
+    sf::FloatRect area(info.bounds.position - sf::Vector2f(AREA_MARGIN, AREA_MARGIN),
+                       info.bounds.size + sf::Vector2f(2 * AREA_MARGIN, 2 * AREA_MARGIN));
+    Heatmap heatmap(mapHash, area, cellSize);
+
+    std::vector<Replay> replays;
+    loadReplays(replayDirectory, mapHash, replays);
+    std::size_t jobCount = replays.size() + randomRuns;
+    if (jobCount == 0)
+    {
+        std::cerr << "No replays of " << mapFile << " in " << replayDirectory << " and no random runs asked for"
+                  << std::endl;
+        return 1;
+    }
+
+    if (threadCount == 0)
+        threadCount = std::max(1u, std::thread::hardware_concurrency());
+    threadCount = static_cast<unsigned>(std::min<std::size_t>(threadCount, jobCount));
+
+    // Replays first, then random runs; run n is seeded by seed + n, so the
+    // counts do not depend on how many threads shared the work
+    RunSampler sampler(start, options);
+    std::vector<Heatmap> shards(threadCount, heatmap);
+    std::atomic<std::size_t> nextJob(0);
+    auto started = Clock::now();
+    std::vector<std::thread> workers;
+    for (unsigned t = 0; t < threadCount; ++t)
+    {
+        workers.emplace_back([&, t]
+        {
+            Heatmap& shard = shards[t];
+            for (std::size_t job = nextJob++; job < jobCount; job = nextJob++)
+            {
+                if (job < replays.size())
+                    sampler.addReplay(replays[job], shard);
+                else
+                    sampler.addRandomRun(seed + (job - replays.size()), shard);
+            }
+        });
+    }
+    for (auto& worker : workers)
+    {
+        worker.join();
+    }
+    for (const Heatmap& shard : shards)
+    {
+        heatmap.merge(shard);
+    }
+    double runSeconds = secondsSince(started);
+
+    if (output.empty())
+        output = Heatmap::pathFor(mapFile);
+
+    if (mergeExisting)
+    {
+        Heatmap existing;
+        if (existing.load(output) && !heatmap.merge(existing))
+        {
+            std::cerr << output << " covers another map or grid, pass --output or drop --merge" << std::endl;
+            return 1;
+        }
+    }
+
+    if (!heatmap.save(output))
+        return 1;
+
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << mapFile << ": " << replays.size() << " replays and " << randomRuns << " random runs in "
+              << runSeconds << " s on " << threadCount << (threadCount == 1 ? " thread" : " threads") << std::endl;
+    if (heatmap.getCellSize() != cellSize)
+    {
+        std::cout << "  Cells grown from " << cellSize << " px so the grid stays within " << Heatmap::MAX_CELLS
+                  << " cells and " << Heatmap::MAX_SIDE << " on a side" << std::endl;
+    }
+    std::cout << "  " << heatmap.getColumns() << " x " << heatmap.getRows() << " cells of " << heatmap.getCellSize()
+              << " px, " << heatmap.getRunCount() << " runs counted" << std::endl;
+    std::cout << "  " << heatmap.getTotal(HeatmapLayer::Deaths) << " deaths, " << heatmap.getTotal(HeatmapLayer::Hooks)
+              << " hooks, " << heatmap.getTotal(HeatmapLayer::Trajectory) << " trajectory samples" << std::endl;
+
+    // Where the map kills most, by the cell's center in level pixels
+    struct Cell
+    {
+        std::uint32_t count;
+        sf::Vector2f center;
+    };
+    std::vector<Cell> deadliest;
+    for (std::uint32_t row = 0; row < heatmap.getRows(); ++row)
+    {
+        for (std::uint32_t column = 0; column < heatmap.getColumns(); ++column)
+        {
+            std::uint32_t count = heatmap.getCount(HeatmapLayer::Deaths, column, row);
+            if (count == 0)
+                continue;
+            sf::Vector2f center = heatmap.getOrigin() +
+                                  sf::Vector2f(column + 0.5f, row + 0.5f) * heatmap.getCellSize();
+            deadliest.push_back({count, center});
+        }
+    }
+    std::size_t shown = std::min<std::size_t>(TOP_CELLS, deadliest.size());
+    std::partial_sort(deadliest.begin(), deadliest.begin() + shown, deadliest.end(),
+                      [](const Cell& a, const Cell& b) { return a.count > b.count; });
+    for (std::size_t i = 0; i < shown; ++i)
+    {
+        std::cout << "  " << deadliest[i].count << " deaths around (" << std::setprecision(0)
+                  << deadliest[i].center.x << ", " << deadliest[i].center.y << ")" << std::endl;
+    }
+
+    std::cout << "Wrote " << output << std::endl;
+    return 0;
+}
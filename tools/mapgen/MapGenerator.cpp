@@ -0,0 +1,167 @@
+#include "MapGenerator.hpp"
+#include "core/Physics.hpp"
+#include "game/Player.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+    constexpr float SAFETY = 0.6f;
+}
+
+MapGenerator::MapGenerator(const MapGeneratorOptions& options)
+    : options(options), rng(options.seed)
+{
+}
+
+float MapGenerator::maxGap()
+{
+    // Time in the air when jumping to the same height, at full run speed
+    float airTime = 2.0f * -Player::JUMP_FORCE / Physics::GRAVITY;
+    return Player::MOVE_SPEED * airTime * SAFETY;
+}
+
+float MapGenerator::maxClimb()
+{
+    return Player::JUMP_FORCE * Player::JUMP_FORCE / (2.0f * Physics::GRAVITY) * SAFETY;
+}
+
+float MapGenerator::uniform(float low, float high)
+{
+    return std::uniform_real_distribution<float>(low, high)(rng);
+}
+
+bool MapGenerator::chance(float probability)
+{
+    return uniform(0.0f, 1.0f) < probability;
+}
+
+std::size_t MapGenerator::generate(MapWriter& writer)
+{
+    writer.tileset(options.tileset);
+
+    std::size_t written = 0;
+    const std::size_t target = std::max<std::size_t>(options.objectCount, 3);
+
+    // Same start as the hand-made maps: spawn is at (100, 250) above this
+    writer.ground(0, 500, 640, 32);
+    ++written;
+
+    // lead is the edge of the last route platform facing the way we travel
+    float lead = 640.0f;
+    float y = 500.0f;
+    float rowY = 500.0f;
+    int direction = 1;
+    int drops = 0;
+    float dropStep = 0;
+    int step = 0;
+    float sceneryBudget = 0;
+
+    // Keep room for the win pickup and the platform under it
+    while (written + 2 < target)
+    {
+        ++step;
+        bool turning = drops > 0;
+        bool hasCheckpoint = step % CHECKPOINT_INTERVAL == 0;
+
+        float gap;
+        float nextY;
+        if (turning)
+        {
+            // End of a row: walk off the edge onto a platform below
+            gap = uniform(8.0f, PLATFORM_WIDTH * 0.5f);
+            nextY = y + dropStep;
+            --drops;
+        }
+        else
+        {
+            gap = uniform(PLATFORM_WIDTH * 0.5f, maxGap());
+            nextY = std::clamp(y + uniform(-maxClimb(), maxClimb()), rowY - 150.0f, rowY + 150.0f);
+        }
+
+        float platformX = direction > 0 ? lead + gap : lead - gap - PLATFORM_WIDTH;
+        float farX = platformX;
+
+        // Checkpoints sit on static platforms so respawning always has footing
+        bool kinematic = !turning && !hasCheckpoint && chance(options.kinematic);
+        if (kinematic && chance(0.5f))
+        {
+            // Slides away from the previous platform and back, so the gap
+            // from it never exceeds the safe one
+            float range = uniform(32.0f, 96.0f);
+            farX = platformX + direction * range;
+            writer.mover(platformX, nextY, farX, nextY, uniform(40.0f, 80.0f));
+        }
+        else if (kinematic)
+        {
+            writer.crumble(platformX, nextY, uniform(0.5f, 1.0f), uniform(1.5f, 3.0f));
+        }
+        else
+        {
+            writer.platform(platformX, nextY);
+        }
+        ++written;
+
+        lead = direction > 0 ? farX + PLATFORM_WIDTH : farX;
+        y = nextY;
+
+        if (hasCheckpoint && written + 2 < target)
+        {
+            writer.checkpoint(platformX + (PLATFORM_WIDTH - PICKUP_SIZE) / 2.0f, nextY - PICKUP_SIZE);
+            ++written;
+        }
+
+        // Near the ends of a row the route runs vertically, so only coins go there
+        bool clearOfTurns = !turning && lead > TURN_MARGIN && lead < ROW_WIDTH - TURN_MARGIN;
+
+        sceneryBudget += options.density;
+        while (sceneryBudget >= 1.0f && written + 2 < target)
+        {
+            sceneryBudget -= 1.0f;
+            float sceneryX = platformX + uniform(-maxGap(), maxGap());
+            float roll = clearOfTurns ? uniform(0.0f, 1.0f) : 0.5f;
+
+            if (roll < 0.45f)
+            {
+                // Hook targets well above the highest jump
+                float sceneryY = rowY - 150.0f - uniform(220.0f, 400.0f);
+                if (chance(options.kinematic))
+                    writer.oscillator(sceneryX, sceneryY, uniform(0.0f, 80.0f), uniform(0.0f, 40.0f), uniform(2.0f, 5.0f));
+                else
+                    writer.platform(sceneryX, sceneryY);
+            }
+            else if (roll < 0.75f)
+            {
+                writer.pickup(platformX + (PLATFORM_WIDTH - PICKUP_SIZE) / 2.0f,
+                              nextY - PICKUP_SIZE - uniform(0.0f, maxClimb() * 0.5f));
+            }
+            else
+            {
+                // Pits under the route punish missed jumps
+                writer.obstacle(sceneryX - OBSTACLE_WIDTH / 2.0f, rowY + 150.0f + uniform(200.0f, 300.0f));
+            }
+            ++written;
+        }
+
+        if (turning && drops == 0)
+        {
+            // Landed on the new row, head back the other way
+            direction = -direction;
+            lead = direction > 0 ? platformX + PLATFORM_WIDTH : platformX;
+        }
+        else if (!turning && ((direction > 0 && lead > ROW_WIDTH) || (direction < 0 && lead < 0)))
+        {
+            rowY += ROW_HEIGHT;
+            drops = static_cast<int>(std::ceil((rowY - y) / ROW_DROP));
+            dropStep = (rowY - y) / drops;
+        }
+    }
+
+    // Finish on a plain platform with the win pickup on it
+    float finishX = direction > 0 ? lead + maxGap() * 0.5f : lead - maxGap() * 0.5f - PLATFORM_WIDTH;
+    writer.platform(finishX, y);
+    writer.win(finishX + (PLATFORM_WIDTH - PICKUP_SIZE) / 2.0f, y - PICKUP_SIZE);
+    written += 2;
+
+    return written;
+}
@@ -0,0 +1,53 @@
+#pragma once
+#include <cstdint>
+#include <random>
+#include <string>
+#include "MapWriter.hpp"
+
+struct MapGeneratorOptions
+{
+    std::uint32_t seed = 1;
+    std::size_t objectCount = 1000;
+    // Scenery objects (hook targets, pits, coins) per platform on the route
+    float density = 2.0f;
+    // Share of route platforms that move or crumble
+    float kinematic = 0.1f;
+    std::string tileset = "forest";
+};
+
+// Builds levels around a route of platforms that each lie within a safe jump
+// of the previous one, ending at the win pickup. Everything else is placed
+// where it cannot block the route. The route snakes back and forth in rows so
+// coordinates stay small even for a million objects.
+class MapGenerator
+{
+public:
+    // Sizes of the tileset images, which is what loadMap gives each object
+    static constexpr float PLATFORM_WIDTH = 64.0f;
+    static constexpr float PLATFORM_HEIGHT = 18.0f;
+    static constexpr float OBSTACLE_WIDTH = 192.0f;
+    static constexpr float PICKUP_SIZE = 32.0f;
+
+    static constexpr float ROW_WIDTH = 20000.0f;
+    static constexpr float ROW_HEIGHT = 900.0f;
+    static constexpr float ROW_DROP = 225.0f;
+    static constexpr float TURN_MARGIN = 600.0f;
+    static constexpr int CHECKPOINT_INTERVAL = 40;
+
+    explicit MapGenerator(const MapGeneratorOptions& options);
+
+    // Returns the number of objects written, tileset line excluded
+    std::size_t generate(MapWriter& writer);
+
+    // Largest safe gap and climb between route platforms, derived from the
+    // player's jump with a margin for reaction time
+    static float maxGap();
+    static float maxClimb();
+
+private:
+    MapGeneratorOptions options;
+    std::mt19937 rng;
+
+    float uniform(float low, float high);
+    bool chance(float probability);
+};
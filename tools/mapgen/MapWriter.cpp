@@ -0,0 +1,92 @@
+#include "MapWriter.hpp"
+#include <charconv>
+#include <iostream>
+
+TextMapWriter::TextMapWriter(const std::string& path)
+    : out(&std::cout)
+{
+    if (!path.empty() && path != "-")
+    {
+        file.open(path, std::ios::binary);
+        out = &file;
+    }
+}
+
+bool TextMapWriter::isOpen() const
+{
+    return out != &file || file.is_open();
+}
+
+void TextMapWriter::line(const char* type, std::initializer_list<float> values)
+{
+    // Shortest fixed-point text that reads back to the same float
+    char buffer[256];
+    char* cursor = buffer;
+    for (const char* c = type; *c; ++c)
+        *cursor++ = *c;
+
+    for (float value : values)
+    {
+        *cursor++ = ' ';
+        cursor = std::to_chars(cursor, buffer + sizeof(buffer) - 1, value, std::chars_format::fixed).ptr;
+    }
+    *cursor++ = '\n';
+
+    out->write(buffer, cursor - buffer);
+}
+
+void TextMapWriter::tileset(const std::string& name)
+{
+    *out << name << '\n';
+}
+
+void TextMapWriter::ground(float x, float y, float width, float height)
+{
+    line("ground", {x, y, width, height});
+}
+
+void TextMapWriter::platform(float x, float y)
+{
+    line("platform", {x, y});
+}
+
+void TextMapWriter::mover(float x, float y, float endX, float endY, float speed)
+{
+    line("mover", {x, y, endX, endY, speed});
+}
+
+void TextMapWriter::oscillator(float x, float y, float amplitudeX, float amplitudeY, float period)
+{
+    line("oscillator", {x, y, amplitudeX, amplitudeY, period});
+}
+
+void TextMapWriter::crumble(float x, float y, float delay, float respawnTime)
+{
+    line("crumble", {x, y, delay, respawnTime});
+}
+
+void TextMapWriter::obstacle(float x, float y)
+{
+    line("obstacle", {x, y});
+}
+
+void TextMapWriter::pickup(float x, float y)
+{
+    line("pickup", {x, y});
+}
+
+void TextMapWriter::checkpoint(float x, float y)
+{
+    line("checkpoint", {x, y});
+}
+
+void TextMapWriter::win(float x, float y)
+{
+    line("win", {x, y});
+}
+
+bool TextMapWriter::finish()
+{
+    out->flush();
+    return static_cast<bool>(*out);
+}
@@ -0,0 +1,54 @@
+#pragma once
+#include <fstream>
+#include <initializer_list>
+#include <ostream>
+#include <string>
+
+// Receives a level one object at a time. The text writer produces the format
+// read by MainWindow::loadMap; other formats only need another writer.
+class MapWriter
+{
+public:
+    virtual ~MapWriter() = default;
+
+    virtual void tileset(const std::string& name) = 0;
+    virtual void ground(float x, float y, float width, float height) = 0;
+    virtual void platform(float x, float y) = 0;
+    virtual void mover(float x, float y, float endX, float endY, float speed) = 0;
+    virtual void oscillator(float x, float y, float amplitudeX, float amplitudeY, float period) = 0;
+    virtual void crumble(float x, float y, float delay, float respawnTime) = 0;
+    virtual void obstacle(float x, float y) = 0;
+    virtual void pickup(float x, float y) = 0;
+    virtual void checkpoint(float x, float y) = 0;
+    virtual void win(float x, float y) = 0;
+
+    virtual bool finish() = 0;
+};
+
+class TextMapWriter : public MapWriter
+{
+public:
+    // Writes to path, or to stdout when path is empty or "-"
+    explicit TextMapWriter(const std::string& path);
+
+    bool isOpen() const;
+
+    void tileset(const std::string& name) override;
+    void ground(float x, float y, float width, float height) override;
+    void platform(float x, float y) override;
+    void mover(float x, float y, float endX, float endY, float speed) override;
+    void oscillator(float x, float y, float amplitudeX, float amplitudeY, float period) override;
+    void crumble(float x, float y, float delay, float respawnTime) override;
+    void obstacle(float x, float y) override;
+    void pickup(float x, float y) override;
+    void checkpoint(float x, float y) override;
+    void win(float x, float y) override;
+
+    bool finish() override;
+
+private:
+    std::ofstream file;
+    std::ostream* out;
+
+    void line(const char* type, std::initializer_list<float> values);
+};
@@ -0,0 +1,139 @@
+// hookleap_pack: bundles an asset directory into one pack file for release
+// builds. See AssetPack.hpp for the layout.
+//
+//   hookleap_pack assets build/assets.pak
+#include "core/AssetPack.hpp"
+#include "core/MappedFile.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace
+{
+    struct PackEntry
+    {
+        std::string name;
+        std::filesystem::path path;
+        std::uint64_t size;
+        std::uint64_t offset;
+    };
+
+    void writeInteger(std::ofstream& out, std::uint64_t value, std::size_t bytes)
+    {
+        char buffer[8];
+        for (std::size_t i = 0; i < bytes; ++i)
+        {
+            buffer[i] = static_cast<char>((value >> (i * 8)) & 0xFF);
+        }
+        out.write(buffer, static_cast<std::streamsize>(bytes));
+    }
+
+    std::uint64_t alignUp(std::uint64_t value)
+    {
+        return (value + AssetPack::ALIGNMENT - 1) / AssetPack::ALIGNMENT * AssetPack::ALIGNMENT;
+    }
+
+    void printUsage()
+    {
+        std::cerr << "Usage: hookleap_pack <asset directory> <output pack>\n";
+    }
+}
+
+int main(int argc, char** argv)
+{
+    if (argc != 3)
+    {
+        printUsage();
+        return 1;
+    }
+
+    std::filesystem::path root = argv[1];
+    std::string output = argv[2];
+
+    std::error_code error;
+    if (!std::filesystem::is_directory(root, error))
+    {
+        std::cerr << "Not a directory: " << root.string() << std::endl;
+        return 1;
+    }
+
+    std::vector<PackEntry> entries;
+    for (const auto& file : std::filesystem::recursive_directory_iterator(root, error))
+    {
+        if (!file.is_regular_file())
+            continue;
+
+        PackEntry entry;
+        entry.name = std::filesystem::relative(file.path(), root).generic_string();
+        entry.path = file.path();
+        entry.size = file.file_size();
+        entry.offset = 0;
+        entries.push_back(std::move(entry));
+    }
+
+    // Sorted so the same assets always produce the same pack
+    std::sort(entries.begin(), entries.end(), [](const PackEntry& a, const PackEntry& b)
+    {
+        return a.name < b.name;
+    });
+
+    std::uint64_t tableSize = sizeof(AssetPack::MAGIC) + 4 + 4;
+    for (const auto& entry : entries)
+    {
+        tableSize += 8 + 8 + 4 + entry.name.size();
+    }
+
+    std::uint64_t offset = alignUp(tableSize);
+    for (auto& entry : entries)
+    {
+        entry.offset = offset;
+        offset = alignUp(offset + entry.size);
+    }
+
+    std::ofstream out(output, std::ios::binary | std::ios::trunc);
+    if (!out)
+    {
+        std::cerr << "Could not write " << output << std::endl;
+        return 1;
+    }
+
+    out.write(AssetPack::MAGIC, sizeof(AssetPack::MAGIC));
+    writeInteger(out, AssetPack::VERSION, 4);
+    writeInteger(out, entries.size(), 4);
+    for (const auto& entry : entries)
+    {
+        writeInteger(out, entry.offset, 8);
+        writeInteger(out, entry.size, 8);
+        writeInteger(out, entry.name.size(), 4);
+        out.write(entry.name.data(), static_cast<std::streamsize>(entry.name.size()));
+    }
+
+    const char padding[AssetPack::ALIGNMENT] = {};
+    std::uint64_t written = tableSize;
+    for (const auto& entry : entries)
+    {
+        out.write(padding, static_cast<std::streamsize>(entry.offset - written));
+
+        MappedFile file;
+        if (!file.open(entry.path.string()) || file.getSize() != entry.size)
+        {
+            std::cerr << "Could not read " << entry.path.string() << std::endl;
+            return 1;
+        }
+        out.write(file.getData(), static_cast<std::streamsize>(file.getSize()));
+        written = entry.offset + entry.size;
+    }
+
+    if (!out)
+    {
+        std::cerr << "Failed while writing " << output << std::endl;
+        return 1;
+    }
+
+    std::cout << "Packed " << entries.size() << " assets, " << written << " bytes, into " << output << std::endl;
+    return 0;
+}
@@ -0,0 +1,167 @@
+#include "RoomPool.hpp"
+#include <algorithm>
+#include <iostream>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+    // A worker this far behind stops trying to catch up
+    constexpr std::chrono::milliseconds MAX_LAG{250};
+
+    void pinToCore(std::thread& thread, std::size_t index)
+    {
+#ifdef __linux__
+        unsigned int cores = std::max(1u, std::thread::hardware_concurrency());
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(index % cores, &set);
+        if (pthread_setaffinity_np(thread.native_handle(), sizeof(set), &set) != 0)
+            std::cerr << "Could not pin worker " << index << " to a core" << std::endl;
+#else
+        // Elsewhere the scheduler decides; rooms still never change worker
+        (void)thread;
+        (void)index;
+#endif
+    }
+}
+
+RoomPool::RoomPool(std::size_t threadCount)
+    : roomCount(0), running(false), lateTicks(0)
+{
+    threadCount = std::max<std::size_t>(1, threadCount);
+    for (std::size_t i = 0; i < threadCount; ++i)
+    {
+        workers.push_back(std::make_unique<Worker>());
+        workers.back()->index = i;
+    }
+}
+
+RoomPool::~RoomPool()
+{
+    stop();
+}
+
+void RoomPool::addRoom(std::unique_ptr<GameServer> room)
+{
+    Worker& worker = *workers[roomCount % workers.size()];
+
+    Room added;
+    added.report.room = roomCount++;
+    added.report.port = room->getPort();
+    added.server = std::move(room);
+    worker.rooms.push_back(std::move(added));
+}
+
+void RoomPool::start()
+{
+    running = true;
+    for (auto& worker : workers)
+    {
+        Worker& started = *worker;
+        worker->thread = std::thread([this, &started] { runWorker(started); });
+        pinToCore(worker->thread, worker->index);
+    }
+}
+
+void RoomPool::stop()
+{
+    if (!running)
+        return;
+
+    running = false;
+    for (auto& worker : workers)
+    {
+        if (worker->thread.joinable())
+            worker->thread.join();
+    }
+}
+
+void RoomPool::runWorker(Worker& worker)
+{
+    sf::SocketSelector selector;
+    for (auto& room : worker.rooms)
+    {
+        selector.add(room.server->getSocket());
+    }
+
+    const auto tickLength = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / TICK_RATE));
+    std::vector<std::chrono::nanoseconds> times(worker.rooms.size());
+    auto nextTick = Clock::now() + tickLength;
+
+    while (running)
+    {
+        // Sleep until the tick is due, waking up to read whatever arrives
+        for (auto now = Clock::now(); now < nextTick; now = Clock::now())
+        {
+            auto wait = std::chrono::duration_cast<std::chrono::microseconds>(nextTick - now);
+            // A zero timeout would make the selector wait forever
+            if (wait.count() <= 0 || !selector.wait(sf::microseconds(wait.count())))
+                continue;
+
+            for (auto& room : worker.rooms)
+            {
+                if (selector.isReady(room.server->getSocket()))
+                    room.server->receive();
+            }
+        }
+
+        for (std::size_t i = 0; i < worker.rooms.size(); ++i)
+        {
+            auto start = Clock::now();
+            worker.rooms[i].server->update();
+            times[i] = Clock::now() - start;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(worker.mutex);
+            for (std::size_t i = 0; i < worker.rooms.size(); ++i)
+            {
+                RoomReport& report = worker.rooms[i].report;
+                report.players = worker.rooms[i].server->getClientCount();
+                report.ticks++;
+                report.total += times[i];
+                report.max = std::max(report.max, times[i]);
+            }
+        }
+
+        nextTick += tickLength;
+        auto now = Clock::now();
+        if (now - nextTick > MAX_LAG)
+        {
+            lateTicks++;
+            nextTick = now + tickLength;
+        }
+    }
+
+    for (auto& room : worker.rooms)
+    {
+        room.server->disconnectAll();
+    }
+}
+
+void RoomPool::collect(std::vector<RoomReport>& reports)
+{
+    reports.assign(roomCount, RoomReport());
+    for (auto& worker : workers)
+    {
+        std::lock_guard<std::mutex> lock(worker->mutex);
+        for (auto& room : worker->rooms)
+        {
+            reports[room.report.room] = room.report;
+            room.report.ticks = 0;
+            room.report.total = std::chrono::nanoseconds(0);
+            room.report.max = std::chrono::nanoseconds(0);
+        }
+    }
+}
+
+std::uint64_t RoomPool::takeLateTicks()
+{
+    return lateTicks.exchange(0);
+}
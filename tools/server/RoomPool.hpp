@@ -0,0 +1,68 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "net/GameServer.hpp"
+
+// Tick cost of one room since the last RoomPool::collect
+struct RoomReport
+{
+    std::size_t room = 0;
+    unsigned short port = 0;
+    std::size_t players = 0;
+    std::uint64_t ticks = 0;
+    std::chrono::nanoseconds total{0};
+    std::chrono::nanoseconds max{0};
+};
+
+// Runs many race rooms on a fixed set of worker threads. A room stays on the
+// worker it was given, and each worker stays on one core, so a room's
+// simulations keep their caches warm. Between ticks a worker sleeps in an
+// sf::SocketSelector over its rooms and reads inputs as they arrive.
+class RoomPool
+{
+public:
+    explicit RoomPool(std::size_t threadCount);
+    ~RoomPool();
+
+    // Rooms are dealt round robin; add them all before start()
+    void addRoom(std::unique_ptr<GameServer> room);
+    void start();
+    // Joins the workers and disconnects every player
+    void stop();
+
+    // One entry per room, in the order they were added. Resets the counters.
+    void collect(std::vector<RoomReport>& reports);
+    // Ticks that started over a quarter second late, i.e. the pool is overloaded
+    std::uint64_t takeLateTicks();
+
+    std::size_t getThreadCount() const { return workers.size(); }
+    std::size_t getRoomCount() const { return roomCount; }
+
+private:
+    struct Room
+    {
+        std::unique_ptr<GameServer> server;
+        RoomReport report;
+    };
+
+    struct Worker
+    {
+        std::size_t index = 0;
+        std::vector<Room> rooms;
+        std::thread thread;
+        // Guards the reports, which the reporting thread reads
+        std::mutex mutex;
+    };
+
+    std::vector<std::unique_ptr<Worker>> workers;
+    std::size_t roomCount;
+    std::atomic<bool> running;
+    std::atomic<std::uint64_t> lateTicks;
+
+    void runWorker(Worker& worker);
+};
@@ -0,0 +1,228 @@
+// hookleap_server: headless race host for many rooms at once
+//
+//   hookleap_server --rooms 200 --map map1.txt --map map3.txt --port 47820
+//
+// Room i listens on port + i; players join one with HookLeap --join host:port.
+#include "RoomPool.hpp"
+#include "core/AssetLoader.hpp"
+#include "net/Protocol.hpp"
+#include <algorithm>
+#include <csignal>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <string>
+
+namespace
+{
+    volatile std::sig_atomic_t stopRequested = 0;
+
+    void requestStop(int)
+    {
+        stopRequested = 1;
+    }
+
+    struct ServerOptions
+    {
+        std::size_t rooms = 1;
+        std::size_t threads = std::max(1u, std::thread::hardware_concurrency());
+        unsigned long port = DEFAULT_PORT;
+        std::vector<std::string> maps;
+        std::string assets = AssetLoader::ASSET_DIRECTORY;
+        double reportInterval = 5.0;
+        bool verbose = false;
+    };
+
+    void printUsage()
+    {
+        std::cerr << "Usage: hookleap_server [options]\n"
+                  << "  --rooms N       number of rooms (default 1)\n"
+                  << "  --threads N     worker threads (default one per core)\n"
+                  << "  --port N        port of the first room, room i gets port + i (default 47820)\n"
+                  << "  --map FILE      map in assets/maps, repeat to rotate maps over rooms (default map1.txt)\n"
+                  << "  --assets DIR    asset directory when no assets.pak is present (default assets)\n"
+                  << "  --report SEC    seconds between timing reports (default 5)\n"
+                  << "  --verbose       report every room, not just the totals\n";
+    }
+
+    double milliseconds(std::chrono::nanoseconds time)
+    {
+        return std::chrono::duration<double, std::milli>(time).count();
+    }
+
+    void printReport(const RoomPool& pool, const std::vector<RoomReport>& reports, double seconds,
+                     std::uint64_t lateTicks, bool verbose)
+    {
+        std::chrono::nanoseconds busy{0};
+        std::uint64_t ticks = 0;
+        std::size_t players = 0;
+        const RoomReport* slowest = nullptr;
+
+        for (const auto& report : reports)
+        {
+            busy += report.total;
+            ticks += report.ticks;
+            players += report.players;
+            if (!slowest || report.max > slowest->max)
+                slowest = &report;
+
+            if (verbose && report.ticks > 0)
+            {
+                std::cout << std::fixed << std::setprecision(3)
+                          << "  room " << report.room << " port " << report.port
+                          << "  players " << report.players
+                          << "  mean " << milliseconds(report.total) / report.ticks << " ms"
+                          << "  max " << milliseconds(report.max) << " ms" << std::endl;
+            }
+        }
+
+        if (ticks == 0 || !slowest)
+            return;
+
+        // Share of the worker cores spent ticking, and how many rooms like
+        // these, or players, one core could carry at 100%
+        double busySeconds = milliseconds(busy) / 1000.0;
+        double load = busySeconds / (seconds * static_cast<double>(pool.getThreadCount()));
+        double roomsPerCore = busySeconds > 0 ? static_cast<double>(reports.size()) * seconds / busySeconds : 0;
+
+        std::cout << std::fixed << std::setprecision(3)
+                  << reports.size() << " rooms, " << players << " players on " << pool.getThreadCount() << " threads"
+                  << " | room tick mean " << milliseconds(busy) / static_cast<double>(ticks) << " ms"
+                  << ", max " << milliseconds(slowest->max) << " ms (room " << slowest->room << ")"
+                  << std::setprecision(1)
+                  << " | load " << load * 100.0 << "%"
+                  << " | ~" << std::setprecision(0) << roomsPerCore << " rooms";
+        if (players > 0)
+            std::cout << " or ~" << static_cast<double>(players) * seconds / busySeconds << " players";
+        std::cout << " per core";
+        if (lateTicks > 0)
+            std::cout << " | " << lateTicks << " late ticks, overloaded";
+        std::cout << std::endl;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    ServerOptions options;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string arg = argv[i];
+        if (arg == "--help" || arg == "-h")
+        {
+            printUsage();
+            return 0;
+        }
+        if (arg == "--verbose")
+        {
+            options.verbose = true;
+            continue;
+        }
+
+        if (i + 1 >= argc)
+        {
+            std::cerr << "Missing value for " << arg << std::endl;
+            printUsage();
+            return 1;
+        }
+        const char* value = argv[++i];
+
+        if (arg == "--rooms")
+            options.rooms = static_cast<std::size_t>(std::strtoull(value, nullptr, 10));
+        else if (arg == "--threads")
+            options.threads = static_cast<std::size_t>(std::strtoull(value, nullptr, 10));
+        else if (arg == "--port")
+            options.port = std::strtoul(value, nullptr, 10);
+        else if (arg == "--map")
+            options.maps.push_back(value);
+        else if (arg == "--assets")
+            options.assets = value;
+        else if (arg == "--report")
+            options.reportInterval = std::strtod(value, nullptr);
+        else
+        {
+            std::cerr << "Unknown option: " << arg << std::endl;
+            printUsage();
+            return 1;
+        }
+    }
+
+    if (options.maps.empty())
+        options.maps.push_back("map1.txt");
+
+    if (options.rooms == 0 || options.threads == 0 || options.reportInterval <= 0)
+    {
+        std::cerr << "Rooms, threads and the report interval must be positive" << std::endl;
+        return 1;
+    }
+
+    if (options.port == 0 || options.port + options.rooms - 1 > 65535)
+    {
+        std::cerr << "Ports " << options.port << " to " << options.port + options.rooms - 1 << " are not all valid" << std::endl;
+        return 1;
+    }
+
+    AssetLoader assets;
+    assets.open(AssetLoader::PACK_FILE, options.assets);
+
+    // Every map is parsed once, however many rooms play it
+    struct LoadedMap
+    {
+        MapData data;
+        std::uint64_t hash = 0;
+    };
+    std::map<std::string, LoadedMap> maps;
+    for (const auto& file : options.maps)
+    {
+        if (maps.count(file) != 0)
+            continue;
+
+        LoadedMap& loaded = maps[file];
+        if (!assets.readMap(file, loaded.data, loaded.hash))
+        {
+            std::cerr << "Could not load map " << file << std::endl;
+            return 1;
+        }
+    }
+
+    RoomPool pool(options.threads);
+    for (std::size_t i = 0; i < options.rooms; ++i)
+    {
+        const std::string& file = options.maps[i % options.maps.size()];
+        const LoadedMap& loaded = maps[file];
+
+        auto room = std::make_unique<GameServer>();
+        room->setLevel(file, loaded.data, loaded.hash);
+        if (!room->listen(static_cast<unsigned short>(options.port + i)))
+            return 1;
+        pool.addRoom(std::move(room));
+    }
+
+    std::signal(SIGINT, requestStop);
+    std::signal(SIGTERM, requestStop);
+
+    pool.start();
+    std::cout << "Hosting " << options.rooms << " rooms on ports " << options.port << "-" << options.port + options.rooms - 1
+              << " with " << pool.getThreadCount() << " threads" << std::endl;
+
+    std::vector<RoomReport> reports;
+    auto lastReport = std::chrono::steady_clock::now();
+    while (!stopRequested)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+        auto now = std::chrono::steady_clock::now();
+        double seconds = std::chrono::duration<double>(now - lastReport).count();
+        if (seconds < options.reportInterval)
+            continue;
+
+        pool.collect(reports);
+        printReport(pool, reports, seconds, pool.takeLateTicks(), options.verbose);
+        lastReport = now;
+    }
+
+    std::cout << "Shutting down" << std::endl;
+    pool.stop();
+    return 0;
+}